@@ -3,6 +3,7 @@
 #include "Framework/MethodCommandProvider.hh"
 #include "Framework/SubSystemStatus.hh"
 #include "Framework/PathAppender.hh"
+#include "Framework/GlobalReduceBatch.hh"
 #include "Environment/FileHandlerOutput.hh"
 #include "Environment/FileHandlerInput.hh"
 #include "Environment/DirPaths.hh"
@@ -90,6 +91,7 @@ AeroForcesFVMCC::AeroForcesFVMCC(const std::string& name) :
   m_aeroForce(),
   m_valuesMatL2(),
   m_l2Norm(),
+  m_l2NormHandles(),
   m_valuesMat(),
   m_valuesMatRes(),
   m_varNames(),
@@ -477,6 +479,9 @@ void AeroForcesFVMCC::executeOnTrs()
     geoBuilder->releaseGE();
   }
   
+  // the reduction of the surface residuals overlaps the output
+  postSurfaceResiduals();
+  
   // all data are written on file at once to ease the parallel writing
   updateOutputFileAero(); 
   updateOutputFileWall();
@@ -737,10 +742,8 @@ void AeroForcesFVMCC::updateOutputFileAero()
 
 //////////////////////////////////////////////////////////////////////////////
 
-void AeroForcesFVMCC::computeSurfaceResiduals()
+void AeroForcesFVMCC::postSurfaceResiduals()
 {
-  const CFuint dim = PhysicalModelStack::getActive()->getDim();
-  
   // compute the L2 norm of some quantities of interest
   SafePtr<TopologicalRegionSet> currTrs = getCurrentTRS();
   const CFuint nbTrsFaces = currTrs->getLocalNbGeoEnts();
@@ -759,17 +762,32 @@ void AeroForcesFVMCC::computeSurfaceResiduals()
   
   cf_assert(m_valuesMatL2.size() > 0);
   
+  // the local sums are complete after the last TRS
+  if (currTrs->getName() == getTrsList().back()->getName()) {
+    GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(getMethodData().getNamespace());
+    m_l2NormHandles.resize(m_valuesMatL2.size());
+    for (CFuint varID = 0; varID < m_valuesMatL2.size(); ++varID) {
+      m_l2NormHandles[varID] = batch.addValue(m_valuesMatL2[varID], GlobalReduceBatch::SUM);
+    }
+    batch.post();
+  }
+}
+      
+//////////////////////////////////////////////////////////////////////////////
+
+void AeroForcesFVMCC::computeSurfaceResiduals()
+{
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  
+  SafePtr<TopologicalRegionSet> currTrs = getCurrentTRS();
   const std::string nsp = this->getMethodData().getNamespace();
   
   bool writeFile = false;
   if (currTrs->getName() == getTrsList().back()->getName()) {
-#ifdef CF_HAVE_MPI
-    m_l2Norm = 0.0;
-    const CFuint count = m_l2Norm.size();
-    MPI_Comm comm = PE::GetPE().GetCommunicator(nsp);
-    MPI_Allreduce(&m_valuesMatL2[0], &m_l2Norm[0], count, MPI_DOUBLE, MPI_SUM, comm);
-    m_valuesMatL2 = m_l2Norm;
-#endif
+    GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(nsp);
+    for (CFuint varID = 0; varID < m_valuesMatL2.size(); ++varID) {
+      m_valuesMatL2[varID] = batch.getValue(m_l2NormHandles[varID]);
+    }
     for (CFuint varID = 0; varID < m_valuesMatL2.size(); ++varID) {
       m_valuesMatL2[varID] = (std::abs(m_valuesMatL2[varID]) > 1e-16) ? std::log(std::sqrt(m_valuesMatL2[varID])) : 1e-16;
     }
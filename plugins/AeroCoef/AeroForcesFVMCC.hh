@@ -105,6 +105,10 @@ protected:
   /// Initialize the surface residuals
   virtual void initSurfaceResiduals();
   
+  /// Register the L2 norms of the residuals of surface quantities of interest
+  /// and start their global reduction
+  virtual void postSurfaceResiduals();
+  
   /// Compute and output to screen the residuals of surface quantities of interest
   virtual void computeSurfaceResiduals();
   
@@ -249,6 +253,9 @@ protected:
   /// array storing the L2 norms of the values to write
   RealVector m_l2Norm;
   
+  /// handles of the L2 norms in the batch of global reductions
+  std::vector<CFuint> m_l2NormHandles;
+  
   /// 2D array storing all values to write to file
   RealMatrix m_valuesMat;
   
@@ -4,10 +4,14 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <fstream>
+
 #include "Common/PE.hh"
 #include "Common/PEFunctions.hh"
 #include "Common/Stopwatch.hh"
 #include "Common/CFLog.hh"
+#include "Common/FilesystemException.hh"
+#include "Common/FNVHash.hh"
 
 #include "Environment/ObjectProvider.hh"
 #include "Environment/DirPaths.hh"
@@ -47,6 +51,7 @@ void CFmeshReader::defineConfigOptions(Config::OptionList& options)
    options.addConfigOption< std::string > ("convertFrom","Name of format from which to convert to CFmesh.");
    options.addConfigOption< bool > ("convertBack","Also convert back to the original format. Usefull only for debugging.");
    options.addConfigOption< bool > ("onlyConversion","Only convert the mesh without loading it into memory.");
+   options.addConfigOption< bool > ("cacheConversion","Skip the conversion if the CFmesh was already produced from an identical input file.");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -79,6 +84,9 @@ CFmeshReader::CFmeshReader(const std::string& name)  : MeshCreator(name)
 
   m_convertBack = false;
   setParameter("convertBack",&m_convertBack);
+  
+  m_cacheConversion = false;
+  setParameter("cacheConversion",&m_cacheConversion);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -146,6 +154,40 @@ void CFmeshReader::buildMeshDataImpl()
 
 //////////////////////////////////////////////////////////////////////////////
 
+std::string CFmeshReader::computeConversionHash(const boost::filesystem::path& fromfile)
+{
+  CFAUTOTRACE;
+  
+  // 64-bit FNV-1a hash, computed while streaming the input file in chunks
+  Common::FNVHash hash;
+  
+  // the converter name and its options are part of the key
+  std::string key = m_converterStr;
+  for (Config::ConfigArgs::const_iterator it = m_stored_args.begin();
+       it != m_stored_args.end(); ++it) {
+    if (it->first.find(m_converterStr) != std::string::npos) {
+      key += " " + it->first + "=" + it->second;
+    }
+  }
+  hash.add(key);
+  
+  ifstream fin(fromfile.string().c_str(), ios::binary);
+  if (!fin) {
+    throw Common::FilesystemException 
+      (FromHere(), "Cannot open file " + fromfile.string());
+  }
+  
+  std::vector<char> buffer(1 << 20);
+  while (fin) {
+    fin.read(&buffer[0], buffer.size());
+    hash.add(&buffer[0], fin.gcount());
+  }
+  
+  return hash.str();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void CFmeshReader::convertFormat()
 {
   CFAUTOTRACE;
@@ -200,11 +242,36 @@ void CFmeshReader::convert(Common::SelfRegistPtr<MeshFormatConverter> converter)
   path fromfile = DirPaths::getInstance().getWorkingDir() / m_data->getConvertFromFileName();
   path tofile   = DirPaths::getInstance().getWorkingDir() / m_data->getFileName();
 
+  // the cached CFmesh is reused only if it was produced by the same converter,
+  // with the same options, from an input file with identical contents
+  // (convertBack needs the data in memory, therefore it always converts)
+  const bool useCache = m_cacheConversion && !m_convertBack;
+  const path hashfile = tofile.string() + ".hash";
+  std::string inputHash;
+  if (useCache) {
+    inputHash = computeConversionHash(fromfile);
+    if (exists(tofile) && exists(hashfile)) {
+      ifstream fin(hashfile.string().c_str());
+      std::string storedHash;
+      fin >> storedHash;
+      if (storedHash == inputHash) {
+	CFLog(INFO, "CFmeshReader::convert() => reusing " << tofile.string()
+	      << " (input hash " << inputHash << ")\n");
+	return;
+      }
+    }
+  }
+  
 #ifndef NDEBUG
   converter->checkFormat(fromfile);
 #endif
 
   converter->convert(fromfile, tofile);
+  
+  if (useCache && PE::GetPE().GetRank(getMethodData()->getNamespace()) == 0) {
+    ofstream fout(hashfile.string().c_str());
+    fout << inputHash << "\n";
+  }
 
   if (m_convertBack)
   {
@@ -86,6 +86,10 @@ private:  // helper functions
   /// Helper function that actually does the job for converting
   void convert(Common::SelfRegistPtr<Framework::MeshFormatConverter> converter);
   
+  /// Compute the key identifying a conversion: a hash of the converter name,
+  /// of its options and of the contents of the input file
+  std::string computeConversionHash(const boost::filesystem::path& fromfile);
+  
 private: // data
 
   ///The Setup string for configuration
@@ -119,6 +123,9 @@ private: // data
   /// option to choose to only convert the mesh without loading it into memory
   bool m_onlyConversion;
   
+  /// option to reuse a previously converted CFmesh if the input is unchanged
+  bool m_cacheConversion;
+  
   /// stored configuration arguments
   /// @todo this should be avoided and removed.
   ///       It is currently only a quick fix for delayed configuration of an object (MeshFormatConverter)
@@ -25,6 +25,7 @@
 #include "Framework/VarSetTransformer.hh"
 #include "Framework/MeshPartitioner.hh"
 #include "Framework/SubSystemStatus.hh"
+#include "Framework/StateCompressor.hh"
 
 #include "CFmeshFileReader/ParCFmeshBinaryFileReader.hh"
 
@@ -47,12 +48,22 @@ ParCFmeshBinaryFileReader::ParCFmeshBinaryFileReader() :
   ParCFmeshFileReader(), // here you have to pass the name of this object to configure
   m_mapString2ReaderFun(),
   m_fh(),
-  m_status()
+  m_status(),
+  m_hasStoredPartition(false),
+  m_storedPartition(),
+  m_elemCost(),
+  m_compressedStates(false)
 {
   addConfigOptionsTo(this);
   
   m_maxBuffSize = 2147479200; // (CFuint) std::numeric_limits<int>::max();
   setParameter("MaxBuffSize",&m_maxBuffSize);
+  
+  m_usePartitionMap = true;
+  setParameter("UsePartitionMap",&m_usePartitionMap);
+  
+  m_maxRemapImbalance = 1.1;
+  setParameter("MaxRemapImbalance",&m_maxRemapImbalance);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -66,6 +77,8 @@ ParCFmeshBinaryFileReader::~ParCFmeshBinaryFileReader()
 void ParCFmeshBinaryFileReader::defineConfigOptions(Config::OptionList& options)
 {
    options.addConfigOption< int >("MaxBuffSize", "Maximum buffer size for MPI I/O");
+   options.addConfigOption< bool >("UsePartitionMap", "Reuse the partition map stored in the file (if any) instead of partitioning");
+   options.addConfigOption< CFreal >("MaxRemapImbalance", "Maximum max/average load ratio accepted when merging a stored partition");
 }
  
 /////////////////////////////////////////////////////////////////////////////
@@ -107,6 +120,7 @@ void ParCFmeshBinaryFileReader::setMapString2Readers()
   m_mapString2ReaderFun["!GEOM_POLYORDER"]     = &ParCFmeshBinaryFileReader::readGeometricPolyOrder;
   m_mapString2ReaderFun["!SOL_POLYORDER"]      = &ParCFmeshBinaryFileReader::readSolutionPolyOrder;
   m_mapString2ReaderFun["!LIST_NODE"]          = &ParCFmeshBinaryFileReader::readNodeList;
+  m_mapString2ReaderFun["!STATE_COMPRESSION"]  = &ParCFmeshBinaryFileReader::readStateCompression;
   m_mapString2ReaderFun["!LIST_STATE"]         = &ParCFmeshBinaryFileReader::readStateList;
   m_mapString2ReaderFun["!NB_TRSs"]            = &ParCFmeshBinaryFileReader::readNbTRSs;
   m_mapString2ReaderFun["!TRS_NAME"]           = &ParCFmeshBinaryFileReader::readTRSName;
@@ -122,6 +136,8 @@ void ParCFmeshBinaryFileReader::setMapString2Readers()
   m_mapString2ReaderFun["!GROUP_NAME"]         = &ParCFmeshBinaryFileReader::readGroupName;
   m_mapString2ReaderFun["!GROUP_ELEM_NB"]      = &ParCFmeshBinaryFileReader::readGroupElementNb;
   m_mapString2ReaderFun["!GROUP_ELEM_LIST"]    = &ParCFmeshBinaryFileReader::readGroupElementList;
+  m_mapString2ReaderFun["!PARTITION_MAP"]      = &ParCFmeshBinaryFileReader::readPartitionMap;
+  m_mapString2ReaderFun["!ELEM_COST"]          = &ParCFmeshBinaryFileReader::readElementCost;
   m_mapString2ReaderFun["!LIST_ELEM"]          = &ParCFmeshBinaryFileReader::readElementList;
 }
 
@@ -660,6 +676,9 @@ void ParCFmeshBinaryFileReader::readElementList(MPI_File* fh)
   readElemListRank(pdata, fh);
   pdata.ndim=(CFint)PhysicalModelStack::getActive()->getDim();
   
+  // the element costs measured by a previous run (if any) are used as weights
+  pdata.elemCost.swap(m_elemCost);
+  
   // do the partitioning of the mesh
   // global element IDs local to each processor after the partitioning
   // will be placed in pdata.part
@@ -672,7 +691,16 @@ void ParCFmeshBinaryFileReader::readElementList(MPI_File* fh)
   // avoid mesh partitioning if you have just one processor
   if (m_nbProc > 1)
   {
-    if (PhysicalModelStack::getActive()->getDim() > DIM_1D) {
+    if (m_hasStoredPartition) {
+      cf_assert(m_storedPartition.size() == m_nbElemPerProc[m_myRank]);
+      CFLog(NOTICE, "Skipping mesh partitioner: using partition map stored in file\n");
+      pdata.part->assign(m_storedPartition.begin(), m_storedPartition.end());
+      SwapEmpty(m_storedPartition);
+      m_hasStoredPartition = false;
+    }
+    else if (PhysicalModelStack::getActive()->getDim() > DIM_1D) {
+      // a stored partition which cannot be used as it is is refined
+      pdata.initialPart.swap(m_storedPartition);
       m_partitioner->SetCommunicator(m_comm);
       CFLog(NOTICE, "Calling mesh partitioner\n");
       CFLog(NOTICE, "+++\n");
@@ -837,6 +865,126 @@ void ParCFmeshBinaryFileReader::readElemListRank(PartitionerData& pdata,
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ParCFmeshBinaryFileReader::readPartitionMap(MPI_File* fh)
+{
+  CFLogDebugMin( "ParCFmeshBinaryFileReader::readPartitionMap() start\n");
+  
+  CFuint nbStoredProc = 0;
+  MPIIOFunctions::readScalar(fh, nbStoredProc);
+  
+  // each rank reads the chunk of the map corresponding to the elements 
+  // it will read in readElemListRank()
+  vector<PartitionerData::IndexT> elmdist;
+  setElmDistArray(elmdist);
+  const CFuint start = elmdist[m_myRank];
+  const CFuint ne = m_nbElemPerProc[m_myRank];
+  
+  MPI_Offset offset;
+  MPI_File_get_position(*fh, &offset);
+  MPI_Offset startPos = offset + start*sizeof(CFuint) + 1;     // the "1" is for the character "\n" 
+  MPI_Offset endPos   = offset + m_totNbElem*sizeof(CFuint) + 1; // the "1" is for the character "\n" 
+  
+  vector<CFuint> buf(ne);
+  MPIIOFunctions::readAll("ParCFmeshBinaryFileReader::readPartitionMap()", fh, startPos, &buf[0], 
+			  ne, m_maxBuffSize, m_comm, m_myRank);
+  
+  MPI_Barrier(m_comm);
+  MPI_File_seek(*fh, endPos, MPI_SEEK_SET);
+  
+  m_hasStoredPartition = (m_usePartitionMap && m_nbProc > 1) ? 
+    remapPartition(nbStoredProc, buf) : false;
+  
+  CFLogDebugMin( "ParCFmeshBinaryFileReader::readPartitionMap() end\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ParCFmeshBinaryFileReader::readElementCost(MPI_File* fh)
+{
+  CFLogDebugMin( "ParCFmeshBinaryFileReader::readElementCost() start\n");
+  
+  // each rank reads the costs of the elements it will read in readElemListRank()
+  vector<PartitionerData::IndexT> elmdist;
+  setElmDistArray(elmdist);
+  const CFuint start = elmdist[m_myRank];
+  const CFuint ne = m_nbElemPerProc[m_myRank];
+  
+  MPI_Offset offset;
+  MPI_File_get_position(*fh, &offset);
+  MPI_Offset startPos = offset + start*sizeof(CFreal) + 1;     // the "1" is for the character "\n" 
+  MPI_Offset endPos   = offset + m_totNbElem*sizeof(CFreal) + 1; // the "1" is for the character "\n" 
+  
+  m_elemCost.resize(ne);
+  MPIIOFunctions::readAll("ParCFmeshBinaryFileReader::readElementCost()", fh, startPos, &m_elemCost[0], 
+			  ne, m_maxBuffSize, m_comm, m_myRank);
+  
+  MPI_Barrier(m_comm);
+  MPI_File_seek(*fh, endPos, MPI_SEEK_SET);
+  
+  CFLogDebugMin( "ParCFmeshBinaryFileReader::readElementCost() end\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool ParCFmeshBinaryFileReader::remapPartition(const CFuint nbStoredProc, 
+					       const vector<CFuint>& storedPart)
+{
+  // with more processes than stored parts, the stored parts keep their rank
+  // and the partitioner spreads them over the other ranks; with less, 
+  // contiguous groups of stored parts are merged into one part 
+  // (with the same number of processes this is the identity)
+  const CFuint ne = storedPart.size();
+  m_storedPartition.resize(ne);
+  vector<CFuint> nbElemPerProc(m_nbProc, 0);
+  CFuint isValid = 1;
+  for (CFuint i = 0; i < ne; ++i) {
+    if (storedPart[i] >= nbStoredProc) {
+      isValid = 0;
+      break;
+    }
+    const CFuint newRank = (nbStoredProc < m_nbProc) ? storedPart[i] : 
+      static_cast<CFuint>((static_cast<unsigned long long>(storedPart[i])*m_nbProc)/nbStoredProc);
+    m_storedPartition[i] = newRank;
+    nbElemPerProc[newRank]++;
+  }
+  
+  CFuint allValid = 0;
+  MPI_Allreduce(&isValid, &allValid, 1, MPIStructDef::getMPIType(&isValid), MPI_MIN, m_comm);
+  if (allValid == 0) {
+    CFLog(WARN, "Stored partition map is incomplete: calling mesh partitioner\n");
+    SwapEmpty(m_storedPartition);
+    return false;
+  }
+  
+  if (nbStoredProc < m_nbProc) {
+    CFLog(NOTICE, "Stored partition map has " << nbStoredProc << " < " << m_nbProc 
+	  << " parts: refining it with the mesh partitioner\n");
+    return false;
+  }
+  
+  vector<CFuint> totNbElemPerProc(m_nbProc, 0);
+  MPI_Allreduce(&nbElemPerProc[0], &totNbElemPerProc[0], (int)m_nbProc, 
+		MPIStructDef::getMPIType(&nbElemPerProc[0]), MPI_SUM, m_comm);
+  
+  const CFreal avgNbElem = static_cast<CFreal>(m_totNbElem)/static_cast<CFreal>(m_nbProc);
+  const CFuint maxNbElem = *std::max_element(totNbElemPerProc.begin(), totNbElemPerProc.end());
+  const CFreal imbalance = static_cast<CFreal>(maxNbElem)/avgNbElem;
+  
+  // with the same number of processes the stored map is used as it is, since
+  // it may have been weighted by cost (e.g. by a dynamic load balancer)
+  if (nbStoredProc > m_nbProc && imbalance > m_maxRemapImbalance) {
+    CFLog(NOTICE, "Merging stored partition map (" << nbStoredProc << " -> " << m_nbProc 
+	  << " parts) gives imbalance " << imbalance << ": refining it with the mesh partitioner\n");
+    return false;
+  }
+  
+  CFLog(INFO, "Stored partition map (" << nbStoredProc << " -> " << m_nbProc 
+	<< " parts) will be used, imbalance = " << imbalance << "\n");
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ParCFmeshBinaryFileReader::readNbTRSs(MPI_File* fh)
 {
   CFLogDebugMin( "ParCFmeshBinaryFileReader::readNbTRSs() start\n");
@@ -2220,6 +2368,7 @@ void ParCFmeshBinaryFileReader::readStateList(MPI_File* fh)
   // get the position of the current pointer in the file
   MPI_Offset startListOffset;
   MPI_File_get_position(*fh, &startListOffset);
+  MPI_Offset endListOffset = startListOffset + m_totNbStates*stateSize*sizeof(CFreal);
   
   vector<CFreal> localStatesData(m_localStateIDs.size()*stateSize);
   vector<CFreal> ghostStatesData;
@@ -2240,12 +2389,18 @@ void ParCFmeshBinaryFileReader::readStateList(MPI_File* fh)
     const CFuint sizeRead = nbStatesPerProc[m_myRank]*stateSize;
     vector<CFreal> buf(nbStatesPerProc[0]*stateSize); // buffer is oversized 
     
-    // each processor reads the portion of nodes that is associated to its rank
-    CFLog(VERBOSE, "ParCFmeshBinaryFileReader::readStateList() => states read in position [" << startPos << 
-	  ", " << startPos + sizeRead*sizeof(CFreal) << "]\n");
-    
-    MPIIOFunctions::readAll("ParCFmeshBinaryFileReader::readStateList()", fh, startPos, &buf[0], 
-			    (CFuint)sizeRead, m_maxBuffSize, m_comm, m_myRank);
+    if (m_compressedStates) {
+      endListOffset = readCompressedStates(fh, startListOffset, stateSize, ranges[m_myRank], 
+					   nbStatesPerProc[m_myRank], buf);
+    }
+    else {
+      // each processor reads the portion of nodes that is associated to its rank
+      CFLog(VERBOSE, "ParCFmeshBinaryFileReader::readStateList() => states read in position [" << startPos << 
+	    ", " << startPos + sizeRead*sizeof(CFreal) << "]\n");
+      
+      MPIIOFunctions::readAll("ParCFmeshBinaryFileReader::readStateList()", fh, startPos, &buf[0], 
+			      (CFuint)sizeRead, m_maxBuffSize, m_comm, m_myRank);
+    }
     getLocalData(buf, ranges, m_localStateIDs, stateSize, localStatesData);
     
     if (m_ghostStateIDs.size() > 0) {
@@ -2257,16 +2412,80 @@ void ParCFmeshBinaryFileReader::readStateList(MPI_File* fh)
   
   if (isWithSolution)  { 
     MPI_Barrier(m_comm);
-    MPI_Offset endPos = startListOffset + m_totNbStates*stateSize*sizeof(CFreal);
-    MPI_File_seek(*fh, endPos, MPI_SEEK_SET);
+    MPI_File_seek(*fh, endListOffset, MPI_SEEK_SET);
   }
   
+  // the flag only applies to the state list that has just been read
+  m_compressedStates = false;
+  
   CFLogDebugMin("m_localStateIDs.size() = " << m_localStateIDs.size() << "\n");
   CFLogDebugMin("m_ghostStateIDs.size() = " << m_ghostStateIDs.size() << "\n");
   
   CFLogDebugMin( "ParCFmeshBinaryFileReader::readStateList() end\n");
 }
       
+//////////////////////////////////////////////////////////////////////
+
+void ParCFmeshBinaryFileReader::readStateCompression(MPI_File* fh)
+{
+  CFuint flag = 0;
+  MPIIOFunctions::readScalar(fh, flag);
+  m_compressedStates = (flag > 0);
+}
+      
+//////////////////////////////////////////////////////////////////////
+
+MPI_Offset ParCFmeshBinaryFileReader::readCompressedStates
+(MPI_File* fh, MPI_Offset offset, const CFuint stateSize, 
+ const pair<CFuint, CFuint>& range, const CFuint nbStatesToRead, vector<CFreal>& buf)
+{
+  CFLogDebugMin( "ParCFmeshBinaryFileReader::readCompressedStates() start\n");
+  
+  // table of blocks: number of blocks, then (number of states, number of bytes) per block
+  MPI_Status status;
+  long long int nbBlocks = 0;
+  MPI_File_read_at_all(*fh, offset, &nbBlocks, 1, MPI_LONG_LONG_INT, &status);
+  vector<long long int> table(2*nbBlocks);
+  MPI_File_read_at_all(*fh, offset + sizeof(long long int), (nbBlocks > 0) ? &table[0] : CFNULL, 
+		       2*nbBlocks, MPI_LONG_LONG_INT, &status);
+  
+  // each process decompresses only the blocks overlapping its own range of states 
+  MPI_Offset blockOffset = offset + (1 + 2*nbBlocks)*sizeof(long long int);
+  CFuint firstState = 0;
+  vector<char> packed;
+  vector<CFreal> block;
+  for (long long int ib = 0; ib < nbBlocks; ++ib) {
+    const CFuint nbInBlock = table[2*ib];
+    const CFuint nbBytes = table[2*ib+1];
+    const CFuint endState = firstState + nbInBlock;
+    
+    if (nbStatesToRead > 0 && firstState <= range.second && endState > range.first) {
+      packed.resize(nbBytes);
+      for (CFuint done = 0; done < nbBytes;) {
+	const int count = std::min(nbBytes - done, (CFuint)m_maxBuffSize);
+	MPI_File_read_at(*fh, blockOffset + done, &packed[done], count, MPI_CHAR, &status);
+	done += count;
+      }
+      
+      block.resize(nbInBlock*stateSize);
+      StateCompressor::decompress(&packed[0], nbBytes, nbInBlock, stateSize, &block[0]);
+      
+      const CFuint first = std::max(firstState, range.first);
+      const CFuint last  = std::min(endState - 1, range.second);
+      std::copy(&block[(first - firstState)*stateSize], &block[0] + (last + 1 - firstState)*stateSize,
+		&buf[(first - range.first)*stateSize]);
+    }
+    
+    blockOffset += nbBytes;
+    firstState = endState;
+  }
+  cf_assert(firstState == m_totNbStates);
+  
+  CFLogDebugMin( "ParCFmeshBinaryFileReader::readCompressedStates() end\n");
+  
+  return blockOffset;
+}
+      
 //////////////////////////////////////////////////////////////////////
 
     } // namespace CFmeshFileReader
@@ -173,6 +173,18 @@ private: // member functions
 
   /// Reads the list of state tensors and initialize the dofs
   void readStateList(MPI_File* fh);
+  
+  /// Reads the flag telling that the following state list is compressed
+  void readStateCompression(MPI_File* fh);
+  
+  /// Reads the compressed blocks overlapping the given range of states and
+  /// decompresses them into @p buf
+  /// @return the offset of the end of the state list
+  MPI_Offset readCompressedStates(MPI_File* fh, MPI_Offset offset, 
+				  const CFuint stateSize, 
+				  const std::pair<CFuint, CFuint>& range,
+				  const CFuint nbStatesToRead,
+				  std::vector<CFreal>& buf);
 
   /// Reads the data concerning the elements
   void readElementList(MPI_File* fh);
@@ -216,6 +228,20 @@ private: // member functions
   
   /// Reads the element list corresponding for the current rank
   void readElemListRank( Framework::PartitionerData& pdata, MPI_File* fh);
+  
+  /// Reads the partition map stored by a previous run, if any
+  void readPartitionMap(MPI_File* fh);
+  
+  /// Reads the element costs measured by a previous run, if any
+  void readElementCost(MPI_File* fh);
+  
+  /// Maps the stored partition (computed on @p nbStoredProc processes) 
+  /// onto the current number of processes
+  /// @return true if the resulting partition can replace the partitioner,
+  ///         false if it has to be refined by the partitioner (if valid, 
+  ///         it is kept in m_storedPartition as initial partition)
+  bool remapPartition(const CFuint nbStoredProc, 
+		      const std::vector<CFuint>& storedPart);
 
   /// Reads the number of groups in the mesh
   void readNbGroups(MPI_File* fh);
@@ -289,6 +315,25 @@ private: // member functions
   /// maximu size of the buffer to write with MPI I/O
   int m_maxBuffSize;
   
+  /// flag telling to reuse the partition map stored in the file
+  bool m_usePartitionMap;
+  
+  /// maximum load imbalance accepted when merging a stored partition
+  CFreal m_maxRemapImbalance;
+  
+  /// flag telling if m_storedPartition holds a valid partition 
+  bool m_hasStoredPartition;
+  
+  /// partition (new owner rank per element) read from file, used as it is 
+  /// or as initial partition of the partitioner
+  std::vector<Framework::PartitionerData::IndexT> m_storedPartition;
+  
+  /// measured cost of the elements read by this rank
+  std::vector<CFreal> m_elemCost;
+  
+  /// flag telling if the state list is compressed
+  bool m_compressedStates;
+  
 }; // class ParCFmeshBinaryFileReader
 
 //////////////////////////////////////////////////////////////////////////////
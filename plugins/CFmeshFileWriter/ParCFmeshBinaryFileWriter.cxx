@@ -24,6 +24,7 @@
 #include "Environment/SingleBehaviorFactory.hh"
 
 #include "Framework/WriteListMap.hh"
+#include "Framework/StateCompressor.hh"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -57,7 +58,11 @@ void cmpAndTakeMaxAbs2(CFreal* invec, CFreal* inoutvec, int* len,
 ParCFmeshBinaryFileWriter::ParCFmeshBinaryFileWriter() :
   ParFileWriter(), 
   ConfigObject("ParCFmeshBinaryFileWriter"),
-  _writeData()
+  _writeData(),
+  _writePartitionMap(),
+  _writeElementCost(),
+  _compressionAbsTol(),
+  _compressionRelTol()
 { 
   addConfigOptionsTo(this);
   
@@ -72,6 +77,19 @@ ParCFmeshBinaryFileWriter::ParCFmeshBinaryFileWriter() :
 
   _firstWithoutSolution = false;
   setParameter("FirstWithoutSolution",&_firstWithoutSolution);
+  
+  _writePartitionMap = false;
+  setParameter("WritePartitionMap",&_writePartitionMap);
+  
+  _writeElementCost = false;
+  setParameter("WriteElementCost",&_writeElementCost);
+  
+  _compressStates = false;
+  setParameter("CompressStates",&_compressStates);
+  
+  setParameter("CompressionAbsTol",&_compressionAbsTol);
+  
+  setParameter("CompressionRelTol",&_compressionRelTol);
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -88,6 +106,11 @@ void ParCFmeshBinaryFileWriter::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< CFuint >("NbWritersPerNode", "Number of writers per node");
   options.addConfigOption< int >("MaxBuffSize", "Maximum buffer size for MPI I/O");
   options.addConfigOption< bool >("FirstWithoutSolution", "Flag telling to write the FIRST CFmesh w/o solution");
+  options.addConfigOption< bool >("WritePartitionMap", "Store the partition map to allow restarts without repartitioning");
+  options.addConfigOption< bool >("WriteElementCost", "Store the measured element costs to allow a cost-weighted partitioning at restart");
+  options.addConfigOption< bool >("CompressStates", "Compress the state list (lossless unless tolerances are given)");
+  options.addConfigOption< std::vector<CFreal> >("CompressionAbsTol", "Absolute error allowed for each state variable by the compression");
+  options.addConfigOption< std::vector<CFreal> >("CompressionRelTol", "Error allowed for each state variable by the compression, relative to its range");
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -96,6 +119,14 @@ void ParCFmeshBinaryFileWriter::setup()
 {
   ParFileWriter::setWriterGroup();
   _offset.resize(1);
+  
+  // tell a dynamic load balancer that the partition it computes will be 
+  // stored in the file and therefore applied at restart
+  const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  SafePtr<DataStorage> ds = MeshDataStack::getActive()->getDataStorage();
+  if (!ds->checkData(nsp + "_partitionTargetWriter")) {
+    ds->createData<CFuint>(nsp + "_partitionTargetWriter", 1, 1);
+  }
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -399,6 +430,20 @@ void ParCFmeshBinaryFileWriter::writeElements(MPI_File* fh)
     }
   }
   
+  // write the owner rank of each element before the element list, so that 
+  // the reader knows it before the partitioning step: a partition computed by 
+  // a dynamic load balancer is always written, since it is applied at restart
+  const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  const bool hasTarget = MeshDataStack::getActive()->getDataStorage()->checkData(nsp + "_partitionTarget");
+  if (_writePartitionMap || hasTarget) {
+    writePartitionMap(fh);
+  }
+  
+  // the measured element costs allow a cost-weighted partitioning at restart
+  if (_writeElementCost) {
+    writeElementCost(fh);
+  }
+  
   // write the list of elements
   writeElementList(fh);
 
@@ -663,6 +708,209 @@ void ParCFmeshBinaryFileWriter::writeElementList(MPI_File* fh)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ParCFmeshBinaryFileWriter::writePartitionMap(MPI_File* fh)
+{
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writePartitionMap() start\n");
+  
+  if (_myRank  == _ioRank) {
+    MPIIOFunctions::writeKeyValue<CFuint>(fh, "\n!PARTITION_MAP ", false, _nbProc);
+    MPIIOFunctions::writeKeyValue<char>(fh, "\n");
+  }
+  
+  SafePtr<TopologicalRegionSet> elements =
+    MeshDataStack::getActive()->getTrs("InnerCells");
+  
+  DataHandle < Framework::State*, Framework::GLOBAL > states =
+    MeshDataStack::getActive()->getStateDataSocketSink().getDataHandle();
+  
+  // the new owner of each element, if a load balancer has computed it
+  const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  const string targetName = nsp + "_partitionTarget";
+  const bool hasTarget = MeshDataStack::getActive()->getDataStorage()->checkData(targetName);
+  DataHandle<CFuint> target(CFNULL);
+  if (hasTarget) {
+    target = MeshDataStack::getActive()->getDataStorage()->getData<CFuint>(targetName);
+  }
+  
+  // elements in the overlap region are present on more than one process:
+  // the owner is the lowest rank holding at least one updatable state of the element
+  const CFuint noOwner = std::numeric_limits<CFuint>::max();
+  const CFuint nbLocalElements = getWriteData().getNbElements();
+  cf_assert(!hasTarget || target.size() == nbLocalElements);
+  vector<CFuint> owner(nbLocalElements, noOwner);
+  for (CFuint iElem = 0; iElem < nbLocalElements; ++iElem) {
+    const CFuint nbStatesInElem = elements->getNbStatesInGeo(iElem);
+    for (CFuint in = 0; in < nbStatesInElem; ++in) {
+      if (states[elements->getStateID(iElem, in)]->isParUpdatable()) {
+	owner[iElem] = (hasTarget) ? target[iElem] : _myRank;
+	break;
+      }
+    }
+  }
+  
+  writeElementValues(fh, owner, noOwner, MPI_MIN, "writePartitionMap()");
+  
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writePartitionMap() end\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ParCFmeshBinaryFileWriter::writeElementCost(MPI_File* fh)
+{
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeElementCost() start\n");
+  
+  const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  const string costName = nsp + "_cellCost";
+  
+  // the cost is written only if all the processes have measured it
+  CFuint hasCost = (MeshDataStack::getActive()->getDataStorage()->checkData(costName)) ? 1 : 0;
+  CFuint allHaveCost = 0;
+  MPI_Allreduce(&hasCost, &allHaveCost, 1, MPIStructDef::getMPIType(&hasCost), MPI_MIN, _comm);
+  if (allHaveCost == 0) {
+    CFLog(WARN, "ParCFmeshBinaryFileWriter::writeElementCost() => no cell cost available\n");
+    return;
+  }
+  
+  if (_myRank  == _ioRank) {
+    MPIIOFunctions::writeKeyValue<char>(fh, "\n!ELEM_COST");
+    MPIIOFunctions::writeKeyValue<char>(fh, "\n");
+  }
+  
+  DataHandle<CFreal> cellCost = 
+    MeshDataStack::getActive()->getDataStorage()->getData<CFreal>(costName);
+  
+  DataHandle < Framework::State*, Framework::GLOBAL > states =
+    MeshDataStack::getActive()->getStateDataSocketSink().getDataHandle();
+  
+  // elements in the overlap region are measured only by the process updating them
+  SafePtr<TopologicalRegionSet> elements =
+    MeshDataStack::getActive()->getTrs("InnerCells");
+  const CFuint nbLocalElements = getWriteData().getNbElements();
+  cf_assert(cellCost.size() == nbLocalElements);
+  vector<CFreal> cost(nbLocalElements, 0.);
+  for (CFuint iElem = 0; iElem < nbLocalElements; ++iElem) {
+    if (states[elements->getStateID(iElem, 0)]->isParUpdatable()) {
+      cost[iElem] = cellCost[iElem];
+    }
+  }
+  
+  writeElementValues(fh, cost, 0., MPI_MAX, "writeElementCost()");
+  
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeElementCost() end\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void ParCFmeshBinaryFileWriter::writeElementValues(MPI_File* fh, 
+						   const vector<T>& localValues, 
+						   const T noValue, MPI_Op op,
+						   const string& caller)
+{
+  // get the local position in the file and broadcast it to all processes
+  MPI_Offset offset;
+  MPI_File_get_position(*fh, &offset);
+  MPI_Bcast(&offset, 1, MPIStructDef::getMPIOffsetType(), _ioRank, _comm);
+  // wOffset is initialized with current offset
+  vector<MPI_Offset> wOffset(_nbWriters, offset); 
+  
+  SafePtr< vector<ElementTypeData> > me = getWriteData().getElementTypeData();
+  const CFuint nbElementTypes = me->size();
+  
+  // the values are stored in file order: elements are sorted by type and, inside 
+  // each type, by global ID 
+  vector<CFuint> typeOffset(nbElementTypes, 0);
+  CFuint totNbElems = 0;
+  for (CFuint iType = 0; iType < nbElementTypes; ++iType) {
+    typeOffset[iType] = totNbElems;
+    totNbElems += (*me)[iType].getNbTotalElems();
+  }
+  
+  const CFuint nSend = _nbWriters;
+  const CFuint nbLocalElements = getWriteData().getNbElements();
+  cf_assert(localValues.size() == nbLocalElements);
+  
+  // the whole list is treated as a single "type" with stride 1
+  WriteListMap elementList;
+  elementList.reserve(1, nSend, nbLocalElements);
+  CFuint totalToSend = 0;
+  elementList.fill(totNbElems, 1, totalToSend);
+  cf_assert(totalToSend == totNbElems);
+  const CFuint maxElemSendSize = elementList.getMaxElemSize();
+  
+  Common::SafePtr< vector<CFuint> > globalElementIDs = 
+    MeshDataStack::getActive()->getGlobalElementIDs();
+  cf_assert(globalElementIDs->size() == nbLocalElements);
+  
+  // the file index of each local element is needed to fill the send buffer 
+  vector<CFuint> fileElemID(nbLocalElements);
+  CFuint elemID = 0;
+  for (CFuint iType = 0; iType < nbElementTypes; ++iType) {
+    const CFuint nbLocalElementsInType = (*me)[iType].getNbElems();
+    for (CFuint iElem = 0; iElem < nbLocalElementsInType; ++iElem, ++elemID) {
+      fileElemID[elemID] = typeOffset[iType] + (*globalElementIDs)[elemID];
+      elementList.insertElemLocalID(elemID, fileElemID[elemID], 0);
+    }
+  }
+  elementList.endElemInsertion(_myRank);
+  
+  // end offset of the list
+  const MPI_Offset endOffset = offset + sizeof(T)*totNbElems;
+  
+  vector<T> sendElements(maxElemSendSize, noValue);
+  vector<T> elementToPrint(maxElemSendSize, noValue);
+  
+  const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  const string writerName = nsp + "_Writers";
+  Group& wg = PE::GetPE().getGroup(writerName);
+  
+  CFint wRank = -1; 
+  CFuint wSendSize = 0;
+  CFuint countElem = 0;
+  for (CFuint is = 0; is < nSend; ++is) {
+    bool isRangeFound = false;
+    WriteListMap::List elist = elementList.find(is, isRangeFound);
+    
+    if (isRangeFound) {
+      for (WriteListMap::ListIterator it = elist.first; it != elist.second; ++it) {
+	const CFuint localElemID = it->second;
+	const CFuint isend = fileElemID[localElemID] - countElem;
+	cf_assert(isend < sendElements.size());
+	sendElements[isend] = localValues[localElemID];
+      }
+    }
+    
+    const CFuint sendSize = elementList.getSendDataSize(is);
+    cf_assert(sendSize <= sendElements.size());
+    
+    if (_isWriterRank && static_cast<CFuint>(wg.globalRanks[is]) == _myRank) {
+      wSendSize = sendSize;
+      wRank = is;
+    }
+    
+    MPI_Reduce(&sendElements[0], &elementToPrint[0], (int)sendSize,
+	       MPIStructDef::getMPIType(&sendElements[0]), op, wg.globalRanks[is], _comm);
+    
+    // the offsets for all writers with send ID > current must be incremented  
+    for (CFuint iw = is+1; iw < wOffset.size(); ++iw) {
+      wOffset[iw] += sendSize*sizeof(T);
+    }
+    
+    sendElements.assign(sendElements.size(), noValue);
+    countElem += sendSize;
+  }
+  
+  if (_isWriterRank) { 
+    cf_assert(wRank >= 0);
+    MPIIOFunctions::writeAll("ParCFmeshBinaryFileWriter::" + caller, fh, wOffset[wRank], 
+			     &elementToPrint[0], wSendSize, _maxBuffSize, _myRank, wg);
+    MPI_Barrier(wg.comm);
+    MPI_File_seek(*fh, endOffset, MPI_SEEK_SET);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ParCFmeshBinaryFileWriter::writeTrsData(MPI_File* fh)
 {
   CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeTrsData() start\n");
@@ -928,7 +1176,11 @@ void ParCFmeshBinaryFileWriter::writeStateList(MPI_File* fh)
     getWriteData().setWithSolution(false);
   }
   
+  const bool compressStates = _compressStates && getWriteData().isWithSolution();
   if (_myRank == _ioRank) {
+    if (compressStates) {
+      MPIIOFunctions::writeKeyValue<CFuint>(fh, "\n!STATE_COMPRESSION ", false, 1);
+    }
     MPIIOFunctions::MPIIOFunctions::writeKeyValue<CFuint>(fh, "\n!LIST_STATE ", false, getWriteData().isWithSolution());
     MPIIOFunctions::MPIIOFunctions::writeKeyValue<char>(fh, "\n");
   }
@@ -1104,8 +1356,14 @@ void ParCFmeshBinaryFileWriter::writeStateList(MPI_File* fh)
       // MPI_File_write_at_all(*fh, wOffset[wRank], &elementToPrint[0], (int)wSendSize,
       // MPIStructDef::getMPIType(&elementToPrint[0]), &_status); 
       
-      MPIIOFunctions::writeAll("ParCFmeshBinaryFileWriter::writeStateList()", fh, wOffset[wRank], &elementToPrint[0], 
-			       wSendSize, _maxBuffSize, _myRank, wg);
+      if (compressStates) {
+	_offset[0].states.second = writeCompressedStates
+	  (fh, offset, elementToPrint, wSendSize, statesStride, wRank);
+      }
+      else {
+	MPIIOFunctions::writeAll("ParCFmeshBinaryFileWriter::writeStateList()", fh, wOffset[wRank], &elementToPrint[0], 
+				 wSendSize, _maxBuffSize, _myRank, wg);
+      }
     }
     
     //reset the all sendElement list to 0
@@ -1131,6 +1389,83 @@ void ParCFmeshBinaryFileWriter::writeStateList(MPI_File* fh)
 
 //////////////////////////////////////////////////////////////////////////////
 
+MPI_Offset ParCFmeshBinaryFileWriter::writeCompressedStates
+(MPI_File* fh, MPI_Offset offset, const vector<CFreal>& elementToPrint,
+ CFuint wSendSize, CFuint statesStride, CFint wRank)
+{
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeCompressedStates() start\n");
+  
+  const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  const string writerName = nsp + "_Writers";
+  Group& wg = PE::GetPE().getGroup(writerName);
+  
+  // the blocks of all writers must be stored in the order of the state IDs
+  int wgRank = 0;
+  MPI_Comm_rank(wg.comm, &wgRank);
+  cf_assert(wgRank == wRank);
+  
+  // states are compressed in blocks of fixed size, so that readers only need 
+  // to decompress the blocks overlapping the range of states they read
+  const CFuint blockSize = 65536;
+  const CFuint nbStates = wSendSize/statesStride;
+  const CFuint nbBlocks = nbStates/blockSize + (nbStates%blockSize > 0);
+  
+  // (number of states, number of bytes) for each block
+  vector<long long int> blockInfo(2*nbBlocks);
+  vector<char> packed;
+  vector<char> block;
+  for (CFuint ib = 0; ib < nbBlocks; ++ib) {
+    const CFuint first = ib*blockSize;
+    const CFuint nbInBlock = std::min(blockSize, nbStates - first);
+    StateCompressor::compress(&elementToPrint[first*statesStride], nbInBlock, statesStride,
+			      _compressionAbsTol, _compressionRelTol, block);
+    packed.insert(packed.end(), block.begin(), block.end());
+    blockInfo[2*ib]   = nbInBlock;
+    blockInfo[2*ib+1] = block.size();
+  }
+  
+  // gather the table of blocks of all writers
+  int nbInfo = blockInfo.size();
+  vector<int> nbInfoPerWriter(_nbWriters);
+  MPI_Allgather(&nbInfo, 1, MPI_INT, &nbInfoPerWriter[0], 1, MPI_INT, wg.comm);
+  vector<int> displs(_nbWriters, 0);
+  for (CFuint iw = 1; iw < _nbWriters; ++iw) {
+    displs[iw] = displs[iw-1] + nbInfoPerWriter[iw-1];
+  }
+  const CFuint tableSize = displs[_nbWriters-1] + nbInfoPerWriter[_nbWriters-1];
+  vector<long long int> table(1 + tableSize);
+  table[0] = tableSize/2;
+  MPI_Allgatherv((nbInfo > 0) ? &blockInfo[0] : CFNULL, nbInfo, MPI_LONG_LONG_INT, 
+		 &table[1], &nbInfoPerWriter[0], &displs[0], MPI_LONG_LONG_INT, wg.comm);
+  
+  // the data of this writer start after the table and after the blocks of the previous writers
+  const MPI_Offset dataStart = offset + table.size()*sizeof(long long int);
+  MPI_Offset wOffset = dataStart;
+  MPI_Offset endOffset = dataStart;
+  for (CFuint ib = 0; ib < tableSize/2; ++ib) {
+    if ((int)(2*ib) < displs[wRank]) {wOffset += table[1 + 2*ib + 1];}
+    endOffset += table[1 + 2*ib + 1];
+  }
+  
+  if (_myRank == _ioRank) {
+    MPI_Status status;
+    MPI_File_write_at(*fh, offset, &table[0], table.size(), MPI_LONG_LONG_INT, &status);
+  }
+  
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeCompressedStates() => P[" << _myRank << "] => " 
+	<< packed.size() << " bytes instead of " << wSendSize*sizeof(CFreal) << "\n");
+  
+  MPIIOFunctions::writeAll("ParCFmeshBinaryFileWriter::writeCompressedStates()", fh, wOffset, 
+			   (packed.size() > 0) ? &packed[0] : CFNULL, 
+			   (CFuint)packed.size(), _maxBuffSize, _myRank, wg);
+  
+  CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeCompressedStates() end\n");
+  
+  return endOffset;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ParCFmeshBinaryFileWriter::writeGeoList(CFuint iTRS, MPI_File* fh)
 {
   CFLog(VERBOSE, "ParCFmeshBinaryFileWriter::writeGeoList() start\n");
@@ -103,11 +103,32 @@ protected: // helper functions
   /// Writes the element list
   void writeElementList(MPI_File* fh);
   
+  /// Writes the owner rank of each element (in file order) so that a restart
+  /// on the same or a smaller number of processes can skip partitioning
+  /// (contiguous groups of stored parts are then merged by the reader)
+  void writePartitionMap(MPI_File* fh);
+  
+  /// Writes the measured cost of each element (in file order), if available
+  void writeElementCost(MPI_File* fh);
+  
+  /// Writes one value per element in file order, combining with the given 
+  /// operation the values of the elements present on more than one process
+  template <typename T>
+  void writeElementValues(MPI_File* fh, const std::vector<T>& localValues, 
+			  const T noValue, MPI_Op op, const std::string& caller);
+  
   /// Writes the list of nodes
   void writeNodeList(MPI_File* fh);
   
   /// Writes the list of state tensors and initialize the dofs
   void writeStateList(MPI_File* fh);
+  
+  /// Writes the states collected by this writer as independently compressed 
+  /// blocks, preceded by the table of the blocks of all writers
+  /// @return the offset of the end of the state list
+  MPI_Offset writeCompressedStates(MPI_File* fh, MPI_Offset offset, 
+				   const std::vector<CFreal>& elementToPrint,
+				   CFuint wSendSize, CFuint statesStride, CFint wRank);
 
   /// Writes the all the data relative to all TRSs
   void writeTrsData(MPI_File* fh);
@@ -123,6 +144,21 @@ protected: // data
   /// acquaintance of the data present in the CFmesh file
   Common::SafePtr<Framework::CFmeshWriterSource> _writeData;
   
+  /// flag telling to store the current partition map in the file
+  bool _writePartitionMap;
+  
+  /// flag telling to store the measured element costs in the file
+  bool _writeElementCost;
+  
+  /// flag telling to compress the states
+  bool _compressStates;
+  
+  /// absolute tolerance for each state variable (lossy compression)
+  std::vector<CFreal> _compressionAbsTol;
+  
+  /// tolerance for each state variable relative to its range (lossy compression)
+  std::vector<CFreal> _compressionRelTol;
+  
 }; // class ParCFmeshBinaryFileWriter
 
 //////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,8 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include <mpi.h>
+#include <string>
+#include <vector>
 
 #include "Common/COOLFluiD.hh"
 
@@ -28,7 +30,7 @@ public:
   
   /// default constructor
   DataToTrasfer() 
-  {array = CFNULL; sendStride = recvStride = nbRanksSend = nbRanksRecv = 0;}
+  {array = CFNULL; sendStride = recvStride = nbRanksSend = nbRanksRecv = 0; hasPlan = false;}
   
   // destructor
   ~DataToTrasfer() {}
@@ -46,6 +48,13 @@ public:
   std::string recvSocketStr; // name of the socket from which data are received 
   std::string groupName;     // name of the MPI group in which data transfer is active
   MPI_Op operation;          // MPI operation to apply
+  
+  // point-to-point redistribution plan (built once, counts in dofs)
+  bool hasPlan;                   // the plan has been built
+  std::vector<CFuint> sendDofs;   // local dofs to send, target rank after target rank
+  std::vector<int> sendCounts;    // number of dofs to send to each rank of the group
+  std::vector<CFuint> recvDofs;   // local dofs to receive, source rank after source rank
+  std::vector<int> recvCounts;    // number of dofs to receive from each rank of the group
 };
  
 //////////////////////////////////////////////////////////////////////////////
@@ -1,4 +1,5 @@
 #include <numeric>
+#include <algorithm>
 
 #include "Common/NotImplementedException.hh"
 #include "Common/CFPrintContainer.hh"
@@ -47,6 +48,8 @@ void StdConcurrentDataTransfer::defineConfigOptions(Config::OptionList& options)
     ("SocketsConnType","Connectivity type for sockets to transfer (State or Node): this is ne1eded to define global IDs.");
   options.addConfigOption< vector<string> >
     ("SendToRecvVariableTransformer","Variables transformers from send to recv variables.");
+  options.addConfigOption< bool >
+    ("RootTransfer","Gather/scatter the data through a root process instead of redistributing them point-to-point.");
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -71,6 +74,9 @@ StdConcurrentDataTransfer::StdConcurrentDataTransfer(const std::string& name) :
   
   _sendToRecvVecTransStr = vector<string>();
   setParameter("SendToRecvVariableTransformer", &_sendToRecvVecTransStr);
+  
+  _rootTransfer = false;
+  setParameter("RootTransfer", &_rootTransfer);
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -180,7 +186,11 @@ void StdConcurrentDataTransfer::execute()
       const CFuint nbRanksSend = dtt->nbRanksSend;
       const CFuint nbRanksRecv = dtt->nbRanksRecv;
       
-      if (nbRanksSend > 1 && nbRanksRecv == 1) {
+      if (!_rootTransfer) {
+	// each dof goes directly from its owner to the ranks holding it 
+	redistributeData(i);
+      }
+      else if (nbRanksSend > 1 && nbRanksRecv == 1) {
 	gatherData(i);
       }
       else if (nbRanksSend == 1 && nbRanksRecv > 1) {
@@ -190,7 +200,7 @@ void StdConcurrentDataTransfer::execute()
       }
       else if (nbRanksSend > 1 && nbRanksRecv > 1) {
 	throw NotImplementedException
-	  (FromHere(),"StdConcurrentDataTransfer::execute() => (nbRanksSend > 1 && nbRanksRecv > 1)");
+	  (FromHere(),"StdConcurrentDataTransfer::execute() => (nbRanksSend > 1 && nbRanksRecv > 1) with RootTransfer");
       }
     }
     
@@ -489,6 +499,189 @@ void StdConcurrentDataTransfer::scatterData(const CFuint idx)
       
 //////////////////////////////////////////////////////////////////////////////
 
+void StdConcurrentDataTransfer::redistributeData(const CFuint idx)
+{
+  SafePtr<DataToTrasfer> dtt = _socketName2data.find(_socketsSendRecv[idx]); 
+  cf_assert(dtt.isNotNull());
+  
+  const string nspSend = dtt->nspSend;
+  const string nspRecv = dtt->nspRecv;
+  const string nspCoupling = dtt->groupName;
+  
+  CFLog(VERBOSE, "StdConcurrentDataTransfer::redistributeData() from namespace[" << nspSend 
+	<< "] to namespace [" << nspRecv << "] within namespace [" << nspCoupling << "] => start\n");
+  
+  Group& group = PE::GetPE().getGroup(nspCoupling);
+  const int rank = PE::GetPE().GetRank("Default"); // rank in MPI_COMM_WORLD
+  const CFuint nbRanks = group.globalRanks.size();
+  const bool isSendRank = PE::GetPE().isRankInGroup(rank, nspSend);
+  const bool isRecvRank = PE::GetPE().isRankInGroup(rank, nspRecv);
+  
+  // the plan is built at the first transfer, the dofs being fixed afterwards
+  if (!dtt->hasPlan) {
+    cf_assert(idx < _socketsConnType.size());
+    if (_socketsConnType[idx] == "State") {
+      buildRedistributionPlan<State*>(dtt, isSendRank, isRecvRank);
+    }
+    if (_socketsConnType[idx] == "Node") {
+      buildRedistributionPlan<Node*>(dtt, isSendRank, isRecvRank);
+    }
+    dtt->hasPlan = true;
+  }
+  cf_assert(dtt->sendCounts.size() == nbRanks);
+  cf_assert(dtt->recvCounts.size() == nbRanks);
+  
+  const CFuint sendStride = dtt->sendStride;
+  const CFuint recvStride = dtt->recvStride;
+  
+  // the values are transformed on the sending side, so that only 
+  // recvStride values per dof are communicated
+  const CFuint nbSendDofs = dtt->sendDofs.size();
+  vector<CFreal> sendbuf(std::max<CFuint>(nbSendDofs*recvStride, 1));
+  if (nbSendDofs > 0) {
+    cf_assert(idx < _sendToRecvVecTrans.size());
+    SafePtr<VarSetTransformer> sendToRecvTrans = _sendToRecvVecTrans[idx].getPtr();
+    cf_assert(sendToRecvTrans.isNotNull());
+    RealVector tState(recvStride, static_cast<CFreal*>(NULL));
+    RealVector state(sendStride, static_cast<CFreal*>(NULL));
+    CFreal *const dataToSend = dtt->array;
+    cf_assert(dataToSend != CFNULL);
+    for (CFuint i = 0; i < nbSendDofs; ++i) {
+      cf_assert(dtt->sendDofs[i]*sendStride < dtt->arraySize);
+      state.wrap(sendStride, &dataToSend[dtt->sendDofs[i]*sendStride]);
+      tState.wrap(recvStride, &sendbuf[i*recvStride]);
+      sendToRecvTrans->transform((const RealVector&)state, (RealVector&)tState);
+    }
+  }
+  
+  // only the ranks sharing dofs exchange messages, as given by the plan
+  const int grank = PE::GetPE().GetRank(nspCoupling);
+  const CFuint nbRecvDofs = dtt->recvDofs.size();
+  vector<CFreal> recvbuf(std::max<CFuint>(nbRecvDofs*recvStride, 1));
+  vector<MPI_Request> requests;
+  requests.reserve(2*nbRanks);
+  const int tag = 2016;
+  CFuint sendStart = 0;
+  CFuint recvStart = 0;
+  for (CFuint r = 0; r < nbRanks; ++r) {
+    const CFuint sendCount = dtt->sendCounts[r]*recvStride;
+    const CFuint recvCount = dtt->recvCounts[r]*recvStride;
+    if (r == static_cast<CFuint>(grank)) {
+      cf_assert(sendCount == recvCount);
+      if (sendCount > 0) {
+	std::copy(&sendbuf[sendStart], &sendbuf[sendStart] + sendCount, &recvbuf[recvStart]);
+      }
+    }
+    else {
+      if (recvCount > 0) {
+	requests.push_back(MPI_REQUEST_NULL);
+	MPIError::getInstance().check
+	  ("MPI_Irecv", "StdConcurrentDataTransfer::redistributeData()", 
+	   MPI_Irecv(&recvbuf[recvStart], recvCount, MPIStructDef::getMPIType(&recvbuf[0]),
+		     r, tag, group.comm, &requests.back()));
+      }
+      if (sendCount > 0) {
+	requests.push_back(MPI_REQUEST_NULL);
+	MPIError::getInstance().check
+	  ("MPI_Isend", "StdConcurrentDataTransfer::redistributeData()", 
+	   MPI_Isend(&sendbuf[sendStart], sendCount, MPIStructDef::getMPIType(&sendbuf[0]),
+		     r, tag, group.comm, &requests.back()));
+      }
+    }
+    sendStart += sendCount;
+    recvStart += recvCount;
+  }
+  
+  if (!requests.empty()) {
+    MPIError::getInstance().check
+      ("MPI_Waitall", "StdConcurrentDataTransfer::redistributeData()", 
+       MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE));
+  }
+  
+  // copy the received values in the local positions of the dofs 
+  if (nbRecvDofs > 0) {
+    CFreal *const dataToRecv = dtt->array;
+    cf_assert(dataToRecv != CFNULL);
+    for (CFuint i = 0; i < nbRecvDofs; ++i) {
+      const CFuint startR = dtt->recvDofs[i]*recvStride;
+      cf_assert(startR + recvStride <= dtt->arraySize);
+      for (CFuint s = 0; s < recvStride; ++s) {
+	dataToRecv[startR + s] = recvbuf[i*recvStride + s];
+      }
+    }
+  }
+  
+  CFLog(VERBOSE, "StdConcurrentDataTransfer::redistributeData() from namespace[" << nspSend 
+	<< "] to namespace [" << nspRecv << "] within namespace [" << nspCoupling << "] => end\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StdConcurrentDataTransfer::exchangeIDs(MPI_Comm comm,
+					    const vector<vector<CFuint> >& sendLists,
+					    vector<vector<CFuint> >& recvLists)
+{
+  // sparse exchange: only the non empty lists are sent and each rank finds
+  // how many lists it gets with a single MPI_Reduce_scatter
+  const CFuint nbRanks = sendLists.size();
+  int myRank = 0;
+  MPI_Comm_rank(comm, &myRank);
+  
+  recvLists.clear();
+  recvLists.resize(nbRanks);
+  
+  vector<int> nbMessages(nbRanks, 0);
+  for (CFuint r = 0; r < nbRanks; ++r) {
+    if (sendLists[r].size() > 0 && r != static_cast<CFuint>(myRank)) {nbMessages[r] = 1;}
+  }
+  vector<int> ones(nbRanks, 1);
+  int nbIncoming = 0;
+  MPIError::getInstance().check
+    ("MPI_Reduce_scatter", "StdConcurrentDataTransfer::exchangeIDs()", 
+     MPI_Reduce_scatter(&nbMessages[0], &nbIncoming, &ones[0], MPI_INT, MPI_SUM, comm));
+  
+  CFuint dummy = 0;
+  MPI_Datatype idType = MPIStructDef::getMPIType(&dummy);
+  const int tag = 2015;
+  vector<MPI_Request> requests;
+  requests.reserve(nbRanks);
+  for (CFuint r = 0; r < nbRanks; ++r) {
+    if (r == static_cast<CFuint>(myRank)) {
+      recvLists[r] = sendLists[r];
+    }
+    else if (nbMessages[r] > 0) {
+      requests.push_back(MPI_REQUEST_NULL);
+      MPIError::getInstance().check
+	("MPI_Isend", "StdConcurrentDataTransfer::exchangeIDs()", 
+	 MPI_Isend(const_cast<CFuint*>(&sendLists[r][0]), sendLists[r].size(), 
+		   idType, r, tag, comm, &requests.back()));
+    }
+  }
+  
+  for (int i = 0; i < nbIncoming; ++i) {
+    MPI_Status status;
+    MPIError::getInstance().check
+      ("MPI_Probe", "StdConcurrentDataTransfer::exchangeIDs()", 
+       MPI_Probe(MPI_ANY_SOURCE, tag, comm, &status));
+    int count = 0;
+    MPI_Get_count(&status, idType, &count);
+    vector<CFuint>& list = recvLists[status.MPI_SOURCE];
+    list.resize(count);
+    MPIError::getInstance().check
+      ("MPI_Recv", "StdConcurrentDataTransfer::exchangeIDs()", 
+       MPI_Recv((count > 0) ? &list[0] : &dummy, count, idType, status.MPI_SOURCE, 
+		tag, comm, MPI_STATUS_IGNORE));
+  }
+  
+  if (!requests.empty()) {
+    MPIError::getInstance().check
+      ("MPI_Waitall", "StdConcurrentDataTransfer::exchangeIDs()", 
+       MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE));
+  }
+}
+      
+//////////////////////////////////////////////////////////////////////////////
+
 int StdConcurrentDataTransfer::getRootProcess(const std::string& nsp, 
 					      const std::string& nspCoupling) const
 {
@@ -630,8 +823,12 @@ void StdConcurrentDataTransfer::addDataToTransfer(const CFuint idx)
       DataHandle<State*, GLOBAL> array = ds->getGlobalData<State*>(recvSocketStr);
       CFLog(VERBOSE, "P" << rank << " has socket " << recvSocketStr << " with sizes = [" 
 	    << array.getLocalSize() << ", " << array.getGlobalSize() << "]\n"); 
-      cf_assert(array.getLocalSize() == array.getGlobalSize());
-      cf_assert(array.size() == array.getGlobalSize());
+      // the root transfer needs the whole field on the receiving rank, while the 
+      // redistribution fills the local states (owned and ghosts) by global ID
+      if (_rootTransfer) {
+	cf_assert(array.getLocalSize() == array.getGlobalSize());
+	cf_assert(array.size() == array.getGlobalSize());
+      }
       
       data->dofsName = recvSocketStr;
       data->array = array.getGlobalArray()->ptr();
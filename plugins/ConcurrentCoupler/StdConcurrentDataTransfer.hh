@@ -77,6 +77,31 @@ protected: // functions
   /// @param idx           index of the data transfer
   virtual void scatterData(const CFuint idx);
   
+  /// redistribute data from all processes in namespace nspSend to all processes 
+  /// in namespace nspRecv, with point-to-point messages between the owners
+  /// @param idx           index of the data transfer
+  virtual void redistributeData(const CFuint idx);
+  
+  /// build the redistribution plan (collective in the transfer group): 
+  /// the owners of each global ID are matched through a directory
+  /// distributed over the ranks of the group (global ID modulo group size)
+  /// @param dtt           data to transfer
+  /// @param isSendRank    flag telling if this rank sends data
+  /// @param isRecvRank    flag telling if this rank receives data
+  template <typename T>
+  void buildRedistributionPlan(Common::SafePtr<DataToTrasfer> dtt,
+			       const bool isSendRank, 
+			       const bool isRecvRank);
+  
+  /// exchange lists of IDs between the ranks of a communicator, only the
+  /// non empty lists being sent
+  /// @param comm          communicator
+  /// @param sendLists     list to send to each rank
+  /// @param recvLists     list received from each rank
+  void exchangeIDs(MPI_Comm comm,
+		   const std::vector<std::vector<CFuint> >& sendLists,
+		   std::vector<std::vector<CFuint> >& recvLists);
+  
   /// fill a mapping between global and local IDs
   /// @param ds            pointer to DataStorage
   /// @param socketName    name of the socket
@@ -164,6 +189,10 @@ protected: // data
   /// variables transformers from send to recv variables
   std::vector<std::string> _sendToRecvVecTransStr;
   
+  /// flag forcing the transfers through a root process (gather/scatter) 
+  /// instead of the point-to-point redistribution
+  bool _rootTransfer;
+  
 }; // class StdConcurrentDataTransfer
       
 //////////////////////////////////////////////////////////////////////////////
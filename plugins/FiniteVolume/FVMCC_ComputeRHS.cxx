@@ -74,7 +74,12 @@ FVMCC_ComputeRHS::FVMCC_ComputeRHS(const std::string& name) :
   _fluxData(CFNULL),
   _tempUnitNormal(),
   _rExtraVars(),
-  _inverter(CFNULL)  
+  _inverter(CFNULL),
+  _ownsCellCost(false),
+  _cellCost(CFNULL),
+  _faceTimer(),
+  _sourceTimer(),
+  _faceSourceTime(0.)
 {
   addConfigOptionsTo(this);
 
@@ -89,6 +94,9 @@ FVMCC_ComputeRHS::FVMCC_ComputeRHS(const std::string& name) :
   
   _useAnalyticalMatrix = true;
   setParameter("useAnalyticalMatrix",&_useAnalyticalMatrix);
+  
+  _measureCellCost = false;
+  setParameter("MeasureCellCost",&_measureCellCost);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -107,6 +115,12 @@ void FVMCC_ComputeRHS::unsetup()
     deletePtr(_rExtraVars[i]);
   }
   
+  if (_ownsCellCost) {
+    const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+    MeshDataStack::getActive()->getDataStorage()->deleteData<CFreal>(nsp + "_cellCost");
+    _ownsCellCost = false;
+  }
+  
   CellCenterFVMCom::unsetup();
 }
 
@@ -125,6 +139,9 @@ void FVMCC_ComputeRHS::defineConfigOptions(Config::OptionList& options)
 
   options.addConfigOption< bool >
     ("useAnalyticalMatrix", "Flag telling if to use analytical matrix."); 
+  
+  options.addConfigOption< bool >
+    ("MeasureCellCost", "Accumulate the time spent on each cell, to be used as partitioning weight."); 
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -167,6 +184,13 @@ void FVMCC_ComputeRHS::execute()
   const vector<string>& noBCTRS = getMethodData().getTRSsWithNoBC();
   SafePtr<CFMap<CFuint, FVMCC_BC*> > bcMap = getMethodData().getMapBC();
   
+  // the time spent on each face is split between its two cells, while the 
+  // source term time goes entirely to its own cell (see computeSourceTerm())
+  if (_measureCellCost) {
+    const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+    _cellCost = MeshDataStack::getActive()->getDataStorage()->getData<CFreal>(nsp + "_cellCost");
+  }
+  
   for (CFuint iTRS = 0; iTRS < nbTRSs; ++iTRS) {
     SafePtr<TopologicalRegionSet> currTrs = trs[iTRS];
     
@@ -211,10 +235,15 @@ void FVMCC_ComputeRHS::execute()
 	
 	if (_currFace->getState(0)->isParUpdatable() || 
 	    (!_currFace->getState(1)->isGhost() && _currFace->getState(1)->isParUpdatable())) {
-	  
+
+	  if (_measureCellCost) {
+	    _faceSourceTime = 0.;
+	    _faceTimer.start();
+	  }
+
 	  // set the data for the FaceIntegrator
 	  setFaceIntegratorData();
-	  
+
 	  // cout << "states = " << _currFace->getState(0)->getLocalID()  << ", " <<  _currFace->getState(1)->getLocalID() << endl;
 	  
 	  // extrapolate (and LIMIT, if the reconstruction is linear or more)
@@ -291,6 +320,19 @@ void FVMCC_ComputeRHS::execute()
 	  CFLog(DEBUG_MIN, "FVMCC_ComputeRHS::execute() => before computeRHSJacobian()\n");
 	  computeRHSJacobian();
 	  CFLog(DEBUG_MIN, "FVMCC_ComputeRHS::execute() => after computeRHSJacobian()\n");
+	  
+	  if (_measureCellCost) {
+	    _faceTimer.stop();
+	    const CFreal faceCost = _faceTimer.read() - _faceSourceTime;
+	    const CFuint leftID = _currFace->getState(0)->getLocalID();
+	    if (isBFace) {
+	      _cellCost[leftID] += faceCost;
+	    }
+	    else {
+	      _cellCost[leftID] += 0.5*faceCost;
+	      _cellCost[_currFace->getState(1)->getLocalID()] += 0.5*faceCost;
+	    }
+	  }
 	}
 	
 	geoBuilder->releaseGE(); 
@@ -439,6 +481,17 @@ void FVMCC_ComputeRHS::setup()
   CellTrsGeoBuilder::GeoData& cellGeoData = getMethodData().getCellTrsGeoBuilder()->getDataGE();
   cellGeoData.trs = cells;
   
+  // the cell cost is not a socket, since it is optional: it is shared by name 
+  // with the mesh writer and with the dynamic load balancer
+  if (_measureCellCost) {
+    const string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+    SafePtr<DataStorage> ds = MeshDataStack::getActive()->getDataStorage();
+    if (!ds->checkData(nsp + "_cellCost")) {
+      ds->createData<CFreal>(nsp + "_cellCost", cells->getLocalNbGeoEnts(), 0.);
+      _ownsCellCost = true;
+    }
+  }
+  
   CFLog(VERBOSE, "FVMCC_ComputeRHS::setup() END\n");
 }
       
@@ -550,6 +603,10 @@ void FVMCC_ComputeRHS::computeSourceTerm()
       continue;
     }
 
+    if (_measureCellCost) {
+      _sourceTimer.start();
+    }
+    
     GeometricEntity *const currCell = _currFace->getNeighborGeo(iCell);
     CFreal invR = 1.0;
     if (getMethodData().isAxisymmetric()) {
@@ -586,6 +643,13 @@ void FVMCC_ComputeRHS::computeSourceTerm()
       cellFlag[cellID] = true;
       _sourceJacobOnCell[iCell]= true;
     }
+    
+    if (_measureCellCost) {
+      _sourceTimer.stop();
+      const CFreal sourceTime = _sourceTimer.read();
+      _faceSourceTime += sourceTime;
+      _cellCost[cellID] += sourceTime;
+    }
   }
   
   CFTRACEEND;
@@ -3,6 +3,7 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include "Common/Stopwatch.hh"
 #include "FiniteVolume/CellCenterFVMData.hh"
 #include "Framework/DataSocketSink.hh"
 #include "FiniteVolume/ComputeDiffusiveFlux.hh"
@@ -113,8 +114,7 @@ protected:
   {
     std::vector<Framework::State*>& states = _polyRec->getExtrapolatedValues();
     std::vector<RealVector>& pdata = _polyRec->getExtrapolatedPhysicaData();
-    _reconstrVar->computePhysicalData(*states[0], pdata[0]);
-    _reconstrVar->computePhysicalData(*states[1], pdata[1]);
+    _reconstrVar->computeBlockPhysicalData(states, pdata, 2);
   }
 
   /**
@@ -126,8 +126,7 @@ protected:
     std::vector<RealVector>& pdata = _polyRec->getExtrapolatedPhysicaData();
     std::vector<RealVector>& pdataBkp = _polyRec->getBackupPhysicaData();
     
-    _reconstrVar->computePhysicalData(*states[0], pdata[0]);
-    _reconstrVar->computePhysicalData(*states[1], pdata[1]);
+    _reconstrVar->computeBlockPhysicalData(states, pdata, 2);
     pdataBkp[0] = pdata[0];
     pdataBkp[1] = pdata[1];
     
@@ -357,6 +356,24 @@ protected:
   /// flag telling if to use analytical transformation matrix
   bool _useAnalyticalMatrix;
   
+  /// flag telling to measure the computational cost of each cell
+  bool _measureCellCost;
+  
+  /// flag telling if the cell cost storage was created by this command
+  bool _ownsCellCost;
+  
+  /// accumulated time spent on each cell
+  Framework::DataHandle<CFreal> _cellCost;
+  
+  /// timer for the processing of the current face
+  Common::Stopwatch<Common::WallTime> _faceTimer;
+  
+  /// timer for the source term of the current cell
+  Common::Stopwatch<Common::WallTime> _sourceTimer;
+  
+  /// time spent in the source term of the current face
+  CFreal _faceSourceTime;
+  
 }; // class FVMCC_ComputeRHS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,7 @@
 #include "Framework/BlockAccumulator.hh"
 #include "Framework/LSSMatrix.hh"
 #include "Framework/MeshData.hh"
+#include "Framework/GlobalReduceBatch.hh"
 
 #ifdef CF_HAVE_MPI
 #include "Common/MPI/MPIStructDef.hh"
@@ -119,26 +120,25 @@ void FVMCC_PseudoSteadyTimeRhs::execute()
   const CFreal cfl = getMethodData().getCFL()->getCFLValue();
   DataHandle<CFreal> volumes = socket_volumes.getDataHandle();
   
+  GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(getMethodData().getNamespace());
   CFreal minDt = 0.0;
+  CFuint minDtHandle = 0;
   if (_useGlobalDT) {
     // select the minimum delta T
     minDt = volumes[0]/updateCoeff[0]*cfl;
     for (CFuint iState = 1; iState < nbStates; ++iState) {
       minDt = min(volumes[iState]/updateCoeff[iState]*cfl, minDt);
     }
+    
+    // the minimum is only needed (and reduced) in this case
+    minDtHandle = batch.addValue(minDt, GlobalReduceBatch::MIN);
+    batch.post();
   }
   
-#ifdef CF_HAVE_MPI
-  const std::string nsp = getMethodData().getNamespace();
-  CFreal totalMinDt = 1e10;
-  MPI_Datatype MPI_CFREAL = Common::MPIStructDef::getMPIType(&totalMinDt);
-  MPI_Allreduce(&minDt, &totalMinDt, 1, MPI_CFREAL, MPI_MIN, PE::GetPE().GetCommunicator(nsp));
-  cf_assert(totalMinDt <= minDt);
-  minDt = totalMinDt;
-#endif
-  
   // if global DT is requested, set the minimum DT
   if (_useGlobalDT) {
+    minDt = batch.getValue(minDtHandle);
+    
     // AL: this is kinda hack, but minDT needs access to CFL, update coefficient and volumes,
     // so it would be more cumbersome to do it elsewhere. Ideally, should be implemented inside a
     // subclass of ComputeDT (future work!!!)
@@ -0,0 +1,215 @@
+#include "Common/MPI/MPIStructDef.hh"
+#include "Common/MPI/MPIError.hh"
+#include "FiniteVolume/PeriodicExchangePlan.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace FiniteVolume {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// tag of the messages of the periodic exchanges
+static const int PERIODIC_EXCHANGE_TAG = 7301;
+
+//////////////////////////////////////////////////////////////////////////////
+
+PeriodicExchangePlan::PeriodicExchangePlan() :
+  m_comm(MPI_COMM_NULL),
+  m_myRank(0),
+  m_blockSize(0),
+  m_sendRanks(),
+  m_sendFaces(),
+  m_sendStart(),
+  m_recvRanks(),
+  m_recvStart(),
+  m_selfFaces(),
+  m_recvIndex(),
+  m_sendBuf(),
+  m_recvBuf(),
+  m_requests(),
+  m_pending(false)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+PeriodicExchangePlan::~PeriodicExchangePlan()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PeriodicExchangePlan::setup(MPI_Comm comm,
+				 const vector<CFuint>& partnerRank,
+				 const vector<CFuint>& partnerFace,
+				 const CFuint blockSize)
+{
+  cf_assert(partnerRank.size() == partnerFace.size());
+
+  m_comm = comm;
+  m_blockSize = blockSize;
+  int rank = 0;
+  int nbProc = 0;
+  MPI_Comm_rank(m_comm, &rank);
+  MPI_Comm_size(m_comm, &nbProc);
+  m_myRank = rank;
+
+  // periodic faces requested to each process, in the order of the local faces
+  const CFuint nbFaces = partnerRank.size();
+  vector<vector<CFuint> > requests(nbProc);
+  vector<vector<CFuint> > requesters(nbProc);
+  m_selfFaces.clear();
+  vector<CFuint> selfRequesters;
+  for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
+    const CFuint p = partnerRank[iFace];
+    cf_assert(p < (CFuint)nbProc);
+    if (p == m_myRank) {
+      m_selfFaces.push_back(partnerFace[iFace]);
+      selfRequesters.push_back(iFace);
+    }
+    else {
+      requests[p].push_back(partnerFace[iFace]);
+      requesters[p].push_back(iFace);
+    }
+  }
+
+  // the received values are stored rank after rank, the local ones last
+  m_recvRanks.clear();
+  m_recvStart.assign(1, 0);
+  m_recvIndex.assign(nbFaces, 0);
+  vector<int> requestCounts(nbProc, 0);
+  for (int p = 0; p < nbProc; ++p) {
+    requestCounts[p] = requests[p].size();
+    if (requests[p].size() > 0) {
+      for (CFuint i = 0; i < requesters[p].size(); ++i) {
+	m_recvIndex[requesters[p][i]] = (m_recvStart.back() + i)*m_blockSize;
+      }
+      m_recvRanks.push_back(p);
+      m_recvStart.push_back(m_recvStart.back() + requests[p].size());
+    }
+  }
+  const CFuint nbRecvFaces = m_recvStart.back();
+  for (CFuint i = 0; i < selfRequesters.size(); ++i) {
+    m_recvIndex[selfRequesters[i]] = (nbRecvFaces + i)*m_blockSize;
+  }
+  m_recvBuf.assign((nbRecvFaces + m_selfFaces.size())*m_blockSize, 0.);
+
+  // only the number of requests is exchanged collectively
+  vector<int> sendCounts(nbProc, 0);
+  MPIError::getInstance().check
+    ("MPI_Alltoall", "PeriodicExchangePlan::setup()",
+     MPI_Alltoall(&requestCounts[0], 1, MPI_INT, &sendCounts[0], 1, MPI_INT, m_comm));
+
+  m_sendRanks.clear();
+  m_sendStart.assign(1, 0);
+  for (int p = 0; p < nbProc; ++p) {
+    if (sendCounts[p] > 0) {
+      m_sendRanks.push_back(p);
+      m_sendStart.push_back(m_sendStart.back() + sendCounts[p]);
+    }
+  }
+  m_sendFaces.resize(m_sendStart.back());
+  m_sendBuf.resize(m_sendFaces.size()*m_blockSize);
+
+  // the requested faces are sent point-to-point to their owners
+  CFuint dummy = 0;
+  MPI_Datatype MPI_CFUINT = MPIStructDef::getMPIType(&dummy);
+  vector<MPI_Request> requestsMPI;
+  requestsMPI.reserve(m_sendRanks.size() + m_recvRanks.size());
+  for (CFuint i = 0; i < m_sendRanks.size(); ++i) {
+    requestsMPI.push_back(MPI_REQUEST_NULL);
+    MPI_Irecv(&m_sendFaces[m_sendStart[i]], m_sendStart[i+1] - m_sendStart[i], MPI_CFUINT,
+	      m_sendRanks[i], PERIODIC_EXCHANGE_TAG, m_comm, &requestsMPI.back());
+  }
+  for (CFuint i = 0; i < m_recvRanks.size(); ++i) {
+    vector<CFuint>& faces = requests[m_recvRanks[i]];
+    requestsMPI.push_back(MPI_REQUEST_NULL);
+    MPI_Isend(&faces[0], faces.size(), MPI_CFUINT,
+	      m_recvRanks[i], PERIODIC_EXCHANGE_TAG, m_comm, &requestsMPI.back());
+  }
+  if (requestsMPI.size() > 0) {
+    MPIError::getInstance().check
+      ("MPI_Waitall", "PeriodicExchangePlan::setup()",
+       MPI_Waitall(requestsMPI.size(), &requestsMPI[0], MPI_STATUSES_IGNORE));
+  }
+
+  m_requests.resize(m_sendRanks.size() + m_recvRanks.size());
+  m_pending = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PeriodicExchangePlan::post(const vector<CFreal>& faceValues)
+{
+  if (m_pending) wait();
+
+  CFreal dummy = 0.;
+  MPI_Datatype MPI_CFREAL = MPIStructDef::getMPIType(&dummy);
+
+  CFuint iReq = 0;
+  for (CFuint i = 0; i < m_recvRanks.size(); ++i, ++iReq) {
+    MPI_Irecv(&m_recvBuf[m_recvStart[i]*m_blockSize],
+	      (m_recvStart[i+1] - m_recvStart[i])*m_blockSize, MPI_CFREAL,
+	      m_recvRanks[i], PERIODIC_EXCHANGE_TAG, m_comm, &m_requests[iReq]);
+  }
+
+  // pack the values of the requested faces
+  for (CFuint f = 0; f < m_sendFaces.size(); ++f) {
+    const CFuint start = m_sendFaces[f]*m_blockSize;
+    cf_assert(start + m_blockSize <= faceValues.size());
+    for (CFuint e = 0; e < m_blockSize; ++e) {
+      m_sendBuf[f*m_blockSize + e] = faceValues[start + e];
+    }
+  }
+
+  for (CFuint i = 0; i < m_sendRanks.size(); ++i, ++iReq) {
+    MPI_Isend(&m_sendBuf[m_sendStart[i]*m_blockSize],
+	      (m_sendStart[i+1] - m_sendStart[i])*m_blockSize, MPI_CFREAL,
+	      m_sendRanks[i], PERIODIC_EXCHANGE_TAG, m_comm, &m_requests[iReq]);
+  }
+
+  // the faces paired on this process are copied meanwhile
+  const CFuint selfStart = m_recvStart.back()*m_blockSize;
+  for (CFuint f = 0; f < m_selfFaces.size(); ++f) {
+    const CFuint start = m_selfFaces[f]*m_blockSize;
+    cf_assert(start + m_blockSize <= faceValues.size());
+    for (CFuint e = 0; e < m_blockSize; ++e) {
+      m_recvBuf[selfStart + f*m_blockSize + e] = faceValues[start + e];
+    }
+  }
+
+  m_pending = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PeriodicExchangePlan::wait()
+{
+  if (!m_pending) return;
+
+  if (m_requests.size() > 0) {
+    MPIError::getInstance().check
+      ("MPI_Waitall", "PeriodicExchangePlan::wait()",
+       MPI_Waitall(m_requests.size(), &m_requests[0], MPI_STATUSES_IGNORE));
+  }
+  m_pending = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace FiniteVolume
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,143 @@
+#ifndef COOLFluiD_Numerics_FiniteVolume_PeriodicExchangePlan_hh
+#define COOLFluiD_Numerics_FiniteVolume_PeriodicExchangePlan_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "mpi.h"
+#include "Common/COOLFluiD.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace FiniteVolume {
+
+//////////////////////////////////////////////////////////////////////////////
+
+  /**
+   * This class is the point-to-point communication plan of a periodic
+   * boundary condition in parallel: it is built once from the pairing of
+   * the local faces with the periodic faces of the other processes, and
+   * then exchanges packed face values only between the paired processes,
+   * with non-blocking communications.
+   *
+   * post() starts an exchange, which is completed by wait(): the caller
+   * should wait as late as possible, right before using the values.
+   */
+class PeriodicExchangePlan {
+public:
+
+  /**
+   * Constructor
+   */
+  PeriodicExchangePlan();
+
+  /**
+   * Default destructor
+   */
+  ~PeriodicExchangePlan();
+
+  /**
+   * Build the plan (collective)
+   * @param comm         communicator of the boundary condition
+   * @param partnerRank  rank owning the periodic face of each local face
+   * @param partnerFace  index of the periodic face in the TRS of that rank
+   * @param blockSize    number of values per face
+   */
+  void setup(MPI_Comm comm,
+	     const std::vector<CFuint>& partnerRank,
+	     const std::vector<CFuint>& partnerFace,
+	     const CFuint blockSize);
+
+  /**
+   * Start the exchange of the face values
+   * @param faceValues blockSize values for each local face of the TRS
+   */
+  void post(const std::vector<CFreal>& faceValues);
+
+  /**
+   * Complete the exchange
+   */
+  void wait();
+
+  /**
+   * @return true if an exchange has been posted and not completed
+   */
+  bool isPending() const {return m_pending;}
+
+  /**
+   * @return the values of the periodic face of the given local face
+   * @pre wait() has been called after the last post()
+   */
+  const CFreal* getPeriodicValues(const CFuint iFace) const
+  {
+    return &m_recvBuf[m_recvIndex[iFace]];
+  }
+
+  /**
+   * @return the number of processes exchanging with this one
+   */
+  CFuint getNbNeighbors() const {return m_sendRanks.size() + m_recvRanks.size();}
+
+private: // data
+
+  /// communicator
+  MPI_Comm m_comm;
+
+  /// rank of this process
+  CFuint m_myRank;
+
+  /// number of values per face
+  CFuint m_blockSize;
+
+  /// ranks to which face values are sent
+  std::vector<int> m_sendRanks;
+
+  /// local faces to send, rank after rank
+  std::vector<CFuint> m_sendFaces;
+
+  /// start of the faces sent to each rank in m_sendFaces (size +1)
+  std::vector<CFuint> m_sendStart;
+
+  /// ranks from which face values are received
+  std::vector<int> m_recvRanks;
+
+  /// start of the faces received from each rank (size +1), in faces
+  std::vector<CFuint> m_recvStart;
+
+  /// local periodic faces of the local faces paired on this process, whose
+  /// values are copied at the end of m_recvBuf
+  std::vector<CFuint> m_selfFaces;
+
+  /// start in m_recvBuf of the values of the periodic face of each local face
+  std::vector<CFuint> m_recvIndex;
+
+  /// packed send buffer
+  std::vector<CFreal> m_sendBuf;
+
+  /// packed receive buffer, the values of the local periodic faces at the end
+  std::vector<CFreal> m_recvBuf;
+
+  /// requests of the exchange in progress
+  std::vector<MPI_Request> m_requests;
+
+  /// an exchange is in progress
+  bool m_pending;
+
+}; // end of class PeriodicExchangePlan
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace FiniteVolume
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Numerics_FiniteVolume_PeriodicExchangePlan_hh
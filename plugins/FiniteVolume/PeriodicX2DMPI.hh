@@ -5,6 +5,7 @@
 
 #include "Framework/State.hh"
 #include "FiniteVolume/FVMCC_BC.hh"
+#include "FiniteVolume/PeriodicExchangePlan.hh"
 #include "Common/CFMap.hh"
 #include "mpi.h"
 #include "Common/PE.hh"
@@ -79,36 +80,18 @@ private: //data
   /// map that maps a face with the number of the processor to which its corresponding periodic face belong
   Common::CFMap<CFuint,CFuint > _ConnectionProcessPeriodic;
 
-  /// vector of displacements between the arrays of boundary state of the faces belonging to a single process
-  std::vector<CFuint> _RecvDis2;
-
-  /// vector of send count for preProcess
-  std::vector<int> _sendcounts2;
-
-  /// vector of received count for preProcess
-  std::vector<int> _recvcounts2;
-
-  /// vector of received displacements for preProcess
-  std::vector<int> _rdispls2;
-
-  /// vector of sed displacements for preProcess
-  std::vector<int> _sdispls2;
-
-  /// size of received buffer
-  CFuint _LastDisplacement;
-
-  /// vector of received buffer for pre Process
-  std::vector<double> _rbuf2;
-
-  /// vector of boundary state of all faces belonging to a single process
-  std::vector<CFreal> _BoundaryState;
-
   ///number of faces per process
   std::vector<CFint> _countFpP;
   
   /// face builder
   Framework::GeometricEntityPool<Framework::FaceTrsGeoBuilder> _faceBuilder;
 
+  /// point-to-point exchange plan of the periodic face values
+  PeriodicExchangePlan _plan;
+
+  /// values of the inner states of the local faces
+  std::vector<CFreal> _faceValues;
+
   ///number of equation
   CFuint _nE;
 
@@ -41,21 +41,15 @@ PeriodicturboMPI::PeriodicturboMPI(const std::string& name):
   _my_nP(),
   _n_P(),
   _nE(), 
-  _LastDisplacement(),
   _nbTrsFaces(),
   _nbDim(), 
   _countFpP(),
   _faceBuilder(),
+  _plan(),
+  _faceValues(),
   _globalToLocalTRSFaceID(),
   _ConnectionFacePeriodic(),
-  _ConnectionProcessPeriodic(),
-  _RecvDis2(),
-  _sendcounts2(),
-  _recvcounts2(),
-  _rdispls2(),
-  _sdispls2(),
-  _rbuf2(),
-  _BoundaryState()
+  _ConnectionProcessPeriodic()
 {
   addConfigOptionsTo(this);
   _threshold = 10e-3;
@@ -337,34 +331,15 @@ void PeriodicturboMPI::setup()
   cout<<" _my_nP = "<<_my_nP<<" iterWest = "<<iterWest<<" nWf "<<nWf<<endl;
   cout<<" _my_nP = "<<_my_nP<<" iterEast = "<<iterEast<<" nEf "<<nEf<<endl;
 
-  // build counts and displacements for preProcess step
-  _sendcounts2.resize(_n_P);
-  _recvcounts2.resize(_n_P);
-  _rdispls2.resize(_n_P);
-  _sdispls2.resize(_n_P);
-  _rdispls2[0] = 0;
-  _sdispls2[0] = 0;
-  CFuint _LastDisplacement = 0;
-  for(CFuint p=0; p<_n_P; p++){
-    _sendcounts2[p] = _nE*_countFpP[_my_nP];
-    _recvcounts2[p] = _nE*_countFpP[p];
-  }
-  if(_n_P>1){
-    for(CFuint p=1; p<_n_P; p++){
-      _rdispls2[p] = _rdispls2[p-1] + _recvcounts2[p-1];
-      _sdispls2[p] = _sdispls2[p-1] + _sendcounts2[p-1];
-    }
-  }
-  _LastDisplacement = _rdispls2[_n_P-1] + _recvcounts2[_n_P-1];
-  _rbuf2.resize(_LastDisplacement);
-  _BoundaryState.resize(_LastDisplacement);
-  for(CFuint i=0; i<_LastDisplacement; i++){
-    _rbuf2[i] = 0.0;
-    _BoundaryState[i] = 0.0;
-  }
-  for(CFuint i=0; i<_n_P; i++){
-    _RecvDis2.push_back(_rdispls2[i]);
+  // point-to-point plan of the ghost updates: only the paired processes communicate
+  std::vector<CFuint> partnerRank(_nbTrsFaces);
+  std::vector<CFuint> partnerFace(_nbTrsFaces);
+  for(CFuint iFace=0; iFace<_nbTrsFaces; iFace++){
+    partnerRank[iFace] = _ConnectionProcessPeriodic.find(iFace);
+    partnerFace[iFace] = _ConnectionFacePeriodic.find(iFace);
   }
+  _plan.setup(_comm, partnerRank, partnerFace, _nE);
+  _faceValues.resize(_nbTrsFaces*_nE);
   cout<<" _my_nP = "<<_my_nP<<" adiossssssssssssssssssssssssssssssssssssss 3"<<endl;
 
 }
@@ -378,40 +353,18 @@ void PeriodicturboMPI::preProcess()
   FaceTrsGeoBuilder::GeoData& faceData = _faceBuilder.getDataGE();
   faceData.isBFace = true;
 
-  const CFuint dimq = _nbTrsFaces*_nE*_n_P;
-  const CFuint dimq2 = _nbTrsFaces*_nE;// <<-----------------------------------with allgatherv
-  std::vector<CFreal> boundaryState(dimq2);
   for(CFuint iFace=0; iFace<_nbTrsFaces; iFace++){
     faceData.idx = iFace;
     GeometricEntity *const face = _faceBuilder.buildGE();
     State *const innerState = face->getState(0);
     for(CFuint e=0; e<_nE; e++){
-      boundaryState[_nE*iFace + e] = (*innerState)[e];
+      _faceValues[_nE*iFace + e] = (*innerState)[e];
     }
     _faceBuilder.releaseGE();
   }
-  std::vector<CFreal> SendBoundaryState;
-  SendBoundaryState.reserve(dimq);
-  for(CFuint p=0; p<_n_P; p++){
-    for(CFuint pp=0; pp<_nbTrsFaces*_nE; pp++){
-      SendBoundaryState.push_back(boundaryState[pp]);
-    }
-  }
 
-  vector<CFreal> sbuf2(SendBoundaryState);
-  vector<CFreal> sbuf2AG(boundaryState);// <<-----------------------------------with allgatherv
- 
-  MPI_Datatype MPI_CFREAL = Common::MPIStructDef::getMPIType(&sbuf2[0]);
-  
-  MPI_Alltoallv(&sbuf2[0], &_sendcounts2[0], &_sdispls2[0], MPI_CFREAL, &_rbuf2[0], &_recvcounts2[0], &_rdispls2[0], MPI_CFREAL, _comm);
-  //MPI_Allgatherv(&sbuf2AG[0], dimq2, MPI_CFREAL, &_rbuf2[0], &_recvcounts2[0], &_rdispls2[0], MPI_CFREAL, _comm);
-
-  _BoundaryState.clear();
-  _BoundaryState.reserve(_LastDisplacement);
-  for(CFuint i=0; i<_LastDisplacement; i++){
-    //_BoundaryState[i] = _rbuf2[i];
-    _BoundaryState.push_back(_rbuf2[i]);
-  }
+  // the exchange is completed right before the first ghost state is set
+  _plan.post(_faceValues);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -422,11 +375,12 @@ void PeriodicturboMPI::setGhostState(GeometricEntity *const face)
    State *const ghostState = face->getState(1);
    const CFuint faceGlobalID = face->getID();
    const CFuint iFace = _globalToLocalTRSFaceID.find(faceGlobalID);
-   const CFuint ProcessPeriodic = _ConnectionProcessPeriodic[iFace];
-   const CFuint FacePeriodic = _ConnectionFacePeriodic[iFace];
+   if (_plan.isPending()) {
+     _plan.wait();
+   }
+   const CFreal *const periodicState = _plan.getPeriodicValues(iFace);
    for(CFuint h=0; h<_nE; h++){
-     //(*ghostState)[h] = _BoundaryState[_RecvDis2[ProcessPeriodic] + _nE*FacePeriodic + h];
-     (*ghostState)[h] = _rbuf2[_RecvDis2[ProcessPeriodic] + _nE*FacePeriodic + h];
+     (*ghostState)[h] = periodicState[h];
    }
 
 }
@@ -0,0 +1,381 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Common/CFLog.hh"
+#include "Common/ThreadPool.hh"
+#include "Common/NotImplementedException.hh"
+#include "Framework/DataProcessing.hh"
+#include "Framework/SubSystemStatus.hh"
+#include "Framework/MethodCommandProvider.hh"
+#include "Framework/MultiScalarTerm.hh"
+#include "Framework/PhysicalModel.hh"
+#include "NavierStokes/EulerTerm.hh"
+#include "FiniteVolume/CellCenterFVM.hh"
+#include "FiniteVolumeNEQ/FiniteVolumeNEQ.hh"
+#include "FiniteVolumeNEQ/SplitChemistry.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD::Framework;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Physics::NavierStokes;
+using namespace COOLFluiD::MathTools;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace FiniteVolume {
+
+//////////////////////////////////////////////////////////////////////////////
+
+MethodCommandProvider<SplitChemistry, DataProcessingData, FiniteVolumeNEQModule>
+splitChemistryProvider("SplitChemistry");
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Functor advancing a range of cells in the thread pool
+struct SplitChemistryAdvance {
+  SplitChemistryAdvance(SplitChemistry* cmd) : m_cmd(cmd) {}
+
+  void operator()(CFuint first, CFuint end, CFuint threadID)
+  {
+    m_cmd->advanceCells(first, end);
+  }
+
+  SplitChemistry* m_cmd;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SplitChemistry::defineConfigOptions(Config::OptionList& options)
+{
+  options.addConfigOption< CFreal >
+    ("TimeFraction","Fraction of the time step integrated at each call (0.5 for Strang splitting).");
+  options.addConfigOption< CFreal >
+    ("TimeStep","Dimensional time step used if the convergence method has none (e.g. steady runs).");
+  options.addConfigOption< CFreal >("RelTolerance","Relative tolerance of the integration.");
+  options.addConfigOption< CFreal >("AbsTolerance","Absolute tolerance on the mass fractions.");
+  options.addConfigOption< CFuint >("MaxSteps","Max number of steps per cell.");
+  options.addConfigOption< CFuint >
+    ("MaxJacobianAge","Number of steps after which the species Jacobian is recomputed.");
+  options.addConfigOption< CFuint >("BatchSize","Number of cells integrated together.");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+SplitChemistry::SplitChemistry(const std::string& name) :
+  DataProcessingCom(name),
+  socket_states("states"),
+  m_library(CFNULL),
+  m_updateVarSet(CFNULL),
+  m_physicalData(),
+  m_nbSpecies(0),
+  m_firstSpecies(0),
+  m_Rs(),
+  m_dt(0.),
+  m_integrator(),
+  m_cells(),
+  m_evalT(),
+  m_evalP(),
+  m_evalRhoi(),
+  m_evalOmega(),
+  m_tVec(),
+  m_hs(),
+  m_hsPert(),
+  m_nbExplicit(0),
+  m_nbSteps(0),
+  m_nbEvaluations(0),
+  m_nbFailed(0)
+{
+  addConfigOptionsTo(this);
+
+  m_timeFraction = 0.5;
+  setParameter("TimeFraction",&m_timeFraction);
+
+  m_timeStep = 0.;
+  setParameter("TimeStep",&m_timeStep);
+
+  m_relTol = 1e-4;
+  setParameter("RelTolerance",&m_relTol);
+
+  m_absTol = 1e-10;
+  setParameter("AbsTolerance",&m_absTol);
+
+  m_maxSteps = 5000;
+  setParameter("MaxSteps",&m_maxSteps);
+
+  m_maxJacobianAge = 20;
+  setParameter("MaxJacobianAge",&m_maxJacobianAge);
+
+  m_batchSize = 4096;
+  setParameter("BatchSize",&m_batchSize);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+SplitChemistry::~SplitChemistry()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<Common::SafePtr<BaseDataSocketSink> >
+SplitChemistry::needsSockets()
+{
+  std::vector<Common::SafePtr<BaseDataSocketSink> > result;
+  result.push_back(&socket_states);
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SplitChemistry::configure ( Config::ConfigArgs& args )
+{
+  CFAUTOTRACE;
+
+  DataProcessingCom::configure(args);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SplitChemistry::setup()
+{
+  CFAUTOTRACE;
+
+  DataProcessingCom::setup();
+
+  m_library = PhysicalModelStack::getActive()->getImplementor()->
+    getPhysicalPropertyLibrary<PhysicalChemicalLibrary>();
+  cf_assert(m_library.isNotNull());
+
+  if (m_library->getNbTempVib() + m_library->getNbTe() > 0) {
+    throw Common::NotImplementedException
+      (FromHere(), "SplitChemistry::setup() => only one-temperature models are supported");
+  }
+
+  SafePtr<MultiScalarTerm<EulerTerm> > term = PhysicalModelStack::getActive()->
+    getImplementor()->getConvectiveTerm().d_castTo<MultiScalarTerm<EulerTerm> >();
+  term->resizePhysicalData(m_physicalData);
+  m_nbSpecies = term->getNbScalarVars(0);
+  m_firstSpecies = term->getFirstScalarVar(0);
+
+  RealVector mm(m_nbSpecies);
+  m_library->getMolarMasses(mm);
+  m_Rs.resize(m_nbSpecies);
+  for (CFuint i = 0; i < m_nbSpecies; ++i) {
+    m_Rs[i] = m_library->getRgas()/mm[i];
+  }
+
+  m_hs.resize(m_nbSpecies);
+  m_hsPert.resize(m_nbSpecies);
+
+  // y = (rho_i, T), the partial densities being positive
+  m_integrator.setup(m_nbSpecies + 1, m_nbSpecies, m_relTol, m_maxSteps, m_maxJacobianAge);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SplitChemistry::unsetup()
+{
+  CFAUTOTRACE;
+
+  m_cells.clear();
+
+  DataProcessingCom::unsetup();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SplitChemistry::execute()
+{
+  CFAUTOTRACE;
+
+  // the time step of the convergence method is adimensional
+  const CFreal dt = SubSystemStatusStack::getActive()->getDT();
+  m_dt = m_timeFraction*((dt > 0.) ? dt*PhysicalModelStack::getActive()->
+			 getImplementor()->getRefTime() : m_timeStep);
+  if (m_dt <= 0.) {
+    CFLog(VERBOSE, "SplitChemistry::execute() => no time step, skipping\n");
+    return;
+  }
+  m_integrator.setTimeStep(m_dt);
+
+  // suppose that just one space method is available
+  SafePtr<SpaceMethod> spaceMethod = getMethodData().getCollaborator<SpaceMethod>();
+  SafePtr<CellCenterFVM> fvmcc = spaceMethod.d_castTo<CellCenterFVM>();
+  cf_assert(fvmcc.isNotNull());
+  m_updateVarSet = fvmcc->getData()->getUpdateVar();
+  cf_assert(m_updateVarSet.isNotNull());
+
+  SafePtr<MultiScalarTerm<EulerTerm> > term = PhysicalModelStack::getActive()->
+    getImplementor()->getConvectiveTerm().d_castTo<MultiScalarTerm<EulerTerm> >();
+  const RealVector& refData = term->getReferencePhysicalData();
+
+  m_nbExplicit = 0;
+  m_nbSteps = 0;
+  m_nbEvaluations = 0;
+  m_nbFailed = 0;
+
+  // the overlap states are integrated as well: they get the same result
+  // as on the process owning them, so no communication is needed
+  DataHandle<State*, GLOBAL> states = socket_states.getDataHandle();
+  const CFuint nbStates = states.size();
+  const CFuint batchSize = std::max(m_batchSize, static_cast<CFuint>(1));
+  const CFuint nbVars = m_nbSpecies + 1;
+  SplitChemistryAdvance advance(this);
+
+  for (CFuint start = 0; start < nbStates; start += batchSize) {
+    const CFuint nbCells = std::min(batchSize, nbStates - start);
+    if (m_cells.size() < nbCells) m_cells.resize(nbCells);
+
+    for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+      m_updateVarSet->computePhysicalData(*states[start + iCell], m_physicalData);
+
+      StiffBDFIntegrator::ODE& c = m_cells[iCell];
+      if (c.y.size() != nbVars) {
+	m_integrator.resize(c);
+      }
+
+      const CFreal rho = m_physicalData[EulerTerm::RHO]*refData[EulerTerm::RHO];
+      for (CFuint i = 0; i < m_nbSpecies; ++i) {
+	c.y[i] = rho*m_physicalData[m_firstSpecies + i];
+	c.absTol[i] = m_absTol*rho;
+      }
+      c.y[m_nbSpecies] = m_physicalData[EulerTerm::T]*refData[EulerTerm::T];
+      c.absTol[m_nbSpecies] = m_absTol*c.y[m_nbSpecies];
+      c.scale = rho;
+      m_integrator.start(c);
+    }
+
+    // rounds of evaluations (serial) and integration (parallel)
+    while (evaluateRequests(nbCells) > 0) {
+      ThreadPool::getInstance().parallelFor(0, nbCells, advance);
+    }
+
+    for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+      State& state = *states[start + iCell];
+      m_updateVarSet->computePhysicalData(state, m_physicalData);
+
+      // density, velocity and total energy are not changed by the chemistry
+      const StiffBDFIntegrator::ODE& c = m_cells[iCell];
+      const CFreal rho = m_physicalData[EulerTerm::RHO]*refData[EulerTerm::RHO];
+      if (c.nbAccepted == 0 && !c.failed) ++m_nbExplicit;
+      m_nbSteps += c.nbAccepted;
+      if (c.failed) ++m_nbFailed;
+      
+      const CFreal T = c.y[m_nbSpecies];
+      CFreal rhoR = 0.;
+      for (CFuint i = 0; i < m_nbSpecies; ++i) {
+	const CFreal rhoi = std::max(c.y[i], 0.);
+	m_physicalData[m_firstSpecies + i] = rhoi/rho;
+	rhoR += rhoi*m_Rs[i];
+      }
+      m_physicalData[EulerTerm::T] = T/refData[EulerTerm::T];
+      m_physicalData[EulerTerm::P] = rhoR*T/refData[EulerTerm::P] - term->getPressInf();
+      m_updateVarSet->computeStateFromPhysicalData(m_physicalData, state);
+    }
+  }
+
+  CFLog(VERBOSE, "SplitChemistry::execute() => dt = " << m_dt << " s, "
+	<< nbStates << " cells, " << m_nbExplicit << " explicit, "
+	<< m_nbSteps << " implicit steps, " << m_nbEvaluations << " evaluations\n");
+  if (m_nbFailed > 0) {
+    CFLog(WARN, "SplitChemistry::execute() => " << m_nbFailed
+	  << " cells not integrated up to the end of the time step\n");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint SplitChemistry::evaluateRequests(const CFuint nbCells)
+{
+  const CFuint nbVars = m_nbSpecies + 1;
+  CFuint nbEval = 0;
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    nbEval += m_cells[iCell].nbReq;
+  }
+  if (nbEval == 0) return 0;
+
+  if (m_evalT.size() < nbEval) {
+    m_evalT.resize(nbEval);
+    m_evalP.resize(nbEval);
+    m_evalRhoi.resize(nbEval*m_nbSpecies);
+    m_evalOmega.resize(nbEval*m_nbSpecies);
+  }
+
+  // gather the requested states
+  CFuint iEval = 0;
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    const StiffBDFIntegrator::ODE& c = m_cells[iCell];
+    for (CFuint r = 0; r < c.nbReq; ++r, ++iEval) {
+      const CFreal *const yr = &c.req[r*nbVars];
+      CFreal *const rhoi = &m_evalRhoi[iEval*m_nbSpecies];
+      CFreal rhoR = 0.;
+      for (CFuint i = 0; i < m_nbSpecies; ++i) {
+	rhoi[i] = std::max(yr[i], 0.);
+	rhoR += rhoi[i]*m_Rs[i];
+      }
+      m_evalT[iEval] = std::max(yr[m_nbSpecies], 1.);
+      m_evalP[iEval] = rhoR*m_evalT[iEval];
+    }
+  }
+
+  m_library->getMassProductionTermBatch(nbEval, 1, &m_evalT[0], &m_evalP[0],
+					&m_evalRhoi[0], &m_evalOmega[0]);
+
+  // dT/dt from the conservation of the internal energy at constant volume:
+  // sum_i e_i omega_i + rho cv dT/dt = 0, with e_i = h_i - R_i T
+  iEval = 0;
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    StiffBDFIntegrator::ODE& c = m_cells[iCell];
+    for (CFuint r = 0; r < c.nbReq; ++r, ++iEval) {
+      CFreal T = m_evalT[iEval];
+      CFreal p = m_evalP[iEval];
+      CFreal *const rhoi = &m_evalRhoi[iEval*m_nbSpecies];
+      m_library->setState(rhoi, &T);
+      m_library->getSpeciesTotEnthalpies(T, m_tVec, p, m_hs);
+
+      CFreal TPert = T*(1. + 1e-4);
+      CFreal pPert = p*(1. + 1e-4);
+      m_library->setState(rhoi, &TPert);
+      m_library->getSpeciesTotEnthalpies(TPert, m_tVec, pPert, m_hsPert);
+
+      const CFreal ovDT = 1./(TPert - T);
+      const CFreal *const omega = &m_evalOmega[iEval*m_nbSpecies];
+      CFreal *const fr = &c.res[r*nbVars];
+      CFreal rhoCv = 0.;
+      CFreal eOmega = 0.;
+      for (CFuint i = 0; i < m_nbSpecies; ++i) {
+	rhoCv += rhoi[i]*((m_hsPert[i] - m_hs[i])*ovDT - m_Rs[i]);
+	eOmega += (m_hs[i] - m_Rs[i]*T)*omega[i];
+	fr[i] = omega[i];
+      }
+      cf_assert(rhoCv > 0.);
+      fr[m_nbSpecies] = -eOmega/rhoCv;
+    }
+  }
+
+  m_nbEvaluations += nbEval;
+  return nbEval;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SplitChemistry::advanceCells(const CFuint first, const CFuint end)
+{
+  for (CFuint iCell = first; iCell < end; ++iCell) {
+    m_integrator.advance(m_cells[iCell]);
+  }
+}
+
+    } // namespace FiniteVolume
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
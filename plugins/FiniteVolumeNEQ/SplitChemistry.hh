@@ -0,0 +1,201 @@
+#ifndef COOLFluiD_Numerics_FiniteVolume_SplitChemistry_hh
+#define COOLFluiD_Numerics_FiniteVolume_SplitChemistry_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Framework/DataProcessingData.hh"
+#include "Framework/DataSocketSink.hh"
+#include "Framework/PhysicalChemicalLibrary.hh"
+#include "FiniteVolumeNEQ/StiffBDFIntegrator.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Framework {
+    class ConvectiveVarSet;
+  }
+
+  namespace Numerics {
+
+    namespace FiniteVolume {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class integrates the chemical source terms in each cell separately
+ * from the transport, for an operator-split (Strang) time integration:
+ * used both in DataPreProcessing and DataPostProcessing with TimeFraction
+ * 0.5 and without chemical source term in the space method, it makes the
+ * sequence chemistry(dt/2) - transport(dt) - chemistry(dt/2), whatever the
+ * convergence method (e.g. RungeKuttaLS or NewtonMethod).
+ *
+ * Each cell is an adiabatic constant volume reactor whose partial densities
+ * and temperature are advanced by a StiffBDFIntegrator.
+ * Cells whose composition changes less than the tolerance during the step
+ * are advanced by one explicit step. The other ones are integrated in
+ * batches: at each round, the function evaluations requested by all the
+ * cells of the batch are done in one pass through the library (that is not
+ * thread-safe), then the cells process them in parallel in the thread pool.
+ *
+ * @author Andrea Lani
+ *
+ */
+class SplitChemistry : public Framework::DataProcessingCom {
+public:
+
+  /**
+   * Defines the Config Option's of this class
+   * @param options a OptionList where to add the Option's
+   */
+  static void defineConfigOptions(Config::OptionList& options);
+
+  /**
+   * Constructor
+   */
+  SplitChemistry(const std::string& name);
+
+  /**
+   * Default destructor
+   */
+  ~SplitChemistry();
+
+  /**
+   * Set up private data and data of the aggregated classes
+   * in this command before processing phase
+   */
+  void setup();
+
+  /**
+   * Unset up private data and data of the aggregated classes
+   * in this command
+   */
+  void unsetup();
+
+  /**
+   * Execute on a set of dofs
+   */
+  void execute();
+
+  /**
+   * Configures this object with supplied arguments.
+   */
+  virtual void configure ( Config::ConfigArgs& args );
+
+  /**
+   * Returns the DataSocket's that this command needs as sinks
+   * @return a vector of SafePtr with the DataSockets
+   */
+  virtual std::vector<Common::SafePtr<Framework::BaseDataSocketSink> > needsSockets();
+
+  /**
+   * Advance the cells [first, end) of the current batch with the function
+   * evaluations of the last round (thread-safe)
+   */
+  void advanceCells(const CFuint first, const CFuint end);
+
+private: // helper functions
+
+  /// evaluate f at the points requested by the first nbCells cells
+  /// @return the number of evaluations
+  CFuint evaluateRequests(const CFuint nbCells);
+
+private: //data
+
+  /// storage of states
+  Framework::DataSocketSink < Framework::State* , Framework::GLOBAL > socket_states;
+
+  /// physical chemical library
+  Common::SafePtr<Framework::PhysicalChemicalLibrary> m_library;
+
+  /// update variable set
+  Common::SafePtr<Framework::ConvectiveVarSet> m_updateVarSet;
+
+  /// array of physical data
+  RealVector m_physicalData;
+
+  /// number of species
+  CFuint m_nbSpecies;
+
+  /// ID of the first species in the physical data
+  CFuint m_firstSpecies;
+
+  /// gas constants of the species
+  RealVector m_Rs;
+
+  /// integration time of the current call
+  CFreal m_dt;
+
+  /// integrator of the cell reactors
+  StiffBDFIntegrator m_integrator;
+
+  /// integration data of the cells of a batch
+  std::vector<StiffBDFIntegrator::ODE> m_cells;
+
+  /// temperatures of the evaluations
+  std::vector<CFreal> m_evalT;
+
+  /// pressures of the evaluations
+  std::vector<CFreal> m_evalP;
+
+  /// partial densities of the evaluations
+  std::vector<CFreal> m_evalRhoi;
+
+  /// mass production terms of the evaluations
+  std::vector<CFreal> m_evalOmega;
+
+  /// vibrational temperatures (unused with one temperature)
+  RealVector m_tVec;
+
+  /// species enthalpies
+  RealVector m_hs;
+
+  /// species enthalpies at a perturbed temperature
+  RealVector m_hsPert;
+
+  /// number of cells advanced by one explicit step
+  CFuint m_nbExplicit;
+
+  /// number of accepted steps
+  CFuint m_nbSteps;
+
+  /// number of evaluations of f
+  CFuint m_nbEvaluations;
+
+  /// number of cells not integrated up to the end
+  CFuint m_nbFailed;
+
+  /// fraction of the time step integrated by this command
+  CFreal m_timeFraction;
+
+  /// dimensional time step used when the convergence method has none
+  CFreal m_timeStep;
+
+  /// relative tolerance
+  CFreal m_relTol;
+
+  /// absolute tolerance on the mass fractions
+  CFreal m_absTol;
+
+  /// max number of steps per cell
+  CFuint m_maxSteps;
+
+  /// number of steps after which the Jacobian is recomputed
+  CFuint m_maxJacobianAge;
+
+  /// number of cells per batch
+  CFuint m_batchSize;
+
+}; // end of class SplitChemistry
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace FiniteVolume
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Numerics_FiniteVolume_SplitChemistry_hh
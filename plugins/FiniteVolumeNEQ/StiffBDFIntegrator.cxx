@@ -0,0 +1,424 @@
+#include <cmath>
+#include <algorithm>
+
+#include "FiniteVolumeNEQ/StiffBDFIntegrator.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace FiniteVolume {
+
+//////////////////////////////////////////////////////////////////////////////
+
+StiffBDFIntegrator::StiffBDFIntegrator() :
+  m_nbVars(0),
+  m_nbPositive(0),
+  m_relTol(0.),
+  m_maxSteps(0),
+  m_maxJacobianAge(0),
+  m_dt(0.)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+StiffBDFIntegrator::~StiffBDFIntegrator()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::setup(const CFuint nbVars, const CFuint nbPositive,
+			       const CFreal relTol, const CFuint maxSteps,
+			       const CFuint maxJacobianAge)
+{
+  cf_assert(nbPositive <= nbVars);
+
+  m_nbVars = nbVars;
+  m_nbPositive = nbPositive;
+  m_relTol = relTol;
+  m_maxSteps = maxSteps;
+  m_maxJacobianAge = maxJacobianAge;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::resize(ODE& ode) const
+{
+  const CFuint nbVars = m_nbVars;
+  ode.absTol.resize(nbVars);
+  ode.y.resize(nbVars);
+  ode.f.resize(nbVars);
+  ode.yPrev.resize(nbVars);
+  ode.fPrev.resize(nbVars);
+  ode.z.resize(nbVars);
+  ode.psi.resize(nbVars);
+  ode.jacob.resize(nbVars*nbVars);
+  ode.lu.resize(nbVars*nbVars);
+  ode.pivots.resize(nbVars);
+  ode.pert.resize(nbVars);
+  ode.req.resize((nbVars + 1)*nbVars);
+  ode.res.resize((nbVars + 1)*nbVars);
+  ode.work.resize(nbVars);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::start(ODE& ode) const
+{
+  cf_assert(ode.y.size() == m_nbVars);
+
+  ode.phase = INIT;
+  ode.failed = false;
+  ode.t = 0.;
+  ode.h = 0.;
+  ode.hPrev = 0.;
+  ode.order = 1;
+  ode.nbAccepted = 0;
+  ode.nbAttempts = 0;
+  ode.nbIter = 0;
+  ode.jacAge = 0;
+  ode.deltaNorm = 0.;
+  ode.hGamma = 0.;
+  ode.nbReq = 1;
+  std::copy(ode.y.begin(), ode.y.end(), ode.req.begin());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::advance(ODE& ode) const
+{
+  if (ode.nbReq == 0) return;
+
+  switch (ode.phase) {
+  case INIT:
+    processInit(ode);
+    break;
+  case JACOBIAN:
+    processJacobian(ode);
+    break;
+  case NEWTON:
+    processNewton(ode);
+    break;
+  default:
+    cf_assert(false);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::processInit(ODE& c) const
+{
+  const CFuint nbVars = m_nbVars;
+  std::copy(c.res.begin(), c.res.begin() + nbVars, c.f.begin());
+
+  // the change over the whole step is within the tolerance
+  const CFreal fNorm = weightedNorm(c, &c.f[0]);
+  if (m_dt*fNorm <= 1.) {
+    for (CFuint i = 0; i < nbVars; ++i) {
+      c.y[i] += m_dt*c.f[i];
+    }
+    c.t = m_dt;
+    finish(c, false);
+    return;
+  }
+
+  // a variable starting from zero can give a tiny estimate: the error
+  // control reduces the step anyway if it is too large
+  c.h = std::min(m_dt, std::max(0.1/fNorm, 1e-12*m_dt));
+  requestJacobian(c);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::requestJacobian(ODE& c) const
+{
+  const CFuint nbVars = m_nbVars;
+  for (CFuint j = 0; j < nbVars; ++j) {
+    // the other variables can vanish: their smallest significant value is
+    // absTol/relTol
+    const CFreal scale = (j < m_nbPositive) ? std::max(std::abs(c.y[j]), 1e-6*c.scale) :
+      std::max(std::abs(c.y[j]), c.absTol[j]/m_relTol);
+    c.pert[j] = 1e-7*scale;
+    CFreal *const yr = &c.req[j*nbVars];
+    std::copy(c.y.begin(), c.y.end(), yr);
+    yr[j] += c.pert[j];
+  }
+  // unperturbed point, c.f being only the approximation of the BDF formula
+  std::copy(c.y.begin(), c.y.end(), &c.req[nbVars*nbVars]);
+  c.nbReq = nbVars + 1;
+  c.phase = JACOBIAN;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::processJacobian(ODE& c) const
+{
+  const CFuint nbVars = m_nbVars;
+  std::copy(&c.res[nbVars*nbVars], &c.res[nbVars*nbVars] + nbVars, c.f.begin());
+  for (CFuint j = 0; j < nbVars; ++j) {
+    const CFreal *const fr = &c.res[j*nbVars];
+    const CFreal ovPert = 1./c.pert[j];
+    for (CFuint i = 0; i < nbVars; ++i) {
+      c.jacob[i*nbVars + j] = (fr[i] - c.f[i])*ovPert;
+    }
+  }
+  c.jacAge = 0;
+  c.hGamma = 0.;
+  startStep(c);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::startStep(ODE& c) const
+{
+  const CFuint nbVars = m_nbVars;
+  if (c.nbAttempts >= m_maxSteps || c.h < 1e-14*m_dt) {
+    finish(c, true);
+    return;
+  }
+  ++c.nbAttempts;
+
+  c.h = std::min(c.h, m_dt - c.t);
+
+  // BDF: y_n+1 = psi + h*gamma*f(y_n+1)
+  CFreal gamma = 1.;
+  if (c.order == 1) {
+    std::copy(c.y.begin(), c.y.end(), c.psi.begin());
+  }
+  else {
+    const CFreal w = c.h/c.hPrev;
+    const CFreal ov = 1./(1. + 2.*w);
+    for (CFuint i = 0; i < nbVars; ++i) {
+      c.psi[i] = ((1. + w)*(1. + w)*c.y[i] - w*w*c.yPrev[i])*ov;
+    }
+    gamma = (1. + w)*ov;
+  }
+
+  // the factorization is done again only if h*gamma has changed
+  const CFreal hGamma = c.h*gamma;
+  if (hGamma != c.hGamma) {
+    for (CFuint i = 0; i < nbVars; ++i) {
+      for (CFuint j = 0; j < nbVars; ++j) {
+	c.lu[i*nbVars + j] = ((i == j) ? 1. : 0.) - hGamma*c.jacob[i*nbVars + j];
+      }
+    }
+    if (!factorize(nbVars, &c.lu[0], &c.pivots[0])) {
+      c.hGamma = 0.;
+      c.h *= 0.25;
+      startStep(c);
+      return;
+    }
+    c.hGamma = hGamma;
+  }
+
+  // predictor by linear extrapolation of the last two solutions
+  if (c.nbAccepted > 0) {
+    const CFreal w = c.h/c.hPrev;
+    for (CFuint i = 0; i < nbVars; ++i) {
+      c.z[i] = c.y[i] + w*(c.y[i] - c.yPrev[i]);
+    }
+  }
+  else {
+    std::copy(c.y.begin(), c.y.end(), c.z.begin());
+  }
+
+  c.nbIter = 0;
+  c.deltaNorm = 0.;
+  std::copy(c.z.begin(), c.z.end(), c.req.begin());
+  c.nbReq = 1;
+  c.phase = NEWTON;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::processNewton(ODE& c) const
+{
+  const CFuint nbVars = m_nbVars;
+
+  // simplified Newton iteration
+  for (CFuint i = 0; i < nbVars; ++i) {
+    c.work[i] = -(c.z[i] - c.psi[i] - c.hGamma*c.res[i]);
+  }
+  solve(nbVars, &c.lu[0], &c.pivots[0], &c.work[0]);
+  for (CFuint i = 0; i < nbVars; ++i) {
+    c.z[i] += c.work[i];
+  }
+  const CFreal deltaNorm = weightedNorm(c, &c.work[0]);
+  const CFreal rate = (c.nbIter > 0 && c.deltaNorm > 0.) ? deltaNorm/c.deltaNorm : 0.;
+  ++c.nbIter;
+  c.deltaNorm = deltaNorm;
+
+  const bool converged = (deltaNorm <= 0.1) ||
+    (rate > 0. && rate < 1. && rate*deltaNorm/(1. - rate) <= 0.1);
+  if (!converged) {
+    if (c.nbIter < 4 && rate < 0.9) {
+      std::copy(c.z.begin(), c.z.end(), c.req.begin());
+      return;
+    }
+
+    // a stale Jacobian is computed again, else the step is reduced
+    if (c.jacAge > 0) {
+      requestJacobian(c);
+    }
+    else {
+      c.h *= 0.25;
+      startStep(c);
+    }
+    return;
+  }
+
+  // derivative at the new point from the BDF formula
+  const CFreal ovHGamma = 1./c.hGamma;
+  for (CFuint i = 0; i < nbVars; ++i) {
+    c.work[i] = (c.z[i] - c.psi[i])*ovHGamma;
+  }
+
+  // local errors of the orders 1 and 2: h^2/2 y'' and 2/9 h^3 y'''
+  for (CFuint i = 0; i < nbVars; ++i) {
+    c.req[i] = 0.5*(c.work[i] - c.f[i])*c.h;
+  }
+  const CFreal err1 = weightedNorm(c, &c.req[0]);
+  CFreal err2 = -1.;
+  if (c.nbAccepted > 0) {
+    const CFreal ovH = 1./c.h;
+    const CFreal ovHPrev = 1./c.hPrev;
+    const CFreal coeff = (4./9.)*c.h*c.h*c.h/(c.h + c.hPrev);
+    for (CFuint i = 0; i < nbVars; ++i) {
+      c.req[i] = coeff*((c.work[i] - c.f[i])*ovH - (c.f[i] - c.fPrev[i])*ovHPrev);
+    }
+    err2 = weightedNorm(c, &c.req[0]);
+  }
+  CFreal err = (c.order == 1) ? err1 : err2;
+
+  // negative values of the positive variables are rejected as errors
+  for (CFuint i = 0; i < m_nbPositive; ++i) {
+    if (c.z[i] < -c.absTol[i]) {
+      err = std::max(err, 2.);
+    }
+  }
+
+  if (err > 1.) {
+    c.h *= std::max(0.2, 0.9*std::pow(err, -1./(c.order + 1.)));
+    startStep(c);
+    return;
+  }
+
+  // accepted step
+  c.yPrev.swap(c.y);
+  c.fPrev.swap(c.f);
+  std::copy(c.z.begin(), c.z.end(), c.y.begin());
+  std::copy(c.work.begin(), c.work.end(), c.f.begin());
+  c.t += c.h;
+  c.hPrev = c.h;
+  ++c.nbAccepted;
+  ++c.jacAge;
+  if (c.t >= m_dt*(1. - 1e-12)) {
+    c.t = m_dt;
+    finish(c, false);
+    return;
+  }
+
+  // order and step giving the largest step
+  const CFreal fac1 = 0.9*std::pow(std::max(err1, 1e-10), -0.5);
+  const CFreal fac2 = (err2 >= 0.) ? 0.9*std::pow(std::max(err2, 1e-10), -1./3.) : 0.;
+  c.order = (fac2 > fac1) ? 2 : 1;
+  c.h *= std::min(std::max(std::max(fac1, fac2), 0.2), 4.);
+
+  if (c.jacAge >= m_maxJacobianAge) {
+    requestJacobian(c);
+  }
+  else {
+    startStep(c);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::finish(ODE& c, const bool failed) const
+{
+  c.nbReq = 0;
+  c.phase = DONE;
+  c.failed = failed;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal StiffBDFIntegrator::weightedNorm(const ODE& c, const CFreal *const v) const
+{
+  const CFuint nbVars = m_nbVars;
+  CFreal sum = 0.;
+  for (CFuint i = 0; i < nbVars; ++i) {
+    const CFreal vw = v[i]/(m_relTol*std::abs(c.y[i]) + c.absTol[i]);
+    sum += vw*vw;
+  }
+  return std::sqrt(sum/nbVars);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool StiffBDFIntegrator::factorize(const CFuint n, CFreal *const a, CFuint *const pivots)
+{
+  for (CFuint k = 0; k < n; ++k) {
+    CFuint p = k;
+    for (CFuint i = k+1; i < n; ++i) {
+      if (std::abs(a[i*n + k]) > std::abs(a[p*n + k])) p = i;
+    }
+    pivots[k] = p;
+    if (a[p*n + k] == 0.) return false;
+    if (p != k) {
+      for (CFuint j = 0; j < n; ++j) {
+	std::swap(a[k*n + j], a[p*n + j]);
+      }
+    }
+
+    const CFreal ovPivot = 1./a[k*n + k];
+    for (CFuint i = k+1; i < n; ++i) {
+      const CFreal l = a[i*n + k]*ovPivot;
+      a[i*n + k] = l;
+      for (CFuint j = k+1; j < n; ++j) {
+	a[i*n + j] -= l*a[k*n + j];
+      }
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StiffBDFIntegrator::solve(const CFuint n, const CFreal *const a,
+			   const CFuint *const pivots, CFreal *const b)
+{
+  // the rows have been swapped entirely, multipliers included
+  for (CFuint k = 0; k < n; ++k) {
+    std::swap(b[k], b[pivots[k]]);
+  }
+  for (CFuint k = 0; k < n; ++k) {
+    for (CFuint i = k+1; i < n; ++i) {
+      b[i] -= a[i*n + k]*b[k];
+    }
+  }
+  for (CFuint k = n; k-- > 0;) {
+    for (CFuint j = k+1; j < n; ++j) {
+      b[k] -= a[k*n + j]*b[j];
+    }
+    b[k] /= a[k*n + k];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace FiniteVolume
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,207 @@
+#ifndef COOLFluiD_Numerics_FiniteVolume_StiffBDFIntegrator_hh
+#define COOLFluiD_Numerics_FiniteVolume_StiffBDFIntegrator_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Common/COOLFluiD.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace FiniteVolume {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class integrates stiff ODE systems y' = f(y) over a time step with
+ * a variable step BDF of order 1 or 2 (the A-stable ones). The Jacobian is
+ * computed by finite differences and reused along the steps until the
+ * Newton iterations stop converging. Systems whose change over the time
+ * step is within the tolerance take one explicit step.
+ *
+ * The integrator does not evaluate f: the state of each system (ODE)
+ * contains the points where f is requested (req) and the caller stores the
+ * results (res) before calling advance(), until no evaluation is requested
+ * anymore. The evaluations of many systems can so be done in one pass.
+ * Different systems can be advanced concurrently.
+ *
+ * @author Andrea Lani
+ *
+ */
+class StiffBDFIntegrator {
+public:
+
+  /// phases of the integration of a system
+  enum Phase {INIT=0, JACOBIAN=1, NEWTON=2, DONE=3};
+
+  /// integration data of a system
+  struct ODE {
+    /// phase of the integration
+    Phase phase;
+    /// flag telling if the integration has stopped before the end
+    bool failed;
+    /// scale of the perturbations of the positive variables
+    CFreal scale;
+    /// time reached
+    CFreal t;
+    /// current step
+    CFreal h;
+    /// previous step
+    CFreal hPrev;
+    /// current order
+    CFuint order;
+    /// number of accepted steps
+    CFuint nbAccepted;
+    /// number of attempted steps
+    CFuint nbAttempts;
+    /// number of Newton iterations in the current step
+    CFuint nbIter;
+    /// number of steps since the Jacobian has been computed
+    CFuint jacAge;
+    /// norm of the last Newton correction
+    CFreal deltaNorm;
+    /// h*gamma of the factorized iteration matrix
+    CFreal hGamma;
+    /// absolute tolerances
+    std::vector<CFreal> absTol;
+    /// solution and its time derivative
+    std::vector<CFreal> y;
+    std::vector<CFreal> f;
+    /// previous solution and its time derivative
+    std::vector<CFreal> yPrev;
+    std::vector<CFreal> fPrev;
+    /// Newton iterate and constant part of the BDF formula
+    std::vector<CFreal> z;
+    std::vector<CFreal> psi;
+    /// Jacobian and LU factors of the iteration matrix I - h*gamma*J
+    std::vector<CFreal> jacob;
+    std::vector<CFreal> lu;
+    std::vector<CFuint> pivots;
+    /// perturbations for the Jacobian
+    std::vector<CFreal> pert;
+    /// points where f is requested and results
+    CFuint nbReq;
+    std::vector<CFreal> req;
+    std::vector<CFreal> res;
+    /// work array
+    std::vector<CFreal> work;
+  };
+
+  /**
+   * Constructor
+   */
+  StiffBDFIntegrator();
+
+  /**
+   * Default destructor
+   */
+  ~StiffBDFIntegrator();
+
+  /**
+   * Set up the integrator
+   * @param nbVars          size of y
+   * @param nbPositive      number of first variables which must stay positive
+   * @param relTol          relative tolerance
+   * @param maxSteps        max number of steps per system
+   * @param maxJacobianAge  number of steps after which the Jacobian is recomputed
+   */
+  void setup(const CFuint nbVars, const CFuint nbPositive, const CFreal relTol,
+	     const CFuint maxSteps, const CFuint maxJacobianAge);
+
+  /**
+   * Set the time step over which the systems are integrated
+   */
+  void setTimeStep(const CFreal dt) {m_dt = dt;}
+
+  /**
+   * @return the size of y
+   */
+  CFuint getNbVars() const {return m_nbVars;}
+
+  /**
+   * Allocate the storage of a system
+   */
+  void resize(ODE& ode) const;
+
+  /**
+   * Start the integration of a system, whose y, absTol and scale are set:
+   * f is requested at y
+   */
+  void start(ODE& ode) const;
+
+  /**
+   * Advance the integration of a system with the results of the last
+   * requested evaluations: new evaluations are requested or the
+   * integration is done (ode.nbReq == 0)
+   */
+  void advance(ODE& ode) const;
+
+private: // helper functions
+
+  /// process the derivative at the initial point
+  void processInit(ODE& c) const;
+
+  /// process the perturbed derivatives for the Jacobian
+  void processJacobian(ODE& c) const;
+
+  /// process the derivative at the Newton iterate
+  void processNewton(ODE& c) const;
+
+  /// request the perturbed derivatives for the Jacobian at c.y
+  void requestJacobian(ODE& c) const;
+
+  /// start a step of size c.h from c.y
+  void startStep(ODE& c) const;
+
+  /// end the integration of the system
+  void finish(ODE& c, const bool failed) const;
+
+  /// @return the weighted RMS norm of v
+  CFreal weightedNorm(const ODE& c, const CFreal *const v) const;
+
+  /// LU factorization with partial pivoting of the n x n matrix a
+  /// @return false if a is singular
+  static bool factorize(const CFuint n, CFreal *const a, CFuint *const pivots);
+
+  /// solve the system factorized by factorize(), b being overwritten by x
+  static void solve(const CFuint n, const CFreal *const a,
+		    const CFuint *const pivots, CFreal *const b);
+
+private: //data
+
+  /// size of y
+  CFuint m_nbVars;
+
+  /// number of first variables which must stay positive
+  CFuint m_nbPositive;
+
+  /// relative tolerance
+  CFreal m_relTol;
+
+  /// max number of steps per system
+  CFuint m_maxSteps;
+
+  /// number of steps after which the Jacobian is recomputed
+  CFuint m_maxJacobianAge;
+
+  /// integration time
+  CFreal m_dt;
+
+}; // end of class StiffBDFIntegrator
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace FiniteVolume
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Numerics_FiniteVolume_StiffBDFIntegrator_hh
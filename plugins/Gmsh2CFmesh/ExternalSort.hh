@@ -0,0 +1,259 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_IO_Gmsh2CFmesh_ExternalSort_hh
+#define COOLFluiD_IO_Gmsh2CFmesh_ExternalSort_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <fstream>
+#include <queue>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "Common/FilesystemException.hh"
+#include "Common/StringOps.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace IO {
+
+    namespace Gmsh2CFmesh {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class sorts a sequence of fixed size records which can be larger
+ * than the available memory. At most chunkSize records are kept in memory:
+ * when the buffer is full, it is sorted and written to a temporary run file,
+ * and the runs are merged when the records are read back.
+ * RECORD must be copyable with memcpy and define operator<.
+ */
+template <typename RECORD>
+class ExternalSort {
+public:
+
+  /**
+   * Constructor
+   * @param prefix    prefix of the temporary run files
+   * @param chunkSize maximum number of records kept in memory
+   */
+  ExternalSort(const std::string& prefix, const CFuint chunkSize) :
+    m_prefix(prefix),
+    m_chunkSize(std::max(chunkSize, static_cast<CFuint>(1))),
+    m_size(0),
+    m_buffer(),
+    m_bufferPos(0),
+    m_runBufferSize(0),
+    m_runNames(),
+    m_runs(),
+    m_runBuffers(),
+    m_runPos(),
+    m_heap()
+  {
+  }
+
+  /**
+   * Destructor removes the temporary run files
+   */
+  ~ExternalSort()
+  {
+    for (CFuint i = 0; i < m_runs.size(); ++i) {
+      delete m_runs[i];
+    }
+    for (CFuint i = 0; i < m_runNames.size(); ++i) {
+      boost::filesystem::remove(m_runNames[i]);
+    }
+  }
+
+  /**
+   * Adds a record to the sequence
+   */
+  void add(const RECORD& record)
+  {
+    if (m_buffer.size() == m_chunkSize) {
+      flushRun();
+    }
+    m_buffer.push_back(record);
+    ++m_size;
+  }
+
+  /**
+   * Ends the insertion: from now on the records can only be read with next()
+   */
+  void finish()
+  {
+    if (m_runNames.empty()) {
+      // everything fits in memory
+      std::sort(m_buffer.begin(), m_buffer.end());
+      m_bufferPos = 0;
+      return;
+    }
+
+    if (!m_buffer.empty()) {
+      flushRun();
+    }
+    std::vector<RECORD>().swap(m_buffer);
+
+    // the memory is shared among the read buffers of the runs
+    const CFuint nbRuns = m_runNames.size();
+    m_runBufferSize = std::max(m_chunkSize/nbRuns, static_cast<CFuint>(1));
+    m_runs.resize(nbRuns);
+    m_runBuffers.resize(nbRuns);
+    m_runPos.resize(nbRuns);
+    for (CFuint iRun = 0; iRun < nbRuns; ++iRun) {
+      m_runs[iRun] = new std::ifstream(m_runNames[iRun].c_str(), std::ios::binary);
+      if (!m_runs[iRun]->is_open()) {
+	throw Common::FilesystemException
+	  (FromHere(), "ExternalSort cannot open " + m_runNames[iRun]);
+      }
+      if (fillBuffer(iRun)) {
+	m_heap.push(HeapEntry(m_runBuffers[iRun][0], iRun));
+      }
+    }
+  }
+
+  /**
+   * Gets the next record in ascending order
+   * @return false if all the records have been read
+   */
+  bool next(RECORD& record)
+  {
+    if (m_runNames.empty()) {
+      if (m_bufferPos == m_buffer.size()) return false;
+      record = m_buffer[m_bufferPos++];
+      return true;
+    }
+
+    if (m_heap.empty()) return false;
+
+    const CFuint iRun = m_heap.top().second;
+    record = m_heap.top().first;
+    m_heap.pop();
+
+    if (++m_runPos[iRun] < m_runBuffers[iRun].size() || fillBuffer(iRun)) {
+      m_heap.push(HeapEntry(m_runBuffers[iRun][m_runPos[iRun]], iRun));
+    }
+    return true;
+  }
+
+  /**
+   * Gets the number of records added to the sequence
+   */
+  CFuint getSize() const
+  {
+    return m_size;
+  }
+
+  /**
+   * Gets the number of runs written to disk
+   */
+  CFuint getNbRuns() const
+  {
+    return m_runNames.size();
+  }
+
+private:
+
+  /// a record with the run it has been read from
+  typedef std::pair<RECORD, CFuint> HeapEntry;
+
+  /// orders the heap so that the smallest record is on top
+  struct GreaterEntry {
+    bool operator() (const HeapEntry& a, const HeapEntry& b) const
+    {
+      return b.first < a.first;
+    }
+  };
+
+  /**
+   * Sorts the buffer and writes it to a new run file
+   */
+  void flushRun()
+  {
+    std::sort(m_buffer.begin(), m_buffer.end());
+
+    const std::string runName = m_prefix + ".run" +
+      Common::StringOps::to_str(m_runNames.size());
+    std::ofstream fout(runName.c_str(), std::ios::binary);
+    if (!fout.is_open()) {
+      throw Common::FilesystemException
+	(FromHere(), "ExternalSort cannot open " + runName);
+    }
+    m_runNames.push_back(runName);
+
+    fout.write(reinterpret_cast<const char*>(&m_buffer[0]),
+	       m_buffer.size()*sizeof(RECORD));
+    fout.close();
+    m_buffer.clear();
+  }
+
+  /**
+   * Reads the next block of records of the given run
+   * @return false if the run is exhausted
+   */
+  bool fillBuffer(const CFuint iRun)
+  {
+    std::vector<RECORD>& buf = m_runBuffers[iRun];
+    buf.resize(m_runBufferSize);
+    m_runs[iRun]->read(reinterpret_cast<char*>(&buf[0]), buf.size()*sizeof(RECORD));
+    buf.resize(m_runs[iRun]->gcount()/sizeof(RECORD));
+    m_runPos[iRun] = 0;
+    return !buf.empty();
+  }
+
+private:
+
+  /// prefix of the run files
+  std::string m_prefix;
+
+  /// maximum number of records in memory
+  CFuint m_chunkSize;
+
+  /// total number of records
+  CFuint m_size;
+
+  /// records not yet written to a run (or all of them, if no run was needed)
+  std::vector<RECORD> m_buffer;
+
+  /// position of the next record to read if no run was needed
+  CFuint m_bufferPos;
+
+  /// number of records read at once from each run
+  CFuint m_runBufferSize;
+
+  /// names of the run files
+  std::vector<std::string> m_runNames;
+
+  /// run files being merged
+  std::vector<std::ifstream*> m_runs;
+
+  /// read buffers of the runs
+  std::vector<std::vector<RECORD> > m_runBuffers;
+
+  /// position of the next record in each read buffer
+  std::vector<CFuint> m_runPos;
+
+  /// smallest unread record of each run
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>, GreaterEntry> m_heap;
+
+}; // end class ExternalSort
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace Gmsh2CFmesh
+
+  } // namespace IO
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_IO_Gmsh2CFmesh_ExternalSort_hh
@@ -17,6 +17,9 @@
 #include "Environment/FileHandlerInput.hh"
 #include "Environment/FileHandlerOutput.hh"
 #include "Common/CFMap.hh"
+#include "Common/FilesystemException.hh"
+#include "Framework/CFGeoEnt.hh"
+#include "Framework/LocalConnectionData.hh"
 #include "Gmsh2CFmesh/Gmsh2CFmeshConverter.hh"
 #include "Gmsh2CFmesh/Gmsh2CFmesh.hh"
 
@@ -44,6 +47,16 @@ gmsh2CFmeshConverterProvider("Gmsh2CFmesh");
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Gmsh2CFmeshConverter::defineConfigOptions(Config::OptionList& options)
+{
+  options.addConfigOption< bool >
+    ("Streaming","Convert serially with bounded memory to a binary CFmesh (Gmsh 2 ASCII files, cell centered FVM only).");
+  options.addConfigOption< CFuint >
+    ("ChunkSize","Maximum number of cells or faces kept in memory by the streaming conversion.");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 Gmsh2CFmeshConverter::Gmsh2CFmeshConverter (const std::string& name)
 : MeshFormatConverter(name),
   _fileFormatVersion(0),
@@ -65,8 +78,15 @@ Gmsh2CFmeshConverter::Gmsh2CFmeshConverter (const std::string& name)
   _nodesPerElemTypeTable(31),
   _orderPerElemTypeTable(31),
   _dimPerElemTypeTable(31),
-  _mapNodeIdxPerElemTypeTable(31)
+  _mapNodeIdxPerElemTypeTable(31),
+  _streaming(false),
+  _chunkSize(1000000)
 {
+  addConfigOptionsTo(this);
+
+  setParameter("Streaming",&_streaming);
+  setParameter("ChunkSize",&_chunkSize);
+
   // Build the nbNodes per ElemTypeTable
   _nodesPerElemTypeTable[0]  = 2;  // line
   _nodesPerElemTypeTable[1]  = 3;  // triangle
@@ -1584,7 +1604,7 @@ void Gmsh2CFmeshConverter::writeDiscontinuousTrsData(ofstream& fout)
 
             cf_assert (count <= nbNodesPerFace);
 
-#ifdef NDEBUG
+#ifndef NDEBUG
             // Double check the algorithm above
             vector<CFuint> uniq_ele (elemens);
             uniq_ele.erase(std::unique(uniq_ele.begin(), uniq_ele.end()),
@@ -1667,8 +1687,6 @@ void Gmsh2CFmeshConverter::writeDiscontinuousTrsData(ofstream& fout)
 
 
             }
-
-            fout.flush ();
          }
       }
    }
@@ -1676,6 +1694,618 @@ void Gmsh2CFmeshConverter::writeDiscontinuousTrsData(ofstream& fout)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Gmsh2CFmeshConverter::convert(const boost::filesystem::path& fromFilepath,
+				   const boost::filesystem::path& filepath)
+{
+  CFAUTOTRACE;
+
+  if (_streaming) {
+    if (_fileFormatVersion == 0) {
+      checkFormat(fromFilepath);
+    }
+    
+    if (_fileFormatVersion == 2 && isDiscontinuous()) {
+      convertStreaming(fromFilepath, filepath);
+      return;
+    }
+    
+    CFLog(WARN, "Gmsh2CFmeshConverter::convert() => streaming needs a Gmsh 2 file "
+	  << "and a cell centered FVM mesh: the conversion is done in memory\n");
+  }
+  
+  MeshFormatConverter::convert(fromFilepath, filepath);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Writes a key padded to 30 characters, as MPIIOFunctions::writeKeyValue()
+/// does for the binary CFmesh writer
+static void writeBinaryKey(ofstream& fout, const std::string& key)
+{
+  cf_assert(key.size() < 30);
+  if (key != "\n") {
+    std::string buf(30, ' ');
+    buf.replace(0, key.size(), key);
+    fout.write(&buf[0], buf.size());
+  }
+  else {
+    fout.write(&key[0], key.size());
+  }
+}
+
+/// Writes an array of values in binary format
+template <typename T>
+static void writeBinary(ofstream& fout, const T* values, const CFuint size)
+{
+  fout.write(reinterpret_cast<const char*>(values), size*sizeof(T));
+}
+
+/// Writes a key followed by a value in binary format
+template <typename T>
+static void writeBinaryKeyValue(ofstream& fout, const std::string& key, const T value)
+{
+  writeBinaryKey(fout, key);
+  writeBinary(fout, &value, 1);
+}
+
+/// Reads one value written by writeBinary()
+template <typename T>
+static T readBinary(ifstream& fin)
+{
+  T value = T();
+  fin.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+
+/// Opens a temporary binary file
+template <typename STREAM>
+static void openTmpFile(STREAM& file, const std::string& name)
+{
+  file.open(name.c_str(), ios::binary);
+  if (!file.is_open()) {
+    throw FilesystemException (FromHere(), "Cannot open temporary file " + name);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint Gmsh2CFmeshConverter::getNbFaceVertices(const CFuint typeID) const
+{
+  switch (_dimPerElemTypeTable[typeID]) {
+  case DIM_0D:
+    return 1;
+  case DIM_1D:
+    return 2;
+  default:
+    // quadrangle, P2 quadrangle, P2 incomplete quadrangle
+    return (typeID == 2 || typeID == 9 || typeID == 15) ? 4 : 3;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Gmsh2CFmeshConverter::convertStreaming(const boost::filesystem::path& fromFilepath,
+					    const boost::filesystem::path& filepath)
+{
+  CFAUTOTRACE;
+
+  using namespace boost::filesystem;
+  path meshFile = change_extension(fromFilepath, getOriginExtension());
+
+  Stopwatch<WallTime> stp;
+  stp.start();
+
+  Common::SelfRegistPtr<Environment::FileHandlerInput>* fhandle =
+    Environment::SingleBehaviorFactory<Environment::FileHandlerInput>::getInstance().createPtr();
+  ifstream& fin = (*fhandle)->open(meshFile);
+
+  // all the data which do not fit in memory are spooled to temporary files
+  const std::string tmpPrefix = filepath.string() + ".tmp";
+  const std::string nodeFileName = tmpPrefix + ".nodes";
+  const std::string cellFileName = tmpPrefix + ".cells";
+  vector<std::string> tmpFiles;
+  tmpFiles.push_back(nodeFileName);
+
+  CFuint lineNb = 0;
+  std::string line;
+  vector<std::string> words;
+
+  map<CFuint,CFuint> physTagToDim;
+  map<CFuint,std::string> physTagToName;
+  // patches are the physical regions of dimension dim-1
+  map<CFuint,CFuint> physTagToPatch;
+  vector<std::string> patchNames;
+
+  CFuint nbNodes = 0;
+  bool contiguousNodes = true;
+  CFMap<CFuint,CFuint> gmshNodesNumberingMap;
+
+  const CFuint maxNbElementTypes = _nodesPerElemTypeTable.size();
+  vector<CFuint> nbElemPerType(maxNbElementTypes, 0);
+  vector<ofstream*> typeFiles(maxNbElementTypes, CFNULL);
+  vector<ofstream*> patchFiles;
+  vector<CFuint> nbFacesPerPatch;
+  vector<CFuint> maxNbNodesPerPatch;
+
+  vector<CFuint> cellNodes;
+  vector<CFreal> coord(_dimension);
+
+  try {
+    while (getline(fin, line)) {
+      ++lineNb;
+      words = Common::StringOps::getWords(line);
+      if (words.empty()) continue;
+
+      if (words[0] == "$MeshFormat") {
+        getGmshWordsFromLine(fin,line,lineNb,words);
+        if (words.size() > 1 && words[1] != "0") {
+	  callGmshFileError("Streaming conversion needs a Gmsh ASCII file", lineNb, meshFile);
+        }
+      }
+      else if (words[0] == "$PhysicalNames") {
+        getGmshWordsFromLine(fin,line,lineNb,words);
+        const CFuint nbPhysicalNames = StringOps::from_str<CFuint>(words[0]);
+        for (CFuint i = 0; i < nbPhysicalNames; ++i) {
+	  getGmshWordsFromLine(fin,line,lineNb,words);
+	  const CFuint physTag = StringOps::from_str<CFuint>(words[1]);
+	  physTagToDim[physTag] = StringOps::from_str<CFuint>(words[0]);
+	  // Clip off the leading and trailing quote
+	  physTagToName[physTag] = words[2].substr(1,words[2].length()-2);
+        }
+
+        for (map<CFuint,CFuint>::const_iterator it = physTagToDim.begin(); it != physTagToDim.end(); ++it) {
+	  if (it->second == _dimension-1) {
+	    const std::string name = physTagToName[it->first];
+	    if (name.size() >= 30) {
+	      callGmshFileError("Physical name " + name + " is too long for a binary CFmesh", lineNb, meshFile);
+	    }
+	    physTagToPatch[it->first] = patchNames.size();
+	    patchNames.push_back(name);
+	  }
+        }
+
+        const CFuint nbPatches = patchNames.size();
+        patchFiles.assign(nbPatches, CFNULL);
+        nbFacesPerPatch.assign(nbPatches, 0);
+        maxNbNodesPerPatch.assign(nbPatches, 0);
+        for (CFuint iPatch = 0; iPatch < nbPatches; ++iPatch) {
+	  const std::string name = tmpPrefix + ".patch" + StringOps::to_str(iPatch);
+	  tmpFiles.push_back(name);
+	  patchFiles[iPatch] = new ofstream();
+	  openTmpFile(*patchFiles[iPatch], name);
+        }
+      }
+      else if (words[0] == "$Nodes") {
+        getGmshWordsFromLine(fin,line,lineNb,words);
+        nbNodes = StringOps::from_str<CFuint>(words[0]);
+
+        ofstream nodeFile;
+        openTmpFile(nodeFile, nodeFileName);
+
+        vector<CFuint> gmshIDs;
+        for (CFuint j = 0; j < nbNodes; ++j) {
+	  getGmshWordsFromLine(fin,line,lineNb,words);
+	  const CFuint gmshID = StringOps::from_str<CFuint>(words[0]);
+	  // Gmsh numbers the nodes contiguously unless told otherwise:
+	  // the numbering map is only built for the other files
+	  if (contiguousNodes && gmshID != j+1) {
+	    contiguousNodes = false;
+	    gmshIDs.reserve(nbNodes);
+	    for (CFuint i = 0; i < j; ++i) {
+	      gmshIDs.push_back(i+1);
+	    }
+	  }
+	  if (!contiguousNodes) {
+	    gmshIDs.push_back(gmshID);
+	  }
+
+	  for (CFuint i = 0; i < _dimension; ++i) {
+	    coord[i] = StringOps::from_str<CFreal>(words[i+1]);
+	  }
+	  writeBinary(nodeFile, &coord[0], _dimension);
+        }
+        nodeFile.close();
+
+        if (!contiguousNodes) {
+	  CFLog(INFO, "Gmsh2CFmeshConverter::convertStreaming() => nodes are not "
+	        << "numbered contiguously: the node numbering map is kept in memory\n");
+	  gmshNodesNumberingMap.reserve(nbNodes);
+	  for (CFuint j = 0; j < nbNodes; ++j) {
+	    gmshNodesNumberingMap.insert(gmshIDs[j], j);
+	  }
+	  gmshNodesNumberingMap.sortKeys();
+        }
+      }
+      else if (words[0] == "$Elements") {
+        if (nbNodes == 0) {
+	  callGmshFileError("Malformed file format: $Elements found before $Nodes", lineNb, meshFile);
+        }
+
+        getGmshWordsFromLine(fin,line,lineNb,words);
+        const CFuint totalNbElements = StringOps::from_str<CFuint>(words[0]);
+
+        for (CFuint i = 0; i < totalNbElements; ++i) {
+	  getGmshWordsFromLine(fin,line,lineNb,words);
+	  const CFuint typeID = StringOps::from_str<CFuint>(words[1]) - 1;
+	  const CFuint nbTags = StringOps::from_str<CFuint>(words[2]);
+	  if (typeID >= maxNbElementTypes || nbTags == 0) {
+	    callGmshFileError("Unknown element type or missing physical tag", lineNb, meshFile);
+	  }
+
+	  const CFuint nbElemNodes = _nodesPerElemTypeTable[typeID];
+	  if (words.size() < 3 + nbTags + nbElemNodes) {
+	    callGmshFileError("The element connectivity has missing nodes", lineNb, meshFile);
+	  }
+
+	  const CFuint physTag = StringOps::from_str<CFuint>(words[3]);
+	  if (physTagToDim.find(physTag) == physTagToDim.end()) {
+	    callGmshFileError("Element with unknown physical region number", lineNb, meshFile);
+	  }
+
+	  cellNodes.resize(nbElemNodes);
+	  for (CFuint j = 0; j < nbElemNodes; ++j) {
+	    const CFuint gmshID = StringOps::from_str<CFuint>(words[3+nbTags+j]);
+	    if (contiguousNodes) {
+	      if (gmshID == 0 || gmshID > nbNodes) {
+	        callGmshFileError("Element with unknown node number", lineNb, meshFile);
+	      }
+	      cellNodes[j] = gmshID - 1;
+	    }
+	    else {
+	      cellNodes[j] = gmshNodesNumberingMap.find(gmshID);
+	    }
+	  }
+
+	  // If this is a volume cell (has the same dimension as the mesh)
+	  if (_dimPerElemTypeTable[typeID] == _dimension) {
+	    if (typeFiles[typeID] == CFNULL) {
+	      const std::string name = tmpPrefix + ".type" + StringOps::to_str(typeID);
+	      tmpFiles.push_back(name);
+	      typeFiles[typeID] = new ofstream();
+	      openTmpFile(*typeFiles[typeID], name);
+	    }
+
+	    // the nodes are stored in the COOLFluiD order
+	    for (CFuint j = 0; j < nbElemNodes; ++j) {
+	      const CFuint nodeID = cellNodes[_mapNodeIdxPerElemTypeTable[typeID][j]];
+	      writeBinary(*typeFiles[typeID], &nodeID, 1);
+	    }
+	    ++nbElemPerType[typeID];
+	  }
+	  else if (_dimPerElemTypeTable[typeID] == _dimension-1) {
+	    const CFuint iPatch = physTagToPatch.find(physTag)->second;
+	    writeBinary(*patchFiles[iPatch], &typeID, 1);
+	    writeBinary(*patchFiles[iPatch], &nbElemNodes, 1);
+	    writeBinary(*patchFiles[iPatch], &cellNodes[0], nbElemNodes);
+	    ++nbFacesPerPatch[iPatch];
+	    maxNbNodesPerPatch[iPatch] = std::max(maxNbNodesPerPatch[iPatch], nbElemNodes);
+	  }
+        }
+      }
+    }
+
+    for (CFuint i = 0; i < typeFiles.size(); ++i) {
+      deletePtr(typeFiles[i]);
+    }
+    for (CFuint i = 0; i < patchFiles.size(); ++i) {
+      deletePtr(patchFiles[i]);
+    }
+    gmshNodesNumberingMap.clear();
+
+    // the cells are numbered by type, in increasing Gmsh type ID
+    vector<CFuint> typeIDs;
+    vector<CFuint> cellStart;
+    _nbCells = 0;
+    _order = 0;
+    for (CFuint i = 0; i < maxNbElementTypes; ++i) {
+      if (nbElemPerType[i] > 0) {
+        typeIDs.push_back(i);
+        cellStart.push_back(_nbCells);
+        _nbCells += nbElemPerType[i];
+        _order = std::max(_order, _orderPerElemTypeTable[i]);
+      }
+    }
+    if (_nbCells == 0 || nbNodes == 0) {
+      callGmshFileError("No nodes or cells found", lineNb, meshFile);
+    }
+
+    // the patches without faces are not written
+    vector<CFuint> patchIDs;
+    for (CFuint iPatch = 0; iPatch < patchNames.size(); ++iPatch) {
+      if (nbFacesPerPatch[iPatch] > 0) {
+        patchIDs.push_back(iPatch);
+      }
+      else {
+        CFLog(WARN, "Gmsh2CFmeshConverter::convertStreaming() => skipping empty patch "
+	      << patchNames[iPatch] << "\n");
+      }
+    }
+
+    tmpFiles.push_back(cellFileName);
+
+    matchBoundaryFaces(tmpPrefix, typeIDs, cellStart, patchNames.size());
+
+    ofstream fout;
+    fout.open(filepath.string().c_str(), ios::binary);
+    if (!fout.is_open()) {
+      throw FilesystemException (FromHere(), "Cannot open " + filepath.string());
+    }
+
+    CFuint nbVariables = getNbVariables();
+    if (nbVariables == 0) {
+      nbVariables = PhysicalModelStack::getActive()->getNbEq();
+    }
+
+    // same layout as the one of ParCFmeshBinaryFileWriter
+    writeBinaryKey(fout, "!COOLFLUID_VERSION ");
+    writeBinaryKey(fout, Environment::CFEnv::getInstance().getCFVersion());
+    writeBinaryKey(fout, "\n!CFMESH_FORMAT_VERSION ");
+    writeBinaryKey(fout, "1.3");
+
+    const CFuint nbNotUpdatable = 0;
+    writeBinaryKeyValue(fout, "\n!NB_DIM ", _dimension);
+    writeBinaryKeyValue(fout, "\n!NB_EQ ", nbVariables);
+    writeBinaryKeyValue(fout, "\n!NB_NODES ", nbNodes);
+    writeBinary(fout, &nbNotUpdatable, 1);
+    writeBinaryKeyValue(fout, "\n!NB_STATES ", _nbCells);
+    writeBinary(fout, &nbNotUpdatable, 1);
+    writeBinaryKeyValue(fout, "\n!NB_ELEM ", _nbCells);
+
+    const CFuint nbElementTypes = typeIDs.size();
+    writeBinaryKeyValue(fout, "\n!NB_ELEM_TYPES ", nbElementTypes);
+    writeBinaryKeyValue(fout, "\n!GEOM_POLYORDER ", _order);
+    writeBinaryKeyValue(fout, "\n!SOL_POLYORDER ", static_cast<CFuint>(CFPolyOrder::ORDER0));
+
+    writeBinaryKey(fout, "\n!ELEM_TYPES ");
+    for (CFuint k = 0; k < nbElementTypes; ++k) {
+      writeBinaryKey(fout, MapGeoEnt::identifyGeoEnt(_nodesPerElemTypeTable[typeIDs[k]],
+						     _orderPerElemTypeTable[typeIDs[k]],
+						     _dimension) + " ");
+    }
+
+    writeBinaryKey(fout, "\n!NB_ELEM_PER_TYPE ");
+    for (CFuint k = 0; k < nbElementTypes; ++k) {
+      writeBinary(fout, &nbElemPerType[typeIDs[k]], 1);
+    }
+
+    writeBinaryKey(fout, "\n!NB_NODES_PER_TYPE ");
+    for (CFuint k = 0; k < nbElementTypes; ++k) {
+      writeBinary(fout, &_nodesPerElemTypeTable[typeIDs[k]], 1);
+    }
+
+    const CFuint nbStatesPerCell = 1;
+    writeBinaryKey(fout, "\n!NB_STATES_PER_TYPE ");
+    for (CFuint k = 0; k < nbElementTypes; ++k) {
+      writeBinary(fout, &nbStatesPerCell, 1);
+    }
+
+    writeBinaryKey(fout, "\n!LIST_ELEM");
+    writeBinaryKey(fout, "\n");
+
+    // each cell is followed by its state ID (== cell ID)
+    for (CFuint k = 0; k < nbElementTypes; ++k) {
+      const CFuint nbCellNodes = _nodesPerElemTypeTable[typeIDs[k]];
+      const CFuint nbCellsPerChunk = std::max(_chunkSize/nbCellNodes, static_cast<CFuint>(1));
+      vector<CFuint> buf(nbCellsPerChunk*(nbCellNodes + 1));
+
+      ifstream typeFile;
+      openTmpFile(typeFile, tmpPrefix + ".type" + StringOps::to_str(typeIDs[k]));
+
+      CFuint cellID = cellStart[k];
+      for (CFuint iCell = 0; iCell < nbElemPerType[typeIDs[k]]; iCell += nbCellsPerChunk) {
+	const CFuint nbCells = std::min(nbCellsPerChunk, nbElemPerType[typeIDs[k]] - iCell);
+	for (CFuint c = 0; c < nbCells; ++c, ++cellID) {
+	  CFuint* cell = &buf[c*(nbCellNodes + 1)];
+	  typeFile.read(reinterpret_cast<char*>(cell), nbCellNodes*sizeof(CFuint));
+	  cell[nbCellNodes] = cellID;
+	}
+	writeBinary(fout, &buf[0], nbCells*(nbCellNodes + 1));
+      }
+    }
+
+    // only boundary TRS are listed
+    ifstream cellFile;
+    openTmpFile(cellFile, cellFileName);
+
+    const CFuint nbTRSs = patchIDs.size();
+    writeBinaryKeyValue(fout, "\n!NB_TRSs ", nbTRSs);
+
+    vector<CFuint> faceNodes;
+    vector<CFint> geo;
+    for (CFuint iTRS = 0; iTRS < nbTRSs; ++iTRS) {
+      const CFuint iPatch = patchIDs[iTRS];
+      writeBinaryKey(fout, "\n!TRS_NAME ");
+      writeBinaryKey(fout, patchNames[iPatch]);
+      writeBinaryKeyValue(fout, "\n!NB_TRs ", static_cast<CFuint>(1));
+      writeBinaryKeyValue(fout, "\n!NB_GEOM_ENTS ", nbFacesPerPatch[iPatch]);
+      writeBinaryKey(fout, "\n!GEOM_TYPE ");
+      writeBinaryKey(fout, CFGeoEnt::Convert::to_str(CFGeoEnt::FACE));
+
+      // maximum number of nodes and states per face, then the faces padded with -1
+      const CFuint maxNodesStates[2] = {maxNbNodesPerPatch[iPatch], nbStatesPerCell};
+      writeBinaryKey(fout, "\n!LIST_GEOM_ENT ");
+      writeBinary(fout, maxNodesStates, 2);
+      writeBinaryKey(fout, "\n");
+
+      ifstream patchFile;
+      openTmpFile(patchFile, tmpPrefix + ".patch" + StringOps::to_str(iPatch));
+
+      const CFuint stride = maxNodesStates[0] + maxNodesStates[1] + 2;
+      geo.resize(stride);
+      for (CFuint iFace = 0; iFace < nbFacesPerPatch[iPatch]; ++iFace) {
+	readBinary<CFuint>(patchFile); // type ID
+	const CFuint nbFaceNodes = readBinary<CFuint>(patchFile);
+	faceNodes.resize(nbFaceNodes);
+	patchFile.read(reinterpret_cast<char*>(&faceNodes[0]), nbFaceNodes*sizeof(CFuint));
+
+	geo.assign(stride, -1);
+	geo[0] = nbFaceNodes;
+	geo[1] = nbStatesPerCell;
+	for (CFuint j = 0; j < nbFaceNodes; ++j) {
+	  geo[2+j] = faceNodes[j];
+	}
+	geo[2+maxNodesStates[0]] = readBinary<CFuint>(cellFile);
+	writeBinary(fout, &geo[0], stride);
+      }
+    }
+
+    writeBinaryKey(fout, "\n!LIST_NODE");
+    writeBinaryKey(fout, "\n");
+
+    ifstream nodeFile;
+    openTmpFile(nodeFile, nodeFileName);
+    vector<char> buf(std::max(_chunkSize, static_cast<CFuint>(1))*sizeof(CFreal));
+    while (nodeFile.read(&buf[0], buf.size()) || nodeFile.gcount() > 0) {
+      fout.write(&buf[0], nodeFile.gcount());
+    }
+
+    // no solution: the terminator overwrites the newline after the flag,
+    // as in ParCFmeshBinaryFileWriter::writeStateList()
+    writeBinaryKeyValue(fout, "\n!LIST_STATE ", static_cast<CFuint>(0));
+    writeBinaryKey(fout, "\n!END");
+    fout.close();
+  }
+  catch (...) {
+    for (CFuint i = 0; i < typeFiles.size(); ++i) {
+      deletePtr(typeFiles[i]);
+    }
+    for (CFuint i = 0; i < patchFiles.size(); ++i) {
+      deletePtr(patchFiles[i]);
+    }
+    for (CFuint i = 0; i < tmpFiles.size(); ++i) {
+      boost::filesystem::remove(tmpFiles[i]);
+    }
+    (*fhandle)->close();
+    delete fhandle;
+    throw;
+  }
+
+  for (CFuint i = 0; i < tmpFiles.size(); ++i) {
+    boost::filesystem::remove(tmpFiles[i]);
+  }
+  (*fhandle)->close();
+  delete fhandle;
+
+  stp.stop();
+  CFLog(INFO, "Streaming conversion " << this->getName() << " took: " << stp.read()
+	<< "s: " << filepath.string() << " is a binary CFmesh, to be read with ParReadCFmeshBinary\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Gmsh2CFmeshConverter::matchBoundaryFaces(const std::string& tmpPrefix,
+					      const vector<CFuint>& typeIDs,
+					      const vector<CFuint>& cellStart,
+					      const CFuint nbPatches)
+{
+  CFAUTOTRACE;
+
+  // every face of every cell is keyed by its sorted vertices, which come
+  // first in the connectivity of the elements of any order
+  ExternalSort<FaceRecord> cellFaces(tmpPrefix + ".cellfaces", _chunkSize);
+  FaceRecord face;
+
+  for (CFuint k = 0; k < typeIDs.size(); ++k) {
+    const CFuint typeID = typeIDs[k];
+    const CFuint nbCellNodes = _nodesPerElemTypeTable[typeID];
+    const CFGeoShape::Type shape = CFGeoShape::Convert::to_enum
+      (MapGeoEnt::identifyGeoEnt(nbCellNodes, _orderPerElemTypeTable[typeID], _dimension));
+    const Table<CFuint>& faceVertices = *LocalConnectionData::getInstance().getFaceDofLocal
+      (shape, CFPolyOrder::ORDER1, NODE, CFPolyForm::LAGRANGE);
+
+    ifstream typeFile;
+    openTmpFile(typeFile, tmpPrefix + ".type" + StringOps::to_str(typeID));
+
+    const CFuint nbCellsPerChunk = std::max(_chunkSize/nbCellNodes, static_cast<CFuint>(1));
+    vector<CFuint> buf(nbCellsPerChunk*nbCellNodes);
+    CFuint cellID = cellStart[k];
+    while (typeFile.read(reinterpret_cast<char*>(&buf[0]), buf.size()*sizeof(CFuint)) ||
+	   typeFile.gcount() > 0) {
+      const CFuint nbCells = typeFile.gcount()/(nbCellNodes*sizeof(CFuint));
+      for (CFuint c = 0; c < nbCells; ++c, ++cellID) {
+	const CFuint* cell = &buf[c*nbCellNodes];
+	for (CFuint iFace = 0; iFace < faceVertices.nbRows(); ++iFace) {
+	  const CFuint nbVertices = faceVertices.nbCols(iFace);
+	  cf_assert(nbVertices <= 4);
+	  std::fill(face.nodes, face.nodes + 4, static_cast<CFuint>(-1));
+	  for (CFuint j = 0; j < nbVertices; ++j) {
+	    face.nodes[j] = cell[faceVertices(iFace,j)];
+	  }
+	  std::sort(face.nodes, face.nodes + nbVertices);
+	  face.id = cellID;
+	  cellFaces.add(face);
+	}
+      }
+    }
+  }
+  cellFaces.finish();
+
+  // the boundary faces are numbered patch by patch
+  ExternalSort<FaceRecord> boundaryFaces(tmpPrefix + ".bfaces", _chunkSize);
+  vector<CFuint> faceNodes;
+  CFuint faceID = 0;
+  for (CFuint iPatch = 0; iPatch < nbPatches; ++iPatch) {
+    ifstream patchFile;
+    openTmpFile(patchFile, tmpPrefix + ".patch" + StringOps::to_str(iPatch));
+
+    while (true) {
+      const CFuint typeID = readBinary<CFuint>(patchFile);
+      if (!patchFile) break;
+      const CFuint nbFaceNodes = readBinary<CFuint>(patchFile);
+      faceNodes.resize(nbFaceNodes);
+      patchFile.read(reinterpret_cast<char*>(&faceNodes[0]), nbFaceNodes*sizeof(CFuint));
+
+      const CFuint nbVertices = getNbFaceVertices(typeID);
+      std::fill(face.nodes, face.nodes + 4, static_cast<CFuint>(-1));
+      std::copy(faceNodes.begin(), faceNodes.begin() + nbVertices, face.nodes);
+      std::sort(face.nodes, face.nodes + nbVertices);
+      face.id = faceID++;
+      boundaryFaces.add(face);
+    }
+  }
+  boundaryFaces.finish();
+
+  // merge the two sorted sequences: a boundary face belongs to the first
+  // cell (i.e. the one with the lowest ID) having a face with the same vertices
+  ExternalSort<FaceRecord> faceToCell(tmpPrefix + ".matched", _chunkSize);
+  FaceRecord cellFace;
+  FaceRecord match;
+  std::fill(match.nodes, match.nodes + 4, static_cast<CFuint>(0));
+  CFuint nbUnmatched = 0;
+  bool hasCellFace = cellFaces.next(cellFace);
+  while (boundaryFaces.next(face)) {
+    while (hasCellFace && cellFace.hasSmallerNodes(face)) {
+      hasCellFace = cellFaces.next(cellFace);
+    }
+
+    if (hasCellFace && cellFace.hasSameNodes(face)) {
+      match.nodes[0] = face.id;
+      match.id = cellFace.id;
+      faceToCell.add(match);
+    }
+    else {
+      ++nbUnmatched;
+    }
+  }
+
+  if (nbUnmatched > 0) {
+    throw BadFormatException
+      (FromHere(), StringOps::to_str(nbUnmatched) + " boundary faces do not belong to any cell");
+  }
+  faceToCell.finish();
+
+  ofstream cellFile;
+  openTmpFile(cellFile, tmpPrefix + ".cells");
+  while (faceToCell.next(match)) {
+    writeBinary(cellFile, &match.id, 1);
+  }
+
+  CFLog(VERBOSE, "Gmsh2CFmeshConverter::matchBoundaryFaces() => " << faceID
+	<< " boundary faces matched using " << cellFaces.getNbRuns() << " sorted runs\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Gmsh2CFmeshConverter::readFiles(const boost::filesystem::path& filepath)
 {
   CFAUTOTRACE;
@@ -13,6 +13,7 @@
 
 #include "Framework/MeshFormatConverter.hh"
 #include "ElementTypeGmsh.hh"
+#include "ExternalSort.hh"
 #include "Common/NotImplementedException.hh"
 #include "Common/CFMultiMap.hh"
 
@@ -222,6 +223,12 @@ public:
 
 public:
 
+  /**
+   * Defines the Config Option's of this class
+   * @param options a OptionList where to add the Option's
+   */
+  static void defineConfigOptions(Config::OptionList& options);
+
   /**
    * Constructor
    */
@@ -238,6 +245,13 @@ public:
    */
   void checkFormat(const boost::filesystem::path& filepath);
 
+  /**
+   * Converts the Gmsh file to CFmesh. In streaming mode the file is
+   * converted with bounded memory and written in binary CFmesh format.
+   */
+  void convert(const boost::filesystem::path& fromFilepath,
+               const boost::filesystem::path& filepath);
+
   /**
    * Writes the data read to the original format.
    * Useful for debugging purposes.
@@ -306,6 +320,65 @@ protected:
 
 private:
 
+  /**
+   * Face identified by the sorted IDs of its vertices (unused entries are
+   * set to -1), together with a cell or boundary face ID
+   */
+  struct FaceRecord {
+    CFuint nodes[4];
+    CFuint id;
+
+    bool hasSmallerNodes(const FaceRecord& other) const
+    {
+      for (CFuint i = 0; i < 4; ++i) {
+        if (nodes[i] != other.nodes[i]) return nodes[i] < other.nodes[i];
+      }
+      return false;
+    }
+
+    bool hasSameNodes(const FaceRecord& other) const
+    {
+      return std::equal(nodes, nodes + 4, other.nodes);
+    }
+
+    bool operator< (const FaceRecord& other) const
+    {
+      if (hasSameNodes(other)) return id < other.id;
+      return hasSmallerNodes(other);
+    }
+  };
+
+  /**
+   * Converts a Gmsh version 2 ASCII file to a binary CFmesh file for
+   * cell centered FVM, keeping at most _chunkSize records in memory.
+   * Cells and boundary faces are read in one pass and spooled to temporary
+   * files, the boundary faces are matched to their cells by an external
+   * sort on the face vertices and the binary CFmesh is assembled from the
+   * temporary files.
+   * The conversion is serial: in parallel runs it is done by rank 0 only,
+   * like the in-memory one, while the other ranks wait for the CFmesh file.
+   */
+  void convertStreaming(const boost::filesystem::path& fromFilepath,
+                        const boost::filesystem::path& filepath);
+
+  /**
+   * Matches each boundary face to the cell it belongs to and writes the
+   * cell IDs, ordered by boundary face, to the file tmpPrefix.cells
+   * @param tmpPrefix  prefix of the temporary files
+   * @param typeIDs    Gmsh type IDs of the cell types
+   * @param cellStart  first cell ID of each cell type
+   * @param nbPatches  number of patches with boundary faces
+   */
+  void matchBoundaryFaces(const std::string& tmpPrefix,
+                          const std::vector<CFuint>& typeIDs,
+                          const std::vector<CFuint>& cellStart,
+                          const CFuint nbPatches);
+
+  /**
+   * Gets the number of vertices of a Gmsh element of dimension dim-1
+   */
+  CFuint getNbFaceVertices(const CFuint typeID) const;
+
   /**
    * Reads the Gmsh file in old file format
    *
@@ -455,6 +528,12 @@ private:
 
   // node element map
   Common::CFMultiMap<CFuint,CFuint> m_nodeElement;
+
+  /// flag telling to convert with bounded memory to a binary CFmesh
+  bool                            _streaming;
+
+  /// maximum number of records kept in memory in streaming mode
+  CFuint                          _chunkSize;
 }; // end class Gmsh2CFmeshConverter
 
 //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,58 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_InSituExtraction_hh
+#define COOLFluiD_InSituExtraction_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Environment/ModuleRegister.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace InSituExtraction {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class defines the Module InSituExtraction
+ */
+class InSituExtractionModule : public Environment::ModuleRegister<InSituExtractionModule> {
+public:
+
+  /**
+   * Static function that returns the module name.
+   * Must be implemented for the ModuleRegister template
+   * @return name of the module
+   */
+  static std::string getModuleName()
+  {
+    return "InSituExtraction";
+  }
+
+  /**
+   * Static function that returns the description of the module.
+   * Must be implemented for the ModuleRegister template
+   * @return descripton of the module
+   */
+  static std::string getModuleDescription()
+  {
+    return "This module implements in-situ extraction of probe and slice time series.";
+  }
+
+}; // end InSituExtractionModule
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace InSituExtraction
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_InSituExtraction_hh
@@ -0,0 +1,554 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cmath>
+#include <set>
+
+#include "Common/PE.hh"
+#include "Common/BadValueException.hh"
+
+#ifdef CF_HAVE_MPI
+#include "Common/MPI/MPIStructDef.hh"
+#endif
+
+#include "Environment/DirPaths.hh"
+
+#include "Framework/MethodCommandProvider.hh"
+#include "Framework/MeshData.hh"
+#include "Framework/LocalConnectionData.hh"
+#include "Framework/PhysicalModel.hh"
+#include "Framework/PathAppender.hh"
+#include "Framework/SubSystemStatus.hh"
+
+#include "InSituExtraction/InSituExtraction.hh"
+#include "InSituExtraction/ProbeSliceExtraction.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace boost::filesystem;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Framework;
+using namespace COOLFluiD::MathTools;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace InSituExtraction {
+
+//////////////////////////////////////////////////////////////////////////////
+
+MethodCommandProvider<ProbeSliceExtraction, DataProcessingData, InSituExtractionModule>
+probeSliceExtractionProvider("ProbeSliceExtraction");
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::defineConfigOptions(Config::OptionList& options)
+{
+  options.addConfigOption< std::string >("OutputFile","Name of the binary output file (one per process).");
+  options.addConfigOption< std::vector<CFreal> >("ProbeCoords","Coordinates of the probe points (x0 y0 [z0] x1 y1 [z1] ...).");
+  options.addConfigOption< std::vector<CFreal> >("SlicePlanes","Point and normal of the slice planes (px py [pz] nx ny [nz] ...).");
+  options.addConfigOption< CFuint >("FlushRate","Number of samples to buffer before writing to file.");
+  options.addConfigOption< bool >("Nodal","Interpolate the nodal states (e.g. for cell centered schemes).");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ProbeSliceExtraction::ProbeSliceExtraction(const std::string& name) :
+  DataProcessingCom(name),
+  socket_nodes("nodes"),
+  socket_states("states"),
+  m_sockets(),
+  m_cellBuilder(),
+  m_writer(),
+  m_entryInfo(),
+  m_entryPtr(),
+  m_stateIDs(),
+  m_weights()
+{
+  addConfigOptionsTo(this);
+  
+  m_outputFile = "probes-slices.bin";
+  setParameter("OutputFile",&m_outputFile);
+  
+  m_probeCoords = vector<CFreal>();
+  setParameter("ProbeCoords",&m_probeCoords);
+  
+  m_slicePlanes = vector<CFreal>();
+  setParameter("SlicePlanes",&m_slicePlanes);
+  
+  m_flushRate = 100;
+  setParameter("FlushRate",&m_flushRate);
+  
+  m_nodal = false;
+  setParameter("Nodal",&m_nodal);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ProbeSliceExtraction::~ProbeSliceExtraction()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::configure ( Config::ConfigArgs& args )
+{
+  DataProcessingCom::configure(args);
+  
+  if (m_nodal) {
+    m_sockets.createSocketSink<RealVector>("nstates");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<Common::SafePtr<BaseDataSocketSink> >
+ProbeSliceExtraction::needsSockets()
+{
+  std::vector<Common::SafePtr<BaseDataSocketSink> > result = m_sockets.getAllSinkSockets();
+  result.push_back(&socket_nodes);
+  result.push_back(&socket_states);
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::setup()
+{
+  CFAUTOTRACE;
+  
+  DataProcessingCom::setup();
+  
+  m_cellBuilder.setup();
+  
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  if (m_probeCoords.size()%dim != 0) {
+    throw BadValueException (FromHere(), "ProbeSliceExtraction: ProbeCoords size is not a multiple of the dimension");
+  }
+  if (m_slicePlanes.size()%(2*dim) != 0) {
+    throw BadValueException (FromHere(), "ProbeSliceExtraction: SlicePlanes size is not a multiple of 2*dimension");
+  }
+  
+  m_entryInfo.clear();
+  m_entryPtr.assign(1, 0);
+  m_stateIDs.clear();
+  m_weights.clear();
+  
+  locateProbes();
+  locateSlices();
+  
+  const CFuint nbEntries = m_entryPtr.size() - 1;
+  CFLog(VERBOSE, "ProbeSliceExtraction::setup() => " << nbEntries << " local entries\n");
+  
+  if (nbEntries > 0) {
+    const CFuint nbEq = PhysicalModelStack::getActive()->getNbEq();
+    vector<CFreal> header;
+    header.reserve(3 + m_entryInfo.size());
+    header.push_back(nbEq);
+    header.push_back(dim);
+    header.push_back(nbEntries);
+    header.insert(header.end(), m_entryInfo.begin(), m_entryInfo.end());
+    
+    path file = Environment::DirPaths::getInstance().getResultsDir() / path(m_outputFile);
+    file = PathAppender::getInstance().appendParallel(file);
+    m_writer.open(file, header, 2 + nbEntries*nbEq, m_flushRate);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::locateProbes()
+{
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  const CFuint nbProbes = m_probeCoords.size()/dim;
+  if (nbProbes == 0) return;
+  
+  DataHandle < Node*, GLOBAL > nodes = socket_nodes.getDataHandle();
+  DataHandle < State*, GLOBAL > states = socket_states.getDataHandle();
+  SafePtr<TopologicalRegionSet> cells = MeshDataStack::getActive()->getTrs("InnerCells");
+  
+  StdTrsGeoBuilder::GeoData& geoData = m_cellBuilder.getDataGE();
+  geoData.trs = cells;
+  
+  const CFuint noCell = std::numeric_limits<CFuint>::max();
+  vector<CFuint> probeCell(nbProbes, noCell);
+  RealVector xmin(dim);
+  RealVector xmax(dim);
+  RealVector coord(dim);
+  
+  // bin the probes in a uniform grid of about one probe per bin
+  RealVector pmin(dim);
+  RealVector pmax(dim);
+  pmin = MathConsts::CFrealMax();
+  pmax = -MathConsts::CFrealMax();
+  for (CFuint iProbe = 0; iProbe < nbProbes; ++iProbe) {
+    for (CFuint d = 0; d < dim; ++d) {
+      pmin[d] = std::min(pmin[d], m_probeCoords[iProbe*dim + d]);
+      pmax[d] = std::max(pmax[d], m_probeCoords[iProbe*dim + d]);
+    }
+  }
+  
+  const CFuint nbBins1D = std::max
+    (static_cast<CFuint>(1), static_cast<CFuint>(std::pow(static_cast<CFreal>(nbProbes), 1./dim)));
+  RealVector binSize(dim);
+  for (CFuint d = 0; d < dim; ++d) {
+    binSize[d] = (pmax[d] > pmin[d]) ? (pmax[d] - pmin[d])/nbBins1D : 1.;
+  }
+  
+  CFuint nbBins = 1;
+  for (CFuint d = 0; d < dim; ++d) {nbBins *= nbBins1D;}
+  vector<CFuint> probeBin(nbProbes);
+  vector<CFuint> binPtr(nbBins + 1, 0);
+  for (CFuint iProbe = 0; iProbe < nbProbes; ++iProbe) {
+    CFuint bin = 0;
+    for (CFint d = dim - 1; d >= 0; --d) {
+      const CFreal x = (m_probeCoords[iProbe*dim + d] - pmin[d])/binSize[d];
+      bin = bin*nbBins1D + std::min(static_cast<CFuint>(std::max(x, 0.)), nbBins1D - 1);
+    }
+    probeBin[iProbe] = bin;
+    ++binPtr[bin + 1];
+  }
+  for (CFuint b = 0; b < nbBins; ++b) {
+    binPtr[b + 1] += binPtr[b];
+  }
+  vector<CFuint> binProbes(nbProbes);
+  vector<CFuint> binFill(binPtr.begin(), binPtr.end() - 1);
+  for (CFuint iProbe = 0; iProbe < nbProbes; ++iProbe) {
+    binProbes[binFill[probeBin[iProbe]]++] = iProbe;
+  }
+  
+  // range of bins overlapped by the bounding box of a cell (3 directions)
+  CFuint lo[3] = {0, 0, 0};
+  CFuint hi[3] = {0, 0, 0};
+  
+  const CFuint nbCells = cells->getLocalNbGeoEnts();
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    // only cells whose first state is owned are considered, so that each 
+    // cell is considered by exactly one process
+    if (!states[cells->getStateID(iCell, 0)]->isParUpdatable()) continue;
+    
+    // bounding box of the cell, to avoid building the cell for each probe 
+    xmin = MathConsts::CFrealMax();
+    xmax = -MathConsts::CFrealMax();
+    const CFuint nbNodesInCell = cells->getNbNodesInGeo(iCell);
+    for (CFuint in = 0; in < nbNodesInCell; ++in) {
+      const Node& node = *nodes[cells->getNodeID(iCell, in)];
+      for (CFuint d = 0; d < dim; ++d) {
+	xmin[d] = std::min(xmin[d], node[d]);
+	xmax[d] = std::max(xmax[d], node[d]);
+      }
+    }
+    
+    bool isInGrid = true;
+    for (CFuint d = 0; d < dim; ++d) {
+      const CFreal eps = 1e-10*(xmax[d] - xmin[d]);
+      xmin[d] -= eps;
+      xmax[d] += eps;
+      if (xmax[d] < pmin[d] || xmin[d] > pmax[d]) {isInGrid = false; break;}
+      lo[d] = std::min(static_cast<CFuint>(std::max((xmin[d] - pmin[d])/binSize[d], 0.)), nbBins1D - 1);
+      hi[d] = std::min(static_cast<CFuint>(std::max((xmax[d] - pmin[d])/binSize[d], 0.)), nbBins1D - 1);
+    }
+    if (!isInGrid) continue;
+    
+    bool isBuilt = false;
+    GeometricEntity* cell = CFNULL;
+    for (CFuint k = lo[2]; k <= hi[2]; ++k) {
+      for (CFuint j = lo[1]; j <= hi[1]; ++j) {
+	for (CFuint i = lo[0]; i <= hi[0]; ++i) {
+	  const CFuint bin = (k*nbBins1D + j)*nbBins1D + i;
+	  for (CFuint ip = binPtr[bin]; ip < binPtr[bin + 1]; ++ip) {
+	    const CFuint iProbe = binProbes[ip];
+	    if (probeCell[iProbe] != noCell) continue;
+	    
+	    bool isInBox = true;
+	    for (CFuint d = 0; d < dim; ++d) {
+	      coord[d] = m_probeCoords[iProbe*dim + d];
+	      if (coord[d] < xmin[d] || coord[d] > xmax[d]) {isInBox = false; break;}
+	    }
+	    
+	    if (isInBox) {
+	      if (!isBuilt) {
+		geoData.idx = iCell;
+		cell = m_cellBuilder.buildGE();
+		isBuilt = true;
+	      }
+	      if (cell->isInElement(coord)) {
+		probeCell[iProbe] = iCell;
+	      }
+	    }
+	  }
+	}
+      }
+    }
+    if (isBuilt) {m_cellBuilder.releaseGE();}
+  }
+  
+  // probes lying on partition boundaries are kept by the lowest rank only
+  const std::string nsp = getMethodData().getNamespace();
+  const CFuint myRank = PE::GetPE().GetRank(nsp);
+  const CFuint noRank = std::numeric_limits<CFuint>::max();
+  vector<CFuint> candidateRank(nbProbes, noRank);
+  for (CFuint iProbe = 0; iProbe < nbProbes; ++iProbe) {
+    if (probeCell[iProbe] != noCell) {candidateRank[iProbe] = myRank;}
+  }
+  vector<CFuint> ownerRank(candidateRank);
+#ifdef CF_HAVE_MPI
+  MPI_Allreduce(&candidateRank[0], &ownerRank[0], (int)nbProbes, 
+		MPIStructDef::getMPIType(&candidateRank[0]), MPI_MIN, 
+		PE::GetPE().GetCommunicator(nsp));
+#endif
+  
+  vector<CFuint> stateIDs;
+  vector<CFreal> weights;
+  for (CFuint iProbe = 0; iProbe < nbProbes; ++iProbe) {
+    if (ownerRank[iProbe] == noRank) {
+      CFLog(WARN, "ProbeSliceExtraction: probe " << iProbe << " is outside the mesh\n");
+      continue;
+    }
+    if (ownerRank[iProbe] != myRank) continue;
+    
+    for (CFuint d = 0; d < dim; ++d) {
+      coord[d] = m_probeCoords[iProbe*dim + d];
+    }
+    
+    geoData.idx = probeCell[iProbe];
+    GeometricEntity *const cell = m_cellBuilder.buildGE();
+    computeWeights(cell, coord, stateIDs, weights);
+    m_cellBuilder.releaseGE();
+    
+    addEntry(iProbe, coord, stateIDs, weights);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::locateSlices()
+{
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  const CFuint nbSlices = m_slicePlanes.size()/(2*dim);
+  if (nbSlices == 0) return;
+  
+  DataHandle < Node*, GLOBAL > nodes = socket_nodes.getDataHandle();
+  SafePtr<TopologicalRegionSet> cells = MeshDataStack::getActive()->getTrs("InnerCells");
+  
+  StdTrsGeoBuilder::GeoData& geoData = m_cellBuilder.getDataGE();
+  geoData.trs = cells;
+  
+  RealVector point(dim);
+  RealVector normal(dim);
+  RealVector coord(dim);
+  vector<CFreal> dist;
+  vector<CFuint> stateIDs;
+  vector<CFreal> weights;
+  
+  // points already sampled, identified by the local IDs of the nodes of 
+  // their edge (twice the same node for a point on a node)
+  std::set<std::pair<CFuint, CFuint> > isSampled;
+  
+  const CFuint nbCells = cells->getLocalNbGeoEnts();
+  for (CFuint iSlice = 0; iSlice < nbSlices; ++iSlice) {
+    for (CFuint d = 0; d < dim; ++d) {
+      point[d]  = m_slicePlanes[iSlice*2*dim + d];
+      normal[d] = m_slicePlanes[iSlice*2*dim + dim + d];
+    }
+    const CFreal nNorm = normal.norm2();
+    if (nNorm <= 0.) {
+      throw BadValueException (FromHere(), "ProbeSliceExtraction: slice plane with null normal");
+    }
+    normal /= nNorm;
+    isSampled.clear();
+    
+    // all the local cells are considered, the points being assigned to 
+    // the processes by their nodes
+    for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+      // the cell is cut if its nodes are not all on the same side of the plane
+      CFreal dmin = MathConsts::CFrealMax();
+      CFreal dmax = -MathConsts::CFrealMax();
+      const CFuint nbNodesInCell = cells->getNbNodesInGeo(iCell);
+      dist.resize(nbNodesInCell);
+      for (CFuint in = 0; in < nbNodesInCell; ++in) {
+	const Node& node = *nodes[cells->getNodeID(iCell, in)];
+	dist[in] = 0.;
+	for (CFuint d = 0; d < dim; ++d) {
+	  dist[in] += (node[d] - point[d])*normal[d];
+	}
+	dmin = std::min(dmin, dist[in]);
+	dmax = std::max(dmax, dist[in]);
+      }
+      if (dmin > 0. || dmax < 0.) continue;
+      
+      geoData.idx = iCell;
+      GeometricEntity *const cell = m_cellBuilder.buildGE();
+      const vector<Node*>& cellNodes = *cell->getNodes();
+      
+      // in 2D the faces of the cell are its edges
+      Common::Table<CFuint> *const edges = (dim == DIM_2D) ?
+	LocalConnectionData::getInstance().getFaceDofLocal
+	(cell->getShape(), CFPolyOrder::ORDER1, NODE, CFPolyForm::LAGRANGE) :
+	LocalConnectionData::getInstance().getEdgeDofLocal
+	(cell->getShape(), CFPolyOrder::ORDER1, NODE, CFPolyForm::LAGRANGE);
+      
+      for (CFuint iEdge = 0; iEdge < edges->nbRows(); ++iEdge) {
+	CFuint a = (*edges)(iEdge, 0);
+	CFuint b = (*edges)(iEdge, 1);
+	const CFreal da = dist[a];
+	const CFreal db = dist[b];
+	if ((da > 0. && db > 0.) || (da < 0. && db < 0.)) continue;
+	
+	// a node lying on the plane is a point of all its edges
+	CFreal t = 0.;
+	if (da == 0.) {b = a;}
+	else if (db == 0.) {a = b;}
+	else {t = da/(da - db);}
+	
+	const Node& nodeA = *cellNodes[a];
+	const Node& nodeB = *cellNodes[b];
+	const CFuint idA = nodeA.getLocalID();
+	const CFuint idB = nodeB.getLocalID();
+	
+	// the point is sampled by the process owning the node of lowest global ID
+	const Node& owner = (nodeA.getGlobalID() < nodeB.getGlobalID()) ? nodeA : nodeB;
+	if (!owner.isParUpdatable()) continue;
+	if (!isSampled.insert(std::make_pair(std::min(idA, idB), std::max(idA, idB))).second) continue;
+	
+	for (CFuint d = 0; d < dim; ++d) {
+	  coord[d] = (1. - t)*nodeA[d] + t*nodeB[d];
+	}
+	
+	if (m_nodal) {
+	  // linear interpolation along the edge
+	  stateIDs.assign(1, idA);
+	  weights.assign(1, 1. - t);
+	  if (idB != idA) {
+	    stateIDs.push_back(idB);
+	    weights.push_back(t);
+	  }
+	}
+	else {
+	  computeWeights(cell, coord, stateIDs, weights);
+	}
+	addEntry(-static_cast<CFreal>(iSlice + 1), coord, stateIDs, weights);
+      }
+      
+      m_cellBuilder.releaseGE();
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::computeWeights(GeometricEntity *const cell, 
+					  const RealVector& coord,
+					  vector<CFuint>& ids, 
+					  vector<CFreal>& weights)
+{
+  if (m_nodal) {
+    const vector<Node*>& cellNodes = *cell->getNodes();
+    const CFuint nbNodes = cellNodes.size();
+    ids.resize(nbNodes);
+    const RealVector xsi = cell->computeMappedCoordFromCoord(coord);
+    const RealVector sf  = cell->computeGeoShapeFunctionAtMappedCoord(xsi);
+    weights.resize(nbNodes);
+    for (CFuint in = 0; in < nbNodes; ++in) {
+      ids[in] = cellNodes[in]->getLocalID();
+      weights[in] = sf[in];
+    }
+    return;
+  }
+  
+  const vector<State*>& cellStates = *cell->getStates();
+  const CFuint nbStates = cellStates.size();
+  ids.resize(nbStates);
+  weights.resize(nbStates);
+  for (CFuint is = 0; is < nbStates; ++is) {
+    ids[is] = cellStates[is]->getLocalID();
+  }
+  
+  if (nbStates == 1) {
+    weights[0] = 1.;
+  }
+  else {
+    const RealVector xsi = cell->computeMappedCoordFromCoord(coord);
+    const RealVector sf  = cell->computeShapeFunctionAtMappedCoord(xsi);
+    for (CFuint is = 0; is < nbStates; ++is) {
+      weights[is] = sf[is];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::addEntry(const CFreal tag, const RealVector& coord,
+				    const vector<CFuint>& stateIDs, 
+				    const vector<CFreal>& weights)
+{
+  cf_assert(stateIDs.size() == weights.size());
+  
+  m_entryInfo.push_back(tag);
+  for (CFuint d = 0; d < coord.size(); ++d) {
+    m_entryInfo.push_back(coord[d]);
+  }
+  
+  m_stateIDs.insert(m_stateIDs.end(), stateIDs.begin(), stateIDs.end());
+  m_weights.insert(m_weights.end(), weights.begin(), weights.end());
+  m_entryPtr.push_back(m_stateIDs.size());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::execute()
+{
+  CFAUTOTRACE;
+  
+  if (!m_writer.isOpen()) return;
+  
+  DataHandle < State*, GLOBAL > states = socket_states.getDataHandle();
+  DataHandle < RealVector > nstates(CFNULL);
+  if (m_nodal) {
+    nstates = m_sockets.getSocketSink<RealVector>("nstates")->getDataHandle();
+  }
+  SafePtr<SubSystemStatus> ssys_status = SubSystemStatusStack::getActive();
+  
+  const CFuint nbEq = PhysicalModelStack::getActive()->getNbEq();
+  const CFuint nbEntries = m_entryPtr.size() - 1;
+  
+  CFreal* rec = m_writer.nextRecord();
+  rec[0] = ssys_status->getCurrentTimeDim();
+  rec[1] = ssys_status->getNbIter();
+  
+  CFreal* value = &rec[2];
+  for (CFuint e = 0; e < nbEntries; ++e, value += nbEq) {
+    for (CFuint iEq = 0; iEq < nbEq; ++iEq) {
+      value[iEq] = 0.;
+    }
+    for (CFuint i = m_entryPtr[e]; i < m_entryPtr[e+1]; ++i) {
+      const RealVector& state = (m_nodal) ? nstates[m_stateIDs[i]] : *states[m_stateIDs[i]];
+      const CFreal w = m_weights[i];
+      for (CFuint iEq = 0; iEq < nbEq; ++iEq) {
+	value[iEq] += w*state[iEq];
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ProbeSliceExtraction::unsetup()
+{
+  m_writer.close();
+  
+  DataProcessingCom::unsetup();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace InSituExtraction
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
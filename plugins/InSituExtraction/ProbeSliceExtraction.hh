@@ -0,0 +1,168 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_InSituExtraction_ProbeSliceExtraction_hh
+#define COOLFluiD_InSituExtraction_ProbeSliceExtraction_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Framework/DataProcessingData.hh"
+#include "Framework/DataSocketSink.hh"
+#include "Framework/DynamicDataSocketSet.hh"
+#include "Framework/GeometricEntityPool.hh"
+#include "Framework/StdTrsGeoBuilder.hh"
+
+#include "InSituExtraction/TimeSeriesWriter.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace InSituExtraction {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class samples the solution at a list of probe points and on the cells
+ * cut by a list of planes, each time the processing is executed.
+ * 
+ * Probes and slices are located once in setup(), where the interpolation 
+ * weights of the states involved are stored: sampling then reduces to a 
+ * weighted sum over a flat list of states and the samples are appended to a 
+ * per-process binary time series by a TimeSeriesWriter.
+ * The probes are binned in a uniform grid, so that each cell is only tested
+ * against the probes of the bins overlapped by its bounding box. The slices
+ * are sampled at the intersections of the planes with the cell edges.
+ * The values are interpolated with the solution shape functions of the cells
+ * or, with the Nodal option (e.g. for cell centered schemes), from the nodal
+ * states with the geometric shape functions.
+ * 
+ * The per-process file is made of CFreal entries:
+ *  - header: nbEq, dim, nbEntries, followed by nbEntries times 
+ *    (tag, coordinates[dim]), where tag is the probe ID for probes and 
+ *    -(sliceID+1) for the points of a slice;
+ *  - records: time, iteration, nbEntries times the interpolated state[nbEq].
+ */
+class ProbeSliceExtraction : public Framework::DataProcessingCom {
+public:
+
+  /**
+   * Defines the Config Option's of this class
+   * @param options a OptionList where to add the Option's
+   */
+  static void defineConfigOptions(Config::OptionList& options);
+
+  /**
+   * Constructor.
+   */
+  ProbeSliceExtraction(const std::string& name);
+
+  /**
+   * Default destructor
+   */
+  virtual ~ProbeSliceExtraction();
+
+  /**
+   * Configure the command
+   */
+  virtual void configure ( Config::ConfigArgs& args );
+
+  /**
+   * Returns the DataSocket's that this command needs as sinks
+   * @return a vector of SafePtr with the DataSockets
+   */
+  virtual std::vector<Common::SafePtr<Framework::BaseDataSocketSink> > needsSockets();
+
+  /**
+   * Set up private data and data of the aggregated classes
+   * in this command before processing phase
+   */
+  virtual void setup();
+
+  /**
+   * Unset up private data and data of the aggregated classes
+   * in this command
+   */
+  virtual void unsetup();
+
+protected: // functions
+
+  /// Execute this command
+  virtual void execute();
+  
+  /// Locate the probe points in the local cells
+  void locateProbes();
+  
+  /// Locate the local cells cut by the slice planes
+  void locateSlices();
+  
+  /// Compute the interpolation weights at the given coordinates in a cell
+  /// @param ids      local IDs of the states (or nodes) involved
+  void computeWeights(Framework::GeometricEntity *const cell, 
+		      const RealVector& coord,
+		      std::vector<CFuint>& ids, 
+		      std::vector<CFreal>& weights);
+  
+  /// Add an entry to the sampling list
+  void addEntry(const CFreal tag, const RealVector& coord,
+		const std::vector<CFuint>& stateIDs, 
+		const std::vector<CFreal>& weights);
+
+private: // data
+
+  /// the socket to the data handle of the node's
+  Framework::DataSocketSink < Framework::Node* , Framework::GLOBAL > socket_nodes;
+
+  /// the socket to the data handle of the state's
+  Framework::DataSocketSink < Framework::State* , Framework::GLOBAL > socket_states;
+
+  /// the sockets to the nodal states, if needed
+  Framework::DynamicDataSocketSet<> m_sockets;
+  
+  /// builder for standard TRS GeometricEntities
+  Framework::GeometricEntityPool< Framework::StdTrsGeoBuilder >  m_cellBuilder;
+  
+  /// binary time series writer
+  TimeSeriesWriter m_writer;
+  
+  /// tag and coordinates of each sampled entry
+  std::vector<CFreal> m_entryInfo;
+  
+  /// pointers to the first state of each entry in m_stateIDs/m_weights
+  std::vector<CFuint> m_entryPtr;
+  
+  /// local IDs of the states (or nodes) contributing to each entry
+  std::vector<CFuint> m_stateIDs;
+  
+  /// interpolation weights of the states contributing to each entry
+  std::vector<CFreal> m_weights;
+  
+  /// name of the output file
+  std::string m_outputFile;
+  
+  /// flattened coordinates of the probe points
+  std::vector<CFreal> m_probeCoords;
+  
+  /// flattened (point, normal) definition of the slice planes
+  std::vector<CFreal> m_slicePlanes;
+  
+  /// number of samples to buffer before flushing to file
+  CFuint m_flushRate;
+  
+  /// flag telling to interpolate the nodal states
+  bool m_nodal;
+  
+}; // end of class ProbeSliceExtraction
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace InSituExtraction
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_InSituExtraction_ProbeSliceExtraction_hh
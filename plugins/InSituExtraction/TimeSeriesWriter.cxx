@@ -0,0 +1,167 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "Common/CFLog.hh"
+#include "Common/FilesystemException.hh"
+
+#ifdef CF_HAVE_MPI
+#include "Common/MPI/MPIStructDef.hh"
+#include "Common/MPI/MPIError.hh"
+#endif
+
+#include "InSituExtraction/TimeSeriesWriter.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace InSituExtraction {
+
+//////////////////////////////////////////////////////////////////////////////
+
+TimeSeriesWriter::TimeSeriesWriter() :
+  m_active(0),
+  m_filled(0),
+  m_recordSize(0),
+  m_isOpen(false)
+#ifdef CF_HAVE_MPI
+  ,m_fh(),
+  m_request(MPI_REQUEST_NULL),
+  m_isPending(false)
+#endif
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+TimeSeriesWriter::~TimeSeriesWriter()
+{
+  if (m_isOpen) {close();}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::open(const boost::filesystem::path& fpath, 
+			    const vector<CFreal>& header,
+			    const CFuint recordSize,
+			    const CFuint nbRecsBuffer)
+{
+  cf_assert(!m_isOpen);
+  cf_assert(recordSize > 0);
+  
+  m_recordSize = recordSize;
+  m_buffer[0].resize(recordSize*std::max(nbRecsBuffer, (CFuint)1));
+  m_buffer[1].resize(m_buffer[0].size());
+  m_active = 0;
+  m_filled = 0;
+  
+#ifdef CF_HAVE_MPI
+  char* fileName = const_cast<char*>(fpath.string().c_str());
+  if (MPI_File_open(MPI_COMM_SELF, fileName, MPI_MODE_WRONLY | MPI_MODE_CREATE, 
+		    MPI_INFO_NULL, &m_fh) != MPI_SUCCESS) {
+    throw FilesystemException (FromHere(), "Could not open file: " + fpath.string());
+  }
+  MPI_File_set_size(m_fh, 0);
+  m_isPending = false;
+#else
+  m_file.open(fpath.string().c_str(), ios::out | ios::binary | ios::trunc);
+  if (!m_file.is_open()) {
+    throw FilesystemException (FromHere(), "Could not open file: " + fpath.string());
+  }
+#endif
+  m_isOpen = true;
+  
+  // the header is written synchronously, it is small and written only once
+  if (header.size() > 0) {
+    write(header, header.size());
+    wait();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal* TimeSeriesWriter::nextRecord()
+{
+  cf_assert(m_isOpen);
+  if (m_filled + m_recordSize > m_buffer[m_active].size()) {
+    flush();
+  }
+  
+  CFreal* rec = &m_buffer[m_active][m_filled];
+  m_filled += m_recordSize;
+  return rec;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::flush()
+{
+  if (m_isOpen && m_filled > 0) {
+    // the other buffer is about to be reused: its write must be completed
+    wait();
+    write(m_buffer[m_active], m_filled);
+    m_active = (m_active + 1)%2;
+    m_filled = 0;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::close()
+{
+  if (m_isOpen) {
+    flush();
+    wait();
+#ifdef CF_HAVE_MPI
+    MPI_File_close(&m_fh);
+#else
+    m_file.close();
+#endif
+    m_isOpen = false;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::write(const vector<CFreal>& buf, const CFuint size)
+{
+#ifdef CF_HAVE_MPI
+  cf_assert(!m_isPending);
+  CFreal* data = const_cast<CFreal*>(&buf[0]);
+  MPIError::getInstance().check
+    ("MPI_File_iwrite", "TimeSeriesWriter::write()",
+     MPI_File_iwrite(m_fh, data, (int)size, MPIStructDef::getMPIType(data), &m_request));
+  m_isPending = true;
+#else
+  m_file.write(reinterpret_cast<const char*>(&buf[0]), size*sizeof(CFreal));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::wait()
+{
+#ifdef CF_HAVE_MPI
+  if (m_isPending) {
+    MPI_Status status;
+    MPI_Wait(&m_request, &status);
+    m_isPending = false;
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace InSituExtraction
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
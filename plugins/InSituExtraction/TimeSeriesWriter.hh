@@ -0,0 +1,116 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_InSituExtraction_TimeSeriesWriter_hh
+#define COOLFluiD_InSituExtraction_TimeSeriesWriter_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <boost/filesystem/path.hpp>
+
+#include "Common/COOLFluiD.hh"
+
+#ifdef CF_HAVE_MPI
+#include <mpi.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace InSituExtraction {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class appends fixed-size binary records to a per-process file.
+ * Records are accumulated in one of two buffers: when the active buffer is 
+ * full it is handed to a non-blocking MPI-IO write and the other buffer 
+ * becomes active, so that the solver never waits for the file system unless
+ * a previous write is still in flight.
+ */
+class TimeSeriesWriter {
+public:
+  
+  /// Constructor
+  TimeSeriesWriter();
+  
+  /// Destructor
+  ~TimeSeriesWriter();
+  
+  /// Open (and truncate) the file and write the header
+  /// @param fpath        path of the file
+  /// @param header       header data
+  /// @param recordSize   number of entries in each record
+  /// @param nbRecsBuffer number of records to buffer before writing
+  void open(const boost::filesystem::path& fpath, 
+	    const std::vector<CFreal>& header,
+	    const CFuint recordSize,
+	    const CFuint nbRecsBuffer);
+  
+  /// Get the storage for the next record in the active buffer
+  CFreal* nextRecord();
+  
+  /// Write the active buffer (if not empty) asynchronously
+  void flush();
+  
+  /// Flush all data, wait for completion and close the file
+  void close();
+  
+  /// @return true if the file is open
+  bool isOpen() const {return m_isOpen;}
+  
+private: // helper functions
+  
+  /// Post the write of the given buffer
+  void write(const std::vector<CFreal>& buf, const CFuint size);
+  
+  /// Wait for the pending write, if any
+  void wait();
+  
+private: // data
+  
+  /// double buffer 
+  std::vector<CFreal> m_buffer[2];
+  
+  /// index of the active buffer
+  CFuint m_active;
+  
+  /// number of entries filled in the active buffer
+  CFuint m_filled;
+  
+  /// number of entries in each record
+  CFuint m_recordSize;
+  
+  /// flag telling if the file is open
+  bool m_isOpen;
+  
+#ifdef CF_HAVE_MPI
+  /// file handle
+  MPI_File m_fh;
+  
+  /// request of the pending write
+  MPI_Request m_request;
+  
+  /// flag telling if there is a pending write
+  bool m_isPending;
+#else
+  /// output file
+  std::ofstream m_file;
+#endif
+  
+}; // end of class TimeSeriesWriter
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace InSituExtraction
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_InSituExtraction_TimeSeriesWriter_hh
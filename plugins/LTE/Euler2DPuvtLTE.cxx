@@ -30,7 +30,11 @@ Euler2DPuvtLTE::Euler2DPuvtLTE(Common::SafePtr<BaseTerm> term) :
   Euler2DVarSet(term),
   _library(CFNULL),
   _dhe(3),
-  _x()
+  _x(),
+  m_blockT(),
+  m_blockP(),
+  m_blockDhe(),
+  m_blockGammaA()
 {
   vector<std::string> names(4);
   names[0] = (!getModel()->isIncompressible()) ? "p" : "dp";
@@ -85,15 +89,9 @@ void Euler2DPuvtLTE::splitJacobian(RealMatrix& jacobPlus,
 void Euler2DPuvtLTE::computePhysicalData(const State& state,
 					 RealVector& data)
 { 
-  const RealVector& refData = getModel()->getReferencePhysicalData();
-    
-  CFreal pdim = getModel()->getPressureFromState(state[0])*refData[EulerTerm::P];
-  // correction in case pdim=0 (e.g. when starting from scratch in compressible mode)
-  pdim = (pdim > 0.01) ? pdim :getModel()->getPressInfComp()*refData[EulerTerm::P];
-  cf_assert(pdim > 0.);
-    
-  CFreal T = state[3];
-  CFreal Tdim = T*getModel()->getTempRef();
+  CFreal pdim = 0.;
+  CFreal Tdim = 0.;
+  getDimensionalTP(state, Tdim, pdim);
   cf_assert(_library.isNotNull());
  
   CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => Tdim = " << Tdim << "\n");
@@ -104,30 +102,86 @@ void Euler2DPuvtLTE::computePhysicalData(const State& state,
   CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => _dhe= " << _dhe  << "\n");
 
   CFreal rhoDim = _dhe[0];
-  const CFreal u = state[1];
-  const CFreal v = state[2];
-  const CFreal V2 = u*u + v*v;
-
   CFreal gamma = 0.0;
   CFreal adim = 0.0;
   _library->gammaAndSoundSpeed(Tdim,pdim,rhoDim,gamma,adim);
   CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => gamma = " << gamma <<  "\n");
   CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => adim = " << adim <<  "\n");
+  
+  setPhysicalData(state, &_dhe[0], gamma, adim, data);
+  
+  CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => data = " << data << "\n");
+  CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => END\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Euler2DPuvtLTE::computeBlockPhysicalData(const vector<State*>& states,
+					      vector<RealVector>& pdata,
+					      const CFuint nbStates)
+{
+  cf_assert(nbStates <= states.size());
+  cf_assert(nbStates <= pdata.size());
+  cf_assert(_library.isNotNull());
+  
+  if (m_blockT.size() < nbStates) {
+    m_blockT.resize(nbStates);
+    m_blockP.resize(nbStates);
+    m_blockDhe.resize(3*nbStates);
+    m_blockGammaA.resize(2*nbStates);
+  }
+  
+  for (CFuint i = 0; i < nbStates; ++i) {
+    getDimensionalTP(*states[i], m_blockT[i], m_blockP[i]);
+  }
+  
+  _library->setDensityEnthalpyEnergyBatch(nbStates, &m_blockT[0], &m_blockP[0], 
+					  &m_blockDhe[0], &m_blockGammaA[0]);
+  
+  for (CFuint i = 0; i < nbStates; ++i) {
+    setPhysicalData(*states[i], &m_blockDhe[3*i], m_blockGammaA[2*i], 
+		    m_blockGammaA[2*i+1], pdata[i]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
 
+void Euler2DPuvtLTE::getDimensionalTP(const State& state, CFreal& Tdim, CFreal& pdim)
+{
+  const RealVector& refData = getModel()->getReferencePhysicalData();
+  
+  pdim = getModel()->getPressureFromState(state[0])*refData[EulerTerm::P];
+  // correction in case pdim=0 (e.g. when starting from scratch in compressible mode)
+  pdim = (pdim > 0.01) ? pdim :getModel()->getPressInfComp()*refData[EulerTerm::P];
+  cf_assert(pdim > 0.);
+  
+  Tdim = state[3]*getModel()->getTempRef();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Euler2DPuvtLTE::setPhysicalData(const State& state, const CFreal* dhe,
+				     const CFreal gamma, const CFreal adim, 
+				     RealVector& data)
+{
+  const RealVector& refData = getModel()->getReferencePhysicalData();
+  
+  const CFreal rhoDim = dhe[0];
+  const CFreal T = state[3];
+  const CFreal u = state[1];
+  const CFreal v = state[2];
+  const CFreal V2 = u*u + v*v;
+  
   data[EulerTerm::RHO] = rhoDim/refData[EulerTerm::RHO];
   data[EulerTerm::P] = state[0];
-  data[EulerTerm::H] = _dhe[1]/refData[EulerTerm::H] + 0.5*V2;
-  data[EulerTerm::E] = _dhe[2]/refData[EulerTerm::H] + 0.5*V2;
+  data[EulerTerm::H] = dhe[1]/refData[EulerTerm::H] + 0.5*V2;
+  data[EulerTerm::E] = dhe[2]/refData[EulerTerm::H] + 0.5*V2;
   data[EulerTerm::A] = adim/refData[EulerTerm::A];
   data[EulerTerm::T] = T;
   data[EulerTerm::V] = sqrt(V2);
   data[EulerTerm::VX] = u;
   data[EulerTerm::VY] = v;
-  data[EulerTerm::T] = T;
   data[EulerTerm::GAMMA] = gamma;
-  
-  CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => data = " << data << "\n");
-  CFLog(DEBUG_MAX, "Euler2DPuvtLTE::computePhysicalData() => END\n");
 }
 
 //////////////////////////////////////////////////////////////////////////////
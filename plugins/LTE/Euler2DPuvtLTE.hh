@@ -114,6 +114,15 @@ public: // classes
   virtual void computePhysicalData(const Framework::State& state,
 				   RealVector& data);
   
+  /**
+   * Set the PhysicalData corresponding to the given States with one
+   * batched call to the thermodynamic library
+   * @see ConvectiveVarSet
+   */
+  virtual void computeBlockPhysicalData(const std::vector<Framework::State*>& states,
+					std::vector<RealVector>& pdata,
+					const CFuint nbStates);
+  
   /**
    * Set a State starting from the given PhysicalData
    * @see EulerPhysicalModel
@@ -127,6 +136,15 @@ public: // classes
     velIDs.resize(2); velIDs[XX] = 1; velIDs[YY] = 2;
   }
   
+private:
+  
+  /// compute the dimensional temperature and pressure of the given state
+  void getDimensionalTP(const Framework::State& state, CFreal& Tdim, CFreal& pdim);
+  
+  /// set the physical data from the state and the thermodynamic properties
+  void setPhysicalData(const Framework::State& state, const CFreal* dhe,
+		       const CFreal gamma, const CFreal adim, RealVector& data);
+  
 private:
 
   /// thermodynamic library
@@ -137,6 +155,18 @@ private:
 
   /// array to store the volume composition for each species
   RealVector _x;
+  
+  /// dimensional temperatures of a block of states
+  std::vector<CFreal> m_blockT;
+  
+  /// dimensional pressures of a block of states
+  std::vector<CFreal> m_blockP;
+  
+  /// density, enthalpy and energy of a block of states
+  std::vector<CFreal> m_blockDhe;
+  
+  /// gamma and sound speed of a block of states
+  std::vector<CFreal> m_blockGammaA;
 
 }; // end of class Euler2DPuvt
 
@@ -1,6 +1,7 @@
 #include "Environment/ObjectProvider.hh"
 #include "MathTools/MathConsts.hh"
 #include "Framework/MeshData.hh"
+#include "Framework/GlobalReduceBatch.hh"
 #include "LUSGSMethod/ComputeL2NormLUSGS.hh"
 #include "LUSGSMethod/LUSGSMethod.hh"
 
@@ -28,7 +29,9 @@ Environment::ObjectProvider<ComputeL2NormLUSGS, ComputeNorm, LUSGSMethodModule,
 ComputeL2NormLUSGS::ComputeL2NormLUSGS(const std::string & name) :
   ComputeNormLUSGS(name),
   m_gr(*this),
-  socket_rhsCurrStatesSet("rhsCurrStatesSet")
+  socket_rhsCurrStatesSet("rhsCurrStatesSet"),
+  m_handles(),
+  m_isPosted(false)
 {
 }
 
@@ -91,13 +94,34 @@ void ComputeL2NormLUSGS::addStatesSetContribution()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ComputeL2NormLUSGS::post ()
+{
+  const std::string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  
+  // all the variables are reduced together
+  GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(nsp);
+  const CFuint nbVars = m_residuals.size();
+  m_handles.resize(nbVars);
+  for(m_var_itr = 0; m_var_itr < nbVars; ++m_var_itr) {
+    m_handles[m_var_itr] = batch.addValue(GR_GetLocalValue(), GlobalReduceBatch::SUM);
+  }
+  batch.post();
+  m_isPosted = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 RealVector ComputeL2NormLUSGS::compute ()
 {
+  if (!m_isPosted) {post();}
+  m_isPosted = false;
+  
   const std::string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(nsp);
   
   for(m_var_itr = 0; m_var_itr < m_residuals.size(); ++m_var_itr)
   {
-    const CFreal globalValue = m_gr.GetGlobalValue (nsp);
+    const CFreal globalValue = batch.getValue(m_handles[m_var_itr]);
     if(globalValue > 0.)
     {
       m_residuals[m_var_itr] = log10(sqrt(globalValue));
@@ -40,6 +40,10 @@ public:
   /// Calculates the norms
   RealVector compute ();
 
+  /// Registers the local contributions to the norms and starts their
+  /// global reduction
+  void post ();
+
   /**
    * Adds contribution of the current states set to the residuals.
    */
@@ -68,6 +72,12 @@ protected: // data
   /// socket for rhs of current set of states
   Framework::DataSocketSink< CFreal > socket_rhsCurrStatesSet;
 
+  /// handles of the norms in the batch of global reductions
+  std::vector<CFuint> m_handles;
+
+  /// flag telling if the norms are being reduced
+  bool m_isPosted;
+
 }; // end of class ComputeL2NormLUSGS
 
 //////////////////////////////////////////////////////////////////////////////
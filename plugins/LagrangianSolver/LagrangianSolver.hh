@@ -62,9 +62,21 @@ public:
     }
   }
   
+  /// migrate the particles only to the neighbor partitions, without
+  /// synchronizing all the processes at every cycle (see SendBuffer)
+  inline void setupAsynchronousMigration(bool asynchronous)
+  {
+    cf_assert(m_sendBuffer.get() != CFNULL);
+    m_sendBuffer->setAsynchronous(asynchronous);
+  }
+  
   inline void newDirection(RealVector direction){ m_particleTracking.newDirection(direction);}
   
   inline void trackingStep(){ m_particleTracking.trackingStep(); }
+  
+  inline bool hasPacketTracking() const {return m_particleTracking.hasPacketTracking();}
+  
+  inline void trackingStepPacket(ParticlePacket& packet){ m_particleTracking.trackingStepPacket(packet); }
 
    inline void getExitPoint(RealVector &exitPoint){ m_particleTracking.getExitPoint(exitPoint); }
 
@@ -128,6 +140,9 @@ public:
 
    void bufferCommitParticle(CFuint faceID);
 
+   /// send the given particle to the process owning the cell behind the face
+   void bufferCommitParticle(CFuint faceID, Particle<UserData>& particle);
+
 private:
 
   void (ParticleTracking::*getNormalsPtr) (CFuint, RealVector, RealVector);
@@ -190,6 +205,18 @@ void LagrangianSolver<UserData, PARTICLE_TRACKING>::bufferCommitParticle(CFuint
 
 //////////////////////////////////////////////////////////////////////////////
 
+template<typename UserData, class PARTICLE_TRACKING>
+void LagrangianSolver<UserData, PARTICLE_TRACKING>::bufferCommitParticle
+(CFuint faceID, Particle<UserData>& particle)
+{
+  cf_assert(m_wallTypes(faceID,0) == ParticleTracking::COMP_DOMAIN_FACE );
+  
+  particle.commonData.cellID = m_wallTypes(faceID,3);
+  m_sendBuffer->push_back(particle, m_wallTypes(faceID,2) );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template<typename UserData, class PARTICLE_TRACKING>
 bool LagrangianSolver<UserData,PARTICLE_TRACKING>::sincronizeParticles(std::vector< Particle<UserData> >&particleBuffer,
 								       bool isLastPhoton)
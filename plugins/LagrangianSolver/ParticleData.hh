@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "Common/COOLFluiD.hh"
 #include "MathTools/CFVec.hh"
 
@@ -36,6 +38,62 @@ struct Particle
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Packet of particles traced together, stored as a structure of arrays
+/// so that the tracking step can be vectorized across the particles
+struct ParticlePacket
+{
+  ParticlePacket() : size(0) {}
+  
+  /// allocate the storage for the given number of particles
+  void reserve(const CFuint width)
+  {
+    for (CFuint i = 0; i < 3; ++i) {
+      point[i].resize(width);
+      direction[i].resize(width);
+    }
+    stepDist.resize(width);
+    cellID.resize(width);
+    exitFaceID.resize(width);
+    exitCellID.resize(width);
+  }
+  
+  /// copy the particle in position j into position i
+  void copy(const CFuint i, const CFuint j)
+  {
+    for (CFuint k = 0; k < 3; ++k) {
+      point[k][i] = point[k][j];
+      direction[k][i] = direction[k][j];
+    }
+    stepDist[i] = stepDist[j];
+    cellID[i] = cellID[j];
+    exitFaceID[i] = exitFaceID[j];
+    exitCellID[i] = exitCellID[j];
+  }
+  
+  /// number of particles in the packet
+  CFuint size;
+  
+  /// current point, set to the exit point by the tracking step
+  std::vector<CFreal> point[3];
+  
+  /// direction
+  std::vector<CFreal> direction[3];
+  
+  /// distance to the exit point
+  std::vector<CFreal> stepDist;
+  
+  /// current cell
+  std::vector<CFint> cellID;
+  
+  /// exit face (-1 if none was found)
+  std::vector<CFint> exitFaceID;
+  
+  /// cell behind the exit face
+  std::vector<CFint> exitCellID;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 }
 
 }
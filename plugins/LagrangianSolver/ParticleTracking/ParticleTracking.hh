@@ -3,6 +3,7 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include "Common/NotImplementedException.hh"
 #include "Framework/SocketBundleSetter.hh"
 #include "LagrangianSolver/ParticleData.hh"
 
@@ -53,6 +54,16 @@ public:
 
   virtual void trackingStep()=0;
 
+  /// @return true if packets of particles can be traced (see trackingStepPacket())
+  virtual bool hasPacketTracking() const {return false;}
+
+  /// advance each particle of the packet to the exit face of its cell
+  virtual void trackingStepPacket(ParticlePacket& packet)
+  {
+    throw Common::NotImplementedException
+      (FromHere(), "ParticleTracking::trackingStepPacket() => packets are not supported");
+  }
+
   virtual void getExitPoint(RealVector &exitPoint) = 0;
 
   virtual CFreal getStepDistance() = 0;
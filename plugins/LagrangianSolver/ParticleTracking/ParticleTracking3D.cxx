@@ -32,7 +32,19 @@ ParticleTracking3D::ParticleTracking3D(const std::string& name):
   m_exitPoint(3),
   m_entryPoint(3),
   m_direction(3),
-  m_initialPoint(3)
+  m_initialPoint(3),
+  m_stepDist(0.),
+  m_hasPacketTables(false),
+  m_nodeCoords(),
+  m_cellTriStart(),
+  m_triNodes(),
+  m_triFace(),
+  m_triFaceIdx(),
+  m_faceStates(),
+  m_laneTriStart(),
+  m_laneNbTris(),
+  m_laneBestT(),
+  m_laneBestTri()
 {
 }
 
@@ -274,6 +286,156 @@ void ParticleTracking3D::trackingStep()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ParticleTracking3D::setupPacketTracking()
+{
+  CFLog(VERBOSE, "ParticleTracking3D::setupPacketTracking() => START\n");
+  
+  DataHandle<Node*, GLOBAL> nodes = m_sockets.nodes.getDataHandle();
+  const CFuint nbNodes = nodes.size();
+  m_nodeCoords.resize(nbNodes*3);
+  for (CFuint i = 0; i < nbNodes; ++i) {
+    for (CFuint d = 0; d < 3; ++d) {
+      m_nodeCoords[i*3+d] = (*nodes[i])[d];
+    }
+  }
+  
+  const CFuint nbFaces = m_isOutward.size();
+  m_faceStates.assign(nbFaces*2, -1);
+  
+  CellTrsGeoBuilder::GeoData& cellData = m_cellBuilder.getDataGE();
+  const CFuint nbCells = cellData.trs->getLocalNbGeoEnts();
+  m_cellTriStart.resize(nbCells+1);
+  m_cellTriStart[0] = 0;
+  m_triNodes.clear();
+  m_triFace.clear();
+  m_triFaceIdx.clear();
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    cellData.idx = iCell;
+    GeometricEntity *const cell = m_cellBuilder.buildGE();
+    const CFuint nFaces = cell->getNbFacets();
+    for (CFuint f = 0; f < nFaces; ++f) {
+      GeometricEntity* const face = cell->getNeighborGeo(f);
+      const vector<Node*>& faceNodes = *face->getNodes();
+      const CFuint faceID = face->getID();
+      const bool reverseCirculation = (static_cast<CFint>(m_isOutward[faceID]) == (CFint)iCell);
+      const CFuint nbTris = faceNodes.size();
+      for (CFuint iTri = 0; iTri < nbTris; ++iTri) {
+	const CFuint iTri_1 = (iTri == nbTris-1) ? 0 : iTri+1;
+	const CFuint n1 = faceNodes[iTri]->getLocalID();
+	const CFuint n2 = faceNodes[iTri_1]->getLocalID();
+	m_triNodes.push_back(reverseCirculation ? n2 : n1);
+	m_triNodes.push_back(reverseCirculation ? n1 : n2);
+	m_triFace.push_back(faceID);
+	m_triFaceIdx.push_back(f);
+      }
+      
+      m_faceStates[faceID*2] = face->getState(0)->getLocalID();
+      m_faceStates[faceID*2+1] = (face->getState(1)->isGhost()) ? -1 : 
+	static_cast<CFint>(face->getState(1)->getLocalID());
+    }
+    m_cellTriStart[iCell+1] = m_triFace.size();
+    m_cellBuilder.releaseGE();
+  }
+  
+  m_hasPacketTables = true;
+  
+  CFLog(VERBOSE, "ParticleTracking3D::setupPacketTracking() => " << m_triFace.size() 
+	<< " triangles in " << nbCells << " cells\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ParticleTracking3D::trackingStepPacket(ParticlePacket& packet)
+{
+  if (!m_hasPacketTables) {
+    setupPacketTracking();
+  }
+  
+  const CFuint n = packet.size;
+  m_laneTriStart.resize(n);
+  m_laneNbTris.resize(n);
+  m_laneBestT.resize(n);
+  m_laneBestTri.resize(n);
+  
+  CFuint maxNbTris = 0;
+  for (CFuint i = 0; i < n; ++i) {
+    const CFuint cellID = packet.cellID[i];
+    m_laneTriStart[i] = m_cellTriStart[cellID];
+    m_laneNbTris[i] = m_cellTriStart[cellID+1] - m_cellTriStart[cellID];
+    m_laneBestT[i] = 0.;
+    m_laneBestTri[i] = m_laneNbTris[i];
+    maxNbTris = std::max(maxNbTris, m_laneNbTris[i]);
+  }
+  
+  const CFreal *const ox = &packet.point[0][0];
+  const CFreal *const oy = &packet.point[1][0];
+  const CFreal *const oz = &packet.point[2][0];
+  const CFreal *const dx = &packet.direction[0][0];
+  const CFreal *const dy = &packet.direction[1][0];
+  const CFreal *const dz = &packet.direction[2][0];
+  const CFreal *const coords = &m_nodeCoords[0];
+  const CFreal *const centers = &m_faceCenters[0];
+  
+  // same intersection test and same choice of the exit face as trackingStep():
+  // the first face (in the order of the cell) which is hit, at its closest triangle
+  for (CFuint k = 0; k < maxNbTris; ++k) {
+    for (CFuint i = 0; i < n; ++i) {
+      const bool valid = (k < m_laneNbTris[i]);
+      const CFuint tri = m_laneTriStart[i] + (valid ? k : 0);
+      const CFreal* V1 = &coords[m_triNodes[tri*2]*3];
+      const CFreal* V2 = &coords[m_triNodes[tri*2+1]*3];
+      const CFreal* V3 = &centers[m_triFace[tri]*3];
+      
+      const CFreal e1x = V2[0] - V1[0], e1y = V2[1] - V1[1], e1z = V2[2] - V1[2];
+      const CFreal e2x = V3[0] - V1[0], e2y = V3[1] - V1[1], e2z = V3[2] - V1[2];
+      const CFreal Px = dy[i]*e2z - dz[i]*e2y;
+      const CFreal Py = dz[i]*e2x - dx[i]*e2z;
+      const CFreal Pz = dx[i]*e2y - dy[i]*e2x;
+      const CFreal det = e1x*Px + e1y*Py + e1z*Pz;
+      const bool parallel = (det > -EPSILON && det < EPSILON);
+      const CFreal inv_det = 1./(parallel ? 1. : det);
+      const CFreal Tx = ox[i] - V1[0], Ty = oy[i] - V1[1], Tz = oz[i] - V1[2];
+      const CFreal u = (Tx*Px + Ty*Py + Tz*Pz)*inv_det;
+      const CFreal Qx = Ty*e1z - Tz*e1y;
+      const CFreal Qy = Tz*e1x - Tx*e1z;
+      const CFreal Qz = Tx*e1y - Ty*e1x;
+      const CFreal v = (dx[i]*Qx + dy[i]*Qy + dz[i]*Qz)*inv_det;
+      const CFreal t = (e2x*Qx + e2y*Qy + e2z*Qz)*inv_det;
+      const bool hit = valid && !parallel && u >= 0. && u <= 1. && v >= 0. && u + v <= 1. && t > EPSILON;
+      
+      const CFuint best = m_laneBestTri[i];
+      const bool noBest = (best == m_laneNbTris[i]);
+      const bool sameFace = !noBest && (m_triFaceIdx[m_laneTriStart[i] + best] == m_triFaceIdx[tri]);
+      const bool better = hit && (noBest || (sameFace && t < m_laneBestT[i]));
+      m_laneBestT[i] = better ? t : m_laneBestT[i];
+      m_laneBestTri[i] = better ? k : best;
+    }
+  }
+  
+  for (CFuint i = 0; i < n; ++i) {
+    if (m_laneBestTri[i] < m_laneNbTris[i]) {
+      const CFuint faceID = m_triFace[m_laneTriStart[i] + m_laneBestTri[i]];
+      const CFreal step = m_laneBestT[i];
+      packet.stepDist[i] = step;
+      packet.exitFaceID[i] = faceID;
+      const CFint s0 = m_faceStates[faceID*2];
+      const CFint s1 = m_faceStates[faceID*2+1];
+      packet.exitCellID[i] = (s0 == packet.cellID[i] && s1 >= 0) ? s1 : s0;
+      for (CFuint d = 0; d < 3; ++d) {
+	packet.point[d][i] += packet.direction[d][i]*step;
+      }
+    }
+    else {
+      packet.stepDist[i] = 0.;
+      packet.exitFaceID[i] = -1;
+      packet.exitCellID[i] = packet.cellID[i];
+      CFLog(VERBOSE, "ParticleTracking3D::trackingStepPacket() => Can't find an exit Point!!\n");
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ParticleTracking3D::newParticle(CommonData &particle){
 
 //  std::cout<<"%*******************\n%NEW PARTICLE\n%************************************\n";
@@ -32,6 +32,13 @@ public:
   
   void trackingStep();
   
+  bool hasPacketTracking() const {return true;}
+  
+  /// advance each particle of the packet to the exit face of its cell: the
+  /// ray-triangle tests are done triangle slot by triangle slot across the
+  /// particles, on tables of oriented triangles built at the first call
+  void trackingStepPacket(ParticlePacket& packet);
+  
   void getExitPoint(RealVector &exitPoint) {exitPoint = m_exitPoint;}
   
   void newParticle(CommonData &particle);
@@ -56,6 +63,9 @@ private:
 			     const Vec3& V3, const Vec3& O, 
 			     const Vec3& D, CFreal* out);
   
+  /// build the tables of the triangles of each cell used by trackingStepPacket()
+  void setupPacketTracking();
+  
 private:
   
   Framework::DataHandle<CFint> m_isOutward; 
@@ -67,6 +77,40 @@ private:
   RealVector m_direction;
   RealVector m_initialPoint;
   CFreal m_stepDist;
+  
+  /// flag telling if the tables of the packet tracking have been built
+  bool m_hasPacketTables;
+  
+  /// coordinates of the nodes (3 per node)
+  std::vector<CFreal> m_nodeCoords;
+  
+  /// start of the triangles of each cell (size nbCells+1)
+  std::vector<CFuint> m_cellTriStart;
+  
+  /// nodes of each triangle (2 per triangle, the third being the face center),
+  /// ordered to get the normal pointing out of the cell
+  std::vector<CFuint> m_triNodes;
+  
+  /// face of each triangle
+  std::vector<CFuint> m_triFace;
+  
+  /// index of the face of each triangle within its cell
+  std::vector<CFuint> m_triFaceIdx;
+  
+  /// states of each face (2 per face, -1 for a ghost state)
+  std::vector<CFint> m_faceStates;
+  
+  /// first triangle of the cell of each particle of the packet
+  std::vector<CFuint> m_laneTriStart;
+  
+  /// number of triangles of the cell of each particle of the packet
+  std::vector<CFuint> m_laneNbTris;
+  
+  /// closest intersection of each particle of the packet
+  std::vector<CFreal> m_laneBestT;
+  
+  /// triangle of the closest intersection of each particle of the packet
+  std::vector<CFuint> m_laneBestTri;
 };
 
 //////////////////////////////////////////////////////////////////////////////
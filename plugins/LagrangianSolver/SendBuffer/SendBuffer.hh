@@ -8,6 +8,7 @@
 #include "Common/PE.hh"
 #include "LagrangianSolver/LagrangianSolverModule.hh"
 #include <iostream>
+#include <list>
 //////////////////////////////////////////////////////////////////////////////
 
 
@@ -15,6 +16,25 @@ namespace COOLFluiD {
 
 namespace LagrangianSolver{
 
+/**
+ * Buffer of the particles leaving the partition, which are migrated to the
+ * process owning the cell they enter.
+ *
+ * By default sincronize() is collective: the counts and the particles are
+ * exchanged among all the processes and the termination is checked with a
+ * global reduction at every cycle, which suits callers doing other collective
+ * communications at every cycle.
+ *
+ * In asynchronous mode (MPI 3) the particles are only sent, with non-blocking
+ * sends, to the processes they migrate to (the neighbors in the partition
+ * graph) and sincronize() returns the particles received so far without
+ * waiting for the other processes. The global termination is detected with
+ * non-blocking reductions of the counts of sent and received particles
+ * (four counters method): the migration is over when two consecutive
+ * reductions find all the processes idle, as many particles received as sent
+ * and the same counts. Callers must then not use collective communications
+ * between two calls of sincronize(), whose number differs among processes.
+ */
 template<typename T>
 class SendBuffer
 {
@@ -27,26 +47,73 @@ private:
     MPI_Comm            m_comm;
     MPI_Datatype        m_MPIdatatype;
 
+    /// flag telling to migrate the particles asynchronously
+    bool                m_asynchronous;
+    /// particles being sent asynchronously, with their requests
+    std::list<std::pair<MPI_Request, std::vector<T> > > m_pendingSends;
+    /// number of particles sent and received in the current migration
+    CFuint              m_nbSent;
+    CFuint              m_nbReceived;
+    /// index of the current migration, used to tell apart its messages
+    CFuint              m_epoch;
+    /// local and global counts (sent, received, active) of the reduction in progress
+    CFuint              m_localCounts[3];
+    CFuint              m_globalCounts[3];
+    /// global counts of the last completed reduction
+    CFuint              m_lastCounts[3];
+    bool                m_hasLastCounts;
+    MPI_Request         m_countsRequest;
+    bool                m_countsInFlight;
+
+    bool sincronizeAsynchronous(std::vector<T> &recvBuffer, bool isLastPhoton);
+    void postParticles();
+    void testSentParticles();
+    bool receiveParticles(std::vector<T> &recvBuffer);
+    bool checkTermination(const bool isIdle);
+
 public:
     SendBuffer();
+    ~SendBuffer();
     void reserve(CFuint nCells);
     bool sincronize(std::vector<T> &recvBuffer, bool isLastPhoton);
     void push_back(const T &a, const CFuint &rank);
     MPI_Datatype getMPIdatatype() const{ return m_MPIdatatype; }
     void setMPIdatatype(const MPI_Datatype MPIdatatype){ m_MPIdatatype = MPIdatatype; }
+    /// the asynchronous mode is ignored if MPI 3 is not available
+    void setAsynchronous(const bool asynchronous){ m_asynchronous = asynchronous; }
+    bool isAsynchronous() const{ return m_asynchronous; }
 };
 
 template<typename T>
 SendBuffer<T>::SendBuffer():
   m_sendBuffer(),
   m_sendCounts(),
-  m_sendBufferOrdered()
+  m_sendBufferOrdered(),
+  m_asynchronous(false),
+  m_pendingSends(),
+  m_nbSent(0),
+  m_nbReceived(0),
+  m_epoch(0),
+  m_hasLastCounts(false),
+  m_countsRequest(MPI_REQUEST_NULL),
+  m_countsInFlight(false)
 {
   const std::string nsp = Framework::MeshDataStack::getActive()->getPrimaryNamespace();
   
   m_comm = Common::PE::GetPE().GetCommunicator(nsp);
   m_nbProcesses= Common::PE::GetPE().GetProcessorCount(nsp);
   m_sendCounts.resize(m_nbProcesses);
+  for (CFuint i = 0; i < 3; ++i) {
+    m_localCounts[i] = m_globalCounts[i] = m_lastCounts[i] = 0;
+  }
+}
+
+template<typename T>
+SendBuffer<T>::~SendBuffer()
+{
+  // a completed migration leaves no communication in progress
+  cf_assert(!m_countsInFlight);
+  cf_assert(m_pendingSends.empty());
 }
 
 template<typename T>
@@ -82,6 +149,12 @@ bool SendBuffer<T>::sincronize( std::vector<T> &recvBuffer, bool isLastPhoton)
     return isLastPhoton;
   } 
 
+#if MPI_VERSION >= 3
+  if (m_asynchronous) {
+    return sincronizeAsynchronous(recvBuffer, isLastPhoton);
+  }
+#endif
+
  
   CFuint nbPhotonsSend=0;
   std::vector<int> displacements(m_nbProcesses);
@@ -135,6 +208,162 @@ bool SendBuffer<T>::sincronize( std::vector<T> &recvBuffer, bool isLastPhoton)
 		Common::MPIStructDef::getMPIType(&nbPhotonsRecv), MPI_SUM, m_comm);
   return (totalPhotonsRecv == 0);
 }  
+
+/// tag of the particles migrated asynchronously, alternated between two
+/// migrations since a process can start the next one before the others
+/// have detected the end of the current one
+static const int ASYNC_PARTICLE_TAG = 7401;
+
+template<typename T>
+bool SendBuffer<T>::sincronizeAsynchronous( std::vector<T> &recvBuffer, bool isLastPhoton)
+{
+  postParticles();
+  testSentParticles();
+  
+  // the particles received so far are returned to be tracked right away
+  recvBuffer.clear();
+  receiveParticles(recvBuffer);
+  
+  // a process is idle when it has no more particles to generate or track:
+  // it can then only become active by receiving particles
+  const bool isIdle = isLastPhoton && recvBuffer.empty();
+  if (checkTermination(isIdle)) {
+    cf_assert(recvBuffer.empty());
+    return true;
+  }
+  if (!isIdle) return false;
+  
+  // wait for incoming particles or for the end of the migration
+  while (true) {
+    if (receiveParticles(recvBuffer)) {
+      // the reduction in progress carries the idle state of this process,
+      // but the counts of received particles tell the others it is active
+      return false;
+    }
+    if (checkTermination(true)) return true;
+    testSentParticles();
+  }
+  return false;
+}
+
+template<typename T>
+void SendBuffer<T>::postParticles()
+{
+  if (m_sendBuffer.empty()) return;
+  
+  // one message per destination, to the neighbor partitions only
+  const int tag = ASYNC_PARTICLE_TAG + m_epoch%2;
+  std::vector<typename std::list<std::pair<MPI_Request, std::vector<T> > >::iterator>
+    rankBuffer(m_nbProcesses, m_pendingSends.end());
+  for (CFuint i = 0; i < m_nbProcesses; ++i) {
+    if (m_sendCounts[i] > 0) {
+      m_pendingSends.push_back(std::make_pair(MPI_REQUEST_NULL, std::vector<T>()));
+      rankBuffer[i] = --m_pendingSends.end();
+      rankBuffer[i]->second.reserve(m_sendCounts[i]);
+    }
+  }
+  for (CFuint i = 0; i < m_sendBuffer.size(); ++i) {
+    rankBuffer[m_sendRanks[i]]->second.push_back(m_sendBuffer[i]);
+  }
+  for (CFuint i = 0; i < m_nbProcesses; ++i) {
+    if (m_sendCounts[i] > 0) {
+      std::vector<T>& particles = rankBuffer[i]->second;
+      Common::MPIError::getInstance().check
+        ("MPI_Isend", "SendBuffer::postParticles()",
+         MPI_Isend(&particles[0], particles.size(), m_MPIdatatype, i, tag, m_comm, &rankBuffer[i]->first));
+      m_nbSent += particles.size();
+      m_sendCounts[i] = 0;
+    }
+  }
+  
+  m_sendBuffer.clear();
+  m_sendRanks.clear();
+}
+
+template<typename T>
+void SendBuffer<T>::testSentParticles()
+{
+  typename std::list<std::pair<MPI_Request, std::vector<T> > >::iterator it = m_pendingSends.begin();
+  while (it != m_pendingSends.end()) {
+    int isSent = 0;
+    MPI_Test(&it->first, &isSent, MPI_STATUS_IGNORE);
+    if (isSent) {
+      it = m_pendingSends.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+template<typename T>
+bool SendBuffer<T>::receiveParticles(std::vector<T> &recvBuffer)
+{
+  const int tag = ASYNC_PARTICLE_TAG + m_epoch%2;
+  bool hasReceived = false;
+  while (true) {
+    int hasMessage = 0;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag, m_comm, &hasMessage, &status);
+    if (!hasMessage) break;
+    
+    int nbParticles = 0;
+    MPI_Get_count(&status, m_MPIdatatype, &nbParticles);
+    const CFuint start = recvBuffer.size();
+    recvBuffer.resize(start + nbParticles);
+    Common::MPIError::getInstance().check
+      ("MPI_Recv", "SendBuffer::receiveParticles()",
+       MPI_Recv(&recvBuffer[start], nbParticles, m_MPIdatatype, status.MPI_SOURCE, tag,
+                m_comm, MPI_STATUS_IGNORE));
+    m_nbReceived += nbParticles;
+    hasReceived = true;
+  }
+  return hasReceived;
+}
+
+template<typename T>
+bool SendBuffer<T>::checkTermination(const bool isIdle)
+{
+  if (m_countsInFlight) {
+    int isComplete = 0;
+    MPI_Test(&m_countsRequest, &isComplete, MPI_STATUS_IGNORE);
+    if (!isComplete) return false;
+    m_countsInFlight = false;
+    
+    // the same result is seen by all the processes, which all stop after
+    // the same reduction
+    const bool isQuiet = (m_globalCounts[2] == 0 && m_globalCounts[0] == m_globalCounts[1]);
+    const bool isOver = isQuiet && m_hasLastCounts &&
+      m_lastCounts[0] == m_globalCounts[0] && m_lastCounts[1] == m_globalCounts[1];
+    for (CFuint i = 0; i < 3; ++i) {
+      m_lastCounts[i] = m_globalCounts[i];
+    }
+    m_hasLastCounts = isQuiet;
+    
+    if (isOver) {
+      // all the particles have been received, so all the sends are complete
+      while (!m_pendingSends.empty()) {
+        MPI_Wait(&m_pendingSends.front().first, MPI_STATUS_IGNORE);
+        m_pendingSends.pop_front();
+      }
+      m_nbSent = 0;
+      m_nbReceived = 0;
+      m_hasLastCounts = false;
+      ++m_epoch;
+      return true;
+    }
+  }
+  
+  m_localCounts[0] = m_nbSent;
+  m_localCounts[1] = m_nbReceived;
+  m_localCounts[2] = (isIdle) ? 0 : 1;
+  Common::MPIError::getInstance().check
+    ("MPI_Iallreduce", "SendBuffer::checkTermination()",
+     MPI_Iallreduce(m_localCounts, m_globalCounts, 3, Common::MPIStructDef::getMPIType(&m_localCounts[0]),
+                    MPI_SUM, m_comm, &m_countsRequest));
+  m_countsInFlight = true;
+  return false;
+}
   
 }
   
@@ -0,0 +1,460 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "Common/FNVHash.hh"
+#include "Common/PE.hh"
+
+#ifdef CF_HAVE_MPI
+#include "Common/MPI/MPIStructDef.hh"
+#endif
+
+#include "Common/Stopwatch.hh"
+#include "Environment/DirPaths.hh"
+
+#include "Framework/DataProcessing.hh"
+#include "Framework/MethodCommandProvider.hh"
+#include "Framework/MeshData.hh"
+#include "Framework/PathAppender.hh"
+#include "Framework/PhysicalModel.hh"
+
+#include "MeshTools/MeshToolsFVM.hh"
+#include "MeshTools/ComputeWallDistanceBVH.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Framework;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace MeshTools {
+
+//////////////////////////////////////////////////////////////////////////////
+
+MethodCommandProvider<ComputeWallDistanceBVH, DataProcessingData, MeshToolsFVMModule>
+computeWallDistanceBVHProvider("ComputeWallDistanceBVH");
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+static T* bufferPtr(vector<T>& v) {return v.empty() ? CFNULL : &v[0];}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::defineConfigOptions(Config::OptionList& options)
+{
+  options.addConfigOption< CFuint >
+    ("LeafSize", "Maximum number of wall faces in a leaf of the hierarchy.");
+  options.addConfigOption< CFuint >
+    ("ReplicatedDepth", "Depth of the levels of the hierarchy replicated on all processors.");
+  options.addConfigOption< bool >
+    ("UseCache", "Read/write the distances from/to a cache file named after the mesh hash.");
+  options.addConfigOption< CFreal >
+    ("AcceptableDistance", "Distance below which the nodes of a cell are flagged.");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ComputeWallDistanceBVH::ComputeWallDistanceBVH(const std::string& name) :
+  ComputeWallDistance(name)
+{
+  addConfigOptionsTo(this);
+
+  m_leafSize = 4;
+  setParameter("LeafSize",&m_leafSize);
+
+  m_replicatedDepth = 3;
+  setParameter("ReplicatedDepth",&m_replicatedDepth);
+
+  m_useCache = true;
+  setParameter("UseCache",&m_useCache);
+
+  m_acceptableDistance = 0.;
+  setParameter("AcceptableDistance",&m_acceptableDistance);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ComputeWallDistanceBVH::~ComputeWallDistanceBVH()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::setup()
+{
+  CFAUTOTRACE;
+
+  ComputeWallDistance::setup();
+
+  DataHandle<CFreal> wallDistance = socket_wallDistance.getDataHandle();
+  wallDistance = MathTools::MathConsts::CFrealMax();
+  DataHandle<bool> nodeisAD = socket_nodeisAD.getDataHandle();
+  nodeisAD.resize(socket_nodes.getDataHandle().size());
+  nodeisAD = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::execute()
+{
+  CFAUTOTRACE;
+
+  CFLog(INFO, "ComputeWallDistanceBVH::execute() => Computing distance to the wall ...\n");
+
+  Stopwatch<WallTime> stp;
+  stp.start();
+
+  vector<CFuint> faceNbNodes;
+  vector<CFreal> faceCoords;
+  collectWallFaces(faceNbNodes, faceCoords);
+
+  const string hash = m_useCache ? computeMeshHash(faceCoords) : string();
+  if (m_useCache && readCache(hash)) {
+    CFLog(INFO, "ComputeWallDistanceBVH::execute() => distances read from cache " << hash << "\n");
+  }
+  else {
+    const CFuint dim = PhysicalModelStack::getActive()->getDim();
+    WallFaceBVH bvh;
+    bvh.build(dim, faceNbNodes, faceCoords, m_leafSize);
+
+    vector<CFreal> dist2;
+    computeDistances(bvh, dist2);
+
+    DataHandle<CFreal> wallDistance = socket_wallDistance.getDataHandle();
+    cf_assert(dist2.size() == wallDistance.size());
+    for (CFuint i = 0; i < dist2.size(); ++i) {
+      wallDistance[i] = std::sqrt(dist2[i]);
+    }
+
+    if (m_useCache) {
+      writeCache(hash);
+    }
+  }
+
+  flagNodesCloseToWall();
+
+  CFLog(INFO, "ComputeWallDistanceBVH::execute() => took " << stp.read() << "s\n");
+
+  if (PE::GetPE().GetProcessorCount(getMethodData().getNamespace()) == 1) {
+    printToFile();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::collectWallFaces(vector<CFuint>& faceNbNodes,
+					      vector<CFreal>& faceCoords) const
+{
+  DataHandle<Node*, GLOBAL> nodes = socket_nodes.getDataHandle();
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+
+  faceNbNodes.clear();
+  faceCoords.clear();
+  for (CFuint iTRS = 0; iTRS < _boundaryTRS.size(); ++iTRS) {
+    SafePtr<TopologicalRegionSet> faces = MeshDataStack::getActive()->getTrs(_boundaryTRS[iTRS]);
+    const CFuint nbFaces = faces->getLocalNbGeoEnts();
+    for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
+      const CFuint nbNodesInFace = faces->getNbNodesInGeo(iFace);
+      cf_assert((nbNodesInFace == 2 && dim == DIM_2D) ||
+		((nbNodesInFace == 3 || nbNodesInFace == 4) && dim == DIM_3D));
+      faceNbNodes.push_back(nbNodesInFace);
+      for (CFuint n = 0; n < nbNodesInFace; ++n) {
+	const Node& node = *nodes[faces->getNodeID(iFace, n)];
+	for (CFuint d = 0; d < dim; ++d) {
+	  faceCoords.push_back(node[d]);
+	}
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::computeDistances(const WallFaceBVH& bvh, vector<CFreal>& dist2)
+{
+  DataHandle<State*, GLOBAL> states = socket_states.getDataHandle();
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  const CFuint nbStates = states.size();
+
+  vector<CFreal> points(nbStates*dim);
+  for (CFuint i = 0; i < nbStates; ++i) {
+    const RealVector& coord = states[i]->getCoordinates();
+    for (CFuint d = 0; d < dim; ++d) {
+      points[i*dim + d] = coord[d];
+    }
+  }
+
+  // first search among the local wall faces
+  dist2.assign(nbStates, numeric_limits<CFreal>::max());
+  NearestQuery query;
+  query.bvh = &bvh;
+  query.points = bufferPtr(points);
+  query.stride = dim;
+  query.dist2 = bufferPtr(dist2);
+  parallelFor(0, nbStates, query);
+
+#ifdef CF_HAVE_MPI
+  const std::string nsp = getMethodData().getNamespace();
+  MPI_Comm comm = PE::GetPE().GetCommunicator(nsp);
+  const CFuint myRank = PE::GetPE().GetRank(nsp);
+  const CFuint nbProc = PE::GetPE().GetProcessorCount(nsp);
+  if (nbProc == 1) return;
+  
+  // the type is taken from a local value, dist2 being empty without states
+  CFreal realValue = 0.;
+  MPI_Datatype realType = MPIStructDef::getMPIType(&realValue);
+
+  // the first levels of each local hierarchy are replicated on all processors
+  const CFuint boxSize = 2*dim;
+  vector<CFreal> localBoxes;
+  bvh.getBoxes(m_replicatedDepth, localBoxes);
+
+  int localBoxesSize = localBoxes.size();
+  vector<int> boxesSize(nbProc, 0);
+  MPI_Allgather(&localBoxesSize, 1, MPI_INT, &boxesSize[0], 1, MPI_INT, comm);
+
+  vector<int> boxesDispl(nbProc, 0);
+  for (CFuint r = 1; r < nbProc; ++r) {
+    boxesDispl[r] = boxesDispl[r-1] + boxesSize[r-1];
+  }
+  vector<CFreal> boxes(boxesDispl[nbProc-1] + boxesSize[nbProc-1]);
+  MPI_Allgatherv(bufferPtr(localBoxes), localBoxesSize, realType,
+		 bufferPtr(boxes), &boxesSize[0], &boxesDispl[0],
+		 realType, comm);
+
+  if (boxes.empty()) {
+    throw Common::BadValueException
+      (FromHere(), "ComputeWallDistanceBVH::computeDistances() => no wall face found");
+  }
+
+  const CFuint nbBoxes = boxes.size()/boxSize;
+  vector<CFuint> boxOwner(nbBoxes);
+  for (CFuint r = 0; r < nbProc; ++r) {
+    for (CFuint b = boxesDispl[r]/boxSize; b < (boxesDispl[r] + boxesSize[r])/boxSize; ++b) {
+      boxOwner[b] = r;
+    }
+  }
+
+  WallFaceBVH boxTree;
+  boxTree.buildOverBoxes(dim, boxes, m_leafSize);
+
+  // a state is sent to the processors owning a box closer than the best
+  // distance known so far, bounded by the farthest point of the nearest box
+  vector<vector<CFuint> > sendStates(nbProc);
+  vector<CFuint> boxIDs;
+  vector<CFuint> ranks;
+  for (CFuint i = 0; i < nbStates; ++i) {
+    const CFreal* point = &points[i*dim];
+    dist2[i] = boxTree.boxesUpperBound2(point, dist2[i]);
+    boxTree.getBoxesCloserThan(point, dist2[i], boxIDs);
+
+    ranks.clear();
+    for (CFuint b = 0; b < boxIDs.size(); ++b) {
+      if (boxOwner[boxIDs[b]] != myRank) ranks.push_back(boxOwner[boxIDs[b]]);
+    }
+    sort(ranks.begin(), ranks.end());
+    ranks.erase(unique(ranks.begin(), ranks.end()), ranks.end());
+    for (CFuint r = 0; r < ranks.size(); ++r) {
+      sendStates[ranks[r]].push_back(i);
+    }
+  }
+
+  // queries: coordinates and current bound of each state
+  const CFuint stride = dim + 1;
+  vector<int> sendCount(nbProc, 0);
+  vector<int> sendDispl(nbProc, 0);
+  vector<CFreal> sendBuf;
+  for (CFuint r = 0; r < nbProc; ++r) {
+    sendDispl[r] = sendBuf.size();
+    sendCount[r] = sendStates[r].size()*stride;
+    for (CFuint s = 0; s < sendStates[r].size(); ++s) {
+      const CFuint i = sendStates[r][s];
+      sendBuf.insert(sendBuf.end(), &points[i*dim], &points[i*dim] + dim);
+      sendBuf.push_back(dist2[i]);
+    }
+  }
+
+  vector<int> recvCount(nbProc, 0);
+  MPI_Alltoall(&sendCount[0], 1, MPI_INT, &recvCount[0], 1, MPI_INT, comm);
+
+  vector<int> recvDispl(nbProc, 0);
+  for (CFuint r = 1; r < nbProc; ++r) {
+    recvDispl[r] = recvDispl[r-1] + recvCount[r-1];
+  }
+  vector<CFreal> recvBuf(recvDispl[nbProc-1] + recvCount[nbProc-1]);
+  MPI_Alltoallv(bufferPtr(sendBuf), &sendCount[0], &sendDispl[0], realType,
+		bufferPtr(recvBuf), &recvCount[0], &recvDispl[0], realType,
+		comm);
+
+  // answer the queries of the other processors with the local wall faces
+  const CFuint nbQueries = recvBuf.size()/stride;
+  vector<CFreal> answers(nbQueries);
+  for (CFuint q = 0; q < nbQueries; ++q) {
+    answers[q] = recvBuf[q*stride + dim];
+  }
+  query.points = bufferPtr(recvBuf);
+  query.stride = stride;
+  query.dist2 = bufferPtr(answers);
+  parallelFor(0, nbQueries, query);
+
+  for (CFuint r = 0; r < nbProc; ++r) {
+    sendCount[r] /= stride;
+    sendDispl[r] /= stride;
+    recvCount[r] /= stride;
+    recvDispl[r] /= stride;
+  }
+  vector<CFreal> results(sendBuf.size()/stride);
+  MPI_Alltoallv(bufferPtr(answers), &recvCount[0], &recvDispl[0], realType,
+		bufferPtr(results), &sendCount[0], &sendDispl[0], realType,
+		comm);
+
+  for (CFuint r = 0; r < nbProc; ++r) {
+    for (CFuint s = 0; s < sendStates[r].size(); ++s) {
+      const CFuint i = sendStates[r][s];
+      dist2[i] = std::min(dist2[i], results[sendDispl[r] + s]);
+    }
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::string ComputeWallDistanceBVH::computeMeshHash(const vector<CFreal>& faceCoords)
+{
+  DataHandle<State*, GLOBAL> states = socket_states.getDataHandle();
+  const std::string nsp = getMethodData().getNamespace();
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+
+  // 64-bit FNV-1a hash of the partition, of the state coordinates and of the wall faces
+  Common::FNVHash hash;
+
+  std::ostringstream key;
+  key << PE::GetPE().GetRank(nsp) << "/" << PE::GetPE().GetProcessorCount(nsp) << "/" << states.size();
+  for (CFuint iTRS = 0; iTRS < _boundaryTRS.size(); ++iTRS) {
+    key << "/" << _boundaryTRS[iTRS];
+  }
+  hash.add(key.str());
+
+  for (CFuint i = 0; i < states.size(); ++i) {
+    const RealVector& coord = states[i]->getCoordinates();
+    for (CFuint d = 0; d < dim; ++d) {
+      hash.addValue(coord[d]);
+    }
+  }
+
+  if (faceCoords.size() > 0) {
+    hash.add(&faceCoords[0], faceCoords.size()*sizeof(CFreal));
+  }
+
+  return hash.str();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static boost::filesystem::path getCacheFile(const std::string& outputFile, const std::string& hash)
+{
+  using namespace boost::filesystem;
+
+  const std::string name = basename(path(outputFile)) + "-" + hash + ".wdcache";
+  return PathAppender::getInstance().appendParallel
+    (Environment::DirPaths::getInstance().getResultsDir() / path(name));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool ComputeWallDistanceBVH::readCache(const std::string& hash)
+{
+  DataHandle<CFreal> wallDistance = socket_wallDistance.getDataHandle();
+  const boost::filesystem::path file = getCacheFile(_nameOutputFile, hash);
+
+  vector<CFreal> cached;
+  int found = 0;
+  ifstream fin(file.string().c_str(), ios::binary);
+  if (fin) {
+    CFuint nbStates = 0;
+    fin.read(reinterpret_cast<char*>(&nbStates), sizeof(CFuint));
+    if (fin && nbStates == wallDistance.size()) {
+      cached.resize(nbStates);
+      fin.read(reinterpret_cast<char*>(bufferPtr(cached)), nbStates*sizeof(CFreal));
+      found = (fin) ? 1 : 0;
+    }
+  }
+
+  // the computation is collective: all the processors must hit the cache
+#ifdef CF_HAVE_MPI
+  const std::string nsp = getMethodData().getNamespace();
+  int allFound = 0;
+  MPI_Allreduce(&found, &allFound, 1, MPI_INT, MPI_MIN, PE::GetPE().GetCommunicator(nsp));
+  found = allFound;
+#endif
+
+  if (found == 0) return false;
+
+  for (CFuint i = 0; i < cached.size(); ++i) {
+    wallDistance[i] = cached[i];
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::writeCache(const std::string& hash) const
+{
+  DataHandle<CFreal> wallDistance = socket_wallDistance.getDataHandle();
+  const boost::filesystem::path file = getCacheFile(_nameOutputFile, hash);
+
+  ofstream fout(file.string().c_str(), ios::binary);
+  if (!fout) {
+    CFLog(WARN, "ComputeWallDistanceBVH::writeCache() => cannot open " << file.string() << "\n");
+    return;
+  }
+
+  const CFuint nbStates = wallDistance.size();
+  fout.write(reinterpret_cast<const char*>(&nbStates), sizeof(CFuint));
+  for (CFuint i = 0; i < nbStates; ++i) {
+    const CFreal value = wallDistance[i];
+    fout.write(reinterpret_cast<const char*>(&value), sizeof(CFreal));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ComputeWallDistanceBVH::flagNodesCloseToWall()
+{
+  DataHandle<CFreal> wallDistance = socket_wallDistance.getDataHandle();
+  DataHandle<bool> nodeisAD = socket_nodeisAD.getDataHandle();
+  SafePtr<TopologicalRegionSet> cells = MeshDataStack::getActive()->getTrs("InnerCells");
+
+  // states and cells share the same local IDs in cell centered discretizations
+  const CFuint nbCells = std::min(cells->getLocalNbGeoEnts(), (CFuint)wallDistance.size());
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    if (wallDistance[iCell] < m_acceptableDistance) {
+      const CFuint nbNodesInCell = cells->getNbNodesInGeo(iCell);
+      for (CFuint in = 0; in < nbNodesInCell; ++in) {
+	const CFuint cellNodeID = cells->getNodeID(iCell, in);
+	cf_assert(cellNodeID < nodeisAD.size());
+	nodeisAD[cellNodeID] = true;
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace MeshTools
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,143 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_MeshTools_ComputeWallDistanceBVH_hh
+#define COOLFluiD_MeshTools_ComputeWallDistanceBVH_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "MeshTools/ComputeWallDistance.hh"
+#include "MeshTools/WallFaceBVH.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace MeshTools {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class computes the exact distance from the states to the wall faces
+ * with a bounding volume hierarchy distributed over the processors:
+ * each processor builds the hierarchy of its own wall faces (the leaves),
+ * while the boxes of its first levels are replicated on all processors.
+ * A state is then only sent to the processors owning a replicated box
+ * closer than the best distance found so far.
+ *
+ * The distances are cached in a binary file per processor, named after
+ * a hash of the mesh partition, so that restarts skip the computation.
+ */
+class ComputeWallDistanceBVH : public ComputeWallDistance {
+public:
+
+  /**
+   * Defines the Config Option's of this class
+   * @param options a OptionList where to add the Option's
+   */
+  static void defineConfigOptions(Config::OptionList& options);
+
+  /**
+   * Constructor.
+   */
+  ComputeWallDistanceBVH(const std::string& name);
+
+  /**
+   * Default destructor
+   */
+  ~ComputeWallDistanceBVH();
+
+  /**
+   * Set up private data and data of the aggregated classes
+   * in this command before processing phase
+   */
+  void setup();
+
+  /**
+   * Execute on a set of dofs
+   */
+  void execute();
+
+private: // helper functions
+
+  /**
+   * Collect the nodes of the local wall faces
+   */
+  void collectWallFaces(std::vector<CFuint>& faceNbNodes,
+			std::vector<CFreal>& faceCoords) const;
+
+  /**
+   * Compute the squared wall distance of all the states
+   */
+  void computeDistances(const WallFaceBVH& bvh, std::vector<CFreal>& dist2);
+
+  /**
+   * Hash of the local mesh partition and of the wall faces
+   */
+  std::string computeMeshHash(const std::vector<CFreal>& faceCoords);
+
+  /**
+   * Try to read the cached wall distances
+   * @return true if the cache file matches the current mesh
+   */
+  bool readCache(const std::string& hash);
+
+  /**
+   * Write the wall distances to the cache file
+   */
+  void writeCache(const std::string& hash) const;
+
+  /**
+   * Flag the nodes of the cells closer to the wall than AcceptableDistance
+   */
+  void flagNodesCloseToWall();
+
+private: // helper classes
+
+  /**
+   * This class computes nearest face distances for a range of points
+   */
+  struct NearestQuery {
+    const WallFaceBVH* bvh;
+    const CFreal* points;
+    CFuint stride;
+    CFreal* dist2;
+
+    void operator()(const CFuint first, const CFuint end, const CFuint threadID)
+    {
+      for (CFuint i = first; i < end; ++i) {
+	dist2[i] = bvh->nearestDistance2(&points[i*stride], dist2[i]);
+      }
+    }
+  };
+
+private: // data
+
+  /// maximum number of faces in a leaf of the hierarchy
+  CFuint m_leafSize;
+
+  /// depth of the levels of the hierarchy replicated on all processors
+  CFuint m_replicatedDepth;
+
+  /// flag telling whether the distances are cached
+  bool m_useCache;
+
+  /// distance below which the nodes are flagged
+  CFreal m_acceptableDistance;
+
+}; // end of class ComputeWallDistanceBVH
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace MeshTools
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_MeshTools_ComputeWallDistanceBVH_hh
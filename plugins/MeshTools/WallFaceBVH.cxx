@@ -0,0 +1,431 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Common/CFLog.hh"
+#include "MeshTools/WallFaceBVH.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace MeshTools {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// orders face IDs by the coordinate of their centroid along one axis
+struct CentroidLess {
+  CentroidLess(const vector<CFreal>& centroids, const CFuint dim, const CFuint axis) :
+    m_centroids(centroids), m_dim(dim), m_axis(axis) {}
+
+  bool operator()(const CFuint f1, const CFuint f2) const
+  {
+    return m_centroids[f1*m_dim + m_axis] < m_centroids[f2*m_dim + m_axis];
+  }
+
+  const vector<CFreal>& m_centroids;
+  const CFuint m_dim;
+  const CFuint m_axis;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+WallFaceBVH::WallFaceBVH() :
+  m_dim(0),
+  m_overBoxes(false),
+  m_tree(),
+  m_faceIDs(),
+  m_faceNbNodes(),
+  m_faceStart(),
+  m_faceCoords(),
+  m_centroids()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+WallFaceBVH::~WallFaceBVH()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void WallFaceBVH::build(const CFuint dim,
+			const vector<CFuint>& faceNbNodes,
+			const vector<CFreal>& faceCoords,
+			const CFuint leafSize)
+{
+  cf_assert(dim == DIM_2D || dim == DIM_3D);
+
+  m_dim = dim;
+  m_overBoxes = false;
+  m_faceNbNodes = faceNbNodes;
+  m_faceCoords = faceCoords;
+  m_tree.clear();
+
+  const CFuint nbFaces = faceNbNodes.size();
+  m_faceIDs.resize(nbFaces);
+  m_faceStart.resize(nbFaces);
+  m_centroids.assign(nbFaces*dim, 0.);
+
+  CFuint start = 0;
+  for (CFuint f = 0; f < nbFaces; ++f) {
+    m_faceIDs[f] = f;
+    m_faceStart[f] = start;
+    for (CFuint n = 0; n < faceNbNodes[f]; ++n) {
+      for (CFuint d = 0; d < dim; ++d) {
+	m_centroids[f*dim + d] += faceCoords[start + n*dim + d];
+      }
+    }
+    for (CFuint d = 0; d < dim; ++d) {
+      m_centroids[f*dim + d] /= (CFreal)faceNbNodes[f];
+    }
+    start += faceNbNodes[f]*dim;
+  }
+  cf_assert(start == faceCoords.size());
+
+  if (nbFaces > 0) {
+    m_tree.reserve(2*nbFaces/std::max<CFuint>(leafSize, 1) + 1);
+    buildNode(0, nbFaces, std::max<CFuint>(leafSize, 1));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void WallFaceBVH::buildOverBoxes(const CFuint dim,
+				 const vector<CFreal>& boxes,
+				 const CFuint leafSize)
+{
+  // the two corners bound the same box as the box itself
+  build(dim, vector<CFuint>(boxes.size()/(2*dim), 2), boxes, leafSize);
+  m_overBoxes = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint WallFaceBVH::buildNode(const CFuint first, const CFuint count, const CFuint leafSize)
+{
+  const CFuint nodeID = m_tree.size();
+  m_tree.push_back(TreeNode());
+
+  TreeNode node;
+  node.children[0] = node.children[1] = 0;
+  node.first = first;
+  node.count = count;
+
+  // box of all the face nodes and extent of the face centroids
+  CFreal cmin[3];
+  CFreal cmax[3];
+  for (CFuint d = 0; d < m_dim; ++d) {
+    node.box[d] = cmin[d] = numeric_limits<CFreal>::max();
+    node.box[m_dim + d] = cmax[d] = -numeric_limits<CFreal>::max();
+  }
+
+  for (CFuint i = first; i < first + count; ++i) {
+    const CFuint f = m_faceIDs[i];
+    const CFreal* coords = &m_faceCoords[m_faceStart[f]];
+    for (CFuint n = 0; n < m_faceNbNodes[f]; ++n) {
+      for (CFuint d = 0; d < m_dim; ++d) {
+	node.box[d] = std::min(node.box[d], coords[n*m_dim + d]);
+	node.box[m_dim + d] = std::max(node.box[m_dim + d], coords[n*m_dim + d]);
+      }
+    }
+    for (CFuint d = 0; d < m_dim; ++d) {
+      cmin[d] = std::min(cmin[d], m_centroids[f*m_dim + d]);
+      cmax[d] = std::max(cmax[d], m_centroids[f*m_dim + d]);
+    }
+  }
+
+  CFuint axis = 0;
+  for (CFuint d = 1; d < m_dim; ++d) {
+    if (cmax[d] - cmin[d] > cmax[axis] - cmin[axis]) axis = d;
+  }
+
+  if (count > leafSize && cmax[axis] > cmin[axis]) {
+    // median split along the largest extent of the centroids
+    const CFuint half = count/2;
+    nth_element(m_faceIDs.begin() + first, m_faceIDs.begin() + first + half,
+		m_faceIDs.begin() + first + count, CentroidLess(m_centroids, m_dim, axis));
+    node.children[0] = buildNode(first, half, leafSize);
+    node.children[1] = buildNode(first + half, count - half, leafSize);
+  }
+
+  m_tree[nodeID] = node;
+  return nodeID;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void WallFaceBVH::getBoxes(const CFuint depth, vector<CFreal>& boxes) const
+{
+  boxes.clear();
+  if (m_tree.empty()) return;
+
+  vector<pair<CFuint, CFuint> > stack(1, pair<CFuint, CFuint>(0, 0));
+  while (!stack.empty()) {
+    const CFuint nodeID = stack.back().first;
+    const CFuint level = stack.back().second;
+    stack.pop_back();
+
+    const TreeNode& node = m_tree[nodeID];
+    if (level == depth || node.children[0] == 0) {
+      boxes.insert(boxes.end(), node.box, node.box + 2*m_dim);
+    }
+    else {
+      stack.push_back(pair<CFuint, CFuint>(node.children[0], level + 1));
+      stack.push_back(pair<CFuint, CFuint>(node.children[1], level + 1));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::nearestDistance2(const CFreal* point, const CFreal bound2) const
+{
+  CFreal best2 = bound2;
+  if (m_tree.empty()) return best2;
+
+  // the median split keeps the depth logarithmic, far below the stack size
+  CFuint stack[128];
+  CFuint top = 0;
+  stack[top++] = 0;
+
+  while (top > 0) {
+    const TreeNode& node = m_tree[stack[--top]];
+    if (boxMinDistance2(m_dim, node.box, point) >= best2) continue;
+
+    if (node.children[0] == 0) {
+      for (CFuint i = node.first; i < node.first + node.count; ++i) {
+	best2 = std::min(best2, faceDistance2(m_faceIDs[i], point));
+      }
+    }
+    else {
+      // the nearest child is visited first, to tighten the bound sooner
+      const CFuint c0 = node.children[0];
+      const CFuint c1 = node.children[1];
+      const CFreal d0 = boxMinDistance2(m_dim, m_tree[c0].box, point);
+      const CFreal d1 = boxMinDistance2(m_dim, m_tree[c1].box, point);
+      cf_assert(top + 2 <= 128);
+      if (d0 < d1) {
+	if (d1 < best2) stack[top++] = c1;
+	if (d0 < best2) stack[top++] = c0;
+      }
+      else {
+	if (d0 < best2) stack[top++] = c0;
+	if (d1 < best2) stack[top++] = c1;
+      }
+    }
+  }
+
+  return best2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::boxesUpperBound2(const CFreal* point, const CFreal bound2) const
+{
+  cf_assert(m_overBoxes);
+
+  CFreal best2 = bound2;
+  if (m_tree.empty()) return best2;
+
+  // a subtree cannot lower the bound if it is entirely farther than it
+  vector<CFuint> stack(1, 0);
+  while (!stack.empty()) {
+    const TreeNode& node = m_tree[stack.back()];
+    stack.pop_back();
+    if (boxMinDistance2(m_dim, node.box, point) >= best2) continue;
+
+    if (node.children[0] == 0) {
+      for (CFuint i = node.first; i < node.first + node.count; ++i) {
+	const CFreal* box = &m_faceCoords[m_faceStart[m_faceIDs[i]]];
+	best2 = std::min(best2, boxMaxDistance2(m_dim, box, point));
+      }
+    }
+    else {
+      stack.push_back(node.children[0]);
+      stack.push_back(node.children[1]);
+    }
+  }
+
+  return best2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void WallFaceBVH::getBoxesCloserThan(const CFreal* point, const CFreal bound2,
+				     vector<CFuint>& boxIDs) const
+{
+  cf_assert(m_overBoxes);
+
+  boxIDs.clear();
+  if (m_tree.empty()) return;
+
+  vector<CFuint> stack(1, 0);
+  while (!stack.empty()) {
+    const TreeNode& node = m_tree[stack.back()];
+    stack.pop_back();
+    if (boxMinDistance2(m_dim, node.box, point) >= bound2) continue;
+
+    if (node.children[0] == 0) {
+      for (CFuint i = node.first; i < node.first + node.count; ++i) {
+	const CFreal* box = &m_faceCoords[m_faceStart[m_faceIDs[i]]];
+	if (boxMinDistance2(m_dim, box, point) < bound2) {
+	  boxIDs.push_back(m_faceIDs[i]);
+	}
+      }
+    }
+    else {
+      stack.push_back(node.children[0]);
+      stack.push_back(node.children[1]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::boxMinDistance2(const CFuint dim, const CFreal* box, const CFreal* point)
+{
+  CFreal dist2 = 0.;
+  for (CFuint d = 0; d < dim; ++d) {
+    const CFreal delta = std::max(std::max(box[d] - point[d], point[d] - box[dim + d]), 0.);
+    dist2 += delta*delta;
+  }
+  return dist2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::boxMaxDistance2(const CFuint dim, const CFreal* box, const CFreal* point)
+{
+  CFreal dist2 = 0.;
+  for (CFuint d = 0; d < dim; ++d) {
+    const CFreal delta = std::max(std::abs(point[d] - box[d]), std::abs(point[d] - box[dim + d]));
+    dist2 += delta*delta;
+  }
+  return dist2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::faceDistance2(const CFuint faceID, const CFreal* point) const
+{
+  const CFreal* c = &m_faceCoords[m_faceStart[faceID]];
+  const CFuint nbNodes = m_faceNbNodes[faceID];
+
+  if (m_overBoxes) {
+    return boxMinDistance2(m_dim, c, point);
+  }
+
+  if (m_dim == DIM_2D) {
+    cf_assert(nbNodes == 2);
+    return segmentDistance2(&c[0], &c[2], point);
+  }
+
+  cf_assert(nbNodes == 3 || nbNodes == 4);
+  const CFreal dist2 = triangleDistance2(&c[0], &c[3], &c[6], point);
+  return (nbNodes == 3) ? dist2 : std::min(dist2, triangleDistance2(&c[0], &c[6], &c[9], point));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::segmentDistance2(const CFreal* a, const CFreal* b, const CFreal* p) const
+{
+  CFreal ab2 = 0.;
+  CFreal apab = 0.;
+  for (CFuint d = 0; d < m_dim; ++d) {
+    ab2 += (b[d] - a[d])*(b[d] - a[d]);
+    apab += (p[d] - a[d])*(b[d] - a[d]);
+  }
+
+  const CFreal t = (ab2 > 0.) ? std::max(0., std::min(1., apab/ab2)) : 0.;
+  CFreal dist2 = 0.;
+  for (CFuint d = 0; d < m_dim; ++d) {
+    const CFreal delta = p[d] - (a[d] + t*(b[d] - a[d]));
+    dist2 += delta*delta;
+  }
+  return dist2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal WallFaceBVH::triangleDistance2(const CFreal* a, const CFreal* b, const CFreal* c,
+				      const CFreal* p) const
+{
+  // closest point by Voronoi regions of the vertices, edges and face
+  CFreal ab[3], ac[3], ap[3], bp[3], cp[3];
+  for (CFuint d = 0; d < 3; ++d) {
+    ab[d] = b[d] - a[d];
+    ac[d] = c[d] - a[d];
+    ap[d] = p[d] - a[d];
+    bp[d] = p[d] - b[d];
+    cp[d] = p[d] - c[d];
+  }
+
+  const CFreal d1 = ab[0]*ap[0] + ab[1]*ap[1] + ab[2]*ap[2];
+  const CFreal d2 = ac[0]*ap[0] + ac[1]*ap[1] + ac[2]*ap[2];
+  const CFreal d3 = ab[0]*bp[0] + ab[1]*bp[1] + ab[2]*bp[2];
+  const CFreal d4 = ac[0]*bp[0] + ac[1]*bp[1] + ac[2]*bp[2];
+  const CFreal d5 = ab[0]*cp[0] + ab[1]*cp[1] + ab[2]*cp[2];
+  const CFreal d6 = ac[0]*cp[0] + ac[1]*cp[1] + ac[2]*cp[2];
+
+  CFreal v = 0.;
+  CFreal w = 0.;
+  const CFreal vc = d1*d4 - d3*d2;
+  const CFreal vb = d5*d2 - d1*d6;
+  const CFreal va = d3*d6 - d5*d4;
+
+  if (d1 <= 0. && d2 <= 0.) {
+    v = w = 0.;
+  }
+  else if (d3 >= 0. && d4 <= d3) {
+    v = 1.; w = 0.;
+  }
+  else if (d6 >= 0. && d5 <= d6) {
+    v = 0.; w = 1.;
+  }
+  else if (vc <= 0. && d1 >= 0. && d3 <= 0.) {
+    v = d1/(d1 - d3); w = 0.;
+  }
+  else if (vb <= 0. && d2 >= 0. && d6 <= 0.) {
+    v = 0.; w = d2/(d2 - d6);
+  }
+  else if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.) {
+    w = (d4 - d3)/((d4 - d3) + (d5 - d6));
+    v = 1. - w;
+  }
+  else {
+    const CFreal denom = va + vb + vc;
+    if (!(denom > 0.)) {
+      // degenerate triangle
+      return std::min(segmentDistance2(a, b, p), segmentDistance2(a, c, p));
+    }
+    v = vb/denom;
+    w = vc/denom;
+  }
+
+  CFreal dist2 = 0.;
+  for (CFuint d = 0; d < 3; ++d) {
+    const CFreal delta = ap[d] - v*ab[d] - w*ac[d];
+    dist2 += delta*delta;
+  }
+  return dist2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace MeshTools
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,185 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_MeshTools_WallFaceBVH_hh
+#define COOLFluiD_MeshTools_WallFaceBVH_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Common/COOLFluiD.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace MeshTools {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class is a bounding volume hierarchy (axis aligned boxes) over a set
+ * of wall faces: segments in 2D, triangles and quadrilaterals in 3D.
+ * It answers nearest face queries, pruning the boxes farther than the
+ * current best distance.
+ *
+ * Quadrilaterals are split in two triangles for the distance computation.
+ * The same hierarchy can be built over boxes instead of faces, to find the
+ * boxes which may contain the faces nearest to a point.
+ */
+class WallFaceBVH {
+public:
+
+  /**
+   * Constructor
+   */
+  WallFaceBVH();
+
+  /**
+   * Default destructor
+   */
+  ~WallFaceBVH();
+
+  /**
+   * Build the hierarchy
+   * @param dim         space dimension
+   * @param faceNbNodes number of nodes of each face
+   * @param faceCoords  node coordinates of all the faces, face after face
+   * @param leafSize    maximum number of faces in a leaf
+   */
+  void build(const CFuint dim,
+	     const std::vector<CFuint>& faceNbNodes,
+	     const std::vector<CFreal>& faceCoords,
+	     const CFuint leafSize);
+
+  /**
+   * Build the hierarchy over boxes instead of faces
+   * @param dim      space dimension
+   * @param boxes    (min, max) coordinates of the boxes: 2*dim values per box
+   * @param leafSize maximum number of boxes in a leaf
+   */
+  void buildOverBoxes(const CFuint dim,
+		      const std::vector<CFreal>& boxes,
+		      const CFuint leafSize);
+
+  /**
+   * @return true if the hierarchy contains no face
+   */
+  bool isEmpty() const {return m_tree.empty();}
+
+  /**
+   * Get the boxes of the tree nodes at the given depth, or of the leaves
+   * above it, as (min, max) coordinates: 2*dim values per box
+   */
+  void getBoxes(const CFuint depth, std::vector<CFreal>& boxes) const;
+
+  /**
+   * Squared distance from a point to the nearest face
+   * @param point  coordinates of the point
+   * @param bound2 squared distance beyond which faces are ignored
+   * @return the squared distance, or bound2 if no face is closer
+   */
+  CFreal nearestDistance2(const CFreal* point, const CFreal bound2) const;
+
+  /**
+   * Upper bound of the squared distance from a point to the contents of the
+   * boxes: the smallest squared distance to the farthest point of a box
+   * @pre the hierarchy is built over boxes
+   * @param bound2 initial bound
+   */
+  CFreal boxesUpperBound2(const CFreal* point, const CFreal bound2) const;
+
+  /**
+   * Get the boxes closer to a point than the given squared distance
+   * @pre the hierarchy is built over boxes
+   * @param boxIDs IDs of the boxes, in the order given to buildOverBoxes()
+   */
+  void getBoxesCloserThan(const CFreal* point, const CFreal bound2,
+			  std::vector<CFuint>& boxIDs) const;
+
+  /**
+   * Squared distance from a point to the closest point of a box
+   */
+  static CFreal boxMinDistance2(const CFuint dim, const CFreal* box, const CFreal* point);
+
+  /**
+   * Squared distance from a point to the farthest point of a box
+   */
+  static CFreal boxMaxDistance2(const CFuint dim, const CFreal* box, const CFreal* point);
+
+private: // helper functions
+
+  /**
+   * Build the subtree over m_faceIDs[first, first+count)
+   * @return the ID of the root of the subtree
+   */
+  CFuint buildNode(const CFuint first, const CFuint count, const CFuint leafSize);
+
+  /**
+   * Squared distance from a point to a face
+   */
+  CFreal faceDistance2(const CFuint faceID, const CFreal* point) const;
+
+  /**
+   * Squared distance from a point to a segment
+   */
+  CFreal segmentDistance2(const CFreal* a, const CFreal* b, const CFreal* p) const;
+
+  /**
+   * Squared distance from a point to a triangle
+   */
+  CFreal triangleDistance2(const CFreal* a, const CFreal* b, const CFreal* c,
+			   const CFreal* p) const;
+
+private: // helper classes
+
+  /// node of the hierarchy: a leaf has no children and refers to
+  /// m_faceIDs[first, first+count)
+  struct TreeNode {
+    CFreal box[6];
+    CFuint children[2];
+    CFuint first;
+    CFuint count;
+  };
+
+private: // data
+
+  /// space dimension
+  CFuint m_dim;
+
+  /// the items are boxes, stored as faces of two nodes (min and max corners)
+  bool m_overBoxes;
+
+  /// nodes of the hierarchy, the root being the first one
+  std::vector<TreeNode> m_tree;
+
+  /// face IDs, reordered so that each node refers to a contiguous range
+  std::vector<CFuint> m_faceIDs;
+
+  /// number of nodes of each face
+  std::vector<CFuint> m_faceNbNodes;
+
+  /// start of the coordinates of each face in m_faceCoords
+  std::vector<CFuint> m_faceStart;
+
+  /// node coordinates of all the faces
+  std::vector<CFreal> m_faceCoords;
+
+  /// coordinates of the face centroids
+  std::vector<CFreal> m_centroids;
+
+}; // end of class WallFaceBVH
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace MeshTools
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_MeshTools_WallFaceBVH_hh
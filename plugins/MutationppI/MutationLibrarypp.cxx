@@ -4,6 +4,7 @@
 #include "Common/Stopwatch.hh"
 #include "Environment/ObjectProvider.hh"
 #include "Common/StringOps.hh"
+#include "Common/PE.hh"
 #include <fstream>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -50,6 +51,12 @@ void MutationLibrarypp::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< CFdouble >("Pmax","Maximum pressure in the table.");
   options.addConfigOption< CFdouble >("Pmin","Minimum pressure in the table.");
   options.addConfigOption< CFdouble >("deltaP","Delta pressure.");
+  options.addConfigOption< bool >
+    ("UniformLookUpTable","Flag telling to locate T and p in O(1) in the lookup table (p geometrically spaced if pLogScale).");
+  options.addConfigOption< bool >
+    ("LookUpCubic","Flag telling to use the monotone bicubic interpolation in the uniform lookup table.");
+  options.addConfigOption< std::string >
+    ("LookUpCacheFile","Name of the file where the uniform lookup table is cached (none if empty).");
 }
       
 //////////////////////////////////////////////////////////////////////////////
@@ -73,7 +80,11 @@ MutationLibrarypp::MutationLibrarypp(const std::string& name) :
   m_hf(),  
   m_Tstate(),
   _nameToIdxVar(), //@modif_LkT
-  _lookUpTables()
+  _lookUpTables(),
+  m_lkpIdxD(0),
+  m_lkpIdxH(0),
+  m_lkpIdxE(0),
+  m_lkpIdxA(0)
 {
   addConfigOptionsTo(this);
   
@@ -119,6 +130,15 @@ MutationLibrarypp::MutationLibrarypp(const std::string& name) :
 
   _deltaP = 1000.0;
   setParameter("deltaP",&_deltaP);
+  
+  m_uniformLookUpTable = false;
+  setParameter("UniformLookUpTable",&m_uniformLookUpTable);
+  
+  m_lookUpCubic = false;
+  setParameter("LookUpCubic",&m_lookUpCubic);
+  
+  m_lookUpCacheFile = "";
+  setParameter("LookUpCacheFile",&m_lookUpCacheFile);
 
 }
 
@@ -360,7 +380,7 @@ CFdouble MutationLibrarypp::soundSpeed(CFdouble& temp, CFdouble& pressure)
   	return m_gasMixture->equilibriumSoundSpeed();
 	}
 	else {
-		return _lookUpTables.get(temp, pressure, _nameToIdxVar.find("a"));
+		return getLookUpValue(temp, pressure, m_lkpIdxA);
 		}
 }
 
@@ -410,9 +430,9 @@ void MutationLibrarypp::setDensityEnthalpyEnergy(CFdouble& temp,
   	CFLog(DEBUG_MAX, "Mutation::setDensityEnthalpyEnergy() => " << dhe << ", " <<  m_y << "\n");
 	}
 	else{
-    dhe[0] = _lookUpTables.get(temp, pressure, _nameToIdxVar.find("d"));
-    dhe[1] = _lookUpTables.get(temp, pressure, _nameToIdxVar.find("h"));
-    dhe[2] = _lookUpTables.get(temp, pressure, _nameToIdxVar.find("e"));
+    dhe[0] = getLookUpValue(temp, pressure, m_lkpIdxD);
+    dhe[1] = getLookUpValue(temp, pressure, m_lkpIdxH);
+    dhe[2] = getLookUpValue(temp, pressure, m_lkpIdxE);
   }
 }
       
@@ -443,7 +463,7 @@ CFdouble MutationLibrarypp::density(CFdouble& temp,CFdouble& pressure,CFreal* tV
     return m_gasMixture->density();
 	}
   else {
-		return _lookUpTables.get(temp, pressure, _nameToIdxVar.find("d"));
+		return getLookUpValue(temp, pressure, m_lkpIdxD);
 	}
 }
 
@@ -486,7 +506,7 @@ CFdouble MutationLibrarypp::energy(CFdouble& temp,CFdouble& pressure)
   	return m_gasMixture->mixtureEnergyMass()- m_H0;
 	}
   else {
-		return _lookUpTables.get(temp, pressure, _nameToIdxVar.find("e"));
+		return getLookUpValue(temp, pressure, m_lkpIdxE);
 	}
 }
       
@@ -499,7 +519,7 @@ CFdouble MutationLibrarypp::enthalpy(CFdouble& temp,CFdouble& pressure)
   	return m_gasMixture->mixtureHMass() - m_H0;
 	}
   else{
-		 return _lookUpTables.get(temp, pressure, _nameToIdxVar.find("h"));
+		 return getLookUpValue(temp, pressure, m_lkpIdxH);
 	}
 
 }
@@ -645,6 +665,106 @@ void MutationLibrarypp::getMassProductionTerm(CFdouble& temperature,
       
 //////////////////////////////////////////////////////////////////////////////
 
+void MutationLibrarypp::setDensityEnthalpyEnergyBatch(const CFuint nb,
+						      const CFdouble* temp,
+						      const CFdouble* pressure,
+						      CFdouble* dhe,
+						      CFdouble* gammaAndA)
+{
+  // in the other state models, the single-cell functions mix the equilibrium 
+  // and the nonequilibrium mixtures
+  if (m_smType != LTE) {
+    PhysicalChemicalLibrary::setDensityEnthalpyEnergyBatch(nb, temp, pressure, dhe, gammaAndA);
+    return;
+  }
+  
+  const bool tabulated = _useLookUpTable && m_lkpIdxD < _lkpVarNames.size() && 
+    m_lkpIdxH < _lkpVarNames.size() && m_lkpIdxE < _lkpVarNames.size();
+  if (tabulated && m_uniformLookUpTable && gammaAndA == CFNULL) {
+    // one pass over the cells per variable
+    m_uniformLookUpTables.get(nb, temp, pressure, m_lkpIdxD, &dhe[0], 3);
+    m_uniformLookUpTables.get(nb, temp, pressure, m_lkpIdxH, &dhe[1], 3);
+    m_uniformLookUpTables.get(nb, temp, pressure, m_lkpIdxE, &dhe[2], 3);
+    return;
+  }
+  
+  for (CFuint i = 0; i < nb; ++i) {
+    CFdouble T = temp[i];
+    CFdouble p = pressure[i];
+    CFdouble *const dheCell = &dhe[3*i];
+    if (tabulated) {
+      dheCell[0] = getLookUpValue(T, p, m_lkpIdxD);
+      dheCell[1] = getLookUpValue(T, p, m_lkpIdxH);
+      dheCell[2] = getLookUpValue(T, p, m_lkpIdxE);
+      if (gammaAndA == CFNULL) continue;
+    }
+    
+    if (T < 100.) {T = 100.;}
+    m_gasMixture->setState(&p, &T, 1);
+    if (!tabulated) {
+      dheCell[0] = m_gasMixture->density();
+      dheCell[1] = m_gasMixture->mixtureHMass() - m_H0;
+      dheCell[2] = dheCell[1] - p/dheCell[0];
+    }
+    if (gammaAndA != CFNULL) {
+      gammaAndA[2*i]   = m_gasMixture->mixtureEquilibriumGamma();
+      gammaAndA[2*i+1] = m_gasMixture->equilibriumSoundSpeed();
+    }
+  }
+  
+  // leave the composition of the last cell as setComposition() would do
+  if (nb > 0 && !tabulated) {
+    m_gasMixture->convert<X_TO_Y>(m_gasMixture->X(), &m_y[0]);
+  }
+}
+      
+//////////////////////////////////////////////////////////////////////////////
+
+void MutationLibrarypp::gammaAndSoundSpeedBatch(const CFuint nb,
+						const CFdouble* temp,
+						const CFdouble* pressure,
+						const CFdouble* rho,
+						CFdouble* gamma,
+						CFdouble* soundSpeed)
+{
+  if (m_smType != LTE) {
+    PhysicalChemicalLibrary::gammaAndSoundSpeedBatch(nb, temp, pressure, rho, gamma, soundSpeed);
+    return;
+  }
+  
+  for (CFuint i = 0; i < nb; ++i) {
+    CFdouble T = std::max(temp[i], 100.);
+    m_gasMixture->setState(&pressure[i], &T, 1);
+    gamma[i] = m_gasMixture->mixtureEquilibriumGamma();
+    soundSpeed[i] = m_gasMixture->equilibriumSoundSpeed();
+  }
+}
+      
+//////////////////////////////////////////////////////////////////////////////
+
+void MutationLibrarypp::getMassProductionTermBatch(const CFuint nb,
+						   const CFuint nbTemps,
+						   const CFdouble* temp,
+						   const CFdouble* pressure,
+						   const CFdouble* rhoi,
+						   CFdouble* omega)
+{
+  cf_assert(nbTemps >= m_Tstate.size());
+  const CFuint nbSpecies = _NS;
+  if (_freezeChemistry) {
+    std::fill(omega, omega + nb*nbSpecies, 0.);
+    return;
+  }
+  
+  for (CFuint i = 0; i < nb; ++i) {
+    setState(const_cast<CFdouble*>(&rhoi[i*nbSpecies]), 
+	     const_cast<CFdouble*>(&temp[i*nbTemps]));
+    m_gasMixture->netProductionRates(&omega[i*nbSpecies]);
+  }
+}
+      
+//////////////////////////////////////////////////////////////////////////////
+
 void MutationLibrarypp::getSource(CFdouble& temperature,
 				 RealVector& tVec,
 				 CFdouble& pressure,
@@ -811,6 +931,15 @@ void MutationLibrarypp::setLookUpTables()
 }
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t MutationLibrarypp::getLookUpVarIdx(const std::string& name)
+{
+  bool isFound = false;
+  const size_t idx = _nameToIdxVar.find(name, isFound);
+  return (isFound) ? idx : _lkpVarNames.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MutationLibrarypp::setTables(vector<ComputeQuantity>& varComputeVec)
 {
   Common::Stopwatch<Common::WallTime> stp;
@@ -836,10 +965,22 @@ void MutationLibrarypp::setTables(vector<ComputeQuantity>& varComputeVec)
 	//d => 3
 	CFLog(NOTICE, ">> In setTables(): After sorting the mapping CFmap... \n");
 	_nameToIdxVar.print();
+  
+  // resolve once the indices used in the property evaluations
+  m_lkpIdxD = getLookUpVarIdx("d");
+  m_lkpIdxH = getLookUpVarIdx("h");
+  m_lkpIdxE = getLookUpVarIdx("e");
+  m_lkpIdxA = getLookUpVarIdx("a");
 	//a => 0
 	//d => 3
 	//e => 1
 	//h => 2
+  
+  if (m_uniformLookUpTable) {
+    setUniformTables(varComputeVec);
+    CFLog(NOTICE, "MutationLibrarypp::setTables() => took " << stp.read() << "s\n");
+    return;
+  }
 
 
   //_____________________________________________________________________________
@@ -1030,6 +1171,66 @@ void MutationLibrarypp::setTables(vector<ComputeQuantity>& varComputeVec)
 }
 ////////////////////////////////////////////////////////////////////////////////
 
+void MutationLibrarypp::setUniformTables(vector<ComputeQuantity>& varComputeVec)
+{
+  const CFuint nbLookUpVars = _lkpVarNames.size();
+  
+  // same number of points as the linear scales, the pressures being 
+  // geometrically spaced with the logarithmic scale
+  const CFuint nbT = static_cast<CFuint>((_Tmax - _Tmin)/_deltaT) + 1;
+  const CFuint nbP = static_cast<CFuint>((_pmax - _pmin)/_deltaP) + 1;
+  m_uniformLookUpTables.initialize(_Tmin, _Tmax, nbT, false, 
+				   _pmin, _pmax, nbP, _pLogScale, nbLookUpVars);
+  m_uniformLookUpTables.setCubic(m_lookUpCubic);
+  
+  // the tabulated variables depend on the mixture and on the state model;
+  // the table itself checks the first key and the spacing of both axes, 
+  // the bounds are also recorded to identify the file
+  std::string signature = _mixtureName + " " + _stateModelName + 
+    " H0=" + Common::StringOps::to_str(m_H0) + 
+    " T=[" + Common::StringOps::to_str(_Tmin) + "," + Common::StringOps::to_str(_Tmax) + "]" +
+    " p=[" + Common::StringOps::to_str(_pmin) + "," + Common::StringOps::to_str(_pmax) + "]" +
+    " vars=";
+  for (CFuint iVar = 0; iVar < nbLookUpVars; ++iVar) {
+    signature += _lkpVarNames[iVar] + " ";
+  }
+  
+  if (m_lookUpCacheFile != "" && 
+      m_uniformLookUpTables.readCache(m_lookUpCacheFile, signature)) {
+    CFLog(NOTICE, "MutationLibrarypp::setUniformTables() => read " << nbT << "x" << nbP 
+	  << " table from " << m_lookUpCacheFile << "\n");
+    return;
+  }
+  
+  CFLog(NOTICE, "MutationLibrarypp::setUniformTables() => computing " << nbT << "x" << nbP 
+	<< " table (T linear, p " << (_pLogScale ? "geometric" : "linear") << ")\n");
+  for (CFuint i = 0; i < nbT; ++i) {
+    for (CFuint j = 0; j < nbP; ++j) {
+      CFdouble T = m_uniformLookUpTables.getKey1(i);
+      CFdouble p = m_uniformLookUpTables.getKey2(j);
+      
+      // set the composition at first (here _useLookUpTable is still false)
+      setComposition(T, p, CFNULL);
+      for (CFuint iVar = 0; iVar < nbLookUpVars; ++iVar) {
+	m_uniformLookUpTables.insert(i, j, iVar, (this->*varComputeVec[iVar])(T, p));
+      }
+    }
+  }
+  
+  if (m_lookUpCacheFile != "" && PE::GetPE().GetRank("Default") == 0) {
+    if (m_uniformLookUpTables.writeCache(m_lookUpCacheFile, signature)) {
+      CFLog(NOTICE, "MutationLibrarypp::setUniformTables() => table written in " 
+	    << m_lookUpCacheFile << "\n");
+    }
+    else {
+      CFLog(WARN, "MutationLibrarypp::setUniformTables() => cannot write " 
+	    << m_lookUpCacheFile << "\n");
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MutationLibrarypp::getSourceTermVT(CFdouble& temperature,
 					RealVector& tVec,
 					CFdouble& pressure,
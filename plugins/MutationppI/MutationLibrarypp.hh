@@ -10,6 +10,7 @@
 #include "MathTools/RealMatrix.hh"
 #include <mutation++.h>
 #include "Common/LookupTable2D.hh" //@modif_LkT
+#include "Common/UniformLookupTable2D.hh"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -41,6 +42,12 @@ public:
    * @modif_LkT
    */
   typedef Common::LookupTable2D<CFdouble, CFdouble, CFdouble> LkpTable; 
+  
+  /**
+   * Table with uniformly (or geometrically) spaced keys
+   */
+  typedef Common::UniformLookupTable2D<CFdouble> UniformLkpTable;
+  
   /**
    * Constructor without arguments
    */
@@ -444,6 +451,39 @@ public:
 			     RealVector& omega,
            RealMatrix& jacobian);
   
+  /**
+   * Batched LTE density, enthalpy and energy (and optionally gamma and
+   * sound speed) with one equilibrium solve or table lookup per cell
+   * @see PhysicalChemicalLibrary::setDensityEnthalpyEnergyBatch()
+   */
+  void setDensityEnthalpyEnergyBatch(const CFuint nb,
+				     const CFdouble* temp,
+				     const CFdouble* pressure,
+				     CFdouble* dhe,
+				     CFdouble* gammaAndA = CFNULL);
+  
+  /**
+   * Batched LTE gamma and sound speed
+   * @see PhysicalChemicalLibrary::gammaAndSoundSpeedBatch()
+   */
+  void gammaAndSoundSpeedBatch(const CFuint nb,
+			       const CFdouble* temp,
+			       const CFdouble* pressure,
+			       const CFdouble* rho,
+			       CFdouble* gamma,
+			       CFdouble* soundSpeed);
+  
+  /**
+   * Batched mass production terms, writing directly in the output array
+   * @see PhysicalChemicalLibrary::getMassProductionTermBatch()
+   */
+  void getMassProductionTermBatch(const CFuint nb,
+				  const CFuint nbTemps,
+				  const CFdouble* temp,
+				  const CFdouble* pressure,
+				  const CFdouble* rhoi,
+				  CFdouble* omega);
+  
   /**
    * Returns the source term for the vibrational relaxation with VT transfer
    * @param temp the mixture temperature
@@ -595,6 +635,26 @@ protected: // helper function
    */
   void setTables(std::vector<ComputeQuantity>& varComputeVec);
   
+  /**
+   * @return the index of the given look up variable (the number of look up 
+   *         variables if it is not tabulated)
+   */
+  size_t getLookUpVarIdx(const std::string& name);
+  
+  /**
+   * Compute the uniform lookup tables or read them from the cache file
+   */
+  void setUniformTables(std::vector<ComputeQuantity>& varComputeVec);
+  
+  /**
+   * @return the tabulated value of the given look up variable
+   */
+  CFdouble getLookUpValue(const CFdouble temp, const CFdouble pressure, const size_t idx)
+  {
+    return (m_uniformLookUpTable) ? m_uniformLookUpTables.get(temp, pressure, idx) :
+      _lookUpTables.get(temp, pressure, idx);
+  }
+  
 protected: //variables
 
   /// flag telling if to use the look up tables
@@ -608,6 +668,18 @@ protected: //variables
 
   /// table of lookup tables
   LkpTable _lookUpTables;
+  
+  /// index of the density in the look up tables
+  size_t m_lkpIdxD;
+  
+  /// index of the enthalpy in the look up tables
+  size_t m_lkpIdxH;
+  
+  /// index of the energy in the look up tables
+  size_t m_lkpIdxE;
+  
+  /// index of the sound speed in the look up tables
+  size_t m_lkpIdxA;
 
   /// gas mixture pointer
   std::auto_ptr<Mutation::Mixture> m_gasMixture;
@@ -705,6 +777,18 @@ protected: //variables
   /// Delta pressure in the table
   CFdouble _deltaP;
 
+  /// flag telling to use the table with uniformly spaced keys
+  bool m_uniformLookUpTable;
+  
+  /// flag telling to use the monotone bicubic interpolation in the uniform table
+  bool m_lookUpCubic;
+  
+  /// name of the cache file of the uniform table (none if empty)
+  std::string m_lookUpCacheFile;
+  
+  /// table with uniformly spaced keys
+  UniformLkpTable m_uniformLookUpTables;
+
   /// Small disturbance
   CFdouble EPS;
 
@@ -83,6 +83,65 @@ void Euler2DNEQRhoivt::splitJacobian(RealMatrix& jacobPlus,
 //////////////////////////////////////////////////////////////////////////////
 
 void Euler2DNEQRhoivt::computePhysicalData(const State& state, RealVector& data)
+{
+  const CFreal rho = setMixtureData(state, data);
+  
+  // set the current species fractions in the thermodynamic library
+  // this has to be done right here, before computing any other thermodynamic quantity !!! 
+  _library->setSpeciesFractions(_ye);
+  
+  setThermodynamics(rho, state, data);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Euler2DNEQRhoivt::computeBlockPhysicalData(const vector<State*>& states,
+						vector<RealVector>& pdata,
+						const CFuint nbStates)
+{
+  cf_assert(nbStates <= states.size());
+  cf_assert(nbStates <= pdata.size());
+  cf_assert(_library.isNotNull());
+  
+  const CFuint nbSpecies = getModel()->getNbScalarVars(0);
+  const CFuint nbTemps = getNbLibraryTemperatures();
+  const CFuint nbDhe = 2 + nbTemps;
+  if (m_blockRho.size() < nbStates) {
+    m_blockRhoi.resize(nbSpecies*nbStates);
+    m_blockT.resize(nbTemps*nbStates);
+    m_blockRho.resize(nbStates);
+    m_blockTDim.resize(nbTemps*nbStates);
+    m_blockP.resize(nbStates);
+    m_blockDhe.resize(nbDhe*nbStates);
+    m_blockGammaA.resize(2*nbStates);
+  }
+  
+  const CFreal refRho = getModel()->getReferencePhysicalData()[EulerTerm::RHO];
+  for (CFuint i = 0; i < nbStates; ++i) {
+    const State& state = *states[i];
+    m_blockRho[i] = setMixtureData(state, pdata[i])*refRho;
+    for (CFuint ie = 0; ie < nbSpecies; ++ie) {
+      m_blockRhoi[i*nbSpecies + ie] = state[ie];
+    }
+    setLibraryTemperatures(state, &m_blockT[i*nbTemps], &m_blockTDim[i*nbTemps]);
+  }
+  
+  CFreal *const dhe = (!_skipEnergyData) ? &m_blockDhe[0] : CFNULL;
+  CFreal *const gammaAndA = (!_skipEnergyData) ? &m_blockGammaA[0] : CFNULL;
+  _library->setThermodynamicStateBatch(nbStates, nbTemps, &m_blockRhoi[0], &m_blockT[0],
+				       &m_blockRho[0], &m_blockTDim[0], &m_blockP[0],
+				       dhe, gammaAndA, _extraData);
+  
+  for (CFuint i = 0; i < nbStates; ++i) {
+    const CFreal *const dheI = (dhe != CFNULL) ? &m_blockDhe[i*nbDhe] : CFNULL;
+    setThermodynamicData(m_blockRho[i]/refRho, *states[i], m_blockP[i], dheI,
+			 &m_blockGammaA[2*i], pdata[i]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal Euler2DNEQRhoivt::setMixtureData(const State& state, RealVector& data)
 {
   const CFuint nbSpecies = getModel()->getNbScalarVars(0);
   
@@ -98,10 +157,6 @@ void Euler2DNEQRhoivt::computePhysicalData(const State& state, RealVector& data)
     _ye[ie] = state[ie]*ovRho;
   }
   
-  // set the current species fractions in the thermodynamic library
-  // this has to be done right here, before computing any other thermodynamic quantity !!! 
-  _library->setSpeciesFractions(_ye);
-  
   // set the species mass fractions
   const CFuint firstSpecies = getModel()->getFirstScalarVar(0);
   for (CFuint ie = 0; ie < nbSpecies; ++ie) {
@@ -115,7 +170,7 @@ void Euler2DNEQRhoivt::computePhysicalData(const State& state, RealVector& data)
   data[EulerTerm::VX] = u;
   data[EulerTerm::VY] = v;
   
-  setThermodynamics(rho, state, data);
+  return rho;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -334,30 +389,64 @@ void Euler2DNEQRhoivt::setThermodynamics(CFreal rho,
   _library->setState(rhoi, &Tdim);
   
   CFreal pdim = _library->pressure(rhodim, Tdim, CFNULL);
-  const CFreal p = (pdim - getModel()->getPressInf())/refData[EulerTerm::P];
   
   // unused //  const EquationSubSysDescriptor& eqSS = PhysicalModelStack::getActive()->getEquationSubSysDescriptor();
   // unused //  const CFuint iEqSS = eqSS.getEqSS();
   // unused //  const CFuint nbEqSS = eqSS.getTotalNbEqSS();
   
-  data[EulerTerm::P] = p; // dp in the case of incompressible flow
-  data[EulerTerm::T] = T;
-  data[EulerTerm::RHO] = rho;
-
+  CFreal gammaAndA[2] = {0., 0.};
   if (!_skipEnergyData) {
     _library->setDensityEnthalpyEnergy(Tdim, pdim,_dhe);
     _library->frozenGammaAndSoundSpeed(Tdim, pdim, rhodim,
-				 data[EulerTerm::GAMMA],
-				 data[EulerTerm::A], CFNULL);
+				 gammaAndA[0], gammaAndA[1], CFNULL);
+  }
+  
+  const CFreal *const dhe = (!_skipEnergyData) ? &_dhe[0] : CFNULL;
+  setThermodynamicData(rho, state, pdim, dhe, gammaAndA, data);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Euler2DNEQRhoivt::setThermodynamicData(CFreal rho,
+					    const State& state,
+					    CFreal pdim,
+					    const CFreal* dhe,
+					    const CFreal* gammaAndA,
+					    RealVector& data)
+{
+  const CFuint nbSpecies = getModel()->getNbScalarVars(0);
+  const RealVector& refData = getModel()->getReferencePhysicalData();
+  const CFreal p = (pdim - getModel()->getPressInf())/refData[EulerTerm::P];
+  
+  data[EulerTerm::P] = p; // dp in the case of incompressible flow
+  data[EulerTerm::T] = state[getTempID(nbSpecies)];
+  data[EulerTerm::RHO] = rho;
+  
+  if (dhe != CFNULL) {
+    data[EulerTerm::GAMMA] = gammaAndA[0];
+    data[EulerTerm::A] = gammaAndA[1];
     
     const CFreal V2 = data[EulerTerm::V]*data[EulerTerm::V];
-    data[EulerTerm::H] = _dhe[1]/refData[EulerTerm::H] + 0.5*V2;
-    data[EulerTerm::E] = _dhe[2]/refData[EulerTerm::H] + 0.5*V2;
+    data[EulerTerm::H] = dhe[1]/refData[EulerTerm::H] + 0.5*V2;
+    data[EulerTerm::E] = dhe[2]/refData[EulerTerm::H] + 0.5*V2;
   }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Euler2DNEQRhoivt::setLibraryTemperatures(const State& state,
+					      CFreal* temp,
+					      CFreal* tempDim)
+{
+  const CFuint nbSpecies = getModel()->getNbScalarVars(0);
+  const CFreal Tdim = state[getTempID(nbSpecies)]*
+    getModel()->getReferencePhysicalData()[EulerTerm::T];
+  temp[0] = Tdim;
+  tempDim[0] = Tdim;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Euler2DNEQRhoivt::computePressureDerivatives(const Framework::State& state, 
 						  RealVector& dp)
 {
@@ -110,6 +110,15 @@ public: // classes
   virtual void computePhysicalData(const Framework::State& state,
 				   RealVector& data);
   
+  /**
+   * Set the PhysicalData corresponding to the given States with one
+   * batched call to the thermodynamic library
+   * @see ConvectiveVarSet
+   */
+  virtual void computeBlockPhysicalData(const std::vector<Framework::State*>& states,
+					std::vector<RealVector>& pdata,
+					const CFuint nbStates);
+  
   /**
    * Set a State starting from the given PhysicalData
    * @see EulerPhysicalModel
@@ -132,6 +141,43 @@ protected:
 				 const Framework::State& state,
 				 RealVector& data);
   
+  /**
+   * Set the thermodynamic quantities in the physical data array from the
+   * dimensional pressure, energies, gamma and sound speed
+   * @param dhe        density, enthalpy, energy and vibrational energies,
+   *                   CFNULL if the energy data are skipped
+   * @param gammaAndA  frozen gamma and sound speed
+   */
+  virtual void setThermodynamicData(CFreal rho,
+				    const Framework::State& state,
+				    CFreal pdim,
+				    const CFreal* dhe,
+				    const CFreal* gammaAndA,
+				    RealVector& data);
+  
+  /**
+   * Set the species mass fractions and the velocity in the physical data
+   * array and in _ye
+   * @return the mixture density
+   */
+  CFreal setMixtureData(const Framework::State& state, RealVector& data);
+  
+  /**
+   * Get the number of temperatures passed to the library for each state
+   */
+  virtual CFuint getNbLibraryTemperatures() const
+  {
+    return 1;
+  }
+  
+  /**
+   * Set the temperatures passed to the library's setState() and the
+   * corresponding dimensional temperatures of the given state
+   */
+  virtual void setLibraryTemperatures(const Framework::State& state,
+				      CFreal* temp,
+				      CFreal* tempDim);
+  
   /**
    * Get the ID of the temperature given the number of species
    */
@@ -161,6 +207,27 @@ protected:
   
   /// array to store Rgas/molar mass for each species
   RealVector _Rspecies;
+  
+  /// partial densities of a block of states
+  std::vector<CFreal> m_blockRhoi;
+  
+  /// temperatures passed to the library for a block of states
+  std::vector<CFreal> m_blockT;
+  
+  /// dimensional densities of a block of states
+  std::vector<CFreal> m_blockRho;
+  
+  /// dimensional temperatures of a block of states
+  std::vector<CFreal> m_blockTDim;
+  
+  /// dimensional pressures of a block of states
+  std::vector<CFreal> m_blockP;
+  
+  /// density, enthalpy, energy and vibrational energies of a block of states
+  std::vector<CFreal> m_blockDhe;
+  
+  /// frozen gamma and sound speed of a block of states
+  std::vector<CFreal> m_blockGammaA;
 
 }; // end of class Euler2DNEQRhoivt
 
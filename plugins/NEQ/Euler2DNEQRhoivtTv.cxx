@@ -101,7 +101,6 @@ void Euler2DNEQRhoivtTv::setThermodynamics(CFreal rho,
   _library->setState(rhoi, Tvec);
   
   const CFuint nbTv = getModel()->getNbScalarVars(1);
-  const CFuint firstTv = getModel()->getFirstScalarVar(1);
   const CFuint startTv = nbSpecies + 3;
   
   for (CFuint ie = 0; ie < nbTv; ++ie) {
@@ -109,44 +108,77 @@ void Euler2DNEQRhoivtTv::setThermodynamics(CFreal rho,
   }
     
   CFreal pdim = _library->pressure(rhodim, Tdim, &_tvDim[0]);
-  const CFreal p = (pdim - getModel()->getPressInf())/refData[EulerTerm::P];
   
   // unused //  const EquationSubSysDescriptor& eqSS = PhysicalModelStack::getActive()->getEquationSubSysDescriptor();
   // unused //  const CFuint iEqSS = eqSS.getEqSS();
   // unused //  const CFuint nbEqSS = eqSS.getTotalNbEqSS();
   
-  data[EulerTerm::P] = p; // dp in the case of incompressible flow
-  data[EulerTerm::T] = T;
-  data[EulerTerm::RHO] = rho;
-  
+  CFreal gammaAndA[2] = {0., 0.};
   if (!_skipEnergyData) {
     _library->setDensityEnthalpyEnergy(Tdim, _tvDim, pdim,_dhe,_extraData);
+    _library->frozenGammaAndSoundSpeed(Tdim, pdim, rhodim,
+				       gammaAndA[0], gammaAndA[1], &_tvDim);
+  }
+  
+  const CFreal *const dhe = (!_skipEnergyData) ? &_dhe[0] : CFNULL;
+  setThermodynamicData(rho, state, pdim, dhe, gammaAndA, data);
+}
+
+//////////////////////////////////////////////////////////////////////////////
 
+void Euler2DNEQRhoivtTv::setThermodynamicData(CFreal rho,
+					      const State& state,
+					      CFreal pdim,
+					      const CFreal* dhe,
+					      const CFreal* gammaAndA,
+					      RealVector& data)
+{
+  Euler2DNEQRhoivt::setThermodynamicData(rho, state, pdim, dhe, gammaAndA, data);
+  
+  if (dhe != CFNULL) {
+    const RealVector& refData = getModel()->getReferencePhysicalData();
+    const CFuint nbTv = getModel()->getNbScalarVars(1);
+    const CFuint firstTv = getModel()->getFirstScalarVar(1);
     const CFuint nbTe = _library->getNbTe();
     const CFuint nbTvH = nbTv - nbTe;
-
+    
     // data stores the moleculare vibrational energy multiplied 
     // by the molecules mass fractions
     if (nbTvH != 0) {
        for (CFuint ie = 0; ie < nbTvH; ++ie) {
-           data[firstTv + ie] = _dhe[3 + ie]/refData[EulerTerm::H]; 
+           data[firstTv + ie] = dhe[3 + ie]/refData[EulerTerm::H]; 
        } 
     }
  
     if (nbTe == 1) {
-      data[firstTv + nbTvH] = _dhe[3 + nbTvH]/refData[EulerTerm::H];
+      data[firstTv + nbTvH] = dhe[3 + nbTvH]/refData[EulerTerm::H];
     }
-    
-    _library->frozenGammaAndSoundSpeed(Tdim, pdim, rhodim,
-				       data[EulerTerm::GAMMA],
-				       data[EulerTerm::A], &_tvDim);
-    
-    const CFreal V2 = data[EulerTerm::V]*data[EulerTerm::V];
-    data[EulerTerm::H] = _dhe[1]/refData[EulerTerm::H] + 0.5*V2;
-    data[EulerTerm::E] = _dhe[2]/refData[EulerTerm::H] + 0.5*V2;
   }
 }
-      
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint Euler2DNEQRhoivtTv::getNbLibraryTemperatures() const
+{
+  return 1 + getModel()->getNbScalarVars(1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Euler2DNEQRhoivtTv::setLibraryTemperatures(const State& state,
+						CFreal* temp,
+						CFreal* tempDim)
+{
+  // the state temperatures (T and Tv's) are passed as such to setState()
+  const CFuint TID = getTempID(getModel()->getNbScalarVars(0));
+  const CFuint nbTemps = getNbLibraryTemperatures();
+  const CFreal refT = getModel()->getReferencePhysicalData()[EulerTerm::T];
+  for (CFuint i = 0; i < nbTemps; ++i) {
+    temp[i] = state[TID + i];
+    tempDim[i] = state[TID + i]*refT;
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 void Euler2DNEQRhoivtTv::computeStateFromPhysicalData(const RealVector& data,
@@ -109,6 +109,30 @@ protected:
 				 const Framework::State& state, 
 				 RealVector& data);
   
+  /**
+   * Set the thermodynamic quantities, including the vibrational energies,
+   * in the physical data array
+   */
+  virtual void setThermodynamicData(CFreal rho,
+				    const Framework::State& state,
+				    CFreal pdim,
+				    const CFreal* dhe,
+				    const CFreal* gammaAndA,
+				    RealVector& data);
+  
+  /**
+   * Get the number of temperatures (T and Tv's) passed to the library
+   */
+  virtual CFuint getNbLibraryTemperatures() const;
+  
+  /**
+   * Set the temperatures passed to the library's setState() and the
+   * corresponding dimensional temperatures of the given state
+   */
+  virtual void setLibraryTemperatures(const Framework::State& state,
+				      CFreal* temp,
+				      CFreal* tempDim);
+  
 protected:
   
   /// array with all different vibrational dimensional temperatures
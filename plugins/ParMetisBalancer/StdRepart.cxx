@@ -16,6 +16,11 @@
 #include "Framework/MethodData.hh"
 #include "Framework/PathAppender.hh"
 #include "Framework/MeshCreator.hh"
+#include "Framework/ParMetis.hh"
+#include "Framework/SubSystemStatus.hh"
+#include "Environment/CFEnv.hh"
+#include "Common/EventHandler.hh"
+#include "Common/MPI/MPIStructDef.hh"
 
 #include "ParMetisBalancer/ParMetisBalancer.hh"
 #include "ParMetisBalancer/ParMetisBalancerModule.hh"
@@ -54,6 +59,25 @@ StdRepart::StdRepart(const std::string& name) :
   m_states(NULL)
 {
   /// Inicializes the command "StdRepart" and sets data socets to be used
+  addConfigOptionsTo(this);
+  
+  m_imbalanceThreshold = 1.1;
+  setParameter("ImbalanceThreshold",&m_imbalanceThreshold);
+  
+  m_checkRate = 10;
+  setParameter("CheckRate",&m_checkRate);
+  
+  m_writeDiagnostics = false;
+  setParameter("WriteDiagnostics",&m_writeDiagnostics);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StdRepart::defineConfigOptions(Config::OptionList& options)
+{
+  options.addConfigOption< CFreal >("ImbalanceThreshold","Ratio between maximum and mean load triggering the repartitioning");
+  options.addConfigOption< CFuint >("CheckRate","Number of iterations between two checks of the load imbalance");
+  options.addConfigOption< bool >("WriteDiagnostics","Run the cell exchange steps and write Tecplot diagnostics in ./FSOmesh");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -73,10 +97,26 @@ void StdRepart::configure(Config::ConfigArgs& args)
 
 void StdRepart::execute()
 {
+  const CFuint iter = SubSystemStatusStack::getActive()->getNbIter();
+  if (m_checkRate == 0 || iter == 0 || iter % m_checkRate != 0) return;
+  
   // Set handles to Cells, Nodes, States
   m_cells = MeshDataStack::getActive()->getTrs("InnerCells");
   m_nodes = MeshDataStack::getActive()->getNodeDataSocketSink().getDataHandle();
   m_states= socket_states.getDataHandle();
+  
+  // nothing to do if the measured load is balanced enough
+  if (!isImbalanced()) return;
+  
+  // the new partition is applied at restart only if it is stored in the 
+  // solution file, which only the binary CFmesh writer does
+  const string nsp = getMethodData().getNamespace();
+  if (!MeshDataStack::getActive()->getDataStorage()->checkData(nsp + "_partitionTargetWriter")) {
+    CFLog(WARN, "StdRepart::execute() => no ParCFmeshBinaryFileWriter is writing the solution: " 
+	  << "the new partition could not be applied at restart, no repartitioning is done\n");
+    return;
+  }
+  
   // Get info on send/recive nodes, apply part1 coloring
   setupDataStorage();
   // Create continus glogal mapping (requierd by PARMetis)
@@ -87,41 +127,120 @@ void StdRepart::execute()
   callParMetisAdaptiveRepart();
   // update interface data on part2 coloring
   UpdateInterfacePart2();
-  // select cells to be send (negotiate cell ownership)
-  SelectCellsToSend();
-  // select nodes to send
-  SelectNodesToSend();
-  // build MPI send/recive structures
-  PrepereMPIcommStruct();
-  // perform MPI communication session
-  MPICommunicate();
-  // Prepere data for mesh update
-  PrepereToUpdate();
-
-  // Raport the results
-  CFLogInfo("TecPlotFile write \n");
-  const CFuint dim = PhysicalModelStack::getActive()->getDim();
-  boost::filesystem::path path = "./FSOmesh/bal_test_interf.dat"; // Storage for testing purposes only
-  if(dim == 2) DoWriteTec<2>(path,true);
-  if(dim == 3) DoWriteTec<3>(path,true);
-  
-  path = "./FSOmesh/bal_test_nointerf.dat"; // Storage for testing purposes only
-  if(dim == 2) DoWriteTec<2>(path,false);
-  if(dim == 3) DoWriteTec<3>(path,false);
-  
-  path="./FSOmesh/bal_test_noremoved.dat"; // Storage for testing purposes only
-  if(dim == 2) DoWriteTecNoRemoved<2>(path);
-  if(dim == 3) DoWriteTecNoRemoved<3>(path);
-  
-  path="./FSOmesh/bal_test_recived.dat"; // Storage for testing purposes only
-  if(dim == 2) DoWriteTecAfterSendRecive<2>(path);
-  if(dim == 3) DoWriteTecAfterSendRecive<3>(path);
+  // store the new owner of each cell
+  setPartitionTarget();
+  
+  if (m_writeDiagnostics) {
+    // select cells to be send (negotiate cell ownership)
+    SelectCellsToSend();
+    // select nodes to send
+    SelectNodesToSend();
+    // build MPI send/recive structures
+    PrepereMPIcommStruct();
+    // perform MPI communication session
+    MPICommunicate();
+    // Prepere data for mesh update
+    PrepereToUpdate();
+    
+    // Raport the results
+    CFLogInfo("TecPlotFile write \n");
+    const CFuint dim = PhysicalModelStack::getActive()->getDim();
+    boost::filesystem::path path = "./FSOmesh/bal_test_interf.dat"; // Storage for testing purposes only
+    if(dim == 2) DoWriteTec<2>(path,true);
+    if(dim == 3) DoWriteTec<3>(path,true);
+    
+    path = "./FSOmesh/bal_test_nointerf.dat"; // Storage for testing purposes only
+    if(dim == 2) DoWriteTec<2>(path,false);
+    if(dim == 3) DoWriteTec<3>(path,false);
+    
+    path="./FSOmesh/bal_test_noremoved.dat"; // Storage for testing purposes only
+    if(dim == 2) DoWriteTecNoRemoved<2>(path);
+    if(dim == 3) DoWriteTecNoRemoved<3>(path);
+    
+    path="./FSOmesh/bal_test_recived.dat"; // Storage for testing purposes only
+    if(dim == 2) DoWriteTecAfterSendRecive<2>(path);
+    if(dim == 3) DoWriteTecAfterSendRecive<3>(path);
+  }
   
   // free the alocated memory
   DoClearMemory();
+  
+  // the cells are migrated by restarting the subsystem from the solution written 
+  // at the end of this run: the partition map stored in the (binary) CFmesh file
+  // assigns each cell to its new owner, then ghost layers, faces, communication
+  // patterns and geometric data are rebuilt by the standard setup
+  CFLog(NOTICE, "StdRepart::execute() => restarting with the new partition\n");
+  Common::SafePtr<EventHandler> event_handler = Environment::CFEnv::getInstance().getEventHandler();
+  const std::string ssname = SubSystemStatusStack::getCurrentName();
+  std::string msg;
+  event_handler->call_signal (event_handler->key(ssname, "CF_ON_MESHADAPTER_AFTERGLOBALREMESHING"), msg );
 }
 
 //////////////////////////////////////////////////////////////////////////////
+
+bool StdRepart::isImbalanced()
+{
+  const std::string nsp = getMethodData().getNamespace();
+  MPI_Comm comm = PE::GetPE().GetCommunicator(nsp);
+  
+  const string costName = nsp + "_cellCost";
+  int hasCost = (MeshDataStack::getActive()->getDataStorage()->checkData(costName)) ? 1 : 0;
+  int allHaveCost = 0;
+  MPI_Allreduce(&hasCost, &allHaveCost, 1, MPI_INT, MPI_MIN, comm);
+  
+  DataHandle<CFreal> cellCost(CFNULL);
+  if (allHaveCost) {
+    cellCost = MeshDataStack::getActive()->getDataStorage()->getData<CFreal>(costName);
+  }
+  
+  // overlap cells are counted by the processes updating their first state
+  CFreal load = 0.;
+  for(CFuint icell=0; icell < m_cells->getLocalNbGeoEnts(); ++icell)
+  {
+    if (m_states[m_cells->getStateID(icell,0)]->isParUpdatable())
+      load += (allHaveCost) ? cellCost[icell] : 1.;
+  }
+  
+  CFreal maxLoad = 0.;
+  CFreal sumLoad = 0.;
+  MPI_Allreduce(&load, &maxLoad, 1, MPIStructDef::getMPIType(&load), MPI_MAX, comm);
+  MPI_Allreduce(&load, &sumLoad, 1, MPIStructDef::getMPIType(&load), MPI_SUM, comm);
+  
+  const CFreal meanLoad = sumLoad/PE::GetPE().GetProcessorCount(nsp);
+  const CFreal imbalance = (meanLoad > 0.) ? maxLoad/meanLoad : 1.;
+  CFLog(INFO, "StdRepart::isImbalanced() => load imbalance = " << imbalance 
+	<< " (threshold = " << m_imbalanceThreshold << ")\n");
+  
+  return (imbalance > m_imbalanceThreshold);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StdRepart::setPartitionTarget()
+{
+  // a cell goes to the lowest new rank among its nodes (as in SelectCellsToSend()):
+  // interface nodes have the same part2 on all processes, so that overlap cells 
+  // get the same target everywhere
+  const std::string nsp = getMethodData().getNamespace();
+  const string targetName = nsp + "_partitionTarget";
+  SafePtr<Framework::DataStorage> ds = MeshDataStack::getActive()->getDataStorage();
+  if (ds->checkData(targetName)) {
+    ds->deleteData<CFuint>(targetName);
+  }
+  
+  const CFuint nbCells = m_cells->getLocalNbGeoEnts();
+  DataHandle<CFuint> target = ds->createData<CFuint>(targetName, nbCells, 0);
+  for(CFuint icell=0; icell < nbCells; ++icell)
+  {
+    CFuint destination_proces = PE::GetPE().GetProcessorCount(nsp);
+    for(CFuint inode=0; inode < m_cells->getNbNodesInGeo(icell); ++inode)
+      destination_proces = min(destination_proces, dataStorage.Part2()[m_cells->getNodeID(icell,inode)]);
+    target[icell] = destination_proces;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void StdRepart::setupDataStorage()
 {
   // Set corect sizes for data containers
@@ -246,7 +365,7 @@ void StdRepart::callParMetisAdaptiveRepart()
   // ParMETIS flags and options  -- see ParMETIS documentation
   PartitionerData::IndexT wgtflag = 0;                 // 0 for no weights(vwgt and adjwgt=NULL), 2 weight on vertices only(adjwgt=NULL)
   PartitionerData::IndexT numflag = 0;                 // 0 for C style array numbering
-  PartitionerData::IndexT ncon    = 0;                 // no of weights for each vertex
+  PartitionerData::IndexT ncon    = 1;                 // no of weights for each vertex
   PartitionerData::IndexT nparts  = PE::GetPE().GetProcessorCount(nsp); // number of subdomains - processes
   
   PartitionerData::RealT itr = 1000;
@@ -256,8 +375,8 @@ void StdRepart::callParMetisAdaptiveRepart()
   
   PartitionerData::IndexT edgecut =0;                  //number of egdes that are cutted
 
-  PartitionerData::RealT *tpwgts = NULL;            //array for weights
-  PartitionerData::RealT *ubvec = NULL;             //array of size ncon for imbalance tolerance
+  vector<PartitionerData::RealT> tpwgts(ncon*nparts, 1./nparts); //array for weights
+  vector<PartitionerData::RealT> ubvec(ncon, 1.05);              //array of size ncon for imbalance tolerance
 
   PartitionerData::IndexT  *vwgt=NULL;
   PartitionerData::IndexT  *adjwgt=NULL;
@@ -268,32 +387,44 @@ void StdRepart::callParMetisAdaptiveRepart()
     part[i] = 0;
   }
   
-  ///HACK:: introduce waights for testing -- to be removed later!! 
-  wgtflag=2;  // 0 for no weights(vwgt and adjwgt=NULL), 2 weight on vertices only(adjwgt=NULL)
-    ncon   =1;  // no of weights for each vertex
+  // the measured cell costs (if available on all processes) are 
+  // distributed to the nodes of each cell and used as vertex weights
+  const string costName = nsp + "_cellCost";
+  int hasCost = (MeshDataStack::getActive()->getDataStorage()->checkData(costName)) ? 1 : 0;
+  int allHaveCost = 0;
+  MPI_Allreduce(&hasCost, &allHaveCost, 1, MPI_INT, MPI_MIN, comm);
+  
+  vector<PartitionerData::IndexT> nodeWeights;
+  if (allHaveCost) {
+    DataHandle<CFreal> cellCost = 
+      MeshDataStack::getActive()->getDataStorage()->getData<CFreal>(costName);
+    cf_assert(cellCost.size() == m_cells->getLocalNbGeoEnts());
     
-    tpwgts = new PartitionerData::RealT[ncon*nparts];
-    for(int i=0; i<(ncon*nparts); ++i) tpwgts[i] = 1./nparts;
+    vector<CFreal> cost(m_nodes.size(), 0.);
+    for(CFuint icell=0; icell < m_cells->getLocalNbGeoEnts(); ++icell)
+    {
+      const CFuint nbNodesInCell = m_cells->getNbNodesInGeo(icell);
+      for(CFuint inode=0; inode < nbNodesInCell; ++inode)
+        cost[m_cells->getNodeID(icell,inode)] += cellCost[icell]/nbNodesInCell;
+    }
     
-    ubvec = new PartitionerData::RealT[ncon];
-    for(int i=0; i<ncon; ++i) ubvec[i] = 1.05;
+    // the vertices are the owned nodes, in local order
+    vector<CFreal> ownedCost;
+    ownedCost.reserve(myNodes);
+    for(CFuint i=0; i<m_nodes.size(); ++i) if( dataStorage.Part1()[i] == PE::GetPE().GetRank(nsp) )
+      ownedCost.push_back(cost[i]);
+    cf_assert(ownedCost.size() == myNodes);
     
-    vwgt = new PartitionerData::IndexT[myNodes];
-    for(CFuint i=0; i<(myNodes); ++i) vwgt[i]=1;
-
-      if(PE::GetPE().GetRank(nsp)==0)
-        for(CFuint i=0; i<(myNodes); ++i) vwgt[i]=3;
-      if(PE::GetPE().GetRank(nsp)==1)
-        for(CFuint i=0; i<(myNodes); ++i) vwgt[i]=10;
-      if(PE::GetPE().GetRank(nsp)==2)
-        for(CFuint i=0; i<(myNodes); ++i) vwgt[i]=5;
-  /// /////////////////////////////////////////////////////////////
-
+    Framework::ParMetis::computeWeights(ownedCost, 10, comm, nodeWeights);
+    wgtflag = 2;
+    vwgt = (myNodes > 0) ? &nodeWeights[0] : NULL;
+  }
+  
   CFLogDebugMin( "Calling ParMetis::AdaptiveRepart()\n");
   Common::Stopwatch<Common::WallTime> MetisTimer;
 
   ParMETIS_V3_AdaptiveRepart (&dataStorage.vtxdist[0], &dataStorage.xadj[0], &dataStorage.adjncy[0], vwgt, vsize, adjwgt, 
-        &wgtflag, &numflag, &ncon, &nparts, tpwgts, ubvec, &itr, options, &edgecut, part, &comm);
+        &wgtflag, &numflag, &ncon, &nparts, &tpwgts[0], &ubvec[0], &itr, options, &edgecut, part, &comm);
   
   CFuint i1=0;
   for(CFuint i=0; i<m_nodes.size(); ++i) if( dataStorage.Part1()[i] == PE::GetPE().GetRank(nsp) )
@@ -304,9 +435,6 @@ void StdRepart::callParMetisAdaptiveRepart()
   }
   //cout<<" myNodes:"<<PE::GetPE().GetRank(nsp)<<" "<<myNodes<<" "<<i1<<endl;
   delete [] part;
-  delete [] vwgt;
-  delete [] tpwgts;
-  delete [] ubvec;
 
   MetisTimer.stop ();
   CFLog(NOTICE, "ParMetis::AdaptiveRepart() took " << MetisTimer << "\n");
@@ -37,6 +37,12 @@ public: // functions
    */
   virtual ~StdRepart();
 
+  /**
+   * Defines the Config Option's of this class
+   * @param options a OptionList where to add the Option's
+   */
+  static void defineConfigOptions(Config::OptionList& options);
+
   /**
    * Configures the command.
    */
@@ -55,6 +61,18 @@ public: // functions
 
 private: // helper functions
 
+  /**
+  * Measures the load of each process (the measured cell cost, if available,
+  * otherwise the number of owned cells)
+  * @return true if the imbalance exceeds the threshold
+  */
+  bool isImbalanced();
+  
+  /**
+  * Stores the new owner of each local cell, to be written as partition map
+  */
+  void setPartitionTarget();
+  
   /**
   * Setup info about the mesh
   * info about nodes, and whare thay belong
@@ -171,6 +189,15 @@ private: // data
   Framework::DataHandle < Framework::Node*, Framework::GLOBAL > m_nodes;
   
   Framework::DataHandle < Framework::State*, Framework::GLOBAL > m_states;
+  
+  /// maximum ratio between the maximum and the mean load before repartitioning
+  CFreal m_imbalanceThreshold;
+  
+  /// number of iterations between two checks of the load imbalance
+  CFuint m_checkRate;
+  
+  /// flag telling to run the cell exchange steps and write the Tecplot diagnostics
+  bool m_writeDiagnostics;
 
 
 }; // class ReadCFmesh
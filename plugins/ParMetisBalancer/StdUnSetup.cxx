@@ -1,4 +1,5 @@
 #include "Framework/MethodCommandProvider.hh"
+#include "Framework/MeshData.hh"
 #include "ParMetisBalancer/ParMetisBalancer.hh"
 #include "ParMetisBalancer/StdUnSetup.hh"
 
@@ -37,6 +38,13 @@ StdUnSetup::~StdUnSetup()
 void StdUnSetup::execute()
 {
   CFAUTOTRACE;
+  
+  // the partition computed by StdRepart has been written with the final solution
+  const std::string targetName = getMethodData().getNamespace() + "_partitionTarget";
+  Common::SafePtr<DataStorage> ds = MeshDataStack::getActive()->getDataStorage();
+  if (ds->checkData(targetName)) {
+    ds->deleteData<CFuint>(targetName);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
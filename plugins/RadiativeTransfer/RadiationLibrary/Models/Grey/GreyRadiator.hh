@@ -31,6 +31,12 @@ public:
 
   CFreal getAbsorption( CFreal lambda, RealVector &s_o );
 
+  void getAbsorptions(const CFuint nb, const CFuint *const stateIDs, 
+		      const CFreal *const lambdas, CFreal *const absorptions)
+  {
+    for (CFuint i = 0; i < nb; ++i) {absorptions[i] = m_absCoeff;}
+  }
+
   CFreal getSpectraLoopPower();
 
   void computeEmissionCPD(){;}
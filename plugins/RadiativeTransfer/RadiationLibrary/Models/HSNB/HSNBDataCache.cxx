@@ -0,0 +1,265 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "Common/MPI/MPIError.hh"
+#include "RadiativeTransfer/RadiationLibrary/Models/HSNB/HSNBDataCache.hh"
+
+// the configuration macros are known only after the COOLFluiD headers
+#ifdef CF_HAVE_ALLOC_MMAP
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#endif // CF_HAVE_ALLOC_MMAP
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+namespace RadiativeTransfer {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// identifier at the beginning of the cache files
+static const char HSNBDataCache_magic[8] = {'C','F','H','S','N','B','1','\0'};
+
+/// alignment of the blocks in the cache files
+static const size_t HSNBDataCache_align = 64;
+
+//////////////////////////////////////////////////////////////////////////////
+
+HSNBDataCache::HSNBDataCache() :
+  m_newBlocks(),
+  m_blocks(),
+  m_data(CFNULL),
+  m_nodeComm(MPI_COMM_NULL),
+  m_hasWindow(false),
+  m_window(),
+  m_mapped(CFNULL),
+  m_mappedSize(0),
+  m_storage()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+HSNBDataCache::~HSNBDataCache()
+{
+  // the MPI window and communicator are released by close(), which must be
+  // called before MPI is finalized
+#ifdef CF_HAVE_ALLOC_MMAP
+  if (m_mapped != CFNULL) {
+    munmap(m_mapped, m_mappedSize);
+  }
+#endif // CF_HAVE_ALLOC_MMAP
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool HSNBDataCache::write(const std::string& fileName, const std::string& signature)
+{
+  // header: magic, signature size, number of blocks, offset of the data,
+  // signature and, for each block, name size, offset, size in bytes and name
+  size_t headerSize = sizeof(HSNBDataCache_magic) + 3*sizeof(size_t) + signature.size();
+  for (size_t i = 0; i < m_newBlocks.size(); ++i) {
+    headerSize += 3*sizeof(size_t) + m_newBlocks[i].name.size();
+  }
+
+  std::vector<size_t> offsets(m_newBlocks.size());
+  size_t offset = headerSize;
+  for (size_t i = 0; i < m_newBlocks.size(); ++i) {
+    offset = ((offset + HSNBDataCache_align - 1)/HSNBDataCache_align)*HSNBDataCache_align;
+    offsets[i] = offset;
+    offset += m_newBlocks[i].bytes;
+  }
+
+  // the file is written under a temporary name and renamed at the end,
+  // so that a concurrent reader never finds a partial file
+  const std::string tmpName = fileName + ".tmp";
+  std::ofstream fout(tmpName.c_str(), std::ios::binary | std::ios::trunc);
+  if (!fout) {
+    m_newBlocks.clear();
+    return false;
+  }
+
+  const size_t sizes[3] = {signature.size(), m_newBlocks.size(),
+			   (offsets.empty()) ? headerSize : offsets[0]};
+  fout.write(HSNBDataCache_magic, sizeof(HSNBDataCache_magic));
+  fout.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+  fout.write(signature.c_str(), signature.size());
+  for (size_t i = 0; i < m_newBlocks.size(); ++i) {
+    const size_t entry[3] = {m_newBlocks[i].name.size(), offsets[i], m_newBlocks[i].bytes};
+    fout.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+    fout.write(m_newBlocks[i].name.c_str(), m_newBlocks[i].name.size());
+  }
+
+  size_t position = headerSize;
+  const std::vector<char> padding(HSNBDataCache_align, 0);
+  for (size_t i = 0; i < m_newBlocks.size(); ++i) {
+    fout.write(&padding[0], offsets[i] - position);
+    fout.write(m_newBlocks[i].getData(), m_newBlocks[i].bytes);
+    position = offsets[i] + m_newBlocks[i].bytes;
+  }
+  fout.close();
+  m_newBlocks.clear();
+  if (!fout) return false;
+
+  return (std::rename(tmpName.c_str(), fileName.c_str()) == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool HSNBDataCache::open(const std::string& fileName, const std::string& signature,
+			 MPI_Comm comm)
+{
+  close();
+
+#if MPI_VERSION >= 3
+  // the first process of each node reads the file in a shared memory window
+  MPIError::getInstance().check
+    ("MPI_Comm_split_type", "HSNBDataCache::open()",
+     MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &m_nodeComm));
+  int nodeRank = 0;
+  MPI_Comm_rank(m_nodeComm, &nodeRank);
+
+  unsigned long long fileSize = 0;
+  if (nodeRank == 0) {
+    std::ifstream fin(fileName.c_str(), std::ios::binary | std::ios::ate);
+    if (fin) fileSize = static_cast<unsigned long long>(fin.tellg());
+  }
+  MPI_Bcast(&fileSize, 1, MPI_UNSIGNED_LONG_LONG, 0, m_nodeComm);
+  if (fileSize == 0) {
+    close();
+    return false;
+  }
+
+  char* base = CFNULL;
+  MPIError::getInstance().check
+    ("MPI_Win_allocate_shared", "HSNBDataCache::open()",
+     MPI_Win_allocate_shared((nodeRank == 0) ? fileSize : 0, 1, MPI_INFO_NULL,
+			     m_nodeComm, &base, &m_window));
+  m_hasWindow = true;
+
+  int isRead = 1;
+  if (nodeRank == 0) {
+    std::ifstream fin(fileName.c_str(), std::ios::binary);
+    fin.read(base, fileSize);
+    isRead = (fin) ? 1 : 0;
+  }
+  MPI_Win_fence(0, m_window);
+  MPI_Bcast(&isRead, 1, MPI_INT, 0, m_nodeComm);
+
+  if (nodeRank != 0) {
+    MPI_Aint size = 0;
+    int dispUnit = 1;
+    MPI_Win_shared_query(m_window, 0, &size, &dispUnit, &base);
+  }
+  m_data = base;
+#else
+#ifdef CF_HAVE_ALLOC_MMAP
+  // each process maps the file, whose pages are shared on the node
+  const int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  const size_t fileSize = fileStat.st_size;
+  void *const mapped = mmap(CFNULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) return false;
+  m_mapped = mapped;
+  m_mappedSize = fileSize;
+  m_data = static_cast<const char*>(mapped);
+  const int isRead = 1;
+#else
+  std::ifstream fin(fileName.c_str(), std::ios::binary | std::ios::ate);
+  if (!fin) return false;
+  const size_t fileSize = fin.tellg();
+  if (fileSize == 0) return false;
+  m_storage.resize(fileSize);
+  fin.seekg(0, std::ios::beg);
+  fin.read(&m_storage[0], fileSize);
+  const int isRead = (fin) ? 1 : 0;
+  m_data = &m_storage[0];
+#endif // CF_HAVE_ALLOC_MMAP
+#endif // MPI_VERSION >= 3
+
+  // all the processes of the node see the same data and take the same decision
+  if (isRead == 0 || !readIndex(fileSize, signature)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool HSNBDataCache::readIndex(const size_t size, const std::string& signature)
+{
+  size_t position = sizeof(HSNBDataCache_magic) + 3*sizeof(size_t);
+  if (size < position ||
+      std::memcmp(m_data, HSNBDataCache_magic, sizeof(HSNBDataCache_magic)) != 0) return false;
+
+  size_t sizes[3];
+  std::memcpy(sizes, m_data + sizeof(HSNBDataCache_magic), sizeof(sizes));
+  if (sizes[0] != signature.size() || size < position + sizes[0] ||
+      signature.compare(0, string::npos, m_data + position, sizes[0]) != 0) return false;
+  position += sizes[0];
+
+  for (size_t i = 0; i < sizes[1]; ++i) {
+    size_t entry[3];
+    if (size < position + sizeof(entry)) return false;
+    std::memcpy(entry, m_data + position, sizeof(entry));
+    position += sizeof(entry);
+    if (size < position + entry[0] || size < entry[1] + entry[2]) return false;
+    const std::string name(m_data + position, entry[0]);
+    position += entry[0];
+    m_blocks[name] = std::make_pair(entry[1], entry[2]);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void HSNBDataCache::close()
+{
+  m_blocks.clear();
+  m_data = CFNULL;
+
+#if MPI_VERSION >= 3
+  if (m_hasWindow) {
+    MPI_Win_free(&m_window);
+    m_hasWindow = false;
+  }
+  if (m_nodeComm != MPI_COMM_NULL) {
+    MPI_Comm_free(&m_nodeComm);
+    m_nodeComm = MPI_COMM_NULL;
+  }
+#endif
+
+#ifdef CF_HAVE_ALLOC_MMAP
+  if (m_mapped != CFNULL) {
+    munmap(m_mapped, m_mappedSize);
+  }
+#endif // CF_HAVE_ALLOC_MMAP
+  m_mapped = CFNULL;
+  m_mappedSize = 0;
+  std::vector<char>().swap(m_storage);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace RadiativeTransfer
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,150 @@
+#ifndef COOLFluiD_RadiativeTransfer_HSNBDataCache_hh
+#define COOLFluiD_RadiativeTransfer_HSNBDataCache_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include "Common/COOLFluiD.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+namespace RadiativeTransfer {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class stores the spectral data of the HSNB model in a binary cache
+/// file made of named blocks, so that the text database is parsed only once.
+/// When the cache is opened, a single process per node reads the file in a
+/// MPI shared memory window (MPI-3), the other processes of the node
+/// accessing the same memory. Without MPI-3, each process maps the file in
+/// memory, the pages being shared anyway by the operating system.
+/// The blocks are read-only and remain valid until close() is called.
+/// @author Andrea Lani
+class HSNBDataCache {
+public:
+
+  /// Constructor
+  HSNBDataCache();
+
+  /// Destructor
+  ~HSNBDataCache();
+
+  /// Register a block to be written by write()
+  /// The data is not copied and must stay valid until write() is called.
+  template <typename T>
+  void addBlock(const std::string& name, const T* data, const size_t n)
+  {
+    m_newBlocks.push_back(NewBlock(name, data, n*sizeof(T)));
+  }
+
+  /// Register a copy of a (small) block to be written by write()
+  template <typename T>
+  void addBlock(const std::string& name, const std::vector<T>& data)
+  {
+    m_newBlocks.push_back(NewBlock(name, CFNULL, data.size()*sizeof(T)));
+    if (!data.empty()) {
+      const char *const start = reinterpret_cast<const char*>(&data[0]);
+      m_newBlocks.back().copy.assign(start, start + m_newBlocks.back().bytes);
+    }
+  }
+
+  /// Write the registered blocks in the given file
+  /// @param signature  string identifying the source data
+  /// @return false if the file could not be written
+  bool write(const std::string& fileName, const std::string& signature);
+
+  /// Open the given file, collectively over the processes of comm
+  /// @param signature  string that must match the one of write()
+  /// @return false if the file is missing or has been written for other data
+  bool open(const std::string& fileName, const std::string& signature, MPI_Comm comm);
+
+  /// Release the memory of the blocks, collectively over the processes of
+  /// the communicator given to open()
+  void close();
+
+  /// @return true if the cache has been opened
+  bool isOpen() const {return (m_data != CFNULL);}
+
+  /// @return the block with the given name (CFNULL if missing)
+  /// @param n  number of elements of the block
+  template <typename T>
+  const T* getBlock(const std::string& name, size_t& n) const
+  {
+    std::map<std::string, std::pair<size_t, size_t> >::const_iterator it =
+      m_blocks.find(name);
+    if (it == m_blocks.end() || it->second.second%sizeof(T) != 0) {
+      n = 0;
+      return CFNULL;
+    }
+    n = it->second.second/sizeof(T);
+    return reinterpret_cast<const T*>(m_data + it->second.first);
+  }
+
+private:
+
+  /// block registered for writing
+  struct NewBlock {
+    NewBlock(const std::string& n, const void* d, const size_t b) :
+      name(n), data(d), bytes(b) {}
+    /// @return the data to write
+    const char* getData() const
+    {
+      return (copy.empty()) ? static_cast<const char*>(data) : &copy[0];
+    }
+    std::string name;
+    const void* data;
+    size_t bytes;
+    std::vector<char> copy;
+  };
+
+  /// read the index of the blocks
+  /// @return false if the data is not a cache with the given signature
+  bool readIndex(const size_t size, const std::string& signature);
+
+private:
+
+  /// blocks registered for writing
+  std::vector<NewBlock> m_newBlocks;
+
+  /// offset and size in bytes of each block
+  std::map<std::string, std::pair<size_t, size_t> > m_blocks;
+
+  /// start of the cache in memory
+  const char* m_data;
+
+  /// communicator of the processes of the node
+  MPI_Comm m_nodeComm;
+
+  /// flag telling if the data is in a MPI shared memory window
+  bool m_hasWindow;
+
+  /// MPI shared memory window
+  MPI_Win m_window;
+
+  /// start of the mapped file
+  void* m_mapped;
+
+  /// size of the mapped file
+  size_t m_mappedSize;
+
+  /// storage of the data when it is neither shared nor mapped
+  std::vector<char> m_storage;
+
+}; // end of class HSNBDataCache
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace RadiativeTransfer
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_RadiativeTransfer_HSNBDataCache_hh
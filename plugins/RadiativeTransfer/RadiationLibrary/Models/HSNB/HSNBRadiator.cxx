@@ -59,6 +59,8 @@ void HSNBRadiator::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< std::string >("NonUniformPathTreatment","Specifies how to treat radiative properties along a non-uniform path");
   options.addConfigOption< std::string >("Namespace","Namespace that the HSNBRadiator is run in in parallel");
   options.addConfigOption< std::string >("compositionType", "Describe how species composition is described (moleFractions/partialDensity)");
+  options.addConfigOption< std::string >
+    ("SpectralCacheFile", "Binary cache of the spectral data, created if missing and shared by the processes of each node (none if empty).");
 
 }
 
@@ -70,6 +72,12 @@ void HSNBRadiator::configure ( Config::ConfigArgs& args )
 
 void HSNBRadiator::unsetup()
 {
+  if (m_dataCache.isOpen()) {
+    // the diatomic systems refer to the tables of the cache
+    m_diatomics.clear();
+    m_dataCache.close();
+  }
+
   Radiator::unsetup();
 }
 
@@ -317,6 +325,17 @@ void HSNBRadiator::setUpMechanisms()
 
 void HSNBRadiator::load_BBCE_data()
 {
+    if (m_dataCache.isOpen()) {
+        size_t n = 0;
+        size_t nCumul = 0;
+        const double* const TTimesLamda = m_dataCache.getBlock<double>("BBCE/TTimesLamda", n);
+        const double* const cumulative = m_dataCache.getBlock<double>("BBCE/cumulative", nCumul);
+        if (TTimesLamda != CFNULL && cumulative != CFNULL && n == nCumul) {
+            m_BBCE.TTimesLamda.assign(TTimesLamda, TTimesLamda+n);
+            m_BBCE.cumulative.assign(cumulative, cumulative+n);
+            return;
+        }
+    }
 
     // Open the file
     std::ifstream& BBCE_file = m_inFileHandle->open(m_blackBodyFile);
@@ -347,6 +366,36 @@ void HSNBRadiator::load_BBCE_data()
     m_inFileHandle->close();
 }
 
+std::string HSNBRadiator::getCacheSignature(const std::string& dataPath) const
+{
+    // original database, list of mechanisms and size of the black body data
+    std::ifstream procFile(m_processFile.string().c_str());
+    std::stringstream processData;
+    processData << procFile.rdbuf();
+
+    std::stringstream signature;
+    signature << "HSNB " << dataPath << "\n" << processData.str() << "\n"
+              << "BBCE " << (boost::filesystem::exists(m_blackBodyFile) ?
+                             boost::filesystem::file_size(m_blackBodyFile) : 0);
+    return signature.str();
+}
+
+void HSNBRadiator::writeSpectralCache(const std::string& signature)
+{
+    m_dataCache.addBlock("BBCE/TTimesLamda", m_BBCE.TTimesLamda);
+    m_dataCache.addBlock("BBCE/cumulative", m_BBCE.cumulative);
+    for (size_t i = 0; i < m_diatomics.size(); ++i) {
+        m_diatomics[i].addToCache(m_dataCache);
+    }
+
+    if (m_dataCache.write(m_spectralCacheFile, signature)) {
+        CFLog(INFO, "HSNBRadiator::writeSpectralCache() => spectral data written in " << m_spectralCacheFile << "\n");
+    }
+    else {
+        CFLog(WARN, "HSNBRadiator::writeSpectralCache() => cannot write " << m_spectralCacheFile << "\n");
+    }
+}
+
 void HSNBRadiator::determineBandRange()
 {
     if (m_diatomics.size() != 0) {
@@ -406,6 +455,9 @@ HSNBRadiator::HSNBRadiator(const std::string& name) :
     m_compositionType= "partialDensity";
     setParameter("compositionType", &m_compositionType);
 
+    m_spectralCacheFile = "";
+    setParameter("SpectralCacheFile", &m_spectralCacheFile);
+
     if (m_compositionType=="partialDensity") {
         m_convertPartialDensity=true;
     }
@@ -465,6 +517,7 @@ void HSNBRadiator::setup(){
 
     CFLog(VERBOSE, "HSNBRadiator::setup() => m_HSNBPath = " << m_HSNBPath << "\n");
 
+    const std::string dataPath = m_HSNBPath.string();
 
     MPI_Request sendRequest, recvRequest;
 
@@ -514,6 +567,20 @@ void HSNBRadiator::setup(){
     boost::filesystem::path blackBodyFile("/data/Black_body_cumulated_energy.dat");
     m_blackBodyFile = m_HSNBPath / blackBodyFile;
 
+    // the spectral data is taken from the cache if it has been written for
+    // the same database and mechanisms
+    std::string cacheSignature = "";
+    if (m_spectralCacheFile != "") {
+      cacheSignature = getCacheSignature(dataPath);
+      if (m_dataCache.open(m_spectralCacheFile, cacheSignature,
+                           PE::GetPE().GetCommunicator(m_namespace))) {
+        CFLog(INFO, "HSNBRadiator::setup() => spectral data read from " << m_spectralCacheFile << "\n");
+      }
+      else {
+        CFLog(INFO, "HSNBRadiator::setup() => " << m_spectralCacheFile << " missing or outdated\n");
+      }
+    }
+
     loadProcessData();
 
     //get the statesID used for this Radiator
@@ -586,6 +653,10 @@ void HSNBRadiator::setup(){
 
 
     setUpMechanisms();
+
+    if (m_spectralCacheFile != "" && !m_dataCache.isOpen() && m_rank == 0) {
+      writeSpectralCache(cacheSignature);
+    }
     
     std::cout << "HSNBRadiator::setup => Rank " << m_rank << " finished setup of mechanisms. \n";
 
@@ -1375,7 +1446,8 @@ void HSNBRadiator::loadProcessData()
         String::tokenize(line, tokens, " \t\r\n");
 
         m_diatomics.push_back(
-            SnbDiatomicSystem(SpeciesLoadData(m_HSNBPath.string(),tokens[0]), tokens[1], tokens.size() > 2 ? tokens[2] : "",m_thermoData));
+            SnbDiatomicSystem(SpeciesLoadData(m_HSNBPath.string(),tokens[0]), tokens[1], tokens.size() > 2 ? tokens[2] : "",m_thermoData,
+                              m_dataCache.isOpen() ? &m_dataCache : NULL));
         it=m_diatomics.end()-1;
 
         if (m_diatomics.back().getMechanismType()==THIN){
@@ -9,6 +9,7 @@
 #include "RadiativeTransfer/RadiationLibrary/RadiationPhysicsHandler.hh"
 #include "RadiativeTransfer/RadiationLibrary/Radiator.hh"
 
+#include "RadiativeTransfer/RadiationLibrary/Models/HSNB/HSNBDataCache.hh"
 #include "RadiativeTransfer/RadiationLibrary/Models/HSNB/core/SnbDiatomicSystem.h"
 #include "RadiativeTransfer/RadiationLibrary/Models/HSNB/core/SnbAtomicSystem.h"
 #include "RadiativeTransfer/RadiationLibrary/Models/HSNB/core/SnbContinuumSystem.h"
@@ -194,6 +195,13 @@ private:
 
     void load_BBCE_data();
 
+    /// @return the string identifying the spectral data in the cache
+    /// @param dataPath  path of the original HSNB database
+    std::string getCacheSignature(const std::string& dataPath) const;
+
+    /// write the spectral data in the cache file
+    void writeSpectralCache(const std::string& signature);
+
     void determineBandRange();
 
 
@@ -230,6 +238,12 @@ private:
     /// Reuse existing radiative data (requires the same number of processors as in the previous run).
     bool m_reuseProperties;
 
+    /// binary cache file of the spectral data (none if empty)
+    std::string m_spectralCacheFile;
+
+    /// spectral data shared by the processes of each node
+    HSNBDataCache m_dataCache;
+
     ///Minimum number density
     CFreal m_ndminFix = 1e+10;
 
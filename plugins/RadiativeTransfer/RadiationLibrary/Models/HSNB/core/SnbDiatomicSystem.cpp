@@ -12,12 +12,20 @@
 #include <cmath>
 
 #include "StringUtils.h"
+#include "RadiativeTransfer/RadiationLibrary/Models/HSNB/HSNBDataCache.hh"
 
 using namespace std;
 using namespace COOLFluiD;
 
-SnbDiatomicSystem::SnbDiatomicSystem(SpeciesLoadData loadData, const std::string& dpdf, const std::string& nup, const ThermoData& thermo)
-    : m_directory(loadData.baseDirectory)
+SnbDiatomicSystem::SnbDiatomicSystem(SpeciesLoadData loadData, const std::string& dpdf, const std::string& nup, const ThermoData& thermo,
+                                     const HSNBDataCache* cache)
+    : m_directory(loadData.baseDirectory),
+      mp_tv(NULL),
+      mp_tr(NULL),
+      mp_iv(NULL),
+      mp_params(NULL),
+      mp_locparams(NULL),
+      m_sharedTables(false)
 {
 
 
@@ -53,17 +61,20 @@ SnbDiatomicSystem::SnbDiatomicSystem(SpeciesLoadData loadData, const std::string
     else
         m_dpdf = TAILED_INVERSE_EXP;
     
-    // Determine the min and max band
-    determineBandRange();
+    // Take the tables from the cache, if any, instead of parsing the database
+    if (cache == NULL || !loadFromCache(*cache)) {
+        // Determine the min and max band
+        determineBandRange();
     
-    // Check if the band range could be loaded
-    if (m_nbands < 0) {
-        cout << "Could not find SNB system '" << m_system << "'" << endl;
-        exit(1);
-    }
+        // Check if the band range could be loaded
+        if (m_nbands < 0) {
+            cout << "Could not find SNB system '" << m_system << "'" << endl;
+            exit(1);
+        }
 
-    // Load the temperature grid and determine number of parameters
-    loadTemperatureGrid();
+        // Load the temperature grid and determine number of parameters
+        loadTemperatureGrid();
+    }
 
     if (nup == "T")
         m_nup = THIN;
@@ -82,6 +93,9 @@ SnbDiatomicSystem::SnbDiatomicSystem(SpeciesLoadData loadData, const std::string
 //              << (m_nup == THIN ? "T" : (m_nup == CURTIS_GODSON ? "CG" : "LS" ))
 //              << ", QSS model = "
 //              << (m_test_qss == true ? "YES" : "NO") << endl;
+
+    if (m_sharedTables)
+        return;
     
     // Allocate storage for the parameter information
     mp_params = new double [m_npoints * m_nbands * m_nparams];
@@ -107,13 +121,23 @@ SnbDiatomicSystem::SnbDiatomicSystem(const SnbDiatomicSystem& system)
       m_nparams(system.m_nparams),
       m_nv(system.m_nv),
       m_npoints(system.m_npoints),
-      mp_tv(system.mp_tv == NULL ? NULL : new float [m_nv]),
-      mp_tr(system.mp_tr == NULL ? NULL : new float [system.mp_iv[1]]),
-      mp_iv(system.mp_iv == NULL ? NULL : new size_t [m_nv+1]),
-      mp_params(system.mp_params == NULL ? NULL :
-          new double [m_npoints*m_nbands*m_nparams]),
-      mp_locparams(NULL)
+      mp_tv(system.mp_tv),
+      mp_tr(system.mp_tr),
+      mp_iv(system.mp_iv),
+      mp_params(system.mp_params),
+      mp_locparams(NULL),
+      m_sharedTables(system.m_sharedTables)
 {
+    // Tables of the cache are shared by all the copies
+    if (m_sharedTables)
+        return;
+
+    mp_tv = (system.mp_tv == NULL ? NULL : new float [m_nv]);
+    mp_tr = (system.mp_tr == NULL ? NULL : new float [system.mp_iv[1]]);
+    mp_iv = (system.mp_iv == NULL ? NULL : new size_t [m_nv+1]);
+    mp_params = (system.mp_params == NULL ? NULL :
+        new double [m_npoints*m_nbands*m_nparams]);
+
     copy(system.mp_tv, system.mp_tv+m_nv, mp_tv);
     copy(system.mp_tr, system.mp_tr+system.mp_iv[1], mp_tr);
     copy(system.mp_iv, system.mp_iv+m_nv+1, mp_iv);
@@ -142,14 +166,17 @@ void swap(SnbDiatomicSystem& s1, SnbDiatomicSystem& s2)
     std::swap(s1.mp_iv, s2.mp_iv);
     std::swap(s1.mp_params, s2.mp_params);
     std::swap(s1.mp_locparams, s2.mp_locparams);
+    std::swap(s1.m_sharedTables, s2.m_sharedTables);
 }
 
 SnbDiatomicSystem::~SnbDiatomicSystem()
 {
-    delete [] mp_tr;
-    delete [] mp_tv;
-    delete [] mp_iv;
-    delete [] mp_params;
+    if (!m_sharedTables) {
+        delete [] mp_tr;
+        delete [] mp_tv;
+        delete [] mp_iv;
+        delete [] mp_params;
+    }
     if (mp_locparams)
         delete [] mp_locparams;
 }
@@ -473,6 +500,58 @@ void SnbDiatomicSystem::loadTemperatureGrid()
 }
 
 
+bool SnbDiatomicSystem::loadFromCache(const HSNBDataCache& cache)
+{
+    // Band range, number of parameters and sizes of the temperature grid
+    size_t n = 0;
+    const int* const p_sizes = cache.getBlock<int>(cacheName()+"/sizes", n);
+    if (p_sizes == NULL || n != 5)
+        return false;
+
+    size_t ntv = 0, ntr = 0, niv = 0, nparams = 0;
+    const float* const p_tv = cache.getBlock<float>(cacheName()+"/tv", ntv);
+    const float* const p_tr = cache.getBlock<float>(cacheName()+"/tr", ntr);
+    const size_t* const p_iv = cache.getBlock<size_t>(cacheName()+"/iv", niv);
+    const double* const p_params =
+        cache.getBlock<double>(cacheName()+"/params", nparams);
+
+    const int nbands = p_sizes[1] - p_sizes[0] + 1;
+    if (nbands <= 0 || p_sizes[2] <= 0 || p_sizes[3] <= 0 || p_sizes[4] <= 0)
+        return false;
+
+    const size_t nv = p_sizes[3];
+    if (p_tv == NULL || p_tr == NULL || p_iv == NULL || p_params == NULL ||
+        ntv != nv || niv != nv+1 || ntr != p_iv[1] ||
+        nparams != size_t(p_sizes[4]) * size_t(nbands) * size_t(p_sizes[2]))
+        return false;
+
+    m_band1   = p_sizes[0];
+    m_bandn   = p_sizes[1];
+    m_nbands  = nbands;
+    m_nparams = p_sizes[2];
+    m_nv      = p_sizes[3];
+    m_npoints = p_sizes[4];
+
+    // The tables are read-only and stay in the cache
+    mp_tv = const_cast<float*>(p_tv);
+    mp_tr = const_cast<float*>(p_tr);
+    mp_iv = const_cast<size_t*>(p_iv);
+    mp_params = const_cast<double*>(p_params);
+    m_sharedTables = true;
+    return true;
+}
+
+void SnbDiatomicSystem::addToCache(HSNBDataCache& cache) const
+{
+    const int sizes[5] = {m_band1, m_bandn, m_nparams, m_nv, m_npoints};
+    cache.addBlock(cacheName()+"/sizes", std::vector<int>(sizes, sizes+5));
+    cache.addBlock(cacheName()+"/tv", mp_tv, m_nv);
+    cache.addBlock(cacheName()+"/tr", mp_tr, mp_iv[1]);
+    cache.addBlock(cacheName()+"/iv", mp_iv, m_nv+1);
+    cache.addBlock(cacheName()+"/params", mp_params,
+                   size_t(m_npoints) * m_nbands * m_nparams);
+}
+
 void SnbDiatomicSystem::loadBandParameters(const size_t& iband)
 {
     // Open the file corresponding to the band
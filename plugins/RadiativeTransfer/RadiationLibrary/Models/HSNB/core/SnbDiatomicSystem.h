@@ -14,6 +14,12 @@
 
 class PhotonPath;
 
+namespace COOLFluiD {
+  namespace RadiativeTransfer {
+    class HSNBDataCache;
+  }
+}
+
 using namespace COOLFluiD;
 using namespace COOLFluiD::RadiativeTransfer;
 
@@ -36,8 +42,10 @@ public:
 
     /**
      * Constructor takes path to system name in the database.
+     * The tables are taken from the cache if it holds them, without copy.
      */
-    SnbDiatomicSystem(SpeciesLoadData loadData, const std::string& dpdf, const std::string& nup, const ThermoData &thermo);
+    SnbDiatomicSystem(SpeciesLoadData loadData, const std::string& dpdf, const std::string& nup, const ThermoData &thermo,
+                      const HSNBDataCache* cache = NULL);
     
     /**
      * Copy constructor.
@@ -130,6 +138,11 @@ public:
 
     CFreal getBand(CFreal sig);
 
+    /**
+     * Registers the tables of this system in the cache to be written.
+     */
+    void addToCache(HSNBDataCache& cache) const;
+
 
 
     friend void swap(SnbDiatomicSystem&, SnbDiatomicSystem&);
@@ -168,6 +181,19 @@ private:
 
  
 private:
+
+    /**
+     * Name of the cache blocks of this system.
+     */
+    std::string cacheName() const {
+        return "diatomic/" + m_species + "/" + m_system;
+    }
+
+    /**
+     * Takes the tables from the cache.
+     * @return false if the cache doesn't hold them
+     */
+    bool loadFromCache(const HSNBDataCache& cache);
     
     std::string m_directory;
     std::string m_species;
@@ -193,6 +219,9 @@ private:
     double* mp_params;
     double* mp_locparams;
 
+    // true if the tables above belong to the cache (and are not deleted)
+    bool m_sharedTables;
+
     CFreal m_tempKu;
     CFreal m_tempBetaD;
     CFreal m_tempBetaL;
@@ -1,4 +1,6 @@
 #include <fstream>
+#include <map>
+#include <cmath>
 
 #include "RadiativeTransfer/RadiationLibrary/Models/PARADE/ParadeRadiator.hh"
 #include "RadiativeTransfer/RadiationLibrary/RadiationPhysicsHandler.hh"
@@ -68,6 +70,8 @@ void ParadeRadiator::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< bool > ("Equilibrium","Activation LTE");
  options.addConfigOption< bool > ("WriteHSNB","Writing HSNB input file");
   options.addConfigOption< bool > ("DataMassFractions","Activating mass fractions reading");
+  options.addConfigOption< CFreal >
+    ("ClusterTolerance", "Relative tolerance on temperatures and number densities under which cells share the same spectra (0 disables clustering).");
 }
   
 //////////////////////////////////////////////////////////////////////////////
@@ -88,7 +92,12 @@ ParadeRadiator::ParadeRadiator(const std::string& name) :
   m_elTempID(),
   m_vibTempID(),
   m_isLTE(),
-  m_massfraction()
+  m_massfraction(),
+  m_startNode(0),
+  m_localTemp(),
+  m_localDens(),
+  m_pointCluster(),
+  m_clusterPoints()
 {
   addConfigOptionsTo(this);
   
@@ -142,6 +151,9 @@ ParadeRadiator::ParadeRadiator(const std::string& name) :
 
   m_Equilibrium = false;
   setParameter("Equilibrium",&m_Equilibrium);
+  
+  m_clusterTolerance = 0.;
+  setParameter("ClusterTolerance",&m_clusterTolerance);
 }
   
 //////////////////////////////////////////////////////////////////////////////
@@ -318,7 +330,13 @@ void ParadeRadiator::setupSpectra(CFreal wavMin, CFreal wavMax)
     // update the wavelength range inside parade.con
     // copy the modified files into the local Parade directories
     updateWavRange(wavMin, wavMax);
-    
+  }
+  
+  // compute the local thermodynamic states and their clusters, needed also 
+  // when reusing properties to map the stored spectra onto the points
+  computeLocalData();
+  
+  if (!m_reuseProperties) {
     // write the local grid, temperature and densities fields 
     writeLocalData();
     
@@ -427,18 +445,18 @@ void ParadeRadiator::updateWavRange(CFreal wavMin, CFreal wavMax)
       
 //////////////////////////////////////////////////////////////////////////////
       
-void ParadeRadiator::writeLocalData()
+void ParadeRadiator::computeLocalData()
 { 
-  CFLog(VERBOSE, "ParadeRadiator::writeLocalData() => START\n");
+  CFLog(VERBOSE, "ParadeRadiator::computeLocalData() => START\n");
   
-  const CFuint dim = PhysicalModelStack::getActive()->getDim();
   const CFuint nbTemps = m_radPhysicsHandlerPtr->getNbTemps();
   const CFuint tempID = m_radPhysicsHandlerPtr->getTempID();
+  const CFuint nbSpecies = m_library->getNbSpecies();
   
   const CFuint totalNbPoints = m_pstates->getSize();
   CFuint nbPoints = totalNbPoints;
   CFuint countNode = 0;
-  // if the full mesh is in this process than you only write a part of its data
+  // if the full mesh is in this process than you only compute a part of its data
   if (fullGridInProcess()) {
     const CFuint nbPointsPerProc = nbPoints/m_nbProc;
     nbPoints = (m_rank < m_nbProc-1) ? nbPointsPerProc : nbPointsPerProc + nbPoints%m_nbProc;
@@ -446,70 +464,22 @@ void ParadeRadiator::writeLocalData()
       countNode += nbPointsPerProc;
     }
   }
+  m_startNode = countNode;
   
-  const CFuint startNode = countNode;
-  
-  CFLog(INFO, "ParadeRadiator::writeLocalData() => nbPoints = " 
-	<< nbPoints << ", nbTemps = " << nbTemps 
-	<< ", tempID = " << tempID << "\n");
-  
-  // write the mesh file
-  ofstream& foutG = m_outFileHandle->open(m_gridFile);
-  foutG << "TINA" << endl;
-  foutG << 1 << " " << nbPoints << endl;
-  for (CFuint i =0; i < nbPoints; ++i, ++countNode) {
-    foutG.precision(14);
-    foutG.setf(ios::scientific,ios::floatfield);
-    cf_assert(countNode < totalNbPoints);
-    CFreal *const node = m_pstates->getNode(countNode);
-    
-    if (dim == DIM_1D) {
-      foutG << node[XX] << " " << 0.0 << " " << 0.0  << endl;
-    }
-    if (dim == DIM_2D) {
-      foutG << node[XX] << " " << node[YY] << " " << 0.0  << endl;
-    }
-    if (dim == DIM_3D) {
-      foutG << node[XX] << " " << node[YY] << " " << node[ZZ] << endl;
-    }
-  } 
-  foutG.close();
-  
-  CFLog(INFO, "ParadeRadiator::writeLocalData() => written coordinates for cells [" 
-	<< startNode << ", " << countNode << "]\n");
-  
-  // write the temperatures
-  ofstream& foutT = m_outFileHandle->open(m_tempFile);
-  //const CFuint nbEqs = PhysicalModelStack::getActive()->getNbEq();
-  foutT << 1 << " " << nbPoints << " " <<  nbTemps << endl;
-  // here it is assumed that the temperatures are the LAST variables 
-  countNode = startNode;
+  // temperatures: here it is assumed that the temperatures are the LAST variables 
+  m_localTemp.resize(nbPoints*nbTemps);
   for (CFuint i = 0; i < nbPoints; ++i, ++countNode) {
     cf_assert(countNode < totalNbPoints);
     CFreal *const currState = m_pstates->getState(countNode);
     for (CFuint t = 0; t < nbTemps; ++t) {
-      foutT.precision(14);
-      foutT.setf(ios::scientific,ios::floatfield);
-      const CFreal temp = std::max(currState[tempID + t], m_TminFix);
-      foutT << temp << " ";
+      m_localTemp[i*nbTemps + t] = std::max(currState[tempID + t], m_TminFix);
     }
-    foutT << endl;
   }
-  foutT.close();
   
-  CFLog(INFO, "ParadeRadiator::writeLocalData() => written temperature for cells [" 
-	<< startNode << ", " << countNode << "]\n");
+  // number densities
+  m_localDens.resize(nbPoints*nbSpecies);
+  countNode = m_startNode;
   
-  // write the number densities
-  ofstream& foutD = m_outFileHandle->open(m_densFile);
-  const CFuint nbSpecies = m_library->getNbSpecies();
-  foutD << 1 << " " << nbPoints << " " << nbSpecies << endl;  
-
-  //write species partial density
- foutD.precision(14);
- foutD.setf(ios::scientific,ios::floatfield);
- countNode = startNode;
-
  if(!m_massfraction){
  
   if(m_isLTE) {	  
@@ -529,10 +499,8 @@ void ParadeRadiator::writeLocalData()
       for (CFuint t = 0; t < nbSpecies; ++t) {
         // number Density = partial density/ molar mass * Avogadro number
         rhoi = rho*y[t];
-        const CFreal nb = std::max(rhoi*m_avogadroOvMM[t],m_ndminFix);
-        foutD << nb << " ";
+        m_localDens[i*nbSpecies + t] = std::max(rhoi*m_avogadroOvMM[t],m_ndminFix);
       }
-      foutD << endl;
     }
   } 
   else{ 
@@ -542,10 +510,8 @@ void ParadeRadiator::writeLocalData()
       cf_assert(countNode < totalNbPoints);
       CFreal *const currState = m_pstates->getState(countNode);
       for(CFuint t=0; t<nbSpecies; ++t){
-	const CFreal nb = std::max(currState[t]*m_avogadroOvMM[t],m_ndminFix);
-	foutD << nb << " ";
+	m_localDens[i*nbSpecies + t] = std::max(currState[t]*m_avogadroOvMM[t],m_ndminFix);
       }
-      foutD << endl;
     }
   }
  }
@@ -567,10 +533,8 @@ void ParadeRadiator::writeLocalData()
       for (CFuint t = 0; t < nbSpecies; ++t) {
         // number Density = partial density/ molar mass * Avogadro number
         rhoi = rho*y[t];
-        const CFreal nb = std::max(rhoi*m_avogadroOvMM[t],m_ndminFix);
-        foutD << nb << " ";
+        m_localDens[i*nbSpecies + t] = std::max(rhoi*m_avogadroOvMM[t],m_ndminFix);
       }
-      foutD << endl;
     }
   } 
   else{ 
@@ -582,17 +546,133 @@ void ParadeRadiator::writeLocalData()
       CFreal temp  = currState[tempID];
       CFuint pressID = currState[0];
       CFreal press = currState[pressID];
-CFLog(INFO,"The pressure in this state is = " << press << "\n");
       const CFreal rho = m_library->density(temp, press, CFNULL);
       for(CFuint t=0; t<nbSpecies; ++t){
-	const CFreal nb = std::max(currState[t]*rho*m_avogadroOvMM[t],m_ndminFix);
-	foutD << nb << " ";
+	m_localDens[i*nbSpecies + t] = std::max(currState[t]*rho*m_avogadroOvMM[t],m_ndminFix);
       }
-      foutD << endl;
     }
   }
  }
-
+  
+  // group the points whose temperatures and number densities are equal within 
+  // the relative tolerance: each quantity is binned on a logarithmic scale and 
+  // the first point falling into a bin becomes the representative for which 
+  // PARADE computes the spectra
+  m_pointCluster.resize(nbPoints);
+  m_clusterPoints.clear();
+  if (m_clusterTolerance > 0.) {
+    const CFreal invLogTol = 1./std::log(1. + m_clusterTolerance);
+    map<vector<CFint>, CFuint> clusterIDs;
+    vector<CFint> key(nbTemps + nbSpecies);
+    for (CFuint i = 0; i < nbPoints; ++i) {
+      for (CFuint t = 0; t < nbTemps; ++t) {
+	key[t] = static_cast<CFint>(std::floor(std::log(m_localTemp[i*nbTemps + t])*invLogTol));
+      }
+      for (CFuint s = 0; s < nbSpecies; ++s) {
+	key[nbTemps + s] = static_cast<CFint>
+	  (std::floor(std::log(m_localDens[i*nbSpecies + s])*invLogTol));
+      }
+      map<vector<CFint>, CFuint>::const_iterator it = clusterIDs.find(key);
+      if (it == clusterIDs.end()) {
+	const CFuint clusterID = m_clusterPoints.size();
+	clusterIDs.insert(make_pair(key, clusterID));
+	m_clusterPoints.push_back(i);
+	m_pointCluster[i] = clusterID;
+      }
+      else {
+	m_pointCluster[i] = it->second;
+      }
+    }
+  }
+  else {
+    m_clusterPoints.resize(nbPoints);
+    for (CFuint i = 0; i < nbPoints; ++i) {
+      m_pointCluster[i] = i;
+      m_clusterPoints[i] = i;
+    }
+  }
+  
+  CFLog(INFO, "ParadeRadiator::computeLocalData() => " << m_clusterPoints.size() 
+	<< " clusters for " << nbPoints << " points\n");
+  
+  CFLog(VERBOSE, "ParadeRadiator::computeLocalData() => END\n");
+}
+      
+//////////////////////////////////////////////////////////////////////////////
+      
+void ParadeRadiator::writeLocalData()
+{ 
+  CFLog(VERBOSE, "ParadeRadiator::writeLocalData() => START\n");
+  
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  const CFuint nbTemps = m_radPhysicsHandlerPtr->getNbTemps();
+  const CFuint tempID = m_radPhysicsHandlerPtr->getTempID();
+  
+  // only the cluster representatives are passed to PARADE
+  const CFuint nbPoints = m_pointCluster.size();
+  const CFuint nbClusters = m_clusterPoints.size();
+  const CFuint startNode = m_startNode;
+  
+  CFLog(INFO, "ParadeRadiator::writeLocalData() => nbPoints = " 
+	<< nbPoints << ", nbClusters = " << nbClusters << ", nbTemps = " << nbTemps 
+	<< ", tempID = " << tempID << "\n");
+  
+  // write the mesh file
+  ofstream& foutG = m_outFileHandle->open(m_gridFile);
+  foutG << "TINA" << endl;
+  foutG << 1 << " " << nbClusters << endl;
+  foutG.precision(14);
+  foutG.setf(ios::scientific,ios::floatfield);
+  for (CFuint c = 0; c < nbClusters; ++c) {
+    cf_assert(startNode + m_clusterPoints[c] < m_pstates->getSize());
+    CFreal *const node = m_pstates->getNode(startNode + m_clusterPoints[c]);
+    
+    if (dim == DIM_1D) {
+      foutG << node[XX] << " " << 0.0 << " " << 0.0  << "\n";
+    }
+    if (dim == DIM_2D) {
+      foutG << node[XX] << " " << node[YY] << " " << 0.0  << "\n";
+    }
+    if (dim == DIM_3D) {
+      foutG << node[XX] << " " << node[YY] << " " << node[ZZ] << "\n";
+    }
+  } 
+  foutG.close();
+  
+  CFLog(INFO, "ParadeRadiator::writeLocalData() => written coordinates for cells [" 
+	<< startNode << ", " << startNode + nbPoints << "]\n");
+  
+  // write the temperatures
+  ofstream& foutT = m_outFileHandle->open(m_tempFile);
+  foutT << 1 << " " << nbClusters << " " <<  nbTemps << endl;
+  foutT.precision(14);
+  foutT.setf(ios::scientific,ios::floatfield);
+  for (CFuint c = 0; c < nbClusters; ++c) {
+    const CFreal *const temp = &m_localTemp[m_clusterPoints[c]*nbTemps];
+    for (CFuint t = 0; t < nbTemps; ++t) {
+      foutT << temp[t] << " ";
+    }
+    foutT << "\n";
+  }
+  foutT.close();
+  
+  CFLog(INFO, "ParadeRadiator::writeLocalData() => written temperature for cells [" 
+	<< startNode << ", " << startNode + nbPoints << "]\n");
+  
+  // write the number densities
+  ofstream& foutD = m_outFileHandle->open(m_densFile);
+  const CFuint nbSpecies = m_library->getNbSpecies();
+  foutD << 1 << " " << nbClusters << " " << nbSpecies << endl;  
+  foutD.precision(14);
+  foutD.setf(ios::scientific,ios::floatfield);
+  for (CFuint c = 0; c < nbClusters; ++c) {
+    const CFreal *const dens = &m_localDens[m_clusterPoints[c]*nbSpecies];
+    for (CFuint t = 0; t < nbSpecies; ++t) {
+      foutD << dens[t] << " ";
+    }
+    foutD << "\n";
+  }
+  foutD.close();
   
 
 if(m_writeHSNB){
@@ -673,7 +753,7 @@ fout << endl;
  }
 
   CFLog(INFO, "ParadeRadiator::writeLocalData() => written densities for cells [" 
-	<< startNode << ", " << countNode << "]\n");
+	<< startNode << ", " << startNode + nbPoints << "]\n");
   
   CFLog(VERBOSE, "ParadeRadiator::writeLocalData() => START\n");
 }   
@@ -701,11 +781,21 @@ void ParadeRadiator::readLocalRadCoeff()
   fin.read((char*)&nbCells, sizeof(int));
   
   CFLog(VERBOSE,"ParadeRadiator::readLocalRadCoeff() => nbCells = " << nbCells << "\n");
+  // PARADE only computes the spectra of the cluster representatives
+  const CFuint nbClusters = m_clusterPoints.size();
+  if (nbCells != (int)nbClusters) {
+    std::string msg = "ParadeRadiator::readLocalRadCoeff() => " +
+      StringOps::to_str(nbCells) + " cells in " + m_radFile.string() +
+      " != " + StringOps::to_str(nbClusters) + " clusters";
+    throw BadValueException (FromHere(), msg);
+  }
+  
+  const CFuint nbLocalPoints = m_pointCluster.size();
   if (!fullGridInProcess()) {
-    cf_assert(nbCells == (int)m_pstates->getSize()  );
+    cf_assert(nbLocalPoints == m_pstates->getSize());
   }
   else {
-    cf_assert(nbCells <= (int)m_pstates->getSize()  );
+    cf_assert(nbLocalPoints <= m_pstates->getSize());
   }
   
   vector<int> wavptsmx(3);
@@ -713,7 +803,7 @@ void ParadeRadiator::readLocalRadCoeff()
   //fout << "wav3 =  "<< wavptsmx[0] << " " << wavptsmx[1] << " " << wavptsmx[2]<< endl;
   cf_assert(wavptsmx[0] == (int) m_nbPoints);
   const CFuint totalNbCells = m_pstates->getSize();
-  const CFuint sizeLocalCells = (!m_saveMemory) ? totalNbCells : nbCells;
+  const CFuint sizeLocalCells = (!m_saveMemory) ? totalNbCells : nbLocalPoints;
   m_data.resize(sizeLocalCells*m_nbPoints*3);
   
   // here if the process stores the full mesh (as in the FV DOM algorithm), each processor 
@@ -721,10 +811,20 @@ void ParadeRadiator::readLocalRadCoeff()
   LocalArray<CFreal>::TYPE partialData;
   LocalArray<CFreal>::TYPE* currData = &m_data;
   if (fullGridInProcess() && !m_saveMemory) {
-    partialData.resize(nbCells*m_nbPoints*3);
+    partialData.resize(nbLocalPoints*m_nbPoints*3);
     currData = &partialData;
   }
   
+  // with clustering, the spectra of the representatives are read in a separate 
+  // buffer and then copied to all the points of their cluster
+  const bool expandClusters = (nbClusters < nbLocalPoints);
+  LocalArray<CFreal>::TYPE clusterData;
+  LocalArray<CFreal>::TYPE* readData = currData;
+  if (expandClusters) {
+    clusterData.resize(nbClusters*m_nbPoints*3);
+    readData = &clusterData;
+  }
+  
   double etot = 0.;
   int wavpts = 0;
   const CFuint sizeCoeff = m_nbPoints*3;
@@ -735,10 +835,17 @@ void ParadeRadiator::readLocalRadCoeff()
     cf_assert(wavpts == (int)m_nbPoints);
     //fout << "wavpt = " <<  wavpts << endl;
     // this reads [wavelength, emission, absorption] for each cell
-    fin.read((char*)&((*currData)[iCell*sizeCoeff]), sizeCoeff*sizeof(double));
+    fin.read((char*)&((*readData)[iCell*sizeCoeff]), sizeCoeff*sizeof(double));
   }
   fin.close();
   
+  if (expandClusters) {
+    for (CFuint i = 0; i < nbLocalPoints; ++i) {
+      const CFreal *const clusterCoeff = &clusterData[m_pointCluster[i]*sizeCoeff];
+      std::copy(clusterCoeff, clusterCoeff + sizeCoeff, &(*currData)[i*sizeCoeff]);
+    }
+  }
+  
   if (fullGridInProcess() && !m_saveMemory) {
     // in case the full mesh is stored in each process, since we have read in only a part 
     // of spectral data, we need now to gather all data so that each process has the full 
@@ -764,7 +871,7 @@ void ParadeRadiator::readLocalRadCoeff()
   CFLog(INFO, "ParadeRadiator::readLocalRadCoeff() => read data for all cells\n");
   
   if (m_writeLocalRadCoeffASCII) {
-    writeLocalRadCoeffASCII(nbCells);
+    writeLocalRadCoeffASCII(nbLocalPoints);
   }
   
   CFLog(VERBOSE, "ParadeRadiator::readLocalRadCoeff() => END\n");
@@ -901,6 +1008,27 @@ CFreal ParadeRadiator::getAbsorption(CFreal lambda, RealVector &s_o)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ParadeRadiator::getAbsorptions(const CFuint nb, const CFuint *const stateIDs, 
+				    const CFreal *const lambdas, CFreal *const absorptions)
+{
+  const CFuint nbCols = m_nbPoints*3;
+  for (CFuint i = 0; i < nb; ++i) {
+    CFuint spectralIdx1 = 0; 
+    CFuint spectralIdx2 = 0;
+    getSpectralIdxs(lambdas[i], spectralIdx1, spectralIdx2);
+    const CFuint stateIdx = m_radPhysicsHandlerPtr->getCellTrsIdx(stateIDs[i]);
+    cf_assert(stateIdx < m_data.size()/nbCols);
+    const CFreal *const row = &m_data[stateIdx*nbCols];
+    const CFreal x0 = row[spectralIdx1*3];
+    const CFreal y0 = row[spectralIdx1*3+2];
+    const CFreal x1 = row[spectralIdx2*3];
+    const CFreal y1 = row[spectralIdx2*3+2];
+    absorptions[i] = y0 + (y1-y0) * (lambdas[i] - x0) / (x1-x0);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ParadeRadiator::computeEmissionCPD()
 {
   CFLog(VERBOSE, "ParadeRadiator::computeEmissionCPD() => start\n");
@@ -116,6 +116,9 @@ public:
   
   virtual CFreal getAbsorption(CFreal lambda, RealVector &s_o);
   
+  virtual void getAbsorptions(const CFuint nb, const CFuint *const stateIDs, 
+			      const CFreal *const lambdas, CFreal *const absorptions);
+  
   virtual CFreal getSpectraLoopPower();
   
   virtual void computeEmissionCPD();
@@ -131,6 +134,10 @@ protected:
   /// update the range of wavelengths to use
   virtual void updateWavRange(CFreal wavMin, CFreal wavMax);
   
+  /// compute the temperatures and number densities of the local points and
+  /// group the points with similar thermodynamic states into clusters
+  virtual void computeLocalData();
+  
   /// write the data (grid, temperatue, densities) corresponding to the local mesh
   virtual void writeLocalData();
   
@@ -332,6 +339,25 @@ protected:
   /// bool to write the table in a file
   bool m_writeHSNB;
   
+  /// relative tolerance on temperatures and number densities under which
+  /// two points share the spectra of the same cluster (0 disables clustering)
+  CFreal m_clusterTolerance;
+  
+  /// index of the first local point in the states storage
+  CFuint m_startNode;
+  
+  /// temperatures of the local points (nbTemps per point)
+  std::vector<CFreal> m_localTemp;
+  
+  /// number densities of the local points (nbSpecies per point)
+  std::vector<CFreal> m_localDens;
+  
+  /// cluster ID of each local point
+  std::vector<CFuint> m_pointCluster;
+  
+  /// local ID of the representative point of each cluster
+  std::vector<CFuint> m_clusterPoints;
+  
 }; // end of class ParadeRadiator
 
 //////////////////////////////////////////////////////////////////////////////
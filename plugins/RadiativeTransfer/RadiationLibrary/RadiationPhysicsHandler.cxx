@@ -151,6 +151,25 @@ Common::SharedPtr< RadiationPhysics > RadiationPhysicsHandler::getCellDistPtr
 
 //////////////////////////////////////////////////////////////////////////////
 
+void RadiationPhysicsHandler::getCellAbsorptions
+(const CFuint nb, const CFuint *const stateIDs, 
+ const CFreal *const lambdas, CFreal *const absorptions)
+{
+  for (CFuint start = 0; start < nb;) {
+    cf_assert(stateIDs[start] < m_statesOwner.size());
+    const CFint owner = m_statesOwner[stateIDs[start]][0];
+    cf_assert(owner != -1);
+    CFuint end = start+1;
+    while (end < nb && m_statesOwner[stateIDs[end]][0] == owner) {++end;}
+    
+    m_radiationPhysics[owner]->getRadiatorPtr()->getAbsorptions
+      (end-start, &stateIDs[start], &lambdas[start], &absorptions[start]);
+    start = end;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 Common::SharedPtr< RadiationPhysics > RadiationPhysicsHandler::getWallDistPtr
 (CFuint GhostStateID)
 {
@@ -52,6 +52,11 @@ public:
   
   /// @return @see RadiationPhysics corresponding to the given cell state ID
   Common::SharedPtr< RadiationPhysics > getCellDistPtr(CFuint stateID);
+  
+  /// compute the absorption coefficients of a batch of cells, calling the
+  /// radiator once for each run of consecutive cells with the same radiation physics
+  void getCellAbsorptions(const CFuint nb, const CFuint *const stateIDs, 
+			  const CFreal *const lambdas, CFreal *const absorptions);
 
   /// @return @see RadiationPhysics corresponding to the given ghost state ID
   Common::SharedPtr< RadiationPhysics > getWallDistPtr(CFuint GhostStateID);
@@ -113,6 +118,9 @@ public:
   /// @return the current cell ID into its corresponding  TRS
   CFuint getCurrentCellTrsIdx() const {return m_cellStateOwnerIdx;}
   
+  /// @return the ID of the given cell into its corresponding TRS
+  CFuint getCellTrsIdx(CFuint stateID) const {return m_statesOwner[stateID][1];}
+  
   /// @return the current cell wall ghost state ID
   CFuint getCurrentWallGhostStateID() const {return m_ghostStateID;}
   
@@ -50,6 +50,18 @@ void Radiator::setup()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Radiator::getAbsorptions(const CFuint nb, const CFuint *const stateIDs, 
+			      const CFreal *const lambdas, CFreal *const absorptions)
+{
+  RealVector null;
+  for (CFuint i = 0; i < nb; ++i) {
+    m_radPhysicsHandlerPtr->getCellDistPtr(stateIDs[i]);
+    absorptions[i] = getAbsorption(lambdas[i], null);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 CFreal Radiator::getCurrentCellVolume() const
 {
   const CFuint stateID = 
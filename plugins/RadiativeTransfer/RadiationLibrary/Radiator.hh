@@ -60,6 +60,15 @@ public:
 
   virtual CFreal getAbsorption( CFreal lambda, RealVector &s_o ) = 0;
 
+  /// compute the absorption coefficients of a batch of cells handled by this radiator
+  /// (by default one by one, setting each cell as the current one)
+  /// @param nb           number of cells
+  /// @param stateIDs     local IDs of the cell states
+  /// @param lambdas      wavelength for each cell
+  /// @param absorptions  absorption coefficient of each cell
+  virtual void getAbsorptions(const CFuint nb, const CFuint *const stateIDs, 
+			      const CFreal *const lambdas, CFreal *const absorptions);
+
   virtual CFreal getSpectraLoopPower() = 0;
 
   virtual void computeEmissionCPD() = 0;
@@ -86,6 +95,9 @@ public:
   /// get the wall face area
   CFreal getWallArea(CFuint wallGeoID) const;
   
+  /// get the random number generator used for the emission
+  RandomNumberGenerator& getRandomGenerator() {return m_rand;}
+  
 protected:
   
   const CFreal m_angstrom; 
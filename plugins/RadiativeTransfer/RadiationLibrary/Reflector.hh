@@ -54,6 +54,9 @@ public:
     m_radPhysicsHandlerPtr = radPhysicsHandlerPtr;
   }
 
+  /// get the random number generator used for the reflection
+  RandomNumberGenerator& getRandomGenerator() {return m_rand;}
+
 protected:
   RadiationPhysics *m_radPhysicsPtr;
   RadiationPhysicsHandler *m_radPhysicsHandlerPtr;
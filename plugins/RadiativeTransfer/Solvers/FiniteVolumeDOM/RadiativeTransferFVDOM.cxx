@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
 #include "Common/PE.hh"
+#include "Common/ThreadPool.hh"
 #include "Common/BadValueException.hh"
 #include "Common/CFPrintContainer.hh"
 
@@ -90,8 +92,10 @@ RadiativeTransferFVDOM::RadiativeTransferFVDOM(const std::string& name) :
   m_Ttable(),
   m_Ptable(),
   m_dotProdInFace(),
-  m_sdone(),
-  m_cdoneIdx(),
+  m_nbUpwindCells(),
+  m_downwindStart(),
+  m_downwindCells(),
+  m_nextStage(),
   m_wallTrsNames(),
   m_dirs(),
   m_advanceOrder(),
@@ -100,7 +104,24 @@ RadiativeTransferFVDOM::RadiativeTransferFVDOM(const std::string& name) :
   m_nbBins(1),
   m_nbBands(1),
   m_multiSpectralIdx(),
-  m_nbDirTypes()
+  m_nbDirTypes(),
+  m_wallFaceIdx(),
+  m_wallFaceCellID(),
+  m_wallFaceIbq(),
+  m_threadSweepData(),
+  m_nextSweepTask(0),
+  m_sweepTaskStride(1),
+  m_nbSweepTasks(0),
+  m_nbSweptTasks(0),
+  m_sweepTasksFetched(false),
+  m_sweepQueue(),
+  m_sweepQueueMutex()
+#ifdef CF_HAVE_MPI
+  ,
+  m_sweepTaskCounter(0),
+  m_sweepTaskWindow(MPI_WIN_NULL),
+  m_hasSweepTaskWindow(false)
+#endif
 {
   addConfigOptionsTo(this);
   
@@ -161,6 +182,9 @@ RadiativeTransferFVDOM::RadiativeTransferFVDOM(const std::string& name) :
   m_loopOverBins = true;
   setParameter("LoopOverBins", &m_loopOverBins);
   
+  m_dynamicScheduling = false;
+  setParameter("DynamicScheduling", &m_dynamicScheduling);
+  
   m_emptyRun = false;
   setParameter("EmptyRun", &m_emptyRun);
     
@@ -235,6 +259,8 @@ void RadiativeTransferFVDOM::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< CFuint >("NbThreads","Number of threads/CPUs in which the algorithm has to be split.");
   options.addConfigOption< CFuint >("ThreadID","ID of the current thread within the parallel algorithm."); 
   options.addConfigOption< bool >("LoopOverBins","Loop over bins and then over directions (do the opposite if =false).");
+  options.addConfigOption< bool >
+    ("DynamicScheduling","Distribute the (bin, direction) sweeps dynamically to the threads and to the processes of RadNamespace (NbThreads and ThreadID are then ignored).");
   options.addConfigOption< bool >("EmptyRun","Run without actually solving anything, just for testing purposes.");
   options.addConfigOption< string >("DirectionsGenerator","Name of the method for generating directions.");
   options.addConfigOption< CFreal >("theta_max","Maximum value of theta.");
@@ -450,8 +476,9 @@ void RadiativeTransferFVDOM::setup()
 
   const CFuint nbCells = cells->nbRows();
     
-  m_sdone.resize(nbCells);
-  m_cdoneIdx.reserve(nbCells);
+  m_nbUpwindCells.resize(nbCells);
+  m_downwindStart.resize(nbCells+1);
+  m_nextStage.reserve(nbCells);
   
   if(m_useExponentialMethod){
     m_fieldSource.resize(nbCells);
@@ -466,10 +493,6 @@ void RadiativeTransferFVDOM::setup()
   m_In.resize(nbCells);
   m_II.resize(nbCells);
   
-  for (CFuint iCell = 0; iCell < nbCells; iCell++){
-    m_sdone[iCell] = false;
-  }
-  
   // m_nbThreads, m_threadID
   cf_assert(m_nbDirs > 0);
   cf_assert(m_nbBins > 0);
@@ -530,6 +553,18 @@ void RadiativeTransferFVDOM::setup()
     }
   }
   
+  if (m_dynamicScheduling) {
+    // any (bin, direction) pair can be swept by this process
+    m_startEndDir.first  = 0;
+    m_startEndBin.first  = 0;
+    m_startEndDir.second = m_nbDirs-1;
+    m_startEndBin.second = m_multiSpectralIdx-1;
+    if (m_oldAlgo) {
+      CFLog(WARN, "RadiativeTransferFVDOM::setup() => OldAlgorithm is ignored with DynamicScheduling\n");
+      m_oldAlgo = false;
+    }
+  }
+  
   const CFuint startBin = m_startEndBin.first;
   const CFuint endBin   = m_startEndBin.second+1;
   cf_assert(endBin <= m_multiSpectralIdx);
@@ -628,6 +663,7 @@ void RadiativeTransferFVDOM::setup()
   // preallocation of memory for qradFluxWall
   socket_qradFluxWall.getDataHandle().resize(nbFaces);
   socket_qradFluxWall.getDataHandle() = 0.0;
+  setupWallFaces();
 
   //Averages for the Sphere case
   if (m_radialData || m_TGSData) {
@@ -1333,7 +1369,12 @@ void RadiativeTransferFVDOM::execute()
     const CFuint endDir   = m_startEndDir.second+1;
     cf_assert(endDir <= m_nbDirs);
     
-    if (m_loopOverBins) {
+    if (socket_qradFluxWall.getDataHandle().size() > 0) {computeWallFaceIbq();}
+    
+    if (m_dynamicScheduling) {
+      loopOverTasks();
+    }
+    else if (m_loopOverBins) {
       loopOverBins(startBin, endBin, startDir, endDir);
     }
     else {
@@ -1441,69 +1482,93 @@ void RadiativeTransferFVDOM::getAdvanceOrder(const CFuint d,
   // precompute the dot products for all faces and directions (a part from the sign)
   computeDotProdInFace(d, m_dotProdInFace);
   
-  CFuint mLast = 0;
-  CFuint m = 0;
-
-  CFuint stage = 1;
-  // Initializing the sdone and cdone for each direction
-  m_sdone.assign(nbCells, false);
-  
-  m_cdoneIdx.clear();
-  cf_assert(m_cdoneIdx.size() == 0);
-  cf_assert(m_cdoneIdx.capacity() == nbCells);
-  
   SafePtr<ConnectivityTable<CFuint> > cellFaces = MeshDataStack::getActive()->getConnectivity("cellFaces");
   DataHandle<CFint> isOutward = socket_isOutward.getDataHandle();
-    
-  while (m < nbCells) { //The loop over the cells begins
-    mLast = m;	  //Checking to see if it counts all the cells
-    for (CFuint iCell = 0; iCell < nbCells; iCell++) {
-      CFLog(DEBUG_MAX, "RadiativeTransferFVDOM::getAdvanceOrder() => iCell = " << iCell <<"\n");
-      if (m_sdone[iCell] == false) {
-	const CFuint nbFaces = cellFaces->nbCols(iCell);
-	for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
-	  const CFuint faceID = (*cellFaces)(iCell, iFace);
-	  const bool isBFace  = m_mapGeoToTrs->isBGeo(faceID);
-	  const bool neighborIsSdone = (!isBFace) ? m_sdone[getNeighborCellID(faceID, iCell)] : true;
-	  
-	  // When dot product is < 0 and neighbor is undone, skip the cell and continue the loop
-	  const CFreal factor = ((CFuint)(isOutward[faceID]) != iCell) ? -1. : 1.;
-	  const CFreal dotMult = m_dotProdInFace[faceID]*factor;
-	  if (dotMult < 0. && neighborIsSdone == false) {goto cell_loop;}
-	}// end loop over the FACES
-	
-	CFLog(DEBUG_MAX, "advanceOrder[" << d << "][" << m <<"] = " << iCell << "\n");
-	
-	advanceOrder[m] = iCell;
-	CellID[iCell] = stage;
-	m_cdoneIdx.push_back(iCell);
-	m += 1;
-      }// end if(Cell is not done)
-      
-    cell_loop:
-      const bool dummy = true;
-    }// end of the loop over the CELLS
-    
-    const string msg = "advanceOrder[" + StringOps::to_str(d) + "] = ";
-    CFLog(DEBUG_MAX, msg << "\n");
-    for (CFuint a = 0; a < nbCells; ++a) {
-      CFLog(DEBUG_MAX, advanceOrder[a] << " ");
+  
+  // graph of the upwind dependencies: a cell must wait for the neighbor 
+  // across each of its faces with a negative dot product
+  m_nbUpwindCells.assign(nbCells, 0);
+  m_downwindStart.assign(nbCells+1, 0);
+  for (CFuint iCell = 0; iCell < nbCells; iCell++) {
+    const CFuint nbFaces = cellFaces->nbCols(iCell);
+    for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
+      const CFuint faceID = (*cellFaces)(iCell, iFace);
+      if (!m_mapGeoToTrs->isBGeo(faceID)) {
+	const CFreal factor = ((CFuint)(isOutward[faceID]) != iCell) ? -1. : 1.;
+	if (m_dotProdInFace[faceID]*factor < 0.) {
+	  ++m_nbUpwindCells[iCell];
+	  ++m_downwindStart[getNeighborCellID(faceID, iCell)+1];
+	}
+      }
+    }
+  }
+  for (CFuint iCell = 0; iCell < nbCells; iCell++) {
+    m_downwindStart[iCell+1] += m_downwindStart[iCell];
+  }
+  m_downwindCells.resize(m_downwindStart[nbCells]);
+  m_nextStage.assign(m_downwindStart.begin(), m_downwindStart.end()-1);
+  for (CFuint iCell = 0; iCell < nbCells; iCell++) {
+    const CFuint nbFaces = cellFaces->nbCols(iCell);
+    for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
+      const CFuint faceID = (*cellFaces)(iCell, iFace);
+      if (!m_mapGeoToTrs->isBGeo(faceID)) {
+	const CFreal factor = ((CFuint)(isOutward[faceID]) != iCell) ? -1. : 1.;
+	if (m_dotProdInFace[faceID]*factor < 0.) {
+	  m_downwindCells[m_nextStage[getNeighborCellID(faceID, iCell)]++] = iCell;
+	}
+      }
+    }
+  }
+  
+  // the first stage is made of the cells without upwind neighbors
+  m_nextStage.clear();
+  for (CFuint iCell = 0; iCell < nbCells; iCell++) {
+    if (m_nbUpwindCells[iCell] == 0) {m_nextStage.push_back(iCell);}
+  }
+  
+  CFuint m = 0;
+  CFuint stage = 1;
+  while (m < nbCells) {
+    if (m_nextStage.size() == 0) {
+      // break the cycle by sweeping the first remaining cell with lagged upwind values
+      CFLog(WARN, "RadiativeTransferFVDOM::getAdvanceOrder() => cyclic dependency in direction [" 
+	    << d << "] after " << m << " cells: upwind values are lagged for one cell\n");
+      for (CFuint iCell = 0; iCell < nbCells; iCell++) {
+	if (m_nbUpwindCells[iCell] > 0) {
+	  m_nbUpwindCells[iCell] = 0;
+	  m_nextStage.push_back(iCell);
+	  break;
+	}
+      }
+      cf_assert(m_nextStage.size() == 1);
     }
-    CFLog(DEBUG_MAX, "\n");
-
-    if (m == mLast) {diagnoseProblem(d, m, mLast);}
     
+    // cells of a stage are ordered by increasing ID, as in a sweep over all cells
+    std::sort(m_nextStage.begin(), m_nextStage.end());
+    const CFuint mStart = m;
+    for (CFuint i = 0; i < m_nextStage.size(); ++i) {
+      const CFuint iCell = m_nextStage[i];
+      CFLog(DEBUG_MAX, "advanceOrder[" << d << "][" << m <<"] = " << iCell << "\n");
+      advanceOrder[m++] = iCell;
+      CellID[iCell] = stage;
+    }
     advanceOrder[m - 1] *= -1;
     
-    CFLog(DEBUG_MAX, "At stage[" << stage << "] => m_cdoneIdx.size() = " << m_cdoneIdx.size() << "\n");
-    for (CFuint id = 0; id < m_cdoneIdx.size(); ++id) {
-      m_sdone[m_cdoneIdx[id]] = true;
+    // the downwind neighbors whose upwind neighbors are all swept form the next stage
+    m_nextStage.clear();
+    for (CFuint i = mStart; i < m; ++i) {
+      const CFuint iCell = std::abs(advanceOrder[i]);
+      for (CFuint k = m_downwindStart[iCell]; k < m_downwindStart[iCell+1]; ++k) {
+	const CFuint downCell = m_downwindCells[k];
+	// a cell released by the cycle breaking may still have upwind neighbors
+	if (m_nbUpwindCells[downCell] > 0 && --m_nbUpwindCells[downCell] == 0) {
+	  m_nextStage.push_back(downCell);
+	}
+      }
     }
-    m_cdoneIdx.clear();
     
     CFLog(VERBOSE, "RadiativeTransferFVDOM::getAdvanceOrder() => m  "<< m << " \n");
     CFLog(VERBOSE, "RadiativeTransferFVDOM::getAdvanceOrder() => End of the "<< stage << " stage\n");
-    
     ++stage;
   }// end of the loop over the STAGES
   
@@ -1698,26 +1763,33 @@ void RadiativeTransferFVDOM::unsetup()
 {
   CFAUTOTRACE;
   
+#ifdef CF_HAVE_MPI
+  if (m_hasSweepTaskWindow) {
+    MPI_Win_free(&m_sweepTaskWindow);
+    m_hasSweepTaskWindow = false;
+  }
+#endif
+  
   DataProcessingCom::unsetup();
 }
       
 //////////////////////////////////////////////////////////////////////////////
 
-void RadiativeTransferFVDOM::getFieldOpacities(const CFuint ib, const CFuint iCell)
+void RadiativeTransferFVDOM::getFieldOpacities(const CFuint ib, const CFuint iCell,
+					       const SweepFields& f)
 {
   CFLog(DEBUG_MIN, "RadiativeTransferFVDOM::getFieldOpacities(" << ib << ", " 
 	<< iCell << ") => START\n");
   
-  m_fieldSource[iCell] = 0.;
+  f.fieldSource[iCell] = 0.;
   if(m_useExponentialMethod){
-    m_fieldAbsor[iCell] = 0.;
+    f.fieldAbsor[iCell] = 0.;
   }
   else{
-    m_fieldAbSrcV[iCell] = 0.;
-    m_fieldAbV[iCell]    = 0.;
+    f.fieldAbSrcV[iCell] = 0.;
+    f.fieldAbV[iCell]    = 0.;
   }
   
-  DataHandle<CFreal> TempProfile    = socket_TempProfile.getDataHandle();
   DataHandle<CFreal> volumes        = socket_volumes.getDataHandle();
   DataHandle<CFreal> alpha_avbin    = socket_alpha_avbin.getDataHandle();
   DataHandle<CFreal> B_bin          = socket_B_bin.getDataHandle();
@@ -1751,7 +1823,7 @@ void RadiativeTransferFVDOM::getFieldOpacities(const CFuint ib, const CFuint iCe
     T = Tmax - (Tmax - Tmin)*(1 - std::exp(-A))/(1 - std::exp(-Amax));
   }
   
-  TempProfile[iCell] = T;
+  if (f.tempProfile != CFNULL) {f.tempProfile[iCell] = T;}
   
   const CFreal patm   = p/101325.; //converting from Pa to atm
   CFreal val1 = 0;
@@ -1766,47 +1838,47 @@ void RadiativeTransferFVDOM::getFieldOpacities(const CFuint ib, const CFuint iCe
     
     if(m_useExponentialMethod){
       if (val1 <= 1e-30 || val2 <= 1e-30 ){
-	m_fieldSource[iCell] = 1e-30;
-	m_fieldAbsor[iCell]  = 1e-30;
+	f.fieldSource[iCell] = 1e-30;
+	f.fieldAbsor[iCell]  = 1e-30;
       } 
       else {
-	m_fieldSource[iCell] = val2/val1;
-	m_fieldAbsor[iCell]  = val1;
+	f.fieldSource[iCell] = val2/val1;
+	f.fieldAbsor[iCell]  = val1;
       }
     } 
     else{
       if (val1 <= 1e-30 || val2 <= 1e-30 ){
-	m_fieldSource[iCell] = 1e-30;
-	m_fieldAbV[iCell]    = 1e-30*volumes[iCell]; // Volume converted from m^3 into cm^3
+	f.fieldSource[iCell] = 1e-30;
+	f.fieldAbV[iCell]    = 1e-30*volumes[iCell]; // Volume converted from m^3 into cm^3
       }
       else {
-	m_fieldSource[iCell] = val2/val1;
-	m_fieldAbV[iCell]    = val1*volumes[iCell];
+	f.fieldSource[iCell] = val2/val1;
+	f.fieldAbV[iCell]    = val1*volumes[iCell];
       }      
-      m_fieldAbSrcV[iCell]   = m_fieldSource[iCell]*m_fieldAbV[iCell];
+      f.fieldAbSrcV[iCell]   = f.fieldSource[iCell]*f.fieldAbV[iCell];
     }
   }
   else {
     if(m_useExponentialMethod){
       if (((alpha_avbin[ib+m_multiSpectralIdx*iCell]) <= 1e-30) || ((B_bin[ib+m_multiSpectralIdx*iCell]) <= 1e-30) ){
-	m_fieldSource[iCell] = 1e-30;
-	m_fieldAbsor[iCell]  = 1e-30;
+	f.fieldSource[iCell] = 1e-30;
+	f.fieldAbsor[iCell]  = 1e-30;
       }
       else {
-	m_fieldSource[iCell] = B_bin[ib+m_multiSpectralIdx*iCell];
-	m_fieldAbsor[iCell]  = alpha_avbin[ib+m_multiSpectralIdx*iCell];
+	f.fieldSource[iCell] = B_bin[ib+m_multiSpectralIdx*iCell];
+	f.fieldAbsor[iCell]  = alpha_avbin[ib+m_multiSpectralIdx*iCell];
       }
     }
     else{
       if (alpha_avbin[ib+m_multiSpectralIdx*iCell] <= 1e-30 || B_bin[ib+m_multiSpectralIdx*iCell] <= 1e-30 ){
-	m_fieldSource[iCell] = 1e-30;
-	m_fieldAbV[iCell]    = 1e-30*volumes[iCell]; // Volume converted from m^3 into cm^3
+	f.fieldSource[iCell] = 1e-30;
+	f.fieldAbV[iCell]    = 1e-30*volumes[iCell]; // Volume converted from m^3 into cm^3
       }
       else {
-	m_fieldSource[iCell] = B_bin[ib+m_multiSpectralIdx*iCell];
-	m_fieldAbV[iCell]    = alpha_avbin[ib+m_multiSpectralIdx*iCell]*volumes[iCell];
+	f.fieldSource[iCell] = B_bin[ib+m_multiSpectralIdx*iCell];
+	f.fieldAbV[iCell]    = alpha_avbin[ib+m_multiSpectralIdx*iCell]*volumes[iCell];
       }      
-      m_fieldAbSrcV[iCell]   = m_fieldSource[iCell]*m_fieldAbV[iCell];
+      f.fieldAbSrcV[iCell]   = f.fieldSource[iCell]*f.fieldAbV[iCell];
     }
   }
   
@@ -1816,16 +1888,15 @@ void RadiativeTransferFVDOM::getFieldOpacities(const CFuint ib, const CFuint iCe
 //////////////////////////////////////////////////////////////////////////////
 
 void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
-						 const CFuint dStart,
-						 const CFuint d)
+						 const CFuint d,
+						 const CFint *const advanceOrder,
+						 const SweepFields& f)
 {      
   CFLog(VERBOSE, 
 	"RadiativeTransferFVDOM::computeQExponential() in (bin, dir) = ("
 	<< ib << ", " << d << ") => start\n");
-  DataHandle<CFreal> qradFluxWall = socket_qradFluxWall.getDataHandle();
   DataHandle<CFreal> faceAreas = socket_faceAreas.getDataHandle();
   DataHandle<CFreal> volumes = socket_volumes.getDataHandle();
-  DataHandle<CFreal> divQ = socket_divq.getDataHandle();
   CellTrsGeoBuilder::GeoData& geoData = m_geoBuilder.getDataGE();
   SafePtr<TopologicalRegionSet> cells = geoData.trs;
   const CFuint nbCells = cells->getLocalNbGeoEnts();
@@ -1833,9 +1904,6 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
   SafePtr<ConnectivityTable<CFuint> > cellFaces = 
     MeshDataStack::getActive()->getConnectivity("cellFaces");
   DataHandle<CFint> isOutward = socket_isOutward.getDataHandle();
-  DataHandle<CFreal> qx = socket_qx.getDataHandle();
-  DataHandle<CFreal> qy = socket_qy.getDataHandle();
-  DataHandle<CFreal> qz = socket_qz.getDataHandle();
   
   //////// 
   /*const CFuint totalNbFaces = MeshDataStack::getActive()->Statistics().getNbFaces();
@@ -1862,7 +1930,6 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
   std::vector< CFreal > ddd;
   std::vector< CFreal > Ibq;
 
-  const CFuint startCell = (d-dStart)*nbCells;
   for (CFuint m = 0; m < nbCells; m++) {
     CFreal inDirDotnANeg = 0.;
     CFreal Ic            = 0.;
@@ -1872,12 +1939,11 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
     CFreal POP_dirDotNA  = 0.;
       
     // allocate the cell entity
-    cf_assert(startCell+m < m_advanceOrder.size());
-    const CFuint iCell = std::abs(m_advanceOrder[startCell+m]);
+    const CFuint iCell = std::abs(advanceOrder[m]);
     
     // new algorithm (more parallelizable): opacities are computed cell by cell
     // for a given bin
-    if (!m_oldAlgo) {getFieldOpacities(ib, iCell);} 
+    if (!m_oldAlgo) {getFieldOpacities(ib, iCell, f);} 
     
     const CFuint nbFaces = cellFaces->nbCols(iCell);
     //    cf_assert(nbFaces == nbFacesInCell[iCell]);
@@ -1885,16 +1951,17 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
     for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
       const CFuint faceID = (*cellFaces)(iCell, iFace);
       const CFreal factor = ((CFuint)(isOutward[faceID]) != iCell) ? -1. : 1.;
-      const CFreal dirDotNA = m_dotProdInFace[faceID]*factor;
+      const CFreal dirDotNA = f.dotProdInFace[faceID]*factor;
       
       // AL: check on wall faces and emissivities (use Radiator for this!!!)
-      const CFint isWallFace = getWallFaceID(faceID);
+      const CFint isWallFace = m_wallFaceIdx[faceID];
       // isInner would always be true...
-      const bool isComputingWallFace = qradFluxWall.size() > 0 && isWallFace != -1 && isInner(iCell, faceID) == 1;
+      const bool isComputingWallFace = f.qradFluxWall != CFNULL && isWallFace != -1 && 
+	m_wallFaceCellID[isWallFace] == iCell;
       if(isComputingWallFace) {
 	wallfIdx.push_back(isWallFace);
 	ddd.push_back(dirDotNA*m_weight[d]/faceAreas[faceID]);
-	Ibq.push_back(getFaceIbq(faceID));
+	Ibq.push_back(m_wallFaceIbq[isWallFace]);
       }
 
       if(dirDotNA < 0.) {
@@ -1902,21 +1969,21 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
 	
 	/*const CFint fcellID = faceCell[faceID*2]; 
 	  const CFint neighborCellID = (fcellID == iCell) ? faceCell[faceID*2+1] : fcellID;
-	  const CFreal source = (neighborCellID >=0) ? m_In[neighborCellID] : m_fieldSource[iCell];
+	  const CFreal source = (neighborCellID >=0) ? f.In[neighborCellID] : f.fieldSource[iCell];
 	  inDirDotnANeg += source*dirDotNA;*/
 	
 	const bool isBFace = m_mapGeoToTrs->isBGeo(faceID);
 	if (!isBFace){
 	  const CFuint neighborCellID = getNeighborCellID(faceID, iCell);
-	  inDirDotnANeg += m_In[neighborCellID]*dirDotNA;
+	  inDirDotnANeg += f.In[neighborCellID]*dirDotNA;
 	}
 	else { // it recognizes a wall as it was a boundary
          if(isComputingWallFace) { // is a wall
-	   inDirDotnANeg += m_wallEmissivity*getFaceIbq(faceID)*dirDotNA/m_multiSpectralIdx; //divided by m_multiSpectralIdx
+	   inDirDotnANeg += m_wallEmissivity*m_wallFaceIbq[isWallFace]*dirDotNA/m_multiSpectralIdx; //divided by m_multiSpectralIdx
              //CFLog(INFO,"WALL FACE ------------> " << getWallFaceID(faceID) << ", SOURCE ----> " << m_wallEmissivity*getFaceIbq(faceID) <<"\n");
           }
           else { // is another boundary
-	  const CFreal boundarySource = m_fieldSource[iCell];
+	  const CFreal boundarySource = f.fieldSource[iCell];
 	  inDirDotnANeg += boundarySource*dirDotNA;
 	 }
         }
@@ -1927,9 +1994,9 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
     } 
     
     Lc          = volumes[iCell]/(- dirDotnANeg); 
-    halfExp     = std::exp(-0.5*Lc*m_fieldAbsor[iCell]);
-    const CFreal InCell = (inDirDotnANeg/dirDotnANeg)*halfExp*halfExp + (1. - halfExp*halfExp)*m_fieldSource[iCell];
-    Ic          = (inDirDotnANeg/dirDotnANeg)*halfExp + (1. - halfExp)*m_fieldSource[iCell];
+    halfExp     = std::exp(-0.5*Lc*f.fieldAbsor[iCell]);
+    const CFreal InCell = (inDirDotnANeg/dirDotnANeg)*halfExp*halfExp + (1. - halfExp*halfExp)*f.fieldSource[iCell];
+    Ic          = (inDirDotnANeg/dirDotnANeg)*halfExp + (1. - halfExp)*f.fieldSource[iCell];
     
     // AL: computation of heat fluxes
     if(wallfIdx.size() > 0) {
@@ -1938,11 +2005,11 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
 	const CFreal DDD = ddd[fcount];
 	const CFreal IBQ = Ibq[fcount];
 	if(DDD > 0.0){
-          qradFluxWall[IDX] += -m_wallEmissivity*InCell*DDD;
+          f.qradFluxWall[IDX] += -m_wallEmissivity*InCell*DDD;
 	}
 	else{
 	  if(ib == 0){ //AL: why for the first bin you do this????
-            qradFluxWall[IDX] += m_wallEmissivity*IBQ*std::abs(DDD);
+            f.qradFluxWall[IDX] += m_wallEmissivity*IBQ*std::abs(DDD);
 	    //CFLog(INFO,"IBQ = " << IBQ <<"\n");
 	  }
 	}
@@ -1954,14 +2021,14 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
 
     CFreal inDirDotnA = inDirDotnANeg;
     inDirDotnA += InCell*POP_dirDotNA;
-    m_In[iCell] = InCell;
+    f.In[iCell] = InCell;
     const CFreal IcWeight = Ic*m_weight[d];
     const CFuint d3 = d*3;
     
-    qx[iCell]   += m_dirs[d3]*IcWeight;
-    qy[iCell]   += m_dirs[d3+1]*IcWeight;
-    qz[iCell]   += m_dirs[d3+2]*IcWeight;
-    divQ[iCell] += inDirDotnA*m_weight[d];
+    f.qx[iCell]   += m_dirs[d3]*IcWeight;
+    f.qy[iCell]   += m_dirs[d3+1]*IcWeight;
+    f.qz[iCell]   += m_dirs[d3+2]*IcWeight;
+    f.divQ[iCell] += inDirDotnA*m_weight[d];
     // m_II[iCell] += Ic*m_weight[d]; // useless
     
     /*if (iCell==100 && d == 0) {
@@ -1969,11 +2036,11 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
       printf ("inDirDotnA  : %6.6f \n",inDirDotnA);
       printf ("InCell      : %6.6f \n", InCell);
       printf ("cellIDin    : %d  \n", iCell*m_nbDirs+d);
-      const CFreal qxIcell = qx[iCell];
+      const CFreal qxIcell = f.qx[iCell];
       printf ("qx[iCell]   : %6.6f  \n", qxIcell);
-      const CFreal divqIcell = divQ[iCell];
+      const CFreal divqIcell = f.divQ[iCell];
       printf ("divq[iCell] : %6.6f  \n", divqIcell);
-      const CFreal In0 = m_In[iCell];
+      const CFreal In0 = f.In[iCell];
       printf ("In[iCell]   : %6.6f  \n", In0);
       printf ("d3          : %d  \n", d3);
       printf ("mdirs[d3]   : %6.6f  \n", m_dirs[d3]);
@@ -1991,15 +2058,15 @@ void RadiativeTransferFVDOM::computeQExponential(const CFuint ib,
 //////////////////////////////////////////////////////////////////////////////
 
 void RadiativeTransferFVDOM::computeQNoExponential(const CFuint ib, 
-						   const CFuint dStart,
-						   const CFuint d)
+						   const CFuint d,
+						   const CFint *const advanceOrder,
+						   const SweepFields& f)
 {      
   CFLog(VERBOSE, 
 	"RadiativeTransferFVDOM::computeQNoExponential() in (bin, dir) = ("
 	<< ib << ", " << d << ") => start\n");
   
   DataHandle<CFreal> volumes = socket_volumes.getDataHandle();
-  DataHandle<CFreal> divQ = socket_divq.getDataHandle();
   CellTrsGeoBuilder::GeoData& geoData = m_geoBuilder.getDataGE();
   SafePtr<TopologicalRegionSet> cells = geoData.trs;
   const CFuint nbCells = cells->getLocalNbGeoEnts();
@@ -2007,29 +2074,24 @@ void RadiativeTransferFVDOM::computeQNoExponential(const CFuint ib,
   SafePtr<ConnectivityTable<CFuint> > cellFaces = 
     MeshDataStack::getActive()->getConnectivity("cellFaces");
   DataHandle<CFint> isOutward = socket_isOutward.getDataHandle();
-  DataHandle<CFreal> qx = socket_qx.getDataHandle();
-  DataHandle<CFreal> qy = socket_qy.getDataHandle();
-  DataHandle<CFreal> qz = socket_qz.getDataHandle();
   
-  const CFuint startCell = (d-dStart)*nbCells;
   for (CFuint m = 0; m < nbCells; m++) {
     CFreal inDirDotnANeg = 0.;
     CFreal Ic            = 0.;
     CFreal dirDotnAPos   = 0.;
     
     // allocate the cell entity
-    cf_assert(startCell+m < m_advanceOrder.size());
-    const CFuint iCell = std::abs(m_advanceOrder[startCell+m]);
+    const CFuint iCell = std::abs(advanceOrder[m]);
     
     // new algorithm (more parallelizable): opacities are computed cell by cell
     // for a given bin
-    if (!m_oldAlgo) {getFieldOpacities(ib, iCell);} 
+    if (!m_oldAlgo) {getFieldOpacities(ib, iCell, f);} 
     
     const CFuint nbFaces = cellFaces->nbCols(iCell);
     for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
       const CFuint faceID = (*cellFaces)(iCell, iFace);
       const CFreal factor = ((CFuint)(isOutward[faceID]) != iCell) ? -1. : 1.;
-      const CFreal dirDotNA = m_dotProdInFace[faceID]*factor;
+      const CFreal dirDotNA = f.dotProdInFace[faceID]*factor;
       
       if (dirDotNA >= 0.){
 	dirDotnAPos += dirDotNA;
@@ -2038,33 +2100,33 @@ void RadiativeTransferFVDOM::computeQNoExponential(const CFuint ib,
 	const bool isBFace = m_mapGeoToTrs->isBGeo(faceID);
 	if (!isBFace){
 	  const CFuint neighborCellID = getNeighborCellID(faceID, iCell);
-	  inDirDotnANeg += m_In[neighborCellID]*dirDotNA;
+	  inDirDotnANeg += f.In[neighborCellID]*dirDotNA;
 	}
 	else {
-	  const CFreal boundarySource = m_fieldSource[iCell];
+	  const CFreal boundarySource = f.fieldSource[iCell];
 	  inDirDotnANeg += boundarySource*dirDotNA;
 	}
       }
     } 
-    m_In[iCell] = (m_fieldAbSrcV[iCell] - inDirDotnANeg)/(m_fieldAbV[iCell] + dirDotnAPos);
-    Ic = m_In[iCell];
+    f.In[iCell] = (f.fieldAbSrcV[iCell] - inDirDotnANeg)/(f.fieldAbV[iCell] + dirDotnAPos);
+    Ic = f.In[iCell];
     
-    qx[iCell] += Ic*m_dirs[d*3]*m_weight[d];
-    qy[iCell] += Ic*m_dirs[d*3+1]*m_weight[d];
-    qz[iCell] += Ic*m_dirs[d*3+2]*m_weight[d];
+    f.qx[iCell] += Ic*m_dirs[d*3]*m_weight[d];
+    f.qy[iCell] += Ic*m_dirs[d*3+1]*m_weight[d];
+    f.qz[iCell] += Ic*m_dirs[d*3+2]*m_weight[d];
     
     CFreal inDirDotnA = inDirDotnANeg;
     for (CFuint iFace = 0; iFace < nbFaces; ++iFace) {
       const CFuint faceID = (*cellFaces)(iCell, iFace);
       const CFreal factor = ((CFuint)(isOutward[faceID]) != iCell) ? -1. : 1.;
-      const CFreal dirDotNA = m_dotProdInFace[faceID]*factor;
+      const CFreal dirDotNA = f.dotProdInFace[faceID]*factor;
       if (dirDotNA > 0.) {
-	inDirDotnA += m_In[iCell]*dirDotNA;
+	inDirDotnA += f.In[iCell]*dirDotNA;
       }
     }
     
-    divQ[iCell] += inDirDotnA*m_weight[d];
-    m_II[iCell] += Ic*m_weight[d];
+    f.divQ[iCell] += inDirDotnA*m_weight[d];
+    f.II[iCell] += Ic*m_weight[d];
   }  
   
   CFLog(VERBOSE, "RadiativeTransferFVDOM::computeQ() in (bin, dir) = ("
@@ -2072,69 +2134,22 @@ void RadiativeTransferFVDOM::computeQNoExponential(const CFuint ib,
 }
       
 //////////////////////////////////////////////////////////////////////////////
-
-void RadiativeTransferFVDOM::diagnoseProblem(const CFuint d, 
-					     const CFuint m, 
-					     const CFuint mLast)
-{
-  //Check that it wrote a cell in the current stage
-  CFLog(ERROR, "RadiativeTransferFVDOM::diagnoseProblem() => No cell added to advance list in direction [" << d << "].\n");
   
-  const CFreal pi = MathTools::MathConsts::CFrealPi();
-  
-  /// Test to rotate the directions
-  CFreal xAngleRotation = 0.;
-  CFreal yAngleRotation = 0.;
-  CFreal zAngleRotation = 0.;
-  std::cout << "Try rotating in x. Introduce an angle in degrees\n";
-  std::cout << "Theta = \n";
-  std::cin >> xAngleRotation;
-  std::cout << "Try rotating in y. Introduce an angle in degrees\n";
-  std::cout << "Phi = \n";
-  std::cin >> yAngleRotation;
-  std::cout << "Try rotating in z. Introduce an angle in degrees\n";
-  std::cout << "Psi = \n";
-  std::cin >> zAngleRotation;
-  
-  xAngleRotation *= pi/180.;
-  yAngleRotation *= pi/180.;
-  zAngleRotation *= pi/180.;
-  
-  RealMatrix mdirs(m_nbDirs, 3, &m_dirs[0]);
-  
-  for(CFuint dirs = 0; dirs < m_nbDirs; dirs++){
-    //Rotating over x
-    const CFreal rot0 = mdirs(dirs,0);
-    const CFreal rot1 = mdirs(dirs,1)*std::cos(xAngleRotation) - mdirs(dirs,2)*std::sin(xAngleRotation);
-    const CFreal rot2 = mdirs(dirs,1)*std::sin(xAngleRotation) + mdirs(dirs,2)*std::cos(xAngleRotation);
-    //Rotating over y
-    const CFreal rot3 = rot0*std::cos(yAngleRotation) + rot2*std::sin(yAngleRotation);
-    const CFreal rot4 = rot1;
-    const CFreal rot5 = -rot0*std::sin(yAngleRotation) + rot2*std::cos(yAngleRotation);
-    //Rotating over z
-    const CFreal rot6 = rot3*std::cos(zAngleRotation) - rot4*std::sin(zAngleRotation);
-    const CFreal rot7 = rot3*std::sin(zAngleRotation) + rot4*std::cos(zAngleRotation);
-    const CFreal rot8 = rot5;
-    
-    mdirs(dirs,0) = rot6;
-    mdirs(dirs,1) = rot7;
-    mdirs(dirs,2) = rot8;
-    CFLog(VERBOSE, "dirs[" << dirs <<"] = ("<<  mdirs(dirs,0) <<", " << mdirs(dirs,1) <<", "<<mdirs(dirs,2)<<")\n");
-  }
-  CFLog(ERROR, "RadiativeTransferFVDOM::getAdvanceOrder() => No cell added to advance list. Problem with mesh\n");
-  return; // goto directions_loop;
-  cf_assert(m != mLast);
-}
-      
+void RadiativeTransferFVDOM::computeDotProdInFace
+(const CFuint d, LocalArray<CFreal>::TYPE& dotProdInFace)
+{
+  cf_assert(dotProdInFace.size() == socket_normals.getDataHandle().size()/3);
+  computeDotProdInFace(d, &dotProdInFace[0]);
+}      
+
 //////////////////////////////////////////////////////////////////////////////
   
 void RadiativeTransferFVDOM::computeDotProdInFace
-(const CFuint d, LocalArray<CFreal>::TYPE& dotProdInFace)
+(const CFuint d, CFreal *const dotProdInFace)
 {
   const CFuint DIM = 3;
   DataHandle<CFreal> normals = socket_normals.getDataHandle();
   const CFuint totalNbFaces = normals.size()/DIM;
-  cf_assert(dotProdInFace.size() == totalNbFaces);
   
   RadiativeTransferFVDOM::DeviceFunc fun;
   for (CFuint faceID = 0; faceID < totalNbFaces; ++faceID) {
@@ -2191,6 +2206,8 @@ void RadiativeTransferFVDOM::loopOverBins(const CFuint startBin,
 					  const CFuint endDir)
 {
   CFLog(VERBOSE, "RadiativeTransferFVDOM::loopOverBins() => START\n");
+  const CFuint nbCells = socket_states.getDataHandle().size();
+  const SweepFields fields = getSweepFields();
   for(CFuint ib = startBin; ib < endBin; ++ib) {
     CFLog(INFO, "( bin: " << ib << " ), ( dir: ");
     // old algorithm: opacities computed for all cells at once for a given bin
@@ -2214,8 +2231,9 @@ void RadiativeTransferFVDOM::loopOverBins(const CFuint startBin,
       // precompute dot products for all faces and directions (a part from the sign)
       computeDotProdInFace(d, m_dotProdInFace);
       
+      const CFint *const advanceOrder = &m_advanceOrder[(d-dStart)*nbCells];
       (m_useExponentialMethod) ? 
-	computeQExponential(ib,dStart,d) : computeQNoExponential(ib,dStart,d);
+	computeQExponential(ib,d,advanceOrder,fields) : computeQNoExponential(ib,d,advanceOrder,fields);
     }
     CFLog(INFO, ")\n");
   }
@@ -2244,6 +2262,8 @@ void RadiativeTransferFVDOM::loopOverDirs(const CFuint startBin,
 					  const CFuint endDir)
 {
   CFLog(VERBOSE, "RadiativeTransferFVDOM::loopOverDirs() => START\n");
+  const CFuint nbCells = socket_states.getDataHandle().size();
+  const SweepFields fields = getSweepFields();
   for (CFuint d = startDir; d < endDir; ++d) {
     CFLog(INFO, "( dir: " << d << " ), ( bin: ");
     const CFuint bStart = (d != startDir) ? 0 : startBin;
@@ -2256,8 +2276,9 @@ void RadiativeTransferFVDOM::loopOverDirs(const CFuint startBin,
       CFLog(INFO, ib << " ");
       if (m_oldAlgo) {getFieldOpacities(ib);}
       
+      const CFint *const advanceOrder = &m_advanceOrder[(d-startDir)*nbCells];
       (m_useExponentialMethod) ? 
-	computeQExponential(ib,startDir,d) : computeQNoExponential(ib,startDir,d);
+	computeQExponential(ib,d,advanceOrder,fields) : computeQNoExponential(ib,d,advanceOrder,fields);
     }
     CFLog(INFO, ")\n");
   }
@@ -2266,6 +2287,281 @@ void RadiativeTransferFVDOM::loopOverDirs(const CFuint startBin,
     
 //////////////////////////////////////////////////////////////////////////////
 
+RadiativeTransferFVDOM::SweepFields RadiativeTransferFVDOM::getSweepFields()
+{
+  DataHandle<CFreal> divQ = socket_divq.getDataHandle();
+  DataHandle<CFreal> qx = socket_qx.getDataHandle();
+  DataHandle<CFreal> qy = socket_qy.getDataHandle();
+  DataHandle<CFreal> qz = socket_qz.getDataHandle();
+  DataHandle<CFreal> qradFluxWall = socket_qradFluxWall.getDataHandle();
+  DataHandle<CFreal> TempProfile = socket_TempProfile.getDataHandle();
+  
+  SweepFields f;
+  f.In            = &m_In[0];
+  f.fieldSource   = &m_fieldSource[0];
+  f.fieldAbsor    = (m_fieldAbsor.size() > 0)  ? &m_fieldAbsor[0]  : CFNULL;
+  f.fieldAbSrcV   = (m_fieldAbSrcV.size() > 0) ? &m_fieldAbSrcV[0] : CFNULL;
+  f.fieldAbV      = (m_fieldAbV.size() > 0)    ? &m_fieldAbV[0]    : CFNULL;
+  f.dotProdInFace = &m_dotProdInFace[0];
+  f.divQ          = &divQ[0];
+  f.qx            = &qx[0];
+  f.qy            = &qy[0];
+  f.qz            = &qz[0];
+  f.II            = &m_II[0];
+  f.qradFluxWall  = (qradFluxWall.size() > 0) ? &qradFluxWall[0] : CFNULL;
+  f.tempProfile   = &TempProfile[0];
+  return f;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RadiativeTransferFVDOM::loopOverTasks()
+{
+  CFLog(VERBOSE, "RadiativeTransferFVDOM::loopOverTasks() => START\n");
+  
+  const CFuint nbCells = socket_states.getDataHandle().size();
+  const CFuint totalNbFaces = m_dotProdInFace.size();
+  const CFuint nbWallFaces = socket_qradFluxWall.getDataHandle().size();
+  const CFuint nbThreads = ThreadPool::getInstance().getNbThreads();
+  const CFuint nbTasks = m_multiSpectralIdx*m_nbDirs;
+  cf_assert(m_advanceOrder.size() == nbCells*m_nbDirs);
+  
+  // fields of the bin (5 per cell), heat fluxes (5 per cell), dot products and wall heat fluxes
+  m_threadSweepData.resize(nbThreads);
+  for (CFuint t = 0; t < nbThreads; ++t) {
+    m_threadSweepData[t].assign(10*nbCells + totalNbFaces + nbWallFaces, 0.);
+  }
+  
+  // the temperature profile does not depend on the bin: it is stored once here
+  const SweepFields fields = getSweepFields();
+  for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+    getFieldOpacities(0, iCell, fields);
+  }
+  
+  // the threads take the tasks one by one from the queue of the process, which
+  // is refilled by chunks from the counter shared by the processes, without 
+  // synchronizing the threads between the chunks
+  startSweepTasks();
+  m_nbSweepTasks = nbTasks;
+  m_nbSweptTasks = 0;
+  m_sweepTasksFetched = false;
+  m_sweepQueue.clear();
+  SweepTasks sweeps;
+  sweeps.solver = this;
+  for (;;) {
+    {
+      boost::mutex::scoped_lock lock(m_sweepQueueMutex);
+      fillSweepQueue();
+      if (m_sweepQueue.empty()) break;
+    }
+    // one call per thread: if the queue can only be refilled by the main thread
+    // (MPI calls) and it runs dry while this is busy, the other threads stop 
+    // and are restarted here
+    parallelFor(0, nbThreads, sweeps, 1);
+  }
+  const CFuint nbSweptTasks = m_nbSweptTasks;
+  CFLog(VERBOSE, "RadiativeTransferFVDOM::loopOverTasks() => " << nbSweptTasks 
+	<< " tasks out of " << nbTasks << " swept by this process\n");
+  
+  // sum the contributions of the threads
+  DataHandle<CFreal> divQ = socket_divq.getDataHandle();
+  DataHandle<CFreal> qx = socket_qx.getDataHandle();
+  DataHandle<CFreal> qy = socket_qy.getDataHandle();
+  DataHandle<CFreal> qz = socket_qz.getDataHandle();
+  DataHandle<CFreal> qradFluxWall = socket_qradFluxWall.getDataHandle();
+  for (CFuint t = 0; t < nbThreads; ++t) {
+    const CFreal *const data = &m_threadSweepData[t][0];
+    for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
+      divQ[iCell]  += data[5*nbCells + iCell];
+      qx[iCell]    += data[6*nbCells + iCell];
+      qy[iCell]    += data[7*nbCells + iCell];
+      qz[iCell]    += data[8*nbCells + iCell];
+      m_II[iCell]  += data[9*nbCells + iCell];
+    }
+    const CFreal *const wallData = data + 10*nbCells + totalNbFaces;
+    for (CFuint i = 0; i < nbWallFaces; ++i) {
+      qradFluxWall[i] += wallData[i];
+    }
+  }
+  
+  CFLog(VERBOSE, "RadiativeTransferFVDOM::loopOverTasks() => END\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RadiativeTransferFVDOM::sweepTask(const CFuint task, const CFuint threadID)
+{
+  const CFuint ib = (m_loopOverBins) ? task/m_nbDirs : task%m_multiSpectralIdx;
+  const CFuint d  = (m_loopOverBins) ? task%m_nbDirs : task/m_multiSpectralIdx;
+  
+  const CFuint nbCells = m_In.size();
+  const CFuint totalNbFaces = m_dotProdInFace.size();
+  CFreal *const data = &m_threadSweepData[threadID][0];
+  SweepFields f;
+  f.In            = data;
+  f.fieldSource   = data + nbCells;
+  f.fieldAbsor    = data + 2*nbCells;
+  f.fieldAbSrcV   = data + 3*nbCells;
+  f.fieldAbV      = data + 4*nbCells;
+  f.divQ          = data + 5*nbCells;
+  f.qx            = data + 6*nbCells;
+  f.qy            = data + 7*nbCells;
+  f.qz            = data + 8*nbCells;
+  f.II            = data + 9*nbCells;
+  f.dotProdInFace = data + 10*nbCells;
+  f.qradFluxWall  = (socket_qradFluxWall.getDataHandle().size() > 0) ? 
+    data + 10*nbCells + totalNbFaces : CFNULL;
+  f.tempProfile   = CFNULL;
+  
+  computeDotProdInFace(d, f.dotProdInFace);
+  const CFint *const advanceOrder = &m_advanceOrder[d*nbCells];
+  (m_useExponentialMethod) ? 
+    computeQExponential(ib,d,advanceOrder,f) : computeQNoExponential(ib,d,advanceOrder,f);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RadiativeTransferFVDOM::startSweepTasks()
+{
+  m_nextSweepTask = 0;
+  m_sweepTaskStride = 1;
+  
+#ifdef CF_HAVE_MPI
+  const CFuint nbProc = PE::GetPE().GetProcessorCount(m_radNamespace);
+  if (nbProc > 1) {
+    MPI_Comm comm = PE::GetPE().GetCommunicator(m_radNamespace);
+    const CFuint rank = PE::GetPE().GetRank(m_radNamespace);
+#if MPI_VERSION >= 3
+    if (!m_hasSweepTaskWindow) {
+      MPIError::getInstance().check
+	("MPI_Win_create", "RadiativeTransferFVDOM::startSweepTasks()",
+	 MPI_Win_create(&m_sweepTaskCounter, sizeof(CFuint), sizeof(CFuint), 
+			MPI_INFO_NULL, comm, &m_sweepTaskWindow));
+      m_hasSweepTaskWindow = true;
+    }
+    
+    // the counter is reset once all the processes are done with the previous
+    // tasks and is used only once it has been reset
+    MPI_Barrier(comm);
+    if (rank == 0) {
+      MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, m_sweepTaskWindow);
+      m_sweepTaskCounter = 0;
+      MPI_Win_unlock(0, m_sweepTaskWindow);
+    }
+    MPI_Barrier(comm);
+#else
+    // without one-sided communications, the chunks are dealt in turn
+    m_nextSweepTask = rank*2*ThreadPool::getInstance().getNbThreads();
+    m_sweepTaskStride = nbProc;
+#endif
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint RadiativeTransferFVDOM::fetchSweepTasks(const CFuint nbTasks)
+{
+#if defined(CF_HAVE_MPI) && MPI_VERSION >= 3
+  if (m_hasSweepTaskWindow) {
+    CFuint first = 0;
+    MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, m_sweepTaskWindow);
+    MPIError::getInstance().check
+      ("MPI_Fetch_and_op", "RadiativeTransferFVDOM::fetchSweepTasks()",
+       MPI_Fetch_and_op(&nbTasks, &first, MPIStructDef::getMPIType(&first), 
+			0, 0, MPI_SUM, m_sweepTaskWindow));
+    MPI_Win_unlock(0, m_sweepTaskWindow);
+    return first;
+  }
+#endif
+  
+  const CFuint first = m_nextSweepTask;
+  m_nextSweepTask += nbTasks*m_sweepTaskStride;
+  return first;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RadiativeTransferFVDOM::fillSweepQueue()
+{
+  // chunks of two tasks per thread, so that the other threads have work
+  // while the thread refilling the queue sweeps its task
+  const CFuint nbThreads = ThreadPool::getInstance().getNbThreads();
+  if (m_sweepTasksFetched || m_sweepQueue.size() >= nbThreads) return;
+  
+  const CFuint chunkSize = 2*nbThreads;
+  const CFuint first = fetchSweepTasks(chunkSize);
+  const CFuint end = std::min(first + chunkSize, m_nbSweepTasks);
+  for (CFuint t = first; t < end; ++t) {
+    m_sweepQueue.push_back(t);
+  }
+  if (end < first + chunkSize) {
+    m_sweepTasksFetched = true;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool RadiativeTransferFVDOM::nextSweepTask(CFuint& task)
+{
+  boost::mutex::scoped_lock lock(m_sweepQueueMutex);
+  
+  // the shared counter is accessed with MPI, which only the main thread can call
+  bool canFill = true;
+#if defined(CF_HAVE_MPI) && MPI_VERSION >= 3
+  canFill = (!m_hasSweepTaskWindow || ThreadPool::getThreadID() == 0);
+#endif
+  if (canFill) {
+    fillSweepQueue();
+  }
+  
+  if (m_sweepQueue.empty()) return false;
+  task = m_sweepQueue.front();
+  m_sweepQueue.pop_front();
+  ++m_nbSweptTasks;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RadiativeTransferFVDOM::setupWallFaces()
+{
+  const CFuint totalNbFaces = m_isWallFace.size();
+  m_wallFaceIdx.assign(totalNbFaces, -1);
+  m_wallFaceCellID.resize(socket_qradFluxWall.getDataHandle().size());
+  m_wallFaceIbq.assign(m_wallFaceCellID.size(), 0.);
+  
+  for (CFuint faceID = 0; faceID < totalNbFaces; ++faceID) {
+    const CFint idx = getWallFaceID(faceID);
+    m_wallFaceIdx[faceID] = idx;
+    if (idx > -1) {
+      cf_assert(idx < (CFint)m_wallFaceCellID.size());
+      const std::string wallTRSName = m_mapGeoToTrs->getTrs(faceID)->getName();
+      FaceTrsGeoBuilder::GeoData& facesData = m_wallFaceBuilder.getDataGE();
+      facesData.trs = MeshDataStack::getActive()->getTrs(wallTRSName);
+      facesData.idx = idx;
+      const GeometricEntity *const face = m_wallFaceBuilder.buildGE();
+      m_wallFaceCellID[idx] = face->getState(0)->getGlobalID();
+      m_wallFaceBuilder.releaseGE();
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void RadiativeTransferFVDOM::computeWallFaceIbq()
+{
+  const CFuint totalNbFaces = m_wallFaceIdx.size();
+  for (CFuint faceID = 0; faceID < totalNbFaces; ++faceID) {
+    const CFint idx = m_wallFaceIdx[faceID];
+    if (idx > -1) {
+      m_wallFaceIbq[idx] = getFaceIbq(faceID);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void RadiativeTransferFVDOM::writeTGSData()
 {
   // AL: THIS NEEDS TO BE PARALLELIZED. see exampe of reduceHeatFlux(), 
@@ -10,6 +10,13 @@
 #include "Framework/GeometricEntityPool.hh"
 #include "Framework/PhysicalConsts.hh"
 
+#include <deque>
+#include <boost/thread/mutex.hpp>
+
+#ifdef CF_HAVE_MPI
+#include <mpi.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 
 namespace COOLFluiD {
@@ -38,6 +45,27 @@ namespace COOLFluiD {
 class RadiativeTransferFVDOM : public Framework::DataProcessingCom {
 public:
   
+  /// arrays of the radiation fields of a bin and of the heat fluxes to which
+  /// the sweeps contribute: the ones of this object or, with the dynamic
+  /// scheduling, the ones private to a thread
+  struct SweepFields {
+    CFreal* In;
+    CFreal* fieldSource;
+    CFreal* fieldAbsor;
+    CFreal* fieldAbSrcV;
+    CFreal* fieldAbV;
+    CFreal* dotProdInFace;
+    CFreal* divQ;
+    CFreal* qx;
+    CFreal* qy;
+    CFreal* qz;
+    CFreal* II;
+    /// CFNULL if no wall heat flux is computed
+    CFreal* qradFluxWall;
+    /// CFNULL if the temperature profile is not stored
+    CFreal* tempProfile;
+  };
+  
   class DeviceFunc {
   public:
     /// constructor
@@ -106,7 +134,11 @@ public:
   void getDirections();
   
   /**
-   * Compute the advance order depending on the option selected 
+   * Compute the advance order for the given direction by a topological sort
+   * of the cells along the upwind faces (Kahn's algorithm, linear in the 
+   * number of cells and faces)
+   * @param d             direction
+   * @param advanceOrder  cells ordered stage after stage, the last cell of a stage being negative
    */  
   void getAdvanceOrder(const CFuint d, CFint *const advanceOrder); 
   
@@ -118,8 +150,9 @@ public:
     CFLog(VERBOSE, "RadiativeTransferFVDOM::getFieldOpacities() => START\n");
     const CFuint nbCells = socket_states.getDataHandle().size();
     cf_assert(nbCells > 0);
+    const SweepFields fields = getSweepFields();
     for (CFuint iCell = 0; iCell < nbCells; ++iCell) {
-      getFieldOpacities(ib, iCell);
+      getFieldOpacities(ib, iCell, fields);
     }
     CFLog(VERBOSE, "RadiativeTransferFVDOM::getFieldOpacities() => END\n");
   }
@@ -130,9 +163,9 @@ public:
   void getFieldOpacitiesBinning(CFuint ib);
     
   /**
-   * Compute the advance order depending on the option selected 
+   * Compute the opacities of the given bin in the given cell
    */  
-  void getFieldOpacities(const CFuint ib, const CFuint iCell);
+  void getFieldOpacities(const CFuint ib, const CFuint iCell, const SweepFields& f);
   
   /**
    * Reads the binary file containing the opacities as function of the temperature, pressure
@@ -189,26 +222,64 @@ protected: //function
   }
     
   /// compute the radiative heat flux with the exponential method
-  /// @param ib  ID of the bin
-  /// @param d   ID of the direction
-  void computeQExponential(const CFuint ib, const CFuint dStart, const CFuint d);
+  /// @param ib            ID of the bin
+  /// @param d             ID of the direction
+  /// @param advanceOrder  advance order of the direction
+  /// @param f             fields to use and update
+  void computeQExponential(const CFuint ib, const CFuint d, 
+			   const CFint *const advanceOrder, const SweepFields& f);
   
   /// compute the radiative heat flux with the standard method
-  /// @param ib  ID of the bin
-  /// @param d   ID of the direction
-  void computeQNoExponential(const CFuint ib, const CFuint dStart, const CFuint d);
+  /// @param ib            ID of the bin
+  /// @param d             ID of the direction
+  /// @param advanceOrder  advance order of the direction
+  /// @param f             fields to use and update
+  void computeQNoExponential(const CFuint ib, const CFuint d, 
+			     const CFint *const advanceOrder, const SweepFields& f);
+  
+  /// @return the fields of this object
+  SweepFields getSweepFields();
+  
+  /// Compute radiative fluxes by distributing the (bin, direction) sweeps 
+  /// dynamically to the threads of this process and to the processes of
+  /// the radiation namespace
+  void loopOverTasks();
+  
+  /// sweep the cells for the given (bin, direction) task in the given thread
+  void sweepTask(const CFuint task, const CFuint threadID);
+  
+  /// prepare the distribution of the tasks among the processes (collective)
+  void startSweepTasks();
+  
+  /// @return the first of the next nbTasks tasks to be swept by this process
+  CFuint fetchSweepTasks(const CFuint nbTasks);
+  
+  /// refill the queue of the tasks of this process if it holds less than one
+  /// task per thread (it must be protected by m_sweepQueueMutex)
+  void fillSweepQueue();
+  
+  /// take the next task of this process, the queue being refilled by the 
+  /// main thread only if this needs MPI calls
+  /// @return false if no task can be taken by the calling thread
+  bool nextSweepTask(CFuint& task);
+  
+  /// set the wall face ID and the inner cell of each face
+  void setupWallFaces();
+  
+  /// compute the blackbody intensity of each wall face
+  void computeWallFaceIbq();
 
   /// parallel reduce the heat flux
   void reduceHeatFlux();
 
 
-  /// diagnose problem when advance order algorithm fails
-  void diagnoseProblem(const CFuint d, const CFuint m, const CFuint mLast);
-  
   /// compute the dot products direction*normal for each face (sign will be adjusted on-the-fly) 
   void computeDotProdInFace(const CFuint d, 
 			    Framework::LocalArray<CFreal>::TYPE& dotProdInFace);
   
+  /// compute the dot products direction*normal for each face into the given array
+  void computeDotProdInFace(const CFuint d, CFreal *const dotProdInFace);
+  
   /// get the neighbor cell ID to the given face and cell
   CFuint getNeighborCellID(const CFuint faceID, const CFuint cellID) const 
   {
@@ -297,6 +368,19 @@ protected: //function
   /// flag telling whether opacities tables are available
   bool readOpacityTables() const {return (m_binTabName != "");}
   
+  /// This class sweeps a range of (bin, direction) tasks in a thread
+  struct SweepTasks {
+    RadiativeTransferFVDOM* solver;
+    
+    void operator()(const CFuint first, const CFuint end, const CFuint threadID)
+    {
+      CFuint task = 0;
+      while (solver->nextSweepTask(task)) {
+	solver->sweepTask(task, threadID);
+      }
+    }
+  };
+  
 protected: //data
   
   /// storage of states
@@ -418,11 +502,17 @@ protected: //data
   /// storage of the dot products per face
   Framework::LocalArray<CFreal>::TYPE m_dotProdInFace; 
   
-  /// Done status of a cell in a given direction at the end of a stage
-  std::vector<bool> m_sdone;
-    
-  /// temporary list of cell indexes to be processed
-  std::vector<CFuint> m_cdoneIdx;
+  /// number of upwind neighbors of each cell which are not swept yet
+  std::vector<CFuint> m_nbUpwindCells;
+  
+  /// start of the downwind neighbors of each cell in m_downwindCells (nb cells + 1 entries)
+  std::vector<CFuint> m_downwindStart;
+  
+  /// downwind neighbors of all the cells, cell after cell
+  std::vector<CFuint> m_downwindCells;
+  
+  /// temporary list of the cells of the next stage
+  std::vector<CFuint> m_nextStage;
   
   /// names of the TRSs of type "Wall"
   std::vector<std::string> m_wallTrsNames;
@@ -532,6 +622,54 @@ protected: //data
   /// flag telling to run a loop over bins and then over directions (or the opposite)
   bool m_loopOverBins;
   
+  /// flag telling to distribute the (bin, direction) sweeps dynamically
+  bool m_dynamicScheduling;
+  
+  /// wall face ID inside the qradFluxWall socket of each face (-1 if not a wall face)
+  std::vector<CFint> m_wallFaceIdx;
+  
+  /// inner cell of each wall face
+  std::vector<CFuint> m_wallFaceCellID;
+  
+  /// blackbody intensity of each wall face
+  std::vector<CFreal> m_wallFaceIbq;
+  
+  /// fields and heat fluxes private to each thread with the dynamic scheduling
+  std::vector<std::vector<CFreal> > m_threadSweepData;
+  
+  /// next task to be swept by this process if no task counter is shared
+  CFuint m_nextSweepTask;
+  
+  /// stride between the chunks of tasks swept by this process if no task 
+  /// counter is shared
+  CFuint m_sweepTaskStride;
+  
+  /// total number of tasks
+  CFuint m_nbSweepTasks;
+  
+  /// number of tasks swept by this process
+  CFuint m_nbSweptTasks;
+  
+  /// flag telling whether all the tasks have been fetched
+  bool m_sweepTasksFetched;
+  
+  /// tasks fetched by this process and not taken by a thread yet
+  std::deque<CFuint> m_sweepQueue;
+  
+  /// protects the queue of the tasks and the counters above
+  boost::mutex m_sweepQueueMutex;
+  
+#ifdef CF_HAVE_MPI
+  /// counter of the tasks shared by the processes of the radiation namespace
+  CFuint m_sweepTaskCounter;
+  
+  /// window exposing m_sweepTaskCounter on the first process
+  MPI_Win m_sweepTaskWindow;
+  
+  /// flag telling whether m_sweepTaskWindow has been created
+  bool m_hasSweepTaskWindow;
+#endif
+  
   /// flag telling to run without solving anything, just for testing
   bool m_emptyRun;
   
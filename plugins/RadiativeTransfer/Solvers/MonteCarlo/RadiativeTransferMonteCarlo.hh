@@ -3,6 +3,7 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
 #include <numeric>
 #include <boost/random.hpp>
 
@@ -63,6 +64,12 @@ struct PhotonData{
     CFreal KS;
     CFreal energyFraction;
     CFreal wavelength;
+    
+    /// partition independent key of the random stream of the photon:
+    /// emitter, index of the photon and next event (see RandomNumberGenerator::setStream())
+    boost::uint32_t emitterID;
+    boost::uint32_t photonID;
+    boost::uint32_t randomEvent;
 };
 
 typedef LagrangianSolver::Particle<PhotonData> Photon;
@@ -129,6 +136,16 @@ private:
    */
   CFuint rayTracing(Photon& photon);
   
+  /**
+   * ray tracing of the given photons by packets of m_packetWidth photons
+   */
+  void rayTracingPackets(std::vector<Photon>& photons);
+  
+  /**
+   * load the given photon into a lane of the packet
+   */
+  void loadPacketPhoton(const CFuint lane, const Photon& photon);
+  
   /**
    * build vector of radiative heat source along a single radius in the middle of the cilinder
    */
@@ -255,8 +272,40 @@ private:
   
   RandomNumberGenerator m_rand;
 
+  /// seed of the counter-based random streams
+  CFuint m_randomSeed;
+  
+  /// seed of the random streams of the current spectral loop
+  boost::uint32_t m_streamSeed;
+  
+  /// number of executions, to get new random streams at each one
+  CFuint m_nbExecutions;
+  
   CFuint m_sendBufferSize;
 
+  /// flag telling to migrate the photons asynchronously between neighbor partitions
+  bool m_asynchronousMigration;
+  
+  /// number of photons traced together (0 to trace them one by one)
+  CFuint m_packetWidth;
+  
+  /// photons to trace by packets
+  std::vector<Photon> m_packetPhotons;
+  
+  /// packet of photons being traced
+  LagrangianSolver::ParticlePacket m_packet;
+  
+  /// user data of the photons of the packet
+  std::vector<PhotonData> m_packetData;
+  
+  /// number of tracking steps of the photons of the packet
+  std::vector<CFuint> m_packetNbSteps;
+  
+  /// cells, wavelengths and absorption coefficients of the photons of the packet
+  std::vector<CFuint> m_packetCells;
+  std::vector<CFreal> m_packetLambdas;
+  std::vector<CFreal> m_packetAbsorptions;
+
   RealVector m_ghostStateInRadPowers;
   
   CFuint m_dim2;
@@ -301,7 +350,10 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::defineConfigOptions
   options.addConfigOption< string >("PostProcessName","Name of the post process routine");
   options.addConfigOption< CFuint >("sendBufferSize","Size of the buffer for communication");
   options.addConfigOption< CFuint >("nbRaysCycle","Number of rays to emit before communication step");
+  options.addConfigOption< bool >("asynchronousMigration","Migrate the photons to the neighbor partitions with non-blocking communications instead of collective ones.");
+  options.addConfigOption< CFuint >("PacketWidth","Number of photons traced together in 3D (0 to trace them one by one).");
   options.addConfigOption< CFreal >("relaxationFactor","Relaxation Factor");
+  options.addConfigOption< CFuint >("RandomSeed","Seed of the random streams, which are independent from the partitioning.");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -357,8 +409,20 @@ RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::RadiativeTransferMonteCarlo
   m_nbRaysCycle = m_sendBufferSize / 2;
   setParameter("nbRaysCycle", &m_nbRaysCycle);
 
+  m_asynchronousMigration = true;
+  setParameter("asynchronousMigration", &m_asynchronousMigration);
+  
+  m_packetWidth = 0;
+  setParameter("PacketWidth", &m_packetWidth);
+
   m_relaxationFactor = 1.;
   setParameter("relaxationFactor", &m_relaxationFactor);
+  
+  m_randomSeed = 0;
+  setParameter("RandomSeed", &m_randomSeed);
+  
+  m_streamSeed = 0;
+  m_nbExecutions = 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -522,6 +586,23 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::setup()
   //initialize ParticleTracking
   m_lagrangianSolver.setDataSockets(sockets);
   m_lagrangianSolver.setupSendBufferSize(m_sendBufferSize);
+  m_lagrangianSolver.setupAsynchronousMigration(m_asynchronousMigration);
+  
+  if (m_packetWidth > 0) {
+    if (m_lagrangianSolver.hasPacketTracking()) {
+      m_packet.reserve(m_packetWidth);
+      m_packetData.resize(m_packetWidth);
+      m_packetNbSteps.resize(m_packetWidth);
+      m_packetCells.resize(m_packetWidth);
+      m_packetLambdas.resize(m_packetWidth);
+      m_packetAbsorptions.resize(m_packetWidth);
+    }
+    else {
+      CFLog(WARN, "RadiativeTransferMonteCarlo::setup() => PacketWidth is ignored: "
+	    << "the particle tracking cannot trace packets\n");
+      m_packetWidth = 0;
+    }
+  }
 
   //initialize PostProcessign
   m_postProcess->setDataSockets(sockets);
@@ -549,9 +630,10 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::setup()
   MPIStruct Userdatatype;//, particleDatatype;
 
   PhotonData photonData;
-  int counts[3] = {1,1,1};
-  MPIStructDef::buildMPIStruct<CFreal,CFreal,CFreal>
-          (&photonData.KS, &photonData.energyFraction, &photonData.wavelength, counts , Userdatatype);
+  int counts[6] = {1,1,1,1,1,1};
+  MPIStructDef::buildMPIStruct<CFreal,CFreal,CFreal,boost::uint32_t,boost::uint32_t,boost::uint32_t>
+          (&photonData.KS, &photonData.energyFraction, &photonData.wavelength, 
+	   &photonData.emitterID, &photonData.photonID, &photonData.randomEvent, counts , Userdatatype);
 
   m_lagrangianSolver.setupParticleDatatype( Userdatatype.type );
  // particleDatatype.type = m_lagrangianSolver.getParticleDataType();
@@ -601,6 +683,7 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::executeOnTrs()
   
   MonteCarlo();
   computeHeatFlux();
+  ++m_nbExecutions;
   
   CFLog(INFO, "MonteCarlo() took " << s << "s\n");
   
@@ -711,9 +794,19 @@ bool RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::getCellPhotonData(Photon &r
       // Calculate the wavelength
       //cout<<"wavelength= "<<ray.userData.wavelength<<endl;
       
+      static Framework::DataHandle<Framework::State*, Framework::GLOBAL> states
+	= socket_states.getDataHandle();
+      
+      // the random numbers of the photon depend only on its emitter and index
+      ray.userData.emitterID = states[ m_istate_cell_fix ]->getGlobalID();
+      ray.userData.photonID = m_iphoton_cell_fix;
+      ray.userData.randomEvent = 2;
+      
       //Get directions
-      m_radiation->getCellDistPtr( m_istate_cell_fix )->
-	getRadiatorPtr()->getRandomEmission(ray.userData.wavelength, m_direction );
+      Common::SafePtr<Radiator> radiator = m_radiation->getCellDistPtr( m_istate_cell_fix )->getRadiatorPtr();
+      radiator->getRandomGenerator().setStream
+	(m_streamSeed, ray.userData.emitterID, ray.userData.photonID, 0);
+      radiator->getRandomEmission(ray.userData.wavelength, m_direction );
       
       //cout<<"ray directions: ";
       for(CFuint ii=0; ii<m_dim2; ++ii){
@@ -722,13 +815,11 @@ bool RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::getCellPhotonData(Photon &r
       //cout<<endl;
       
       //Get the beam max optical path Ks
+      m_rand.setStream(m_streamSeed, ray.userData.emitterID, ray.userData.photonID, 1);
       ray.userData.KS = - std::log( m_rand.uniformRand() );
       // ray.actualKS = 0;
       //  cout<<"getCellcenter"<<endl;
       //Get cell center
-      static Framework::DataHandle<Framework::State*, Framework::GLOBAL> states
-	= socket_states.getDataHandle();
-      
       Node& baricenter = (*states[ m_istate_cell_fix ]).getCoordinates();
       
       for(CFuint i=0;i<m_dim;++i){
@@ -776,11 +867,28 @@ bool RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::getFacePhotonData(Photon &r
   {
     for( ; m_iphoton_face_fix < m_nbPhotonsGhostState[ m_igState_face_fix  ]; )
     {
+      const CFuint faceGeoID = m_radiation->getCurrentWallGeoID();
+      
+      // the random numbers of the photon depend only on its emitter and index:
+      // the wall faces are identified by their centers
+      DataHandle<CFreal> faceCenters = socket_faceCenters.getDataHandle();
+      boost::uint32_t centerKey = 1;
+      for(CFuint i=0;i<m_dim;++i){
+	const double x = faceCenters[m_dim * faceGeoID + i];
+	boost::uint32_t words[2];
+	std::memcpy(words, &x, sizeof(words));
+	centerKey = RandomNumberGenerator::hashKey(centerKey, words[0], words[1], i);
+      }
+      ray.userData.emitterID = centerKey;
+      ray.userData.photonID = m_iphoton_face_fix | 0x80000000u;
+      ray.userData.randomEvent = 2;
+      
       //Get directions
-      m_radiation->getWallDistPtr( m_igState_face_fix )->
-	getRadiatorPtr()->getRandomEmission(ray.userData.wavelength, m_direction );
+      Common::SafePtr<Radiator> radiator = m_radiation->getWallDistPtr( m_igState_face_fix )->getRadiatorPtr();
+      radiator->getRandomGenerator().setStream
+	(m_streamSeed, ray.userData.emitterID, ray.userData.photonID, 0);
+      radiator->getRandomEmission(ray.userData.wavelength, m_direction );
       
-      const CFuint faceGeoID = m_radiation->getCurrentWallGeoID();
       const CFuint cellID = m_lagrangianSolver.getWallStateId( faceGeoID );
       
       static Framework::DataHandle<Framework::State*, Framework::GLOBAL> states
@@ -796,12 +904,10 @@ bool RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::getFacePhotonData(Photon &r
       //cout<<" ]; "<<endl;
       
       //Get the beam max optical path Ks
+      m_rand.setStream(m_streamSeed, ray.userData.emitterID, ray.userData.photonID, 1);
       ray.userData.KS = - std::log( m_rand.uniformRand() );
       // ray.actualKS = 0;
 
-      //Get the face center
-      DataHandle<CFreal> faceCenters = socket_faceCenters.getDataHandle();
-
       //cout<<"baricenter= [ ";
 
       //cout<<" ]; "<<endl;
@@ -878,7 +984,6 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::computePhotons()
     
   CFLog(DEBUG_MAX, "RadiativeTransferMonteCarlo::computeCellRays()\n");
   
-  m_rand.seed(time(NULL)*(m_myProcessRank+1));
 
 
   // CFuint totalnbPhotons =  (m_nbRaysElem )* m_radiation->getNbStates();
@@ -922,12 +1027,19 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::computePhotons()
     CFuint nbWallPhotons =
         std::min(std::max(CFint(m_nbRaysCycle) - CFint(recvSize) - CFint(nbCellPhotons),(CFint)0), CFint(toGenerateWallPhotons ));
 
+    // with packets, the photons are collected and traced together
+    const bool usePackets = (m_packetWidth > 0);
+    if (usePackets) {
+      m_packetPhotons.clear();
+    }
+    
     for(CFuint i=0; i < nbCellPhotons ; ++i ){
        
       if(getCellPhotonData( photon )){
         //CFLog(INFO,"PHOTON: " << photon.cellID<<' '<<photon.userData.KS<<'\n' );
         //printPhoton(photon);
-        rayTracing(photon);
+        if (usePackets) {m_packetPhotons.push_back(photon);}
+        else {rayTracing(photon);}
       }
       --toGenerateCellPhotons;
       if (m_myProcessRank == 0)  ++*(progressBar);
@@ -936,18 +1048,25 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::computePhotons()
     for(CFuint i=0; i < nbWallPhotons ; ++i ){
       if(getFacePhotonData( photon )){
 	//printPhoton(photon);
-        rayTracing(photon);
+        if (usePackets) {m_packetPhotons.push_back(photon);}
+        else {rayTracing(photon);}
       }
       -- toGenerateWallPhotons;
       if (m_myProcessRank == 0)  ++*(progressBar);
     }
 
 //    CFLog(INFO, "raytrace the outer photons \n");
-    for(CFuint i = 0; i< photonStack.size(); ++i ){
-      //photon=photonStack[i];
-      //CFLog(INFO,"PHOTON: " << photon.cellID<<' '<<photon.userData.KS<<'\n' );
-      //printPhoton(photonStack[i]);
-      rayTracing( photonStack[i] );
+    if (usePackets) {
+      m_packetPhotons.insert(m_packetPhotons.end(), photonStack.begin(), photonStack.end());
+      rayTracingPackets(m_packetPhotons);
+    }
+    else {
+      for(CFuint i = 0; i< photonStack.size(); ++i ){
+	//photon=photonStack[i];
+	//CFLog(INFO,"PHOTON: " << photon.cellID<<' '<<photon.userData.KS<<'\n' );
+	//printPhoton(photonStack[i]);
+	rayTracing( photonStack[i] );
+      }
     }
 
     //sincronize
@@ -1009,6 +1128,8 @@ void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::MonteCarlo()
   m_iphoton_face_fix=0, m_igState_face_fix=0;
  
   for(CFuint i=0; i< nbLoops; ++i){
+    // new random streams for each execution and spectral loop, equal on all the processes
+    m_streamSeed = RandomNumberGenerator::hashKey(m_randomSeed, m_nbExecutions, i, 0);
     m_radiation->setupWavStride(i);
     getTotalEnergy();
     
@@ -1114,6 +1235,7 @@ CFuint RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::rayTracing(Photon& beam)
 	
         m_lagrangianSolver.getNormals(exitFaceID, m_position, m_normal);
 	
+        m_rand.setStream(m_streamSeed, beamData.emitterID, beamData.photonID, beamData.randomEvent);
         const CFreal reflectionProbability =  m_rand.uniformRand();
 	CFLog(DEBUG_MIN, "reflectionProbability[" << reflectionProbability << "] <= wallK[" 
 	      << wallK << "]\n");
@@ -1129,8 +1251,12 @@ CFuint RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::rayTracing(Photon& beam)
           return exitFaceID;
         }
         else {
-	  m_radiation->getWallDistPtr(ghostStateID)->getReflectorPtr()->getRandomDirection
+	  Common::SafePtr<Reflector> reflector = m_radiation->getWallDistPtr(ghostStateID)->getReflectorPtr();
+	  reflector->getRandomGenerator().setStream
+	    (m_streamSeed, beamData.emitterID, beamData.photonID, beamData.randomEvent + 1);
+	  reflector->getRandomDirection
 	    (beamData.wavelength, m_exitDirection, m_entryDirection, m_normal);
+	  beamData.randomEvent += 2;
           m_lagrangianSolver.newDirection( m_exitDirection );
 	  
           CFLog(DEBUG_MED, "Particle reflected with Entry Direction[" << m_entryDirection 
@@ -1165,6 +1291,148 @@ CFuint RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::rayTracing(Photon& beam)
 
 /////////////////////////////////////////////////////////////////////////////
 
+template<class PARTICLE_TRACKING>
+void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::loadPacketPhoton
+(const CFuint lane, const Photon& photon)
+{
+  LagrangianSolver::ParticlePacket& packet = m_packet;
+  for (CFuint d = 0; d < 3; ++d) {
+    packet.point[d][lane] = photon.commonData.currentPoint[d];
+    packet.direction[d][lane] = photon.commonData.direction[d];
+  }
+  packet.cellID[lane] = photon.commonData.cellID;
+  m_packetData[lane] = photon.userData;
+  m_packetNbSteps[lane] = 0;
+}
+  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class PARTICLE_TRACKING>
+void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::rayTracingPackets
+(std::vector<Photon>& photons)
+{
+  using namespace std;
+  using namespace COOLFluiD::Framework;
+  using namespace COOLFluiD::Common;
+  using namespace COOLFluiD::LagrangianSolver;
+  
+  CFLog(DEBUG_MED, "RadiativeTransferMonteCarlo::rayTracingPackets() => START\n");
+  
+  // the photons follow the same steps as in rayTracing(), but each tracking
+  // step and each query of the absorption coefficients is done for the whole
+  // packet; the packet is refilled as soon as photons leave it
+  ParticlePacket& packet = m_packet;
+  const CFuint nbPhotons = photons.size();
+  CFuint nextPhoton = 0;
+  packet.size = 0;
+  
+  while (true) {
+    while (packet.size < m_packetWidth && nextPhoton < nbPhotons) {
+      loadPacketPhoton(packet.size, photons[nextPhoton]);
+      ++packet.size;
+      ++nextPhoton;
+    }
+    if (packet.size == 0) break;
+    
+    m_lagrangianSolver.trackingStepPacket(packet);
+    
+    const CFuint n = packet.size;
+    for (CFuint i = 0; i < n; ++i) {
+      m_packetCells[i] = packet.cellID[i];
+      m_packetLambdas[i] = m_packetData[i].wavelength;
+    }
+    m_radiation->getCellAbsorptions(n, &m_packetCells[0], &m_packetLambdas[0], &m_packetAbsorptions[0]);
+    
+    // lanes are removed by moving the last one in their place
+    for (CFuint i = 0; i < packet.size;) {
+      PhotonData& beamData = m_packetData[i];
+      const CFint exitFaceID = packet.exitFaceID[i];
+      bool isDone = (exitFaceID < 0);
+      ++m_packetNbSteps[i];
+      
+      if (!isDone) {
+	const CFuint currentCellID = packet.cellID[i];
+	beamData.KS -= packet.stepDist[i]*m_packetAbsorptions[i];
+	
+	if (beamData.KS <= 0.) { // photon absorbed by a cell
+	  cf_assert(currentCellID < m_stateInRadPowers.size());
+	  m_stateInRadPowers[currentCellID] += beamData.energyFraction;
+	  isDone = true;
+	}
+	else {
+	  const CFuint faceType = m_lagrangianSolver.getFaceType(exitFaceID);
+	  
+	  if (faceType == ParticleTracking::WALL_FACE) {
+	    for (CFuint d = 0; d < 3; ++d) {
+	      m_entryDirection[d] = packet.direction[d][i];
+	      m_position[d] = packet.point[d][i];
+	    }
+	    const CFuint ghostStateID = m_lagrangianSolver.getWallGhotsStateId(exitFaceID);
+	    const CFreal wallK = m_radiation->getWallDistPtr(ghostStateID)
+	      ->getRadiatorPtr()->getAbsorption( beamData.wavelength, m_entryDirection );
+	    m_lagrangianSolver.getNormals(exitFaceID, m_position, m_normal);
+	    
+	    m_rand.setStream(m_streamSeed, beamData.emitterID, beamData.photonID, beamData.randomEvent);
+	    const CFreal reflectionProbability = m_rand.uniformRand();
+	    if (reflectionProbability <= wallK) { // the photon is absorbed by the wall
+	      m_ghostStateInRadPowers[ghostStateID] += beamData.energyFraction;
+	      isDone = true;
+	    }
+	    else {
+	      SafePtr<Reflector> reflector = m_radiation->getWallDistPtr(ghostStateID)->getReflectorPtr();
+	      reflector->getRandomGenerator().setStream
+		(m_streamSeed, beamData.emitterID, beamData.photonID, beamData.randomEvent + 1);
+	      reflector->getRandomDirection
+		(beamData.wavelength, m_exitDirection, m_entryDirection, m_normal);
+	      beamData.randomEvent += 2;
+	      for (CFuint d = 0; d < 3; ++d) {
+		packet.direction[d][i] = m_exitDirection[d];
+	      }
+	    }
+	  }
+	  else if (faceType == ParticleTracking::BOUNDARY_FACE) {
+	    isDone = true;
+	  }
+	  else if (faceType == ParticleTracking::COMP_DOMAIN_FACE) {
+	    Photon photon;
+	    for (CFuint d = 0; d < 3; ++d) {
+	      photon.commonData.currentPoint[d] = packet.point[d][i];
+	      photon.commonData.direction[d] = packet.direction[d][i];
+	    }
+	    photon.userData = beamData;
+	    m_lagrangianSolver.bufferCommitParticle(exitFaceID, photon);
+	    isDone = true;
+	  }
+	}
+	
+	if (!isDone && m_packetNbSteps[i] > m_maxVisitedCells) {
+	  CFLog(INFO, "RadiativeTransferMonteCarlo::rayTracingPackets() => Max number of steps reached! \n");
+	  isDone = true;
+	}
+	packet.cellID[i] = packet.exitCellID[i];
+      }
+      
+      if (isDone) {
+	const CFuint last = packet.size-1;
+	if (i < last) {
+	  packet.copy(i, last);
+	  m_packetData[i] = m_packetData[last];
+	  m_packetNbSteps[i] = m_packetNbSteps[last];
+	  m_packetAbsorptions[i] = m_packetAbsorptions[last];
+	}
+	--packet.size;
+      }
+      else {
+	++i;
+      }
+    }
+  }
+  
+  CFLog(DEBUG_MED, "RadiativeTransferMonteCarlo::rayTracingPackets() => END\n");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 template<class PARTICLE_TRACKING>
 void RadiativeTransferMonteCarlo<PARTICLE_TRACKING>::computeHeatFlux()
 {
@@ -6,15 +6,90 @@ namespace COOLFluiD {
 namespace RadiativeTransfer {
   using namespace std;
 
+  RandomNumberGenerator::RandomNumberGenerator() :
+    m_generator(),
+    m_useStream(false),
+    m_blockPos(4)
+  {
+    m_key[0] = m_key[1] = 0;
+    m_counter[0] = m_counter[1] = m_counter[2] = m_counter[3] = 0;
+    m_block[0] = m_block[1] = m_block[2] = m_block[3] = 0;
+  }
+
   CFreal RandomNumberGenerator::uniformRand(const CFreal i0, const CFreal i1){
-    boost::uniform_real<CFreal> uniformDist(i0,i1);
-    boost::variate_generator<typeGenerator&, boost::uniform_real<CFreal> >
-             uniform(m_generator, uniformDist);
-    return uniform();
+    return i0 + (i1 - i0)*nextUnit();
   }
 
   void RandomNumberGenerator::seed(CFuint seedNumber){
     m_generator.seed(seedNumber);
+    m_useStream = false;
+  }
+
+  void RandomNumberGenerator::setStream(boost::uint32_t seedNumber, boost::uint32_t emitterID,
+					boost::uint32_t photonID, boost::uint32_t event){
+    m_useStream = true;
+    m_key[0] = emitterID;
+    m_key[1] = seedNumber;
+    m_counter[0] = photonID;
+    m_counter[1] = event;
+    m_counter[2] = 0;
+    m_counter[3] = 0;
+    m_blockPos = 4;
+  }
+
+  CFreal RandomNumberGenerator::nextUnit(){
+    boost::uint32_t a = 0;
+    boost::uint32_t b = 0;
+    if (m_useStream) {
+      // each block of the stream gives two numbers
+      if (m_blockPos == 4) {
+	philox(m_key, m_counter, m_block);
+	++m_counter[2];
+	m_blockPos = 0;
+      }
+      a = m_block[m_blockPos];
+      b = m_block[m_blockPos+1];
+      m_blockPos += 2;
+    }
+    else {
+      a = m_generator();
+      b = m_generator();
+    }
+    // 53 random bits, shifted by half an ulp to exclude 0 and 1
+    return ((a >> 5)*67108864. + (b >> 6) + 0.5)*(1./9007199254740992.);
+  }
+
+  void RandomNumberGenerator::philox(const boost::uint32_t key[2], const boost::uint32_t counter[4],
+				     boost::uint32_t out[4]){
+    const boost::uint64_t M0 = 0xD2511F53u;
+    const boost::uint64_t M1 = 0xCD9E8D57u;
+    const boost::uint32_t W0 = 0x9E3779B9u;
+    const boost::uint32_t W1 = 0xBB67AE85u;
+
+    boost::uint32_t k0 = key[0];
+    boost::uint32_t k1 = key[1];
+    out[0] = counter[0]; out[1] = counter[1]; out[2] = counter[2]; out[3] = counter[3];
+    for (CFuint r = 0; r < 10; ++r) {
+      const boost::uint64_t p0 = M0*out[0];
+      const boost::uint64_t p1 = M1*out[2];
+      const boost::uint32_t x0 = static_cast<boost::uint32_t>(p1 >> 32) ^ out[1] ^ k0;
+      const boost::uint32_t x2 = static_cast<boost::uint32_t>(p0 >> 32) ^ out[3] ^ k1;
+      out[0] = x0;
+      out[1] = static_cast<boost::uint32_t>(p1);
+      out[2] = x2;
+      out[3] = static_cast<boost::uint32_t>(p0);
+      k0 += W0;
+      k1 += W1;
+    }
+  }
+
+  boost::uint32_t RandomNumberGenerator::hashKey(boost::uint32_t w0, boost::uint32_t w1,
+						 boost::uint32_t w2, boost::uint32_t w3){
+    const boost::uint32_t key[2] = {0x243F6A88u, 0x85A308D3u};
+    const boost::uint32_t counter[4] = {w0, w1, w2, w3};
+    boost::uint32_t out[4];
+    philox(key, counter, out);
+    return out[0];
   }
 }
 }
@@ -3,7 +3,10 @@
 
 #include "MathTools/MathFunctions.hh"
 #include <boost/random.hpp>
+#include <boost/cstdint.hpp>
 #include "Common/COOLFluiD.hh"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 /*  Wrapper class for the Boost Random library
@@ -21,34 +24,100 @@ class RandomNumberGenerator{
 
 public:
 
+  RandomNumberGenerator();
+
+  /// sample a direction uniformly on the unit sphere (dim = 2 or 3) into
+  /// the caller's storage
   template<typename Tout>
   void sphereDirections(CFuint dim, Tout &directions);
 
   template<typename Tin, typename Tout>
-  void hemiDirections(CFuint dim , Tin faceNormals, Tout &directions);
+  void hemiDirections(CFuint dim , const Tin& faceNormals, Tout &directions);
 
   CFreal uniformRand(const CFreal i0=0., const CFreal i1=1.);
 
+  /// seed the Mersenne Twister and leave the counter-based mode
   void seed(CFuint seedNumber);
 
+  /**
+   * Switch to the counter-based mode (Philox4x32-10): the numbers drawn
+   * until the next call are a pure function of the arguments, whatever the
+   * process or the thread drawing them, so that a photon gets the same
+   * numbers for any partitioning
+   * @param seedNumber  seed of the simulation
+   * @param emitterID   partition independent ID of the emitter (e.g. global cell ID)
+   * @param photonID    index of the photon emitted by the emitter
+   * @param event       index of the event in the life of the photon
+   */
+  void setStream(boost::uint32_t seedNumber, boost::uint32_t emitterID,
+		 boost::uint32_t photonID, boost::uint32_t event);
+
+  /// hash the given words into a 32 bits key with the Philox rounds
+  static boost::uint32_t hashKey(boost::uint32_t w0, boost::uint32_t w1,
+				 boost::uint32_t w2, boost::uint32_t w3);
+
+private:
+
+  /// @return a number uniformly distributed in ]0,1[
+  CFreal nextUnit();
+
+  /// apply the 10 rounds of Philox4x32 to the counter with the given key
+  static void philox(const boost::uint32_t key[2], const boost::uint32_t counter[4],
+		     boost::uint32_t out[4]);
+
 private:
 
   typeGenerator m_generator;
+
+  /// flag telling if the counter-based mode is active
+  bool m_useStream;
+
+  /// key of the counter-based mode
+  boost::uint32_t m_key[2];
+
+  /// counter of the counter-based mode (photon, event, block, 0)
+  boost::uint32_t m_counter[4];
+
+  /// output of the last block
+  boost::uint32_t m_block[4];
+
+  /// number of words of m_block already used
+  CFuint m_blockPos;
 };
 
 template<class Tout>
 void RandomNumberGenerator::sphereDirections(CFuint dim, Tout &directions){
-  boost::uniform_on_sphere<CFreal, std::vector<CFreal> > uniformOnSphere(dim);
-  boost::variate_generator<typeGenerator&, boost::uniform_on_sphere<CFreal , std::vector<CFreal> > >
-       randSphere(m_generator, uniformOnSphere);
-  std::vector<CFreal> temp=randSphere();
-  for (CFuint i=0; i<dim;++i){
-    directions[i]=temp[i];
+  static const CFreal twoPi = 6.283185307179586;
+  if (dim == 3) {
+    const CFreal z = 2.*nextUnit() - 1.;
+    const CFreal phi = twoPi*nextUnit();
+    const CFreal r = std::sqrt(std::max(0., 1. - z*z));
+    directions[0] = r*std::cos(phi);
+    directions[1] = r*std::sin(phi);
+    directions[2] = z;
+    return;
+  }
+
+  // Box-Muller normals projected on the sphere
+  CFreal norm2 = 0.;
+  for (CFuint i = 0; i < dim; i += 2) {
+    const CFreal r = std::sqrt(-2.*std::log(nextUnit()));
+    const CFreal phi = twoPi*nextUnit();
+    directions[i] = r*std::cos(phi);
+    norm2 += directions[i]*directions[i];
+    if (i+1 < dim) {
+      directions[i+1] = r*std::sin(phi);
+      norm2 += directions[i+1]*directions[i+1];
+    }
+  }
+  const CFreal invNorm = 1./std::sqrt(norm2);
+  for (CFuint i = 0; i < dim; ++i) {
+    directions[i] *= invNorm;
   }
 }
 
 template<typename Tin, typename Tout>
-void RandomNumberGenerator::hemiDirections(CFuint dim , Tin faceNormals, Tout &directions){
+void RandomNumberGenerator::hemiDirections(CFuint dim , const Tin& faceNormals, Tout &directions){
   //generate spherical directions;
   sphereDirections(dim, directions);
   //if the direction is in the wrong half of the sphere
@@ -101,6 +101,14 @@ public: // classes
   virtual void computePhysicalData(const Framework::State& state,
 				   RealVector& data);
   
+  /**
+   * Set the PhysicalData corresponding to the first nbStates given States
+   * @see ConvectiveVarSet
+   */
+  virtual void computeBlockPhysicalData(const std::vector<Framework::State*>& states,
+  					std::vector<RealVector>& pdata,
+  					const CFuint nbStates);
+  
   /**
    * Set a State starting from the given PhysicalData
    * @see EulerPhysicalModel
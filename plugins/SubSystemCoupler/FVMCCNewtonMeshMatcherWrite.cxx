@@ -175,7 +175,7 @@ void FVMCCNewtonMeshMatcherWrite::executeWrite(const CFuint iProc)
       interfaceData.resize(otherNbStates - rejectedStates);
 
       ///Write the file with the info isAccepted
-      writeIsAcceptedFile(socketAcceptNames[iType]);
+      if(getMethodData().isTransferFiles()) writeIsAcceptedFile(socketAcceptNames[iType]);
     } //end of loop over data transfer coord type
   } // end loop over the OtherTRS
 }
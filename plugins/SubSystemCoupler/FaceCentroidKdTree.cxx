@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SubSystemCoupler/FaceCentroidKdTree.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace SubSystemCoupler {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Comparison of two faces along one direction
+struct CentroidLess {
+  CentroidLess(const vector<CFreal>& centroids, const CFuint dim, const CFuint d) :
+    m_centroids(centroids), m_dim(dim), m_d(d) {}
+
+  bool operator() (const CFuint a, const CFuint b) const
+  {
+    return m_centroids[a*m_dim + m_d] < m_centroids[b*m_dim + m_d];
+  }
+
+  const vector<CFreal>& m_centroids;
+  const CFuint m_dim;
+  const CFuint m_d;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+FaceCentroidKdTree::FaceCentroidKdTree() :
+  m_dim(0),
+  m_centroids(),
+  m_index(),
+  m_splitDim(),
+  m_maxRadius(0.)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+FaceCentroidKdTree::~FaceCentroidKdTree()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FaceCentroidKdTree::build(const vector<CFreal>& centroids,
+			       const vector<CFreal>& radii,
+			       const CFuint dim)
+{
+  cf_assert(dim > 0);
+  cf_assert(centroids.size() == radii.size()*dim);
+
+  m_dim = dim;
+  m_centroids = centroids;
+  const CFuint nbFaces = radii.size();
+  m_index.resize(nbFaces);
+  m_splitDim.assign(nbFaces, 0);
+  m_maxRadius = 0.;
+  for (CFuint i = 0; i < nbFaces; ++i) {
+    m_index[i] = i;
+    m_maxRadius = std::max(m_maxRadius, radii[i]);
+  }
+
+  buildNode(0, nbFaces);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FaceCentroidKdTree::buildNode(const CFuint begin, const CFuint end)
+{
+  if (end - begin < 2) return;
+
+  // split along the direction of largest extent
+  CFuint splitDim = 0;
+  CFreal maxExtent = -1.;
+  for (CFuint d = 0; d < m_dim; ++d) {
+    CFreal cmin = m_centroids[m_index[begin]*m_dim + d];
+    CFreal cmax = cmin;
+    for (CFuint i = begin + 1; i < end; ++i) {
+      const CFreal c = m_centroids[m_index[i]*m_dim + d];
+      cmin = std::min(cmin, c);
+      cmax = std::max(cmax, c);
+    }
+    if (cmax - cmin > maxExtent) {
+      maxExtent = cmax - cmin;
+      splitDim = d;
+    }
+  }
+
+  const CFuint mid = (begin + end)/2;
+  std::nth_element(m_index.begin() + begin, m_index.begin() + mid, m_index.begin() + end,
+		   CentroidLess(m_centroids, m_dim, splitDim));
+  m_splitDim[mid] = splitDim;
+
+  buildNode(begin, mid);
+  buildNode(mid + 1, end);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FaceCentroidKdTree::findCandidates(const RealVector& coord, vector<CFuint>& faces) const
+{
+  cf_assert(coord.size() == m_dim);
+  cf_assert(m_dim <= 3);
+
+  faces.clear();
+  if (m_index.empty()) return;
+
+  CFreal x[3];
+  for (CFuint d = 0; d < m_dim; ++d) {
+    x[d] = coord[d];
+  }
+  CFreal minDist2 = distance2(x, m_index[m_index.size()/2]);
+  findNearest(x, 0, m_index.size(), minDist2);
+
+  const CFreal radius = std::sqrt(minDist2) + 2.*m_maxRadius;
+  // the radius is slightly enlarged against the round-off errors
+  findInRadius(x, radius*radius*(1. + 1e-10) + 1e-300, 0, m_index.size(), faces);
+
+  // keep the order of the exhaustive search
+  std::sort(faces.begin(), faces.end());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FaceCentroidKdTree::findNearest(const CFreal* x, const CFuint begin, const CFuint end,
+				     CFreal& minDist2) const
+{
+  if (begin >= end) return;
+
+  const CFuint mid = (begin + end)/2;
+  const CFuint iFace = m_index[mid];
+  minDist2 = std::min(minDist2, distance2(x, iFace));
+  if (end - begin == 1) return;
+
+  const CFuint d = m_splitDim[mid];
+  const CFreal diff = x[d] - m_centroids[iFace*m_dim + d];
+  if (diff < 0.) {
+    findNearest(x, begin, mid, minDist2);
+    if (diff*diff < minDist2) findNearest(x, mid + 1, end, minDist2);
+  }
+  else {
+    findNearest(x, mid + 1, end, minDist2);
+    if (diff*diff < minDist2) findNearest(x, begin, mid, minDist2);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FaceCentroidKdTree::findInRadius(const CFreal* x, const CFreal r2,
+				      const CFuint begin, const CFuint end,
+				      vector<CFuint>& faces) const
+{
+  if (begin >= end) return;
+
+  const CFuint mid = (begin + end)/2;
+  const CFuint iFace = m_index[mid];
+  if (distance2(x, iFace) <= r2) faces.push_back(iFace);
+  if (end - begin == 1) return;
+
+  const CFuint d = m_splitDim[mid];
+  const CFreal diff = x[d] - m_centroids[iFace*m_dim + d];
+  if (diff < 0. || diff*diff <= r2) findInRadius(x, r2, begin, mid, faces);
+  if (diff >= 0. || diff*diff <= r2) findInRadius(x, r2, mid + 1, end, faces);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace SubSystemCoupler
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
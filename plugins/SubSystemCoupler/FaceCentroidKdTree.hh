@@ -0,0 +1,129 @@
+#ifndef COOLFluiD_Numerics_SubSystemCoupler_FaceCentroidKdTree_hh
+#define COOLFluiD_Numerics_SubSystemCoupler_FaceCentroidKdTree_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Common/COOLFluiD.hh"
+#include "MathTools/RealVector.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Numerics {
+
+    namespace SubSystemCoupler {
+
+//////////////////////////////////////////////////////////////////////////////
+
+  /**
+   * This class is a static k-d tree over the centroids of the faces of an
+   * interface, used by the mesh matchers to restrict the projection of a
+   * point to the faces close to it instead of looping over all the faces.
+   *
+   * The candidates of a point are the faces whose centroid lies within
+   * the distance to the nearest centroid plus twice the largest face
+   * radius (distance between a centroid and the nodes of its face): this
+   * includes all the faces which can be closer to the point than the face
+   * of the nearest centroid, as well as the faces owning the closest node.
+   */
+class FaceCentroidKdTree {
+public:
+
+  /**
+   * Constructor
+   */
+  FaceCentroidKdTree();
+
+  /**
+   * Default destructor
+   */
+  ~FaceCentroidKdTree();
+
+  /**
+   * Build the tree
+   * @param centroids  coordinates of the face centroids (dim per face)
+   * @param radii      largest distance between each centroid and the nodes of its face
+   * @param dim        space dimension
+   */
+  void build(const std::vector<CFreal>& centroids,
+	     const std::vector<CFreal>& radii,
+	     const CFuint dim);
+
+  /**
+   * Find the faces which can be the closest to the given point
+   * @param coord  coordinates of the point
+   * @param faces  indices of the candidate faces, in increasing order
+   */
+  void findCandidates(const RealVector& coord, std::vector<CFuint>& faces) const;
+
+  /**
+   * @return the number of faces in the tree
+   */
+  CFuint getNbFaces() const {return m_index.size();}
+
+private: // functions
+
+  /**
+   * Recursively build the subtree of the given range of m_index
+   */
+  void buildNode(const CFuint begin, const CFuint end);
+
+  /**
+   * Recursively find the squared distance to the nearest centroid
+   */
+  void findNearest(const CFreal* x, const CFuint begin, const CFuint end,
+		   CFreal& minDist2) const;
+
+  /**
+   * Recursively collect the faces whose centroid is within sqrt(r2)
+   */
+  void findInRadius(const CFreal* x, const CFreal r2,
+		    const CFuint begin, const CFuint end,
+		    std::vector<CFuint>& faces) const;
+
+  /**
+   * @return the squared distance between the point and a centroid
+   */
+  CFreal distance2(const CFreal* x, const CFuint iFace) const
+  {
+    const CFreal* c = &m_centroids[iFace*m_dim];
+    CFreal d2 = 0.;
+    for (CFuint d = 0; d < m_dim; ++d) {
+      d2 += (x[d] - c[d])*(x[d] - c[d]);
+    }
+    return d2;
+  }
+
+private: // data
+
+  /// space dimension
+  CFuint m_dim;
+
+  /// coordinates of the centroids
+  std::vector<CFreal> m_centroids;
+
+  /// faces ordered as an implicit balanced tree (the root of a range is its middle)
+  std::vector<CFuint> m_index;
+
+  /// splitting direction of each node of the implicit tree
+  std::vector<CFuint> m_splitDim;
+
+  /// largest face radius
+  CFreal m_maxRadius;
+
+}; // end of class FaceCentroidKdTree
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace SubSystemCoupler
+
+  } // namespace Numerics
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Numerics_SubSystemCoupler_FaceCentroidKdTree_hh
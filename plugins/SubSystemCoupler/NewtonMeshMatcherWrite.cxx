@@ -228,7 +228,7 @@ void NewtonMeshMatcherWrite::executeWrite(const CFuint iProc)
       interfaceData.resize(otherNbStates - rejectedStates);
 
       //Write the file with the info isAccepted
-      writeIsAcceptedFile(socketAcceptNames[iType]);
+      if(getMethodData().isTransferFiles()) writeIsAcceptedFile(socketAcceptNames[iType]);
     } //end of loop over data transfer coord type
   } // end loop over the OtherTRS
   if(_shiftStates) unshiftStatesCoord();
@@ -1,6 +1,9 @@
 
 
 #include "Common/FilesystemException.hh"
+#include "Common/NotImplementedException.hh"
+#include "Common/MPI/MPIError.hh"
+#include "Common/MPI/MPIStructDef.hh"
 #include "Environment/SingleBehaviorFactory.hh"
 #include "Environment/FileHandlerInput.hh"
 #include "Environment/FileHandlerOutput.hh"
@@ -10,6 +13,7 @@
 #include "Environment/DirPaths.hh"
 #include "Framework/MeshData.hh"
 #include "Framework/CommandGroup.hh"
+#include "Framework/NamespaceSwitcher.hh"
 #include "SubSystemCoupler/StdMeshMatcherRead.hh"
 #include "SubSystemCoupler/SubSystemCoupler.hh"
 
@@ -36,7 +40,9 @@ MethodCommandProvider<StdMeshMatcherRead, SubSysCouplerData, SubSystemCouplerMod
 
 StdMeshMatcherRead::StdMeshMatcherRead(const std::string& name) :
   CouplerCom(name),
-  _sockets()
+  _sockets(),
+  _recvBuffers(),
+  _recvDispls()
 {
 }
 
@@ -127,6 +133,10 @@ void StdMeshMatcherRead::execute()
 
   CFAUTOTRACE;
   const std::string nsp = getMethodData().getNamespace();
+  if (!getMethodData().isTransferFiles() && Common::PE::GetPE().IsParallel()) {
+    exchangeIsAccepted();
+  }
+  
   //Here no need for barrier because each processor reads different files
   for (_iProc = 0; _iProc < Common::PE::GetPE().GetProcessorCount(nsp); ++_iProc) {
     executeRead();
@@ -158,7 +168,13 @@ void StdMeshMatcherRead::executeRead()
 
     for(CFuint iType=0;iType< localAcceptedSocketNames.size();iType++)
     {
-      readIsAcceptedFile(parAcceptedSocketNames[iType]);
+      if(getMethodData().isTransferFiles())
+      {
+        readIsAcceptedFile(parAcceptedSocketNames[iType]);
+      }
+      else {
+        readIsAcceptedFromMemory(localAcceptedSocketNames[iType]);
+      }
       assembleIsAcceptedFiles(localAcceptedSocketNames[iType]);
     }
   }
@@ -274,6 +290,115 @@ void StdMeshMatcherRead::readIsAcceptedFile(const std::string dataHandleName)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void StdMeshMatcherRead::exchangeIsAccepted()
+{
+  CFAUTOTRACE;
+
+  const std::string interfaceName = getCommandGroupName();
+  const std::string nsp = getMethodData().getNamespace();
+  const std::string otherNamespace = getMethodData().getCoupledNameSpaceName(interfaceName);
+  const CFuint nbProcs = PE::GetPE().GetProcessorCount(nsp);
+  if (PE::GetPE().GetProcessorCount(otherNamespace) != nbProcs) {
+    throw NotImplementedException
+      (FromHere(), "StdMeshMatcherRead::exchangeIsAccepted() => the namespaces [" + nsp + "] and [" +
+       otherNamespace + "] must share the processors to match the meshes without files");
+  }
+  const CFuint myRank = PE::GetPE().GetRank(nsp);
+  MPI_Comm comm = PE::GetPE().GetCommunicator(nsp);
+
+  Common::SafePtr<Namespace> otherNsp = NamespaceSwitcher::getInstance
+    (SubSystemStatusStack::getCurrentName()).getNamespace(otherNamespace);
+  Common::SafePtr<DataStorage> otherDataStorage =
+    MeshDataStack::getInstance().getEntryByNamespace(otherNsp)->getDataStorage();
+
+  vector<int> sendcounts(nbProcs, 0);
+  vector<int> sdispls(nbProcs, 0);
+  vector<int> recvcounts(nbProcs, 0);
+  vector<int> rdispls(nbProcs, 0);
+  vector<CFreal> sendbuf;
+
+  vector< SafePtr<TopologicalRegionSet> > trs = getTrsList();
+  for (CFuint iTRS=0; iTRS < trs.size(); iTRS++)
+  {
+    const vector<std::string> localAcceptedSocketNames =
+      getMethodData().getThisCoupledAcceptedName(interfaceName, getTrsName(iTRS));
+
+    for(CFuint iType=0;iType< localAcceptedSocketNames.size();iType++)
+    {
+      // the other namespace matched on this processor the points of each
+      // processor iProc and stored the acceptance flags in "<name>.P<thisProc>P<iProc>"
+      sendbuf.clear();
+      for (CFuint iProc = 0; iProc < nbProcs; ++iProc) {
+        const std::string suffix = ".P" + StringOps::to_str(myRank) + "P" + StringOps::to_str(iProc);
+        DataHandle<CFreal> otherAccepted = otherDataStorage->getData<CFreal>
+          (otherNamespace + "_" + localAcceptedSocketNames[iType] + suffix);
+
+        sdispls[iProc] = sendbuf.size();
+        for (CFuint iState = 0; iState < otherAccepted.size(); ++iState) {
+          sendbuf.push_back(otherAccepted[iState]);
+        }
+        sendcounts[iProc] = sendbuf.size() - sdispls[iProc];
+      }
+      // avoid taking the address of an empty buffer
+      if (sendbuf.empty()) sendbuf.resize(1);
+
+      MPIError::getInstance().check
+        ("MPI_Alltoall", "StdMeshMatcherRead::exchangeIsAccepted()",
+         MPI_Alltoall(&sendcounts[0], 1, MPI_INT, &recvcounts[0], 1, MPI_INT, comm));
+
+      for (CFuint iProc = 1; iProc < nbProcs; ++iProc) {
+        rdispls[iProc] = rdispls[iProc-1] + recvcounts[iProc-1];
+      }
+
+      vector<CFreal>& recvbuf = _recvBuffers[localAcceptedSocketNames[iType]];
+      recvbuf.resize(std::max(rdispls[nbProcs-1] + recvcounts[nbProcs-1], 1));
+      rdispls.push_back(rdispls[nbProcs-1] + recvcounts[nbProcs-1]);
+      _recvDispls[localAcceptedSocketNames[iType]] = rdispls;
+      rdispls.pop_back();
+
+      MPIError::getInstance().check
+        ("MPI_Alltoallv", "StdMeshMatcherRead::exchangeIsAccepted()",
+         MPI_Alltoallv(&sendbuf[0], &sendcounts[0], &sdispls[0], MPIStructDef::getMPIType(&sendbuf[0]),
+                       &recvbuf[0], &recvcounts[0], &rdispls[0], MPIStructDef::getMPIType(&sendbuf[0]),
+                       comm));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StdMeshMatcherRead::readIsAcceptedFromMemory(const std::string localDataHandleName)
+{
+  CFAUTOTRACE;
+
+  if (Common::PE::GetPE().IsParallel()) {
+    // flags received from processor _iProc by exchangeIsAccepted()
+    cf_assert(_recvBuffers.count(localDataHandleName) > 0);
+    const vector<int>& displs = _recvDispls[localDataHandleName];
+    const CFreal *const buffer = &_recvBuffers[localDataHandleName][0];
+    _tempIsAccepted.resize(displs[_iProc+1] - displs[_iProc]);
+    for (CFuint iState = 0; iState < _tempIsAccepted.size(); ++iState) {
+      _tempIsAccepted[iState] = buffer[displs[_iProc] + iState];
+    }
+  }
+  else {
+    // flags computed by the other namespace, stored under the same name
+    const std::string interfaceName = getCommandGroupName();
+    const std::string otherNamespace = getMethodData().getCoupledNameSpaceName(interfaceName);
+    Common::SafePtr<Namespace> otherNsp = NamespaceSwitcher::getInstance
+      (SubSystemStatusStack::getCurrentName()).getNamespace(otherNamespace);
+    DataHandle<CFreal> otherAccepted = MeshDataStack::getInstance().getEntryByNamespace(otherNsp)->
+      getDataStorage()->getData<CFreal>(otherNamespace + "_" + localDataHandleName);
+
+    _tempIsAccepted.resize(otherAccepted.size());
+    for (CFuint iState = 0; iState < otherAccepted.size(); ++iState) {
+      _tempIsAccepted[iState] = otherAccepted[iState];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void StdMeshMatcherRead::assembleIsAcceptedFiles(const std::string localDataHandleName)
 {
   CFAUTOTRACE;
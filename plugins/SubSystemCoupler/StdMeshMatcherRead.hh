@@ -3,6 +3,8 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
 #include "SubSysCouplerData.hh"
 #include "Framework/GeometricEntity.hh"
 #include "Framework/MeshData.hh"
@@ -71,6 +73,20 @@ protected: // data
    */
   virtual void readIsAcceptedFile(const std::string dataHandleName);
 
+  /**
+   * Exchange in memory the acceptance status computed by the other namespace
+   * on each processor (parallel runs without file transfer): one
+   * MPI_Alltoallv per TRS and coordinate type
+   */
+  void exchangeIsAccepted();
+
+  /**
+   * Get the acceptance status of the points from processor _iProc without
+   * file transfer, from the data received by exchangeIsAccepted() in parallel
+   * or from the datahandle of the other namespace in serial
+   */
+  void readIsAcceptedFromMemory(const std::string localDataHandleName);
+
   /**
    * Assembling the acceptance status of the states from the various
    * processors in a unique datahandle
@@ -108,6 +124,12 @@ protected: // data
   /// Temporary variable to store which processor accepted the states
   std::vector<CFuint> _tempParallelIndex;
 
+  ///acceptance status received in memory from all the processors, for each socket
+  std::map<std::string, std::vector<CFreal> > _recvBuffers;
+
+  ///start of the data received from each processor (nb processors + 1 entries)
+  std::map<std::string, std::vector<int> > _recvDispls;
+
 
 }; // class StdMeshMatcherRead
 
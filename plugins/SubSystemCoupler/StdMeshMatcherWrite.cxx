@@ -1,4 +1,5 @@
 #include <boost/progress.hpp>
+#include <cmath>
 
 #include "Common/FilesystemException.hh"
 #include "Environment/SingleBehaviorFactory.hh"
@@ -35,12 +36,26 @@ MethodCommandProvider<StdMeshMatcherWrite, SubSysCouplerData, SubSystemCouplerMo
 
 //////////////////////////////////////////////////////////////////////////////
 
+void StdMeshMatcherWrite::defineConfigOptions(Config::OptionList& options)
+{
+   options.addConfigOption< bool> ("KdTreeSearch","Search the matching faces with a k-d tree of the face centroids (the pairings can differ from the linear search).");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 StdMeshMatcherWrite::StdMeshMatcherWrite(const std::string& name) :
   CouplerCom(name),
   _sockets(),
   _matchingFace(static_cast<Framework::TopologicalRegionSet*>(CFNULL),CFNULL),
-  _shapeFunctionAtCoord()
+  _shapeFunctionAtCoord(),
+  _searchFaces(),
+  _faceTree(),
+  _candidateFaces()
 {
+   addConfigOptionsTo(this);
+
+  _useKdTree = false;
+   setParameter("KdTreeSearch",&_useKdTree);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -116,6 +131,9 @@ void StdMeshMatcherWrite::execute()
 {
   CFAUTOTRACE;
   
+  // the faces are the same for the points of all the processors
+  buildFaceSearchTree();
+
   const std::string nsp = getMethodData().getNamespace();
   for (CFuint iProc = 0; iProc < Common::PE::GetPE().GetProcessorCount(nsp); ++iProc) {
     executeWrite(iProc);
@@ -124,6 +142,66 @@ void StdMeshMatcherWrite::execute()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void StdMeshMatcherWrite::buildFaceSearchTree()
+{
+  CFAUTOTRACE;
+
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+
+  Common::SafePtr<GeometricEntityPool<StdTrsGeoBuilder> >
+  geoBuilder = getMethodData().getStdTrsGeoBuilder();
+
+  StdTrsGeoBuilder::GeoData& geoData = geoBuilder->getDataGE();
+
+  _searchFaces.clear();
+  vector<CFreal> centroids;
+  vector<CFreal> radii;
+
+  vector< SafePtr<TopologicalRegionSet> > trs = getTrsList();
+  for (CFuint iTRS = 0; iTRS < trs.size(); ++iTRS) {
+    const CFuint nbGeos = trs[iTRS]->getLocalNbGeoEnts();
+    geoData.trs = trs[iTRS];
+
+    for(CFuint iGeoEnt = 0; iGeoEnt < nbGeos; ++iGeoEnt) {
+      geoData.idx = iGeoEnt;
+      GeometricEntity& currFace = *geoBuilder->buildGE();
+
+      const CFuint nbNodes = currFace.nbNodes();
+      const CFuint start = centroids.size();
+      centroids.resize(start + dim, 0.);
+      for (CFuint iNode = 0; iNode < nbNodes; ++iNode) {
+        const Node& node = *currFace.getNode(iNode);
+        for (CFuint d = 0; d < dim; ++d) {
+          centroids[start + d] += node[d]/nbNodes;
+        }
+      }
+
+      CFreal radius2 = 0.;
+      for (CFuint iNode = 0; iNode < nbNodes; ++iNode) {
+        const Node& node = *currFace.getNode(iNode);
+        CFreal dist2 = 0.;
+        for (CFuint d = 0; d < dim; ++d) {
+          dist2 += (node[d] - centroids[start + d])*(node[d] - centroids[start + d]);
+        }
+        radius2 = std::max(radius2, dist2);
+      }
+      radii.push_back(std::sqrt(radius2));
+
+      _searchFaces.push_back(SubSysCouplerData::GeoEntityIdx(trs[iTRS], iGeoEnt));
+
+      geoBuilder->releaseGE();
+    }
+  }
+
+  if (_useKdTree) {
+    _faceTree.build(centroids, radii, dim);
+  }
+
+  CFLog(VERBOSE, "StdMeshMatcherWrite::buildFaceSearchTree() => " << _searchFaces.size() << " faces\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void StdMeshMatcherWrite::executeWrite(const CFuint iProc)
 {
   CFAUTOTRACE;
@@ -246,7 +324,7 @@ void StdMeshMatcherWrite::executeWrite(const CFuint iProc)
       interfaceData.resize(otherNbStates - rejectedStates);
 
       ///Write the file with the info isAccepted
-      writeIsAcceptedFile(socketAcceptNames[iType]);
+      if(getMethodData().isTransferFiles()) writeIsAcceptedFile(socketAcceptNames[iType]);
     } //end of loop over data transfer coord type
   } // end loop over the OtherTRS
 }
@@ -270,131 +348,132 @@ void StdMeshMatcherWrite::nodeToElementPairing(const RealVector& coord, CFint& n
   CFreal tempV, tempW;
   bool isOnFace(false);
 
-  /// Loop over all the faces of all the TRS's of this command
-  vector< SafePtr<TopologicalRegionSet> > trs = getTrsList();
-  vector< SafePtr<TopologicalRegionSet> >::iterator iTRS;
+  /// Loop over the candidate faces of all the TRS's of this command
+  /// (all the faces without the k-d tree), in the order of the TRS's
+  if (_useKdTree) {
+    _faceTree.findCandidates(coord, _candidateFaces);
+  }
+  const CFuint nbCandidates = (_useKdTree) ? _candidateFaces.size() : _searchFaces.size();
 
   Common::SafePtr<GeometricEntityPool<StdTrsGeoBuilder> >
   geoBuilder = getMethodData().getStdTrsGeoBuilder();
 
   StdTrsGeoBuilder::GeoData& geoData = geoBuilder->getDataGE();
 
-  for (iTRS = trs.begin(); iTRS != trs.end(); ++iTRS) {
+  for (CFuint iCandidate = 0; iCandidate < nbCandidates; ++iCandidate) {
 
-      const CFuint nbGeos = (*iTRS)->getLocalNbGeoEnts();
-      const std::string currentTRSName = (*iTRS)->getName();
-      geoData.trs = (*iTRS);
+    const CFuint iFace = (_useKdTree) ? _candidateFaces[iCandidate] : iCandidate;
+    SafePtr<TopologicalRegionSet> currTrs = _searchFaces[iFace].first;
+    const CFuint iGeoEnt = _searchFaces[iFace].second;
+    geoData.trs = currTrs;
 
-      for(CFuint iGeoEnt = 0; iGeoEnt < nbGeos; ++iGeoEnt) {
+    // build the GeometricEntity
+    geoData.idx = iGeoEnt;
+    GeometricEntity& currFace = *geoBuilder->buildGE();
 
-        // build the GeometricEntity
-        geoData.idx = iGeoEnt;
-        GeometricEntity& currFace = *geoBuilder->buildGE();
+    /// Check if node defined by coord has his projection in face...
+    // 1 - compute the normal to the face
+    // compute the face normal in 2D
+    cf_assert(PhysicalModelStack::getActive()->getDim() == DIM_2D);
+    ///@todo modify this for 3D
 
-        /// Check if node defined by coord has his projection in face...
-        // 1 - compute the normal to the face
-        // compute the face normal in 2D
-        cf_assert(PhysicalModelStack::getActive()->getDim() == DIM_2D);
-        ///@todo modify this for 3D
+    x0 = *(currFace.getNode(0));
+    x1 = *(currFace.getNode(1));
+    v1 = x1-x0;
 
-        x0 = *(currFace.getNode(0));
-        x1 = *(currFace.getNode(1));
-        v1 = x1-x0;
-
-        normal = currFace.computeAvgCellNormal();
+    normal = currFace.computeAvgCellNormal();
 //         normal[0] = -v1[1];
 //         normal[1] = v1[0];
 
-        // 2 - project vector xP-x0 (=v) on the normal from x0 -> w = (n*v)*v
-        v = coord - x0;
-        w = (normal * v);
+    // 2 - project vector xP-x0 (=v) on the normal from x0 -> w = (n*v)*v
+    v = coord - x0;
+    w = (normal * v);
 
-        // 3 - Obtain the vector xProj-x0 (= v - w)
-        project = v-w ;
-        projectCoord = project + x0 ;
-        project2 = projectCoord - x1;
-        // 4 - Now we have the point projected on the plane of the face
-        //     We have to check if the point is inside the face
-        //  We check that (xProj -x0) < (x1-x0)
+    // 3 - Obtain the vector xProj-x0 (= v - w)
+    project = v-w ;
+    projectCoord = project + x0 ;
+    project2 = projectCoord - x1;
+    // 4 - Now we have the point projected on the plane of the face
+    //     We have to check if the point is inside the face
+    //  We check that (xProj -x0) < (x1-x0)
 
-        if ((project.norm2() < v1.norm2()) && (project2.norm2() < v1.norm2()))
-          {
-          isOnFace = true;
-          // 5 - if it falls inside the face, then OK...
-          //     but with concave surfaces, there might be more than one...
-          //     so continue and select the face for which the distance
-          //     to ??? is minimum!!
-          //     Distance to be minimized: averaged distance from the points
-          //                               minimum distance between xP and any node
-          //                               ...
-
-          // Compute the distance of projected point to the nodes and take minimum
-          v = projectCoord - x0;
-          w = projectCoord - x1;
-          tempV = sqrt(v[0]*v[0] + v[1]*v[1]);
-          tempW = sqrt(w[0]*w[0] + w[1]*w[1]);
-          if ((tempV < _minimumDistanceOnFace) || (tempW < _minimumDistanceOnFace)) {
-            coord_Proj = projectCoord;
-            _matchingFace.first = (*iTRS);
-            _matchingFace.second = iGeoEnt;
-            _shapeFunctionAtCoord.resize(currFace.nbNodes());
-            _shapeFunctionAtCoord = currFace.computeShapeFunctionAtCoord(coord_Proj);
+    if ((project.norm2() < v1.norm2()) && (project2.norm2() < v1.norm2()))
+      {
+      isOnFace = true;
+      // 5 - if it falls inside the face, then OK...
+      //     but with concave surfaces, there might be more than one...
+      //     so continue and select the face for which the distance
+      //     to ??? is minimum!!
+      //     Distance to be minimized: averaged distance from the points
+      //                               minimum distance between xP and any node
+      //                               ...
+
+      // Compute the distance of projected point to the nodes and take minimum
+      v = projectCoord - x0;
+      w = projectCoord - x1;
+      tempV = sqrt(v[0]*v[0] + v[1]*v[1]);
+      tempW = sqrt(w[0]*w[0] + w[1]*w[1]);
+      if ((tempV < _minimumDistanceOnFace) || (tempW < _minimumDistanceOnFace)) {
+        coord_Proj = projectCoord;
+        _matchingFace.first = currTrs;
+        _matchingFace.second = iGeoEnt;
+        _shapeFunctionAtCoord.resize(currFace.nbNodes());
+        _shapeFunctionAtCoord = currFace.computeShapeFunctionAtCoord(coord_Proj);
 /*CFout << "Face iGeoEnt: " << iGeoEnt << "\n";
 CFout << "Node 0: " << x0 << "\n";
 CFout << "Node 1: " << x1 << "\n";
 CFout << "Coord Proj: " << coord_Proj << "\n";
 CFout << "_shapeFunctionAtCoord: " << _shapeFunctionAtCoord << "\n";*/
-            if(tempV < tempW)
-            {
-              _minimumDistanceOnFace = tempV;
-            }
-            else
-            {
-              _minimumDistanceOnFace = tempW;
-            }
-            //once is has been projected on a face, no need of this
-            _minimumDistanceOffFace = -1.;
-
-            }
-          }
+        if(tempV < tempW)
+        {
+          _minimumDistanceOnFace = tempV;
+        }
         else
+        {
+          _minimumDistanceOnFace = tempW;
+        }
+        //once is has been projected on a face, no need of this
+        _minimumDistanceOffFace = -1.;
+
+        }
+      }
+    else
+      {
+        if(!isOnFace)
+        {
+          // 6 - the point projection might fall outside all faces
+          // Compute the coordinates of projected point
+          coord_Proj = project + x0 ;
+
+          v = coord_Proj - x0;
+          w = coord_Proj - x1;
+          tempV = sqrt(v[0]*v[0] + v[1]*v[1]);
+          tempW = sqrt(w[0]*w[0] + w[1]*w[1]);
+          _shapeFunctionAtCoord.resize(currFace.nbNodes());
+          _shapeFunctionAtCoord = 0.;
+          if (tempV < _minimumDistanceOffFace)
+          {
+            nodeID = 0;
+            _matchingFace.first = currTrs;
+            _matchingFace.second = iGeoEnt;
+            _shapeFunctionAtCoord[nodeID] = 1.;
+            _minimumDistanceOffFace = tempV;
+          }
+          if (tempW < _minimumDistanceOffFace)
           {
-            if(!isOnFace)
-            {
-              // 6 - the point projection might fall outside all faces
-              // Compute the coordinates of projected point
-              coord_Proj = project + x0 ;
-
-              v = coord_Proj - x0;
-              w = coord_Proj - x1;
-              tempV = sqrt(v[0]*v[0] + v[1]*v[1]);
-              tempW = sqrt(w[0]*w[0] + w[1]*w[1]);
-              _shapeFunctionAtCoord.resize(currFace.nbNodes());
-              _shapeFunctionAtCoord = 0.;
-              if (tempV < _minimumDistanceOffFace)
-              {
-                nodeID = 0;
-                _matchingFace.first = (*iTRS);
-                _matchingFace.second = iGeoEnt;
-                _shapeFunctionAtCoord[nodeID] = 1.;
-                _minimumDistanceOffFace = tempV;
-              }
-              if (tempW < _minimumDistanceOffFace)
-              {
-                nodeID = 1;
-                _matchingFace.first = (*iTRS);
-                _matchingFace.second = iGeoEnt;
-                _shapeFunctionAtCoord[nodeID] = 1.;
-                _minimumDistanceOffFace = tempW;
-              }
-            }
+            nodeID = 1;
+            _matchingFace.first = currTrs;
+            _matchingFace.second = iGeoEnt;
+            _shapeFunctionAtCoord[nodeID] = 1.;
+            _minimumDistanceOffFace = tempW;
           }
+        }
+      }
 
     //release the GeometricEntity
     geoBuilder->releaseGE();
 
-    } // end of loop over faces
-  } // end of loop over TRS's
+  } // end of loop over faces
 
   if(isOnFace == true){
     nodeID = -1;
@@ -7,6 +7,7 @@
 #include "Framework/GeometricEntity.hh"
 #include "Framework/MeshData.hh"
 #include "Framework/DynamicDataSocketSet.hh"
+#include "SubSystemCoupler/FaceCentroidKdTree.hh"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -30,6 +31,12 @@ namespace COOLFluiD {
 class StdMeshMatcherWrite : public CouplerCom {
 public:
 
+  /**
+   * Defines the Config Option's of this class
+   * @param options a OptionList where to add the Option's
+   */
+  static void defineConfigOptions(Config::OptionList& options);
+
   /**
    * Constructor.
    */
@@ -69,6 +76,12 @@ protected: // data
    */
   virtual void nodeToElementPairing(const RealVector& coord, CFint& nodeID, RealVector& coordProj);
 
+  /**
+   * Builds the list of the faces of the TRS's of this command
+   * and the k-d tree of their centroids
+   */
+  void buildFaceSearchTree();
+
   /**
    * Writing to a file the acceptance status of the points
    */
@@ -97,6 +110,18 @@ protected: // data
 
   RealVector _shapeFunctionAtCoord;
 
+  /// flag telling to search the matching faces with a k-d tree
+  bool _useKdTree;
+
+  /// faces of the TRS's of this command, TRS after TRS
+  std::vector<SubSysCouplerData::GeoEntityIdx> _searchFaces;
+
+  /// k-d tree of the centroids of the faces in _searchFaces
+  FaceCentroidKdTree _faceTree;
+
+  /// candidate faces of the current point
+  std::vector<CFuint> _candidateFaces;
+
 }; // class StdMeshMatcherWrite
 
 //////////////////////////////////////////////////////////////////////////////
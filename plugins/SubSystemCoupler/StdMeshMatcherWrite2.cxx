@@ -312,7 +312,7 @@ CFout << "mappedCoord: "<< mappedCoord  << "\n";
       interfaceData.resize(otherNbStates - rejectedStates);
 
       ///Write the file with the info isAccepted
-      writeIsAcceptedFile(socketAcceptNames[iType]);
+      if(getMethodData().isTransferFiles()) writeIsAcceptedFile(socketAcceptNames[iType]);
     } //end of loop over data transfer coord type
   } // end loop over the OtherTRS
 
@@ -1,4 +1,7 @@
 #include "Common/FilesystemException.hh"
+#include "Common/NotImplementedException.hh"
+#include "Common/MPI/MPIError.hh"
+#include "Common/MPI/MPIStructDef.hh"
 #include "Environment/SingleBehaviorFactory.hh"
 #include "Environment/FileHandlerInput.hh"
 #include "Environment/FileHandlerOutput.hh"
@@ -128,7 +131,16 @@ void StdPreProcessRead::executeOnTrs()
   
   const std::string nsp = getMethodData().getNamespace();
   const bool isParallel = Common::PE::GetPE().IsParallel();
-  if(isParallel)
+  if(isParallel && !getMethodData().isTransferFiles())
+  {
+    // the coordinates of all the processors are gathered at once
+    gatherOtherCoordinates();
+    for (CFuint iProc = 0; iProc < Common::PE::GetPE().GetProcessorCount(nsp); ++iProc)
+    {
+      executeReadOnTrs(iProc);
+    }
+  }
+  else if(isParallel)
   {
     Common::PE::GetPE().setBarrier(nsp);
     
@@ -180,9 +192,14 @@ void StdPreProcessRead::executeReadOnTrs(const CFuint iProc)
       const std::string socketName = socketCoordNames[iType];
 
       if (std::count(_alreadyReadSockets.begin(),_alreadyReadSockets.end(),socketName) == 0) {
-        // Temporary: transfer info through files...
-        // Read the otherSubSystem_COORD files
-        readFile(socketName);
+        // Read the otherSubSystem_COORD files, unless the coordinates are
+        // transferred in memory (already gathered in parallel)
+        if (getMethodData().isTransferFiles()) {
+          readFile(socketName);
+        }
+        else if (!Common::PE::GetPE().IsParallel()) {
+          readFromDataHandle(socketName);
+        }
 
         _alreadyReadSockets.push_back(socketName);
       }
@@ -249,6 +266,119 @@ void StdPreProcessRead::readFile(const std::string& socketName)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void StdPreProcessRead::readFromDataHandle(const std::string& socketName)
+{
+  CFAUTOTRACE;
+
+  DataHandle<RealVector> interfaceCoord =
+    _sockets.getSocketSource<RealVector>(socketName)->getDataHandle();
+
+  // in serial, the other namespace stores its coordinates under the same name
+  const std::string interfaceName = getCommandGroupName();
+  const std::string otherNamespace = getMethodData().getCoupledNameSpaceName(interfaceName);
+  Common::SafePtr<Namespace> otherNsp = NamespaceSwitcher::getInstance
+    (SubSystemStatusStack::getCurrentName()).getNamespace(otherNamespace);
+  DataHandle<RealVector> otherCoord = MeshDataStack::getInstance().getEntryByNamespace(otherNsp)->
+    getDataStorage()->getData<RealVector>(otherNamespace + "_" + socketName);
+
+  interfaceCoord.resize(otherCoord.size());
+  for (CFuint i = 0; i < otherCoord.size(); ++i) {
+    interfaceCoord[i].resize(otherCoord[i].size());
+    interfaceCoord[i] = otherCoord[i];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StdPreProcessRead::gatherOtherCoordinates()
+{
+  CFAUTOTRACE;
+
+  const std::string interfaceName = getCommandGroupName();
+  const std::string nsp = getMethodData().getNamespace();
+  const std::string otherNamespace = getMethodData().getCoupledNameSpaceName(interfaceName);
+  const CFuint nbProcs = PE::GetPE().GetProcessorCount(nsp);
+  if (PE::GetPE().GetProcessorCount(otherNamespace) != nbProcs) {
+    throw NotImplementedException
+      (FromHere(), "StdPreProcessRead::gatherOtherCoordinates() => the namespaces [" + nsp + "] and [" +
+       otherNamespace + "] must share the processors to transfer the coordinates without files");
+  }
+  const CFuint myRank = PE::GetPE().GetRank(nsp);
+  MPI_Comm comm = PE::GetPE().GetCommunicator(nsp);
+
+  Common::SafePtr<Namespace> otherNsp = NamespaceSwitcher::getInstance
+    (SubSystemStatusStack::getCurrentName()).getNamespace(otherNamespace);
+  Common::SafePtr<DataStorage> otherDataStorage =
+    MeshDataStack::getInstance().getEntryByNamespace(otherNsp)->getDataStorage();
+
+  const CFuint dim = PhysicalModelStack::getActive()->getDim();
+  vector<int> recvcounts(nbProcs, 0);
+  vector<int> displs(nbProcs, 0);
+  vector<CFreal> sendbuf;
+  vector<CFreal> recvbuf;
+
+  const vector<std::string> otherTrsNames = getMethodData().getCoupledSubSystemsTRSNames(interfaceName);
+  for (CFuint iTRS = 0; iTRS < otherTrsNames.size(); ++iTRS)
+  {
+    const vector<std::string> myCoordNames =
+      getMethodData().getOtherCoupledCoordName(interfaceName,otherTrsNames[iTRS],myRank);
+
+    for(CFuint iType=0; iType < myCoordNames.size(); iType++)
+    {
+      // the read status is the same on all the processors
+      if (std::count(_alreadyReadSockets.begin(),_alreadyReadSockets.end(),myCoordNames[iType]) > 0) continue;
+
+      // the other namespace stores the coordinates of its points on this
+      // processor under the socket name without the ".P<rank>" suffix
+      const std::string localName = myCoordNames[iType].substr(0, myCoordNames[iType].rfind(".P"));
+      DataHandle<RealVector> otherCoord =
+        otherDataStorage->getData<RealVector>(otherNamespace + "_" + localName);
+
+      sendbuf.resize(std::max<CFuint>(otherCoord.size()*dim, 1));
+      for (CFuint i = 0; i < otherCoord.size(); ++i) {
+        cf_assert(otherCoord[i].size() == dim);
+        for (CFuint j = 0; j < dim; ++j) {
+          sendbuf[i*dim + j] = otherCoord[i][j];
+        }
+      }
+      int sendcount = otherCoord.size()*dim;
+
+      MPIError::getInstance().check
+        ("MPI_Allgather", "StdPreProcessRead::gatherOtherCoordinates()",
+         MPI_Allgather(&sendcount, 1, MPI_INT, &recvcounts[0], 1, MPI_INT, comm));
+      for (CFuint iProc = 1; iProc < nbProcs; ++iProc) {
+        displs[iProc] = displs[iProc-1] + recvcounts[iProc-1];
+      }
+      recvbuf.resize(std::max(displs[nbProcs-1] + recvcounts[nbProcs-1], 1));
+
+      MPIError::getInstance().check
+        ("MPI_Allgatherv", "StdPreProcessRead::gatherOtherCoordinates()",
+         MPI_Allgatherv(&sendbuf[0], sendcount, MPIStructDef::getMPIType(&sendbuf[0]),
+                        &recvbuf[0], &recvcounts[0], &displs[0], MPIStructDef::getMPIType(&sendbuf[0]),
+                        comm));
+
+      for (CFuint iProc = 0; iProc < nbProcs; ++iProc)
+      {
+        const std::string socketName =
+          getMethodData().getOtherCoupledCoordName(interfaceName,otherTrsNames[iTRS],iProc)[iType];
+        DataHandle<RealVector> interfaceCoord =
+          _sockets.getSocketSource<RealVector>(socketName)->getDataHandle();
+
+        const CFuint nbOtherStates = recvcounts[iProc]/dim;
+        interfaceCoord.resize(nbOtherStates);
+        for (CFuint i = 0; i < nbOtherStates; ++i) {
+          interfaceCoord[i].resize(dim);
+          for (CFuint j = 0; j < dim; ++j) {
+            interfaceCoord[i][j] = recvbuf[displs[iProc] + i*dim + j];
+          }
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void StdPreProcessRead::getWordsFromLine(ifstream& fin,
                                      std::string& line,
                                      CFuint&  lineNb,
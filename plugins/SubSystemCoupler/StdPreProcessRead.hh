@@ -74,6 +74,19 @@ protected: //
   //Read file containing the coordinates of the other side
   void readFile(const std::string& name);
 
+  /**
+   * Copy the coordinates of the other side from the datahandle of the other
+   * namespace (serial runs without file transfer)
+   */
+  void readFromDataHandle(const std::string& socketName);
+
+  /**
+   * Gather in memory the coordinates of the other side on all the processors
+   * (parallel runs without file transfer, both namespaces sharing the
+   * processors): one MPI_Allgatherv per TRS and coordinate type
+   */
+  void gatherOtherCoordinates();
+
   /**
    * Helper function that gets a line from a file and puts
    * into a string incrementing a supplied counter
@@ -206,7 +206,7 @@ void StdPreProcessWrite::executeWriteOnTrs(const CFuint iProc)
           }
         }//end for
       }//end if
-      writeFile(socketCoordNames[iType]);
+      if(getMethodData().isTransferFiles()) writeFile(socketCoordNames[iType]);
 
     // Resize the datahandles, now that we know the number of coupled states
 /*    DataHandle<CFreal> isAccepted =
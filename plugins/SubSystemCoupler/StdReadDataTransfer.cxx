@@ -22,6 +22,8 @@
 #include "SubSystemCoupler/SubSystemCoupler.hh"
 #include "SubSystemCoupler/StdReadDataTransfer.hh"
 #include "Framework/NamespaceSwitcher.hh"
+#include "Common/MPI/MPIError.hh"
+#include "Common/MPI/MPIStructDef.hh"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -164,6 +166,11 @@ void StdReadDataTransfer::execute()
   CFAUTOTRACE;
   
   const std::string nsp = getMethodData().getNamespace();
+  if (!getMethodData().isTransferFiles() && Common::PE::GetPE().IsParallel()) {
+    _interfaceName = getCommandGroupName();
+    exchangeInterfaceData();
+  }
+
   for (_iProc = 0; _iProc < Common::PE::GetPE().GetProcessorCount(nsp); ++_iProc)
   {
     executeRead();
@@ -203,8 +210,12 @@ void StdReadDataTransfer::executeRead()
       }
       else{
         const bool isParallel = Common::PE::GetPE().IsParallel();
-        cf_assert(!isParallel);
-        readFromDataHandle(socketDataNames[iType]);
+        if (isParallel) {
+          readFromBuffer(socketDataNames[iType], socketAcceptedNames[iType]);
+        }
+        else {
+          readFromDataHandle(socketDataNames[iType]);
+        }
       }
     }
   }
@@ -488,6 +499,144 @@ void StdReadDataTransfer::readFromDataHandle(const std::string dataHandleName)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void StdReadDataTransfer::exchangeInterfaceData()
+{
+  CFAUTOTRACE;
+
+  const std::string nsp = getMethodData().getNamespace();
+  const std::string otherNamespace = getMethodData().getCoupledNameSpaceName(_interfaceName);
+  const CFuint nbProcs = PE::GetPE().GetProcessorCount(nsp);
+  if (PE::GetPE().GetProcessorCount(otherNamespace) != nbProcs) {
+    throw NotImplementedException
+      (FromHere(), "StdReadDataTransfer::exchangeInterfaceData() => the namespaces [" + nsp + "] and [" +
+       otherNamespace + "] must share the processors to transfer data without files");
+  }
+  const CFuint myRank = PE::GetPE().GetRank(nsp);
+  MPI_Comm comm = PE::GetPE().GetCommunicator(nsp);
+
+  Common::SafePtr<Namespace> otherNsp = NamespaceSwitcher::getInstance
+    (SubSystemStatusStack::getCurrentName()).getNamespace(otherNamespace);
+  Common::SafePtr<DataStorage> otherDataStorage =
+    MeshDataStack::getInstance().getEntryByNamespace(otherNsp)->getDataStorage();
+
+  vector<int> sendcounts(nbProcs, 0);
+  vector<int> sdispls(nbProcs, 0);
+  vector<int> recvcounts(nbProcs, 0);
+  vector<int> rdispls(nbProcs, 0);
+  vector<CFreal> sendbuf;
+
+  vector< SafePtr<TopologicalRegionSet> > trs = getTrsList();
+  for (CFuint iTRS=0; iTRS < trs.size(); iTRS++)
+  {
+    const std::string trsName = getTrsName(iTRS);
+    const vector<std::string> socketAcceptedNames = getMethodData().getThisCoupledAcceptedName(_interfaceName,trsName);
+    const vector<std::string> socketDataNames = getMethodData().getThisCoupledDataName(_interfaceName,trsName);
+
+    for(CFuint iType=0;iType < socketDataNames.size();iType++)
+    {
+      // the other namespace computed on this processor the data for the points of
+      // each processor iProc: they are stored in "<name>.P<thisProc>P<iProc>", and
+      // are packed as [nbStates, nbData, dataSize, isAccepted..., data...]
+      sendbuf.clear();
+      for (CFuint iProc = 0; iProc < nbProcs; ++iProc) {
+        const std::string suffix = ".P" + StringOps::to_str(myRank) + "P" + StringOps::to_str(iProc);
+        DataHandle<CFreal> otherAccepted =
+          otherDataStorage->getData<CFreal>(otherNamespace + "_" + socketAcceptedNames[iType] + suffix);
+        DataHandle<RealVector> otherData =
+          otherDataStorage->getData<RealVector>(otherNamespace + "_" + socketDataNames[iType] + suffix);
+
+        const CFuint nbStates = otherAccepted.size();
+        const CFuint nbData = otherData.size();
+        const CFuint dataSize = (nbData > 0) ? otherData[0].size() : 0;
+
+        sdispls[iProc] = sendbuf.size();
+        sendbuf.reserve(sendbuf.size() + 3 + nbStates + nbData*dataSize);
+        sendbuf.push_back(nbStates);
+        sendbuf.push_back(nbData);
+        sendbuf.push_back(dataSize);
+        for (CFuint iState = 0; iState < nbStates; ++iState) {
+          sendbuf.push_back(otherAccepted[iState]);
+        }
+        for (CFuint iData = 0; iData < nbData; ++iData) {
+          cf_assert(otherData[iData].size() == dataSize);
+          for (CFuint j = 0; j < dataSize; ++j) {
+            sendbuf.push_back(otherData[iData][j]);
+          }
+        }
+        sendcounts[iProc] = sendbuf.size() - sdispls[iProc];
+      }
+
+      MPIError::getInstance().check
+        ("MPI_Alltoall", "StdReadDataTransfer::exchangeInterfaceData()",
+         MPI_Alltoall(&sendcounts[0], 1, MPI_INT, &recvcounts[0], 1, MPI_INT, comm));
+
+      for (CFuint iProc = 1; iProc < nbProcs; ++iProc) {
+        rdispls[iProc] = rdispls[iProc-1] + recvcounts[iProc-1];
+      }
+
+      vector<CFreal>& recvbuf = _recvBuffers[socketDataNames[iType]];
+      recvbuf.resize(rdispls[nbProcs-1] + recvcounts[nbProcs-1]);
+      _recvDispls[socketDataNames[iType]] = rdispls;
+
+      MPIError::getInstance().check
+        ("MPI_Alltoallv", "StdReadDataTransfer::exchangeInterfaceData()",
+         MPI_Alltoallv(&sendbuf[0], &sendcounts[0], &sdispls[0], MPIStructDef::getMPIType(&sendbuf[0]),
+                       &recvbuf[0], &recvcounts[0], &rdispls[0], MPIStructDef::getMPIType(&sendbuf[0]),
+                       comm));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StdReadDataTransfer::readFromBuffer(const std::string dataHandleName, const std::string acceptedDataHandleName)
+{
+  CFAUTOTRACE;
+
+  DataHandle< CFuint> parallelDataIndex =
+    _sockets.getSocketSink<CFuint>(acceptedDataHandleName + "PAR")->getDataHandle();
+
+  DataHandle< RealVector> interfaceData =
+    _sockets.getSocketSink<RealVector>(dataHandleName)->getDataHandle();
+
+  DataHandle< RealVector> interfacePastData =
+    _sockets.getSocketSink<RealVector>(dataHandleName + "_PAST")->getDataHandle();
+
+  DataHandle< RealVector> originalData =
+    _sockets.getSocketSink<RealVector>(dataHandleName + "_ORIGINAL")->getDataHandle();
+
+  cf_assert(_recvBuffers.count(dataHandleName) > 0);
+  const CFreal *const buffer = &_recvBuffers[dataHandleName][_recvDispls[dataHandleName][_iProc]];
+  const CFuint nbStates = static_cast<CFuint>(buffer[0]);
+  const CFuint dataSize = static_cast<CFuint>(buffer[2]);
+  const CFreal *const isAccepted = &buffer[3];
+  const CFreal* data = &buffer[3 + nbStates];
+
+  for (CFuint iState = 0; iState < nbStates; ++iState)
+  {
+    if(isAccepted[iState] >= 0.){
+      //Only store the transfered value if the data
+      //comes from the processor who accepted the data
+      if(parallelDataIndex[iState] == _iProc){
+        //First backup past Data
+        if(SubSystemStatusStack::getActive()->isSubIterationFirstStep())
+        {
+          interfacePastData[iState] = interfaceData[iState];
+        }
+
+        cf_assert(dataSize == (originalData[iState]).size());
+        for (CFuint j=0; j<dataSize;++j)
+        {
+          (originalData[iState])[j] = data[j];
+        }
+      }
+      data += dataSize;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void StdReadDataTransfer::readFile(const std::string dataFileName, const std::string acceptedFileName, const std::string dataHandleName, const std::string acceptedDataHandleName)
 {
   CFAUTOTRACE;
@@ -3,6 +3,8 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
 #include "SubSysCouplerData.hh"
 #include "Framework/GeometricEntity.hh"
 #include "Framework/MeshData.hh"
@@ -78,6 +80,20 @@ protected: // functions
   ///Read the datahandle of the other namespace put values into your own datahandle
   void readFromDataHandle(const std::string dataHandleName);
 
+  /**
+   * Exchange in memory the data computed by the other namespace on each
+   * processor, when both namespaces share the processors (parallel runs
+   * without file transfer): one MPI_Alltoallv per TRS and coordinate type
+   * sends the acceptance flags and the data in a packed binary layout
+   */
+  void exchangeInterfaceData();
+
+  /**
+   * Read the data received from processor _iProc by exchangeInterfaceData()
+   * and put the value in the data datahandle (same semantics as readFile())
+   */
+  void readFromBuffer(const std::string dataHandleName, const std::string acceptedDataHandleName);
+
   ///Outputs to file the norm of the data update
   void prepareNormFile(const std::string dataHandleName);
 
@@ -145,6 +161,12 @@ protected: // data
   ///other processor for which the data is processed
   CFuint _iProc;
 
+  ///data received in memory from all the processors, for each data socket
+  std::map<std::string, std::vector<CFreal> > _recvBuffers;
+
+  ///start of the data received from each processor, for each data socket
+  std::map<std::string, std::vector<int> > _recvDispls;
+
 }; // class StdReadDataTransfer
 
 //////////////////////////////////////////////////////////////////////////////
@@ -40,7 +40,7 @@ void SubSysCouplerData::defineConfigOptions(Config::OptionList& options)
       ("PostVariableTransformers","Variable Transformers for each interface. Transformation after receiving data");
 
    options.addConfigOption< std::vector<std::string> >("CoordType","Type of coordinates: nodes/states/gauss/ghost/nodalgauss");
-   options.addConfigOption< bool >("FileTransfer","Transfer data using files (otherwise, though datahandles");
+   options.addConfigOption< bool >("FileTransfer","Transfer data using files (otherwise, in memory through the datahandles: in parallel, both namespaces must then share the processors)");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <boost/thread/recursive_mutex.hpp>
+
 #include "Common/CFLog.hh"
 
 #include "logcpp/FileAppender.hh"
@@ -19,6 +21,29 @@ namespace COOLFluiD {
 
 //////////////////////////////////////////////////////////////////////////////
 
+// recursive, since the streamed values may log in turn
+static boost::recursive_mutex& getLogMutex()
+{
+  static boost::recursive_mutex mutex;
+  return mutex;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFLogLock::CFLogLock()
+{
+  getLogMutex().lock();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFLogLock::~CFLogLock()
+{
+  getLogMutex().unlock();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 CFLogger& CFLogger::getInstance ()
 {
   static CFLogger logger;
@@ -79,6 +79,23 @@ private: // methods
 
 };
 
+//////////////////////////////////////////////////////////////////////////////
+
+/// Serializes a message of CFLog when it is written directly to std::cout,
+/// so that the threads of the Common::ThreadPool do not interleave their
+/// output. A temporary lives until the whole message is written.
+/// Messages going through logcpp are already serialized by the categories.
+class Common_API CFLogLock {
+public:
+
+  /// Constructor locks the output
+  CFLogLock();
+
+  /// Destructor unlocks the output
+  ~CFLogLock();
+
+};
+
 //////////////////////////////////////////////////////////////////////////////
 // Logging macros
 //////////////////////////////////////////////////////////////////////////////
@@ -104,8 +121,9 @@ private: // methods
 #if (defined(CF_HAVE_IBMSTATIC) || !defined(CF_HAVE_LOG4CPP)) && defined(CF_HAVE_MPI)
 static int getCPURank() 
 {
-  int rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  // queried once: with MPI_THREAD_FUNNELED only the main thread may call MPI
+  static int rank = -1;
+  if (rank < 0) MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   return rank;
 }
 #ifdef CF_HAVE_IBMSTATIC
@@ -113,7 +131,7 @@ static int getCPURank()
 #endif
 
 #ifndef CF_HAVE_LOG4CPP
-#define CFLog(n,x) if (n <= CFLogger::getInstance().getMainLoggerLevel() && getCPURank() == 0) std::cout << x
+#define CFLog(n,x) if (n <= CFLogger::getInstance().getMainLoggerLevel() && getCPURank() == 0) CFLogLock(), std::cout << x
 #endif
 
 #endif
@@ -0,0 +1,75 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_Common_FNVHash_hh
+#define COOLFluiD_Common_FNVHash_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Common {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class computes the 64-bit FNV-1a hash of a sequence of bytes, which
+/// can be added in several pieces (e.g. while streaming a file)
+class FNVHash {
+public:
+
+  /// Constructor
+  FNVHash() : m_hash(14695981039346656037ULL) {}
+
+  /// Add the given bytes
+  void add(const void* data, const size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      m_hash = (m_hash ^ bytes[i])*1099511628211ULL;
+    }
+  }
+
+  /// Add the characters of the given string
+  void add(const std::string& str) { add(str.data(), str.size()); }
+
+  /// Add the bytes of the given value
+  template <typename T>
+  void addValue(const T& value) { add(&value, sizeof(T)); }
+
+  /// @return the hash
+  unsigned long long getValue() const { return m_hash; }
+
+  /// @return the hash as 16 hexadecimal digits
+  std::string str() const
+  {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << m_hash;
+    return oss.str();
+  }
+
+private:
+
+  /// current hash
+  unsigned long long m_hash;
+
+}; // end of class FNVHash
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Common
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Common_FNVHash_hh
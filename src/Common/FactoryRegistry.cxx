@@ -17,7 +17,9 @@ namespace COOLFluiD {
 
 //////////////////////////////////////////////////////////////////////////////
 
-FactoryRegistry::FactoryRegistry()
+FactoryRegistry::FactoryRegistry() :
+  m_store(),
+  m_missingHandler(CFNULL)
 {
 }
 
@@ -85,6 +87,19 @@ SafePtr<FactoryBase> FactoryRegistry::getFactory(const std::string& type_name)
   // CFtrace << "FactoryRegistry::getFactory(" << type_name << ") => end\n";
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector< SafePtr<FactoryBase> > FactoryRegistry::getAllFactories()
+{
+  std::vector< SafePtr<FactoryBase> > result;
+  result.reserve(m_store.size());
+  for (GeneralStorage<FactoryBase>::iterator itr = m_store.begin(); 
+       itr != m_store.end(); ++itr) {
+    result.push_back(itr->second);
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
   } // namespace Common 
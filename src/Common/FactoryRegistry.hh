@@ -9,6 +9,8 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include <vector>
+
 #include "Common/SafePtr.hh"
 #include "Common/GeneralStorage.hh"
 #include "Common/NonCopyable.hh"
@@ -30,6 +32,21 @@ namespace COOLFluiD {
 class Common_API FactoryRegistry : public NonCopyable<FactoryRegistry> {
  
  public:
+  
+  /// Interface of the objects able to register missing providers on demand,
+  /// typically by loading the module defining them
+  class Common_API MissingProviderHandler {
+  public:
+    /// Default destructor
+    virtual ~MissingProviderHandler() {}
+    
+    /// Called when a provider is not found in a factory
+    /// @param factoryName  type name of the factory
+    /// @param providerName name of the missing provider
+    virtual void loadMissingProvider(const std::string& factoryName,
+				     const std::string& providerName) = 0;
+  };
+  
   /// Default constructor
   FactoryRegistry();
   
@@ -49,9 +66,27 @@ class Common_API FactoryRegistry : public NonCopyable<FactoryRegistry> {
   /// @return a pointer to a FactoryBase if found or a null pointer if not found
   SafePtr<FactoryBase> getFactory(const std::string& name);
   
+  /// Get all the registered factories
+  /// @return a vector with pointers to all the FactoryBase's
+  std::vector< SafePtr<FactoryBase> > getAllFactories();
+  
+  /// Set the object called when a provider is missing (CFNULL for none)
+  void setMissingProviderHandler(MissingProviderHandler* handler) {m_missingHandler = handler;}
+  
+  /// Give a chance to register a missing provider
+  /// @param factoryName  type name of the factory
+  /// @param providerName name of the missing provider
+  void loadMissingProvider(const std::string& factoryName, const std::string& providerName)
+  {
+    if (m_missingHandler != CFNULL) {m_missingHandler->loadMissingProvider(factoryName, providerName);}
+  }
+  
  private: // data
   
   GeneralStorage<FactoryBase> m_store;
+  
+  /// object called when a provider is missing
+  MissingProviderHandler* m_missingHandler;
 
 }; // end of class FactoryRegistry
 
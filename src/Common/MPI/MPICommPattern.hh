@@ -36,6 +36,8 @@
 #ifndef COOLFluiD_Common_MPICommPattern_hh
 #define COOLFluiD_Common_MPICommPattern_hh
 
+#include <algorithm>
+#include <map>
 #include <set>
 #include <sstream>
 #include <fstream>
@@ -225,6 +227,8 @@ private:
   ///      (WARNING! CONSISTENCY IN PARALLEL RUN!)
   static const int _MPI_TAG_BUILDGHOSTMAP;
   static const int _MPI_TAG_SYNC;
+  /// first of the three tags used by BuildGhostMapRendezvous
+  static const int _MPI_TAG_RENDEZVOUS;
 
   /// The rank of this CPU (cached for speed reasons)
   int _CommRank;
@@ -318,6 +322,14 @@ private:
   void Sync_BuildTypeHelper (const std::vector<std::vector<IndexType> > & V,
                                    std::vector<MPI_Datatype> & MPIType ) const;
 
+  /// Send one buffer to each rank in SendBufs and receive the buffers sent
+  /// to this rank, keyed by source rank. If KnownSources is true, the keys
+  /// already in RecvBufs are the only sources, otherwise their number is
+  /// found with a single MPI_Reduce_scatter. Buffers to self are copied.
+  void Sync_SparseExchange (const std::map<int, std::vector<IndexType> > & SendBufs,
+			    int Tag, bool KnownSources,
+			    std::map<int, std::vector<IndexType> > & RecvBufs);
+
   /// Find functions (for internal use)
   /// These take advantage of a index map if one is present
   IndexType FindLocal (IndexType GlobalIndex) const;
@@ -414,16 +426,25 @@ public: // funcions
   /// @pre InitMPI needs to be called before this.
   void BuildGhostMap(const std::string& algo) 
   {
-    cf_assert(algo == "Old" || algo == "Bcast" || algo == "AllToAll");
+    cf_assert(algo == "Old" || algo == "Bcast" || algo == "AllToAll" || 
+	      algo == "Rendezvous");
     if (algo == "Old") {
       BuildGhostMapOld(); 
     }
     else if (_CommSize > 1) {
       if (algo == "Bcast") BuildGhostMapBcast();
       if (algo == "AllToAll") BuildGhostMapAllToAll();
+      if (algo == "Rendezvous") BuildGhostMapRendezvous();
     }
   }  
   
+  /// Build the ghost mapping for synchronization with a distributed directory:
+  /// each global ID is registered by its owner on the rank GlobalID%CommSize,
+  /// which resolves the owners of the ghosts, then each rank asks its donors
+  /// directly. No donor map is needed and no rank loops over all the others.
+  /// Both BeginSync() and synchronize() can be used afterwards.
+  void BuildGhostMapRendezvous();
+  
   /// Build the ghost mapping for synchronization with the new algorithm 
   /// based on MPI_Alltoall and MPI_Alltoallv
   /// @author Andrea Lani
@@ -525,6 +546,10 @@ template <typename DATA>
 const int MPICommPattern<DATA>::_MPI_TAG_SYNC  =
   MPICommPattern<DATA>::_MPI_TAG_BUILDGHOSTMAP + 1;
 
+template <typename DATA>
+const int MPICommPattern<DATA>::_MPI_TAG_RENDEZVOUS  =
+  MPICommPattern<DATA>::_MPI_TAG_SYNC + 1;
+
 //////////////////////////////////////////////////////////////////////////////
 
 //
@@ -1400,6 +1425,220 @@ void MPICommPattern<DATA>::BuildGhostMapAllToAll()
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename DATA>
+void MPICommPattern<DATA>::Sync_SparseExchange
+(const std::map<int, std::vector<IndexType> > & SendBufs, int Tag, 
+ bool KnownSources, std::map<int, std::vector<IndexType> > & RecvBufs)
+{
+  using namespace std;
+  
+  typedef typename map<int, vector<IndexType> >::const_iterator BufIter;
+  
+  IndexType dummy = 0;
+  MPI_Datatype IndexMPIType = MPIStructDef::getMPIType(&dummy);
+  
+  int NbIncoming = 0;
+  if (KnownSources) {
+    NbIncoming = RecvBufs.size() - (RecvBufs.count(_CommRank) ? 1 : 0);
+  }
+  else {
+    RecvBufs.clear();
+    vector<int> NbMessages(_CommSize, 0);
+    for (BufIter it = SendBufs.begin(); it != SendBufs.end(); ++it) {
+      if (it->first != _CommRank) NbMessages[it->first] = 1;
+    }
+    vector<int> Ones(_CommSize, 1);
+    MPIError::getInstance().check
+      ("MPI_Reduce_scatter", "MPICommPattern<DATA>::Sync_SparseExchange()",
+       MPI_Reduce_scatter(&NbMessages[0], &NbIncoming, &Ones[0], MPI_INT, 
+			  MPI_SUM, _Communicator));
+  }
+  
+  vector<MPI_Request> Requests;
+  Requests.reserve(SendBufs.size());
+  for (BufIter it = SendBufs.begin(); it != SendBufs.end(); ++it) {
+    if (it->first == _CommRank) {
+      RecvBufs[_CommRank] = it->second;
+      continue;
+    }
+    
+    Requests.push_back(MPI_REQUEST_NULL);
+    IndexType* Buf = it->second.empty() ? &dummy : const_cast<IndexType*>(&it->second[0]);
+    Common::CheckMPIStatus(MPI_Isend (Buf, (int)it->second.size(), IndexMPIType,
+				      it->first, Tag, _Communicator, &Requests.back()));
+  }
+  
+  for (int i = 0; i < NbIncoming; ++i) {
+    MPI_Status Status;
+    Common::CheckMPIStatus(MPI_Probe (MPI_ANY_SOURCE, Tag, _Communicator, &Status));
+    
+    int Count = 0;
+    MPI_Get_count (&Status, IndexMPIType, &Count);
+    
+    vector<IndexType>& Buf = RecvBufs[Status.MPI_SOURCE];
+    Buf.resize(Count);
+    Common::CheckMPIStatus(MPI_Recv (Count > 0 ? &Buf[0] : &dummy, Count, IndexMPIType,
+				     Status.MPI_SOURCE, Tag, _Communicator,
+				     MPI_STATUS_IGNORE));
+  }
+  
+  if (!Requests.empty()) {
+    Common::CheckMPIStatus(MPI_Waitall ((int)Requests.size(), &Requests[0], 
+					MPI_STATUSES_IGNORE));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename DATA>
+void MPICommPattern<DATA>::BuildGhostMapRendezvous()
+{ 
+  CFLog(VERBOSE, "MPICommPattern<DATA>::BuildGhostMapRendezvous() => start\n");
+  
+  using namespace std;
+  
+  cf_assert (_InitMPIOK);
+  cf_assert (_GhostSendList.size()==static_cast<CFuint>(_CommSize));
+  cf_assert (_GhostReceiveList.size()==static_cast<CFuint>(_CommSize));
+  
+  typedef map<int, vector<IndexType> > RankBuffers;
+  typedef typename RankBuffers::const_iterator BufIter;
+  
+  for (int j=0; j<_CommSize; j++) {
+    _GhostSendList[j].clear();
+    _GhostReceiveList[j].clear();
+  }
+  
+  // 1) each rank sends to the directory rank of each global ID a message with
+  // the number of IDs it owns there, those owned IDs and the ghost IDs to resolve
+  RankBuffers OwnedToDir;
+  RankBuffers GhostsToDir;
+  for (typename TIndexMap::const_iterator it = _IndexMap.begin(); it != _IndexMap.end(); ++it) {
+    OwnedToDir[it->first % _CommSize].push_back(it->first);
+  }
+  for (typename TGhostMap::const_iterator it = _GhostMap.begin(); it != _GhostMap.end(); ++it) {
+    GhostsToDir[it->first % _CommSize].push_back(it->first);
+  }
+  
+  RankBuffers ToDir;
+  for (BufIter it = OwnedToDir.begin(); it != OwnedToDir.end(); ++it) {
+    vector<IndexType>& Buf = ToDir[it->first];
+    Buf.push_back(it->second.size());
+    Buf.insert(Buf.end(), it->second.begin(), it->second.end());
+  }
+  for (BufIter it = GhostsToDir.begin(); it != GhostsToDir.end(); ++it) {
+    vector<IndexType>& Buf = ToDir[it->first];
+    if (Buf.empty()) Buf.push_back(0);
+    Buf.insert(Buf.end(), it->second.begin(), it->second.end());
+  }
+  
+  RankBuffers FromRanks;
+  Sync_SparseExchange(ToDir, _MPI_TAG_RENDEZVOUS, false, FromRanks);
+  
+  CFLog(VERBOSE, "MPICommPattern<DATA>::BuildGhostMapRendezvous() => 1\n");
+  
+  // 2) the directory answers each query with the owner ranks, in the same order
+  vector<pair<IndexType, IndexType> > Directory;
+  for (BufIter it = FromRanks.begin(); it != FromRanks.end(); ++it) {
+    const IndexType NbOwned = it->second[0];
+    for (IndexType i = 1; i <= NbOwned; ++i) {
+      Directory.push_back(pair<IndexType, IndexType>(it->second[i], it->first));
+    }
+  }
+  sort(Directory.begin(), Directory.end());
+  
+  RankBuffers Owners;
+  for (BufIter it = FromRanks.begin(); it != FromRanks.end(); ++it) {
+    vector<IndexType>& Reply = Owners[it->first];
+    const IndexType Start = it->second[0] + 1;
+    for (IndexType i = Start; i < it->second.size(); ++i) {
+      const IndexType GlobalID = it->second[i];
+      typename vector<pair<IndexType, IndexType> >::const_iterator Found = 
+	lower_bound(Directory.begin(), Directory.end(), pair<IndexType, IndexType>(GlobalID, 0));
+      if (Found == Directory.end() || Found->first != GlobalID) {
+	std::ostringstream S;
+	S << "MPICommPattern<DATA>::BuildGhostMapRendezvous() => ghost element "
+	  << GlobalID << " is not owned by any rank\n";
+	throw NotFoundException(FromHere(), S.str().c_str());
+      }
+      Reply.push_back(Found->second);
+    }
+  }
+  
+  RankBuffers FromDir;
+  for (BufIter it = ToDir.begin(); it != ToDir.end(); ++it) {
+    FromDir[it->first];
+  }
+  Sync_SparseExchange(Owners, _MPI_TAG_RENDEZVOUS+1, true, FromDir);
+  
+  CFLog(VERBOSE, "MPICommPattern<DATA>::BuildGhostMapRendezvous() => 2\n");
+  
+  // 3) each rank asks its donors for the ghosts, ordered by donor and global ID
+  vector<pair<IndexType, IndexType> > Donor2Ghost;
+  Donor2Ghost.reserve(_GhostMap.size());
+  for (BufIter it = GhostsToDir.begin(); it != GhostsToDir.end(); ++it) {
+    const vector<IndexType>& Reply = FromDir[it->first];
+    cf_assert(Reply.size() == it->second.size());
+    for (CFuint i = 0; i < Reply.size(); ++i) {
+      cf_assert(Reply[i] != static_cast<IndexType>(_CommRank));
+      Donor2Ghost.push_back(pair<IndexType, IndexType>(Reply[i], it->second[i]));
+    }
+  }
+  sort(Donor2Ghost.begin(), Donor2Ghost.end());
+  
+  RankBuffers ToDonor;
+  for (CFuint i = 0; i < Donor2Ghost.size(); ++i) {
+    const int Donor = Donor2Ghost[i].first;
+    const IndexType GlobalID = Donor2Ghost[i].second;
+    ToDonor[Donor].push_back(GlobalID);
+    _GhostReceiveList[Donor].push_back(_GhostMap.find(GlobalID)->second);
+  }
+  
+  RankBuffers FromReceivers;
+  Sync_SparseExchange(ToDonor, _MPI_TAG_RENDEZVOUS+2, false, FromReceivers);
+  
+  for (BufIter it = FromReceivers.begin(); it != FromReceivers.end(); ++it) {
+    for (CFuint i = 0; i < it->second.size(); ++i) {
+      typename TIndexMap::const_iterator Iter = _IndexMap.find(it->second[i]);
+      cf_assert(Iter != _IndexMap.end());
+      _GhostSendList[it->first].push_back(Iter->second);
+    }
+  }
+  
+  CFLog(VERBOSE, "MPICommPattern<DATA>::BuildGhostMapRendezvous() => 3\n");
+  
+  // datatypes for BeginSync() and buffers for synchronize()
+  Sync_BuildSendTypes();
+  Sync_BuildReceiveTypes();
+  
+  const CFuint elemsize = _ElementSize/sizeof(T);
+  m_sendCount.assign(_CommSize, 0);
+  m_recvCount.assign(_CommSize, 0);
+  m_sendDispl.assign(_CommSize, 0);
+  m_recvDispl.assign(_CommSize, 0);
+  m_sendLocalIDs.clear();
+  m_recvLocalIDs.clear();
+  for (int i = 0; i < _CommSize; ++i) {
+    m_sendDispl[i] = m_sendLocalIDs.size()*elemsize;
+    m_recvDispl[i] = m_recvLocalIDs.size()*elemsize;
+    m_sendCount[i] = _GhostSendList[i].size()*elemsize;
+    m_recvCount[i] = _GhostReceiveList[i].size()*elemsize;
+    m_sendLocalIDs.insert(m_sendLocalIDs.end(), _GhostSendList[i].begin(), _GhostSendList[i].end());
+    m_recvLocalIDs.insert(m_recvLocalIDs.end(), _GhostReceiveList[i].begin(), _GhostReceiveList[i].end());
+  }
+  
+  CFLog(DEBUG_MIN, CFPrintContainer<vector<int> >("sendCount  = ", &m_sendCount));
+  CFLog(DEBUG_MIN, CFPrintContainer<vector<int> >("recvCount  = ", &m_recvCount));
+  
+#ifdef CF_ENABLE_PARALLEL_DEBUG
+  WriteCommPattern ();
+#endif
+  
+  CFLog(VERBOSE, "MPICommPattern<DATA>::BuildGhostMapRendezvous() => end\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <typename DATA>
 void MPICommPattern<DATA>::BuildGhostMapOld()
 { 
@@ -33,10 +33,17 @@ static void ThrowMPI (MPI_Comm * Comm, int * Error, ...)
 PEInterface<PM_MPI>::PEInterface (int * argc, char *** args)
   : InitOK_(false), StopCalled_(false)
 {
-  CheckMPIStatus(MPI_Init (argc, args));
+  // the workers of the ThreadPool never call MPI, so FUNNELED is enough
+  int provided = MPI_THREAD_SINGLE;
+  CheckMPIStatus(MPI_Init_thread (argc, args, MPI_THREAD_FUNNELED, &provided));
   
   InitOK_ = true;
   
+  if (provided < MPI_THREAD_FUNNELED) {
+    CFLog(WARN, "PEInterface<PM_MPI> => MPI_THREAD_FUNNELED is not supported,"
+	  << " running with one thread per rank\n");
+  }
+  
   CallInitFunctions ();
 }
       
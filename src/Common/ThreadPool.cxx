@@ -0,0 +1,286 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "Common/ThreadPool.hh"
+#include "Common/ParallelException.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Common {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// ID of the calling thread, unset for the main thread
+static boost::thread_specific_ptr<CFuint> s_threadID;
+
+//////////////////////////////////////////////////////////////////////////////
+
+ThreadPool& ThreadPool::getInstance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool() :
+  m_slots(),
+  m_workers(),
+  m_mutex(),
+  m_start(),
+  m_done(),
+  m_generation(0),
+  m_nbBusy(0),
+  m_shutdown(false),
+  m_running(false),
+  m_task(CFNULL),
+  m_grain(1),
+  m_error()
+{
+  m_slots.push_back(new Slot());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ThreadPool::~ThreadPool()
+{
+  resize(1);
+  delete m_slots[0];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint ThreadPool::getDefaultNbThreads()
+{
+  const char* vars[2] = {"CF_NUM_THREADS", "OMP_NUM_THREADS"};
+  for (CFuint i = 0; i < 2; ++i) {
+    const char* value = getenv(vars[i]);
+    if (value != CFNULL && atoi(value) > 0) {
+      return static_cast<CFuint>(atoi(value));
+    }
+  }
+  return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint ThreadPool::getThreadID()
+{
+  const CFuint* id = s_threadID.get();
+  return (id != CFNULL) ? *id : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::resize(CFuint nbThreads)
+{
+  cf_assert(!m_running);
+  cf_assert(getThreadID() == 0);
+
+  nbThreads = std::max<CFuint>(nbThreads, 1);
+  if (nbThreads == m_slots.size()) return;
+
+  // join the current workers
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_start.notify_all();
+  for (CFuint i = 0; i < m_workers.size(); ++i) {
+    m_workers[i]->join();
+    delete m_workers[i];
+  }
+  m_workers.clear();
+  m_shutdown = false;
+
+  // the slot of the main thread is kept with its scratch memory
+  for (CFuint i = 1; i < m_slots.size(); ++i) {
+    delete m_slots[i];
+  }
+  m_slots.resize(1);
+
+  for (CFuint i = 1; i < nbThreads; ++i) {
+    m_slots.push_back(new Slot());
+  }
+  for (CFuint i = 1; i < nbThreads; ++i) {
+    m_workers.push_back
+      (new boost::thread(boost::bind(&ThreadPool::workerLoop, this, i, m_generation)));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+char* ThreadPool::getScratch(CFuint threadID, size_t nbBytes)
+{
+  cf_assert(threadID < m_slots.size());
+  vector<char>& scratch = m_slots[threadID]->scratch;
+  if (scratch.size() < std::max<size_t>(nbBytes, 1)) {
+    scratch.resize(std::max<size_t>(nbBytes, 1));
+  }
+  return &scratch[0];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::run(CFuint begin, CFuint end, CFuint grain, const Task& task)
+{
+  if (begin >= end) return;
+
+  const CFuint nbThreads = m_slots.size();
+  const CFuint threadID = getThreadID();
+  if (nbThreads < 2 || threadID != 0 || m_running) {
+    task(begin, end, threadID);
+    return;
+  }
+
+  // one contiguous block per thread
+  const unsigned long long size = end - begin;
+  for (CFuint i = 0; i < nbThreads; ++i) {
+    m_slots[i]->first = begin + static_cast<CFuint>(size*i/nbThreads);
+    m_slots[i]->end   = begin + static_cast<CFuint>(size*(i+1)/nbThreads);
+  }
+
+  m_task  = &task;
+  m_grain = (grain > 0) ? grain : std::max<CFuint>(size/(8*nbThreads), 1);
+  m_error.clear();
+  m_running = true;
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_nbBusy = nbThreads - 1;
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  work(0);
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (m_nbBusy > 0) {
+      m_done.wait(lock);
+    }
+  }
+
+  m_running = false;
+  m_task = CFNULL;
+
+  if (!m_error.empty()) {
+    throw ParallelException (FromHere(), "ThreadPool::parallelFor() => " + m_error);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::workerLoop(CFuint threadID, CFuint generation)
+{
+  s_threadID.reset(new CFuint(threadID));
+
+  for (;;) {
+    {
+      boost::mutex::scoped_lock lock(m_mutex);
+      while (!m_shutdown && m_generation == generation) {
+	m_start.wait(lock);
+      }
+      if (m_shutdown) return;
+      generation = m_generation;
+    }
+
+    work(threadID);
+
+    {
+      boost::mutex::scoped_lock lock(m_mutex);
+      if (--m_nbBusy == 0) m_done.notify_one();
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::work(CFuint threadID)
+{
+  try {
+    CFuint first = 0;
+    CFuint end = 0;
+    while (nextChunk(threadID, first, end)) {
+      (*m_task)(first, end, threadID);
+    }
+  }
+  catch (std::exception& e) {
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_error.empty()) m_error = e.what();
+  }
+  catch (...) {
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_error.empty()) m_error = "unknown exception";
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool ThreadPool::nextChunk(CFuint threadID, CFuint& first, CFuint& end)
+{
+  Slot& own = *m_slots[threadID];
+  {
+    boost::mutex::scoped_lock lock(own.mutex);
+    if (own.first < own.end) {
+      first = own.first;
+      end = std::min(own.first + m_grain, own.end);
+      own.first = end;
+      return true;
+    }
+  }
+
+  // steal the upper half of the first non empty block, starting from the
+  // next thread; the victim is released before touching the own block, so
+  // that two threads stealing from each other cannot deadlock
+  const CFuint nbThreads = m_slots.size();
+  for (CFuint i = 1; i < nbThreads; ++i) {
+    Slot& victim = *m_slots[(threadID + i) % nbThreads];
+    CFuint stolenFirst = 0;
+    CFuint stolenEnd = 0;
+    {
+      boost::mutex::scoped_lock lock(victim.mutex);
+      const CFuint left = victim.end - victim.first;
+      if (left == 0) continue;
+
+      stolenFirst = (left <= m_grain) ? victim.first : victim.first + left/2;
+      stolenEnd = victim.end;
+      victim.end = stolenFirst;
+    }
+
+    first = stolenFirst;
+    end = std::min(stolenFirst + m_grain, stolenEnd);
+    if (end < stolenEnd) {
+      boost::mutex::scoped_lock lock(own.mutex);
+      own.first = end;
+      own.end = stolenEnd;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Common
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_Common_ThreadPool_hh
+#define COOLFluiD_Common_ThreadPool_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "Common/NonCopyable.hh"
+#include "Common/COOLFluiD.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace boost { class thread; }
+
+namespace COOLFluiD {
+
+  namespace Common {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class is the pool of threads owned by each MPI rank.
+/// The calling (main) thread always takes part to the work as thread 0, so a
+/// pool of N threads spawns N-1 workers. A parallelFor() splits the index
+/// range in one contiguous block per thread, which is consumed in chunks of
+/// "grain" indices; a thread running out of work steals the upper half of
+/// the remaining block of another thread.
+/// The workers never call MPI, which keeps the MPI_THREAD_FUNNELED level
+/// requested by PEInterface<PM_MPI> sufficient.
+class Common_API ThreadPool : public Common::NonCopyable<ThreadPool> {
+public:
+
+  /// Type of the task run on a chunk: (first index, end index, thread ID)
+  typedef boost::function<void (CFuint, CFuint, CFuint)> Task;
+
+  /// @return the instance of this singleton
+  static ThreadPool& getInstance();
+
+  /// Default number of threads: CF_NUM_THREADS or else OMP_NUM_THREADS
+  /// from the environment, 1 if none is set
+  static CFuint getDefaultNbThreads();
+
+  /// @return the ID of the calling thread in the pool (0 for the main thread)
+  static CFuint getThreadID();
+
+  /// Resize the pool, joining or spawning the workers
+  /// @pre it is called by the main thread, out of any parallelFor()
+  void resize(CFuint nbThreads);
+
+  /// @return the number of threads, main thread included
+  CFuint getNbThreads() const { return m_slots.size(); }
+
+  /// Apply functor(first, end, threadID) to chunks covering [begin, end).
+  /// Nested calls and calls from a pool of one thread run serially.
+  /// @param grain number of indices per chunk (0 means automatic)
+  template <typename FUNCTOR>
+  void parallelFor(const CFuint begin, const CFuint end, FUNCTOR& functor,
+		   const CFuint grain = 0)
+  {
+    run(begin, end, grain, Task(boost::ref(functor)));
+  }
+
+  /// Scratch memory private to a thread, kept between calls
+  /// @param threadID ID of the calling thread
+  /// @param nbBytes  minimum size of the buffer
+  char* getScratch(CFuint threadID, size_t nbBytes);
+
+  /// Typed scratch memory private to a thread
+  /// @param threadID ID of the calling thread
+  /// @param size     minimum number of entries
+  template <typename T>
+  T* getScratch(CFuint threadID, size_t size)
+  {
+    return reinterpret_cast<T*>(getScratch(threadID, size*sizeof(T)));
+  }
+
+private: // helper classes
+
+  /// Block of indices owned by a thread, padded to its own cache line
+  struct Slot {
+    Slot() : first(0), end(0) {}
+
+    boost::mutex mutex;
+    CFuint first;
+    CFuint end;
+    std::vector<char> scratch;
+    char padding[64];
+  };
+
+private: // methods
+
+  /// Constructor
+  ThreadPool();
+
+  /// Destructor
+  ~ThreadPool();
+
+  /// Run the task over [begin, end)
+  void run(CFuint begin, CFuint end, CFuint grain, const Task& task);
+
+  /// Main loop of a worker
+  /// @param generation value of m_generation when the worker was spawned
+  void workerLoop(CFuint threadID, CFuint generation);
+
+  /// Consume the own block of indices, then steal from the others
+  void work(CFuint threadID);
+
+  /// Take the next chunk of the given thread, stealing if needed
+  /// @return false if no work is left in the pool
+  bool nextChunk(CFuint threadID, CFuint& first, CFuint& end);
+
+private: // data
+
+  /// blocks of indices, one per thread
+  std::vector<Slot*> m_slots;
+
+  /// worker threads (the main thread is not stored)
+  std::vector<boost::thread*> m_workers;
+
+  /// protects the fields below
+  boost::mutex m_mutex;
+
+  /// wakes up the workers
+  boost::condition_variable m_start;
+
+  /// wakes up the main thread
+  boost::condition_variable m_done;
+
+  /// incremented by each parallelFor()
+  CFuint m_generation;
+
+  /// number of workers still busy in the current parallelFor()
+  CFuint m_nbBusy;
+
+  /// workers must exit
+  bool m_shutdown;
+
+  /// a parallelFor() is running
+  bool m_running;
+
+  /// the current task
+  const Task* m_task;
+
+  /// chunk size of the current task
+  CFuint m_grain;
+
+  /// message of the first exception thrown by a task
+  std::string m_error;
+
+}; // end of class ThreadPool
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Common
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Common_ThreadPool_hh
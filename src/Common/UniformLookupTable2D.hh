@@ -0,0 +1,209 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_Common_UniformLookupTable2D_hh
+#define COOLFluiD_Common_UniformLookupTable2D_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "Common/COOLFluiD.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Common {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class represents a table of values on a structured grid whose keys
+/// are uniformly spaced, either in the keys themselves or in their logarithm
+/// (geometric spacing). Unlike LookupTable2D, the cell containing a pair of
+/// keys is found in O(1) and values can be interpolated either with the
+/// bilinear shape functions or with monotone bicubic Hermite polynomials.
+/// The values can be saved to a binary cache file and mapped back in memory
+/// to avoid computing them again.
+/// The values are stored by variable and then by key2 and key1, so that the
+/// batched get() interpolates one variable from contiguous memory.
+/// @author Andrea Lani
+template <class VALUE>
+class UniformLookupTable2D {
+
+public:
+
+  /// Constructor
+  UniformLookupTable2D();
+
+  /// Default destructor
+  ~UniformLookupTable2D();
+
+  /// Initialize the table by reserving memory and setting the axes
+  /// @param key1Min     first key1
+  /// @param key1Max     last key1
+  /// @param nbKeys1     number of key1s (>= 2)
+  /// @param logKey1     flag telling if key1s are geometrically spaced
+  /// @param key2Min     first key2
+  /// @param key2Max     last key2
+  /// @param nbKeys2     number of key2s (>= 2)
+  /// @param logKey2     flag telling if key2s are geometrically spaced
+  /// @param valueStride stride for the value (that is
+  ///                    logically an array of values)
+  void initialize(const VALUE key1Min, const VALUE key1Max,
+		  const size_t nbKeys1, const bool logKey1,
+		  const VALUE key2Min, const VALUE key2Max,
+		  const size_t nbKeys2, const bool logKey2,
+		  const size_t valueStride);
+
+  /// Use the monotone bicubic interpolation instead of the bilinear one
+  void setCubic(const bool cubic) {_cubic = cubic;}
+
+  /// @return the number of key1s
+  size_t getNbKeys1() const {return _nbKeys[0];}
+
+  /// @return the number of key2s
+  size_t getNbKeys2() const {return _nbKeys[1];}
+
+  /// @return the key1 of index i1
+  VALUE getKey1(const size_t i1) const {return getKey(0, i1);}
+
+  /// @return the key2 of index i2
+  VALUE getKey2(const size_t i2) const {return getKey(1, i2);}
+
+  /// Inserts a VALUE at the grid point of indices (i1, i2)
+  void insert(const size_t i1, const size_t i2,
+	      const size_t iValue, const VALUE& value);
+
+  /// Gets the interpolated VALUE of the supplied keys
+  /// Keys outside the table are moved to its boundary.
+  VALUE get(const VALUE key1, const VALUE key2, const size_t iValue) const;
+
+  /// Gets the interpolated VALUEs of n pairs of keys
+  /// @param out        output array, out[i*outStride] receiving the i-th value
+  void get(const size_t n, const VALUE* key1, const VALUE* key2,
+	   const size_t iValue, VALUE* out, const size_t outStride = 1) const;
+
+  /// Write the table in a binary cache file
+  /// @param signature  string identifying the tabulated data (mixture, model, ...)
+  /// @return false if the file could not be written
+  bool writeCache(const std::string& fileName, const std::string& signature) const;
+
+  /// Read the table from a binary cache file, mapping it in memory if possible
+  /// @param signature  string that must match the one of writeCache()
+  /// @return false if the file is missing or has been written for another table
+  bool readCache(const std::string& fileName, const std::string& signature);
+
+private:
+
+  /// Copy constructor is not allowed (the values can be mapped in memory)
+  UniformLookupTable2D(const UniformLookupTable2D&);
+
+  /// Assignment operator is not allowed
+  const UniformLookupTable2D& operator= (const UniformLookupTable2D&);
+
+  /// @return the key of the given index along the given axis
+  VALUE getKey(const size_t axis, const size_t idx) const;
+
+  /// Compute the cell index and the local coordinate in [0,1] of a key
+  void getCell(const size_t axis, const VALUE key, size_t& idx, VALUE& t) const
+  {
+    const VALUE x = (_log[axis]) ? std::log(key) : key;
+    VALUE s = (x - _min[axis])*_invDelta[axis];
+    s = std::max(s, static_cast<VALUE>(0.));
+    s = std::min(s, static_cast<VALUE>(_nbKeys[axis] - 1));
+    idx = std::min(static_cast<size_t>(s), _nbKeys[axis] - 2);
+    t = s - idx;
+  }
+
+  /// @return the bilinear interpolation in the cell (i1, i2)
+  VALUE bilinear(const VALUE *const values, const size_t i1, const size_t i2,
+		 const VALUE t1, const VALUE t2) const
+  {
+    const VALUE *const v = &values[i1 + i2*_nbKeys[0]];
+    const VALUE *const vUp = v + _nbKeys[0];
+    return (1. - t2)*((1. - t1)*v[0] + t1*v[1]) + t2*((1. - t1)*vUp[0] + t1*vUp[1]);
+  }
+
+  /// @return the monotone bicubic interpolation in the cell (i1, i2)
+  VALUE bicubic(const VALUE *const values, const size_t i1, const size_t i2,
+		const VALUE t1, const VALUE t2) const;
+
+  /// @return the monotone cubic Hermite interpolation between y0 and y1
+  /// with the slopes of Fritsch and Butland (harmonic mean of the secants)
+  static VALUE hermite(const VALUE ym, const VALUE y0, const VALUE y1,
+		       const VALUE y2, const VALUE t)
+  {
+    const VALUE sm = y0 - ym;
+    const VALUE s0 = y1 - y0;
+    const VALUE s1 = y2 - y1;
+    const VALUE d0 = (sm*s0 > 0.) ? 2.*sm*s0/(sm + s0) : 0.;
+    const VALUE d1 = (s0*s1 > 0.) ? 2.*s0*s1/(s0 + s1) : 0.;
+    const VALUE t2 = t*t;
+    const VALUE t3 = t2*t;
+    return (2.*t3 - 3.*t2 + 1.)*y0 + (t3 - 2.*t2 + t)*d0 +
+      (3.*t2 - 2.*t3)*y1 + (t3 - t2)*d1;
+  }
+
+  /// release the values mapped in memory
+  void unmap();
+
+private:
+
+  /// flag checking if the table is initialized
+  bool _isInitialized;
+
+  /// flag telling to use the monotone bicubic interpolation
+  bool _cubic;
+
+  /// stride of the value array
+  size_t _valueStride;
+
+  /// number of keys along each axis
+  size_t _nbKeys[2];
+
+  /// flag telling if the keys are geometrically spaced along each axis
+  bool _log[2];
+
+  /// first key (or its logarithm) along each axis
+  VALUE _min[2];
+
+  /// spacing of the keys (or of their logarithms) along each axis
+  VALUE _delta[2];
+
+  /// inverse of the spacing
+  VALUE _invDelta[2];
+
+  /// storage of the values when they are not mapped in memory
+  std::vector<VALUE> _values;
+
+  /// values in use (either in _values or in the mapped file)
+  const VALUE* _data;
+
+  /// start of the mapped file
+  void* _mapped;
+
+  /// size of the mapped file
+  size_t _mappedSize;
+
+}; // end of class UniformLookupTable2D
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Common
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include "UniformLookupTable2D.ci"
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Common_UniformLookupTable2D_hh
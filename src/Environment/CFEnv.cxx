@@ -22,6 +22,7 @@
 #include "Common/SignalHandler.hh"
 #include "Common/OSystem.hh"
 #include "Common/FactoryRegistry.hh"
+#include "Common/ThreadPool.hh"
 
 #include "Environment/SingleBehaviorFactory.hh"
 #include "Environment/DirPaths.hh"
@@ -73,7 +74,8 @@ void CFEnv::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< bool >    ("ErrorOnUnusedConfig","Signal error when some user provided config parameters are not used");
   options.addConfigOption< std::string >("MainLoggerFileName", "Name of main log file");
   options.addConfigOption< CFuint >("NbWriters", "Number of writing processes in parallel I/O");
-  options.addConfigOption< std::string >("SyncAlgo", "Choose the synchronization algorithm (Old, Bcast, AllToAll");
+  options.addConfigOption< CFuint >("NbThreads", "Number of threads per process (0 means CF_NUM_THREADS or OMP_NUM_THREADS)");
+  options.addConfigOption< std::string >("SyncAlgo", "Choose the synchronization algorithm (Old, Bcast, AllToAll, Rendezvous)");
 }
     
 //////////////////////////////////////////////////////////////////////////////
@@ -104,6 +106,7 @@ CFEnv::CFEnv() :
   setParameter("MainLoggerFileName",    &(m_env_vars->MainLoggerFileName));
   setParameter("ExceptionLogLevel",     &(m_env_vars->ExceptionLogLevel));
   setParameter("NbWriters",     &(m_env_vars->NbWriters));
+  setParameter("NbThreads",     &(m_env_vars->NbThreads));
   setParameter("SyncAlgo",   &(m_env_vars->SyncAlgo));
 }
 
@@ -129,6 +132,16 @@ void CFEnv::configure ( Config::ConfigArgs& args )
   CFLog(VERBOSE, "Configuring Logging ... \n");
   initLoggers();
   CFLog(VERBOSE, "OK\n");
+  
+  CFuint nbThreads = (m_env_vars->NbThreads > 0) ?
+    m_env_vars->NbThreads : ThreadPool::getDefaultNbThreads();
+#ifdef CF_HAVE_MPI
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&provided);
+  if (provided < MPI_THREAD_FUNNELED) nbThreads = 1;
+#endif
+  CFLog(VERBOSE, "Configuring ThreadPool with " << nbThreads << " threads\n");
+  ThreadPool::getInstance().resize(nbThreads);
 
   // clean the config.log file
  /* boost::filesystem::path fileconfig =
@@ -165,6 +178,8 @@ void CFEnv::setup()
 
 void CFEnv::unsetup()
 {
+  ThreadPool::getInstance().resize(1);
+  
   SetupObject::unsetup();
 }
 
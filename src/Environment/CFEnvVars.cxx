@@ -33,6 +33,7 @@ CFEnvVars::CFEnvVars() :
   InitArgs.first  = 0;
   InitArgs.second = CFNULL;
   NbWriters = 1;
+  NbThreads = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -57,6 +57,8 @@ class Environment_API CFEnvVars : public Common::NonCopyable<CFEnvVars>
     std::pair<int,char**> InitArgs;
     /// number of writing processes in parallel I/O
     CFuint NbWriters;
+    /// number of threads per process (0 means from the environment)
+    CFuint NbThreads;
         
 }; // end class CFEnvVars
 
@@ -156,6 +156,13 @@ template <class BASE>
 Common::SafePtr< typename BASE::PROVIDER >
 Factory<BASE>::getProvider(const std::string& providerName)
 {
+  if (!exists(providerName))
+  {
+    // the provider may be defined in a module which is not loaded yet
+    Environment::CFEnv::getInstance().getFactoryRegistry()->loadMissingProvider
+      (BASE::getClassName(), providerName);
+  }
+  
   if (!exists(providerName))
   {
     throw Common::NoSuchValueException (FromHere(),
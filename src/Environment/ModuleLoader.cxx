@@ -4,9 +4,20 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <boost/filesystem/operations.hpp>
+
 #include "Common/MemFunArg.hh"
 #include "Common/OSystem.hh"
 #include "Common/LibLoader.hh"
+#include "Common/PE.hh"
+#include "Common/FactoryRegistry.hh"
+#include "Common/FactoryBase.hh"
+#include "Common/ProviderBase.hh"
 
 #include "Environment/DirPaths.hh"
 #include "Environment/CFEnv.hh"
@@ -30,21 +41,40 @@ namespace COOLFluiD {
 void ModuleLoader::defineConfigOptions(Config::OptionList& options)
 {
    options.addConfigOption< std::vector<std::string> >("Libs","Module libraries to load.");
+   options.addConfigOption< bool >("LazyLoading","Load only the libraries providing objects named in the configuration, the other ones being loaded when one of their providers is requested.");
+   options.addConfigOption< std::string >("IndexFile","File mapping each library to its providers, relative to the first modules dir. Built by the first run with LazyLoading if missing or out of date.");
+   options.addConfigOption< std::string >("StageDir","Node-local directory where the libraries are copied before loading (only with LazyLoading).");
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 ModuleLoader::ModuleLoader() : ConfigObject("Modules"),
-  m_moduleNames()
+  m_moduleNames(),
+  m_configWords(),
+  m_index(),
+  m_providerModules(),
+  m_allLoaded(false)
 {
    addConfigOptionsTo(this);
    setParameter("Libs",&m_moduleNames);
+   
+   m_lazyLoading = false;
+   setParameter("LazyLoading",&m_lazyLoading);
+   
+   m_indexFileName = "CFmodules.index";
+   setParameter("IndexFile",&m_indexFileName);
+   
+   m_stageDir = "";
+   setParameter("StageDir",&m_stageDir);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 ModuleLoader::~ModuleLoader()
 {
+  if (m_lazyLoading) {
+    CFEnv::getInstance().getFactoryRegistry()->setMissingProviderHandler(CFNULL);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -60,38 +90,339 @@ void ModuleLoader::loadExternalModules()
 {
   std::vector< boost::filesystem::path > paths =  Environment::DirPaths::getInstance().getModulesDir();
 
-  setSearchPaths(paths);
-
   // attempt to load all modules from the list
-  if( !m_moduleNames.empty() )
+  if( m_moduleNames.empty() )
+  {
+    setSearchPaths(paths);
+    CFLog(NOTICE,"ModuleLoader: No external modules loaded\n");
+  }
+  else if ( !m_lazyLoading )
   {
+    setSearchPaths(paths);
     std::for_each( m_moduleNames.begin(), m_moduleNames.end(), mem_fun_arg(*this,(&ModuleLoader::loadModule)) );
   }
+  else if ( !readIndex(paths) )
+  {
+    // first run: everything is loaded and the index is built for the next ones
+    setSearchPaths(paths);
+    loadAllModulesAndBuildIndex();
+  }
   else
   {
-    CFLog(NOTICE,"ModuleLoader: No external modules loaded\n");
+    std::vector<std::string> mods = selectNeededModules();
+    CFLog(NOTICE,"ModuleLoader: loading " << mods.size() << " out of " 
+	  << m_moduleNames.size() << " modules\n");
+    
+    if ( !m_stageDir.empty() ) { stageModules(mods, paths); }
+    
+    setSearchPaths(paths);
+    std::for_each( mods.begin(), mods.end(), mem_fun_arg(*this,(&ModuleLoader::loadModule)) );
+    
+    // the other modules are loaded when one of their providers is requested,
+    // e.g. because it is the default value of an option
+    CFEnv::getInstance().getFactoryRegistry()->setMissingProviderHandler(this);
   }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void ModuleLoader::loadModule(const std::string& mod)
+std::string ModuleLoader::getModuleName(const std::string& mod) const
+{
+  // we assume that library name is the same as the module being loaded
+  // with the lib prefix stripped out
+  return (Common::StringOps::startsWith(mod,"lib")) ? std::string(mod,3) : mod;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+boost::filesystem::path 
+ModuleLoader::findLibrary(const std::string& mod,
+			  const std::vector< boost::filesystem::path >& paths) const
+{
+  std::string libname = "lib" + getModuleName(mod);
+#ifdef CF_OS_LINUX
+  libname += ".so";
+#endif
+#ifdef CF_OS_MACOSX
+  libname += ".dylib";
+#endif
+#ifdef CF_OS_WINDOWS
+  libname += ".dll";		
+#endif
+  
+  for (CFuint ip = 0; ip < paths.size(); ++ip) {
+    const boost::filesystem::path file = paths[ip] / libname;
+    if (boost::filesystem::exists(file)) return file;
+  }
+  return boost::filesystem::path();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+boost::filesystem::path ModuleLoader::getIndexFilePath() const
+{
+  using namespace boost::filesystem;
+  
+  path indexFile(m_indexFileName);
+  if (indexFile.is_complete()) return indexFile;
+  
+  const std::vector< path > paths = Environment::DirPaths::getInstance().getModulesDir();
+  return (!paths.empty()) ? paths[0] / indexFile : 
+    Environment::DirPaths::getInstance().getWorkingDir() / indexFile;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool ModuleLoader::readIndex(const std::vector< boost::filesystem::path >& paths)
 {
   CFAUTOTRACE;
+  
+  const boost::filesystem::path indexFile = getIndexFilePath();
+  ifstream fin(indexFile.string().c_str());
+  if (!fin) {
+    CFLog(NOTICE,"ModuleLoader: index " << indexFile.string() 
+	  << " not found, loading all modules\n");
+    return false;
+  }
+  
+  // each line holds a module name, the modification time and the size of 
+  // its library, followed by the factory:provider pairs it registers
+  m_index.clear();
+  m_providerModules.clear();
+  std::string line;
+  while (getline(fin, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    istringstream iss(line);
+    std::string mod;
+    IndexEntry entry;
+    if (!(iss >> mod >> entry.time >> entry.size)) {
+      CFLog(NOTICE,"ModuleLoader: index " << indexFile.string() 
+	    << " has an old format, loading all modules\n");
+      return false;
+    }
+    std::string pair;
+    while (iss >> pair) {
+      const std::string::size_type colon = pair.find(':');
+      if (colon == std::string::npos) continue;
+      entry.providers.push_back(make_pair(pair.substr(0, colon), pair.substr(colon + 1)));
+      m_providerModules[entry.providers.back()] = mod;
+    }
+    m_index[mod] = entry;
+  }
+  
+  // the index is rebuilt if any library has been added or modified since
+  for (CFuint im = 0; im < m_moduleNames.size(); ++im) {
+    const std::string lmod = getModuleName(m_moduleNames[im]);
+    std::map<std::string, IndexEntry>::const_iterator it = m_index.find(lmod);
+    const boost::filesystem::path lib = findLibrary(lmod, paths);
+    if (it == m_index.end() || lib.empty() ||
+	boost::filesystem::last_write_time(lib) != it->second.time ||
+	boost::filesystem::file_size(lib) != it->second.size) {
+      CFLog(NOTICE,"ModuleLoader: index " << indexFile.string() << " is out of date for module "
+	    << lmod << ", loading all modules\n");
+      return false;
+    }
+  }
+  
+  return true;
+}
 
-  cf_assert( OSystem::getInstance().getLibLoader().isNotNull() );
+//////////////////////////////////////////////////////////////////////////////
 
-  // we assume that library name is the same as the module being loaded
-  // with the lib prefix stripped out
-  std::string lmod;
-  if (Common::StringOps::startsWith(mod,"lib"))
-  {
-    lmod = std::string(mod,3); // create a copy without the first 3 letters
+void ModuleLoader::loadAllModulesAndBuildIndex()
+{
+  CFAUTOTRACE;
+  
+#ifndef CF_HAVE_SINGLE_EXEC
+  SafePtr<FactoryRegistry> registry = CFEnv::getInstance().getFactoryRegistry();
+  const std::vector< boost::filesystem::path > paths = 
+    Environment::DirPaths::getInstance().getModulesDir();
+  
+  // the providers are recorded as the difference between the providers 
+  // registered before and after loading each module: a dependency is 
+  // therefore indexed under the first module that pulls it in
+  m_index.clear();
+  typedef std::pair<std::string, std::string> FactoryProvider;
+  std::set<FactoryProvider> known;
+  for (CFuint im = 0; im <= m_moduleNames.size(); ++im) {
+    std::set<FactoryProvider> current;
+    std::vector< SafePtr<FactoryBase> > factories = registry->getAllFactories();
+    for (CFuint f = 0; f < factories.size(); ++f) {
+      const std::string factoryName = factories[f]->getTypeName();
+      std::vector<ProviderBase*> providers = factories[f]->getAllProviders();
+      for (CFuint p = 0; p < providers.size(); ++p) {
+	current.insert(make_pair(factoryName, providers[p]->getProviderName()));
+      }
+    }
+    
+    if (im > 0) {
+      const std::string lmod = getModuleName(m_moduleNames[im-1]);
+      IndexEntry& entry = m_index[lmod];
+      const boost::filesystem::path lib = findLibrary(lmod, paths);
+      entry.time = (!lib.empty()) ? boost::filesystem::last_write_time(lib) : 0;
+      entry.size = (!lib.empty()) ? boost::filesystem::file_size(lib) : 0;
+      std::set_difference(current.begin(), current.end(), known.begin(), known.end(),
+			  std::back_inserter(entry.providers));
+    }
+    known.swap(current);
+    
+    if (im < m_moduleNames.size()) { loadModule(m_moduleNames[im]); }
   }
-  else
-  {
-    lmod = mod;
+  m_allLoaded = true;
+  
+  if (PE::GetPE().GetRank("Default") == 0) {
+    const boost::filesystem::path indexFile = getIndexFilePath();
+    const std::string tmpFile = indexFile.string() + ".tmp";
+    ofstream fout(tmpFile.c_str());
+    if (fout) {
+      fout << "# module library_time library_size factory:provider ...\n";
+      std::map<std::string, IndexEntry>::const_iterator it;
+      for (it = m_index.begin(); it != m_index.end(); ++it) {
+	fout << it->first << " " << it->second.time << " " << it->second.size;
+	for (CFuint p = 0; p < it->second.providers.size(); ++p) { 
+	  fout << " " << it->second.providers[p].first << ":" << it->second.providers[p].second; 
+	}
+	fout << "\n";
+      }
+      fout.close();
+      // the index appears atomically for concurrent runs
+      boost::filesystem::rename(tmpFile, indexFile);
+      CFLog(NOTICE,"ModuleLoader: written index " << indexFile.string() << "\n");
+    }
+    else {
+      CFLog(WARN,"ModuleLoader: cannot write index " << indexFile.string() << "\n");
+    }
+  }
+#else
+  std::for_each( m_moduleNames.begin(), m_moduleNames.end(), mem_fun_arg(*this,(&ModuleLoader::loadModule)) );
+  m_allLoaded = true;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> ModuleLoader::selectNeededModules() const
+{
+  CFAUTOTRACE;
+  
+  // a module is needed if its name appears in the configuration or if the
+  // name of any of its providers does: this may select a few modules too 
+  // many (providers of other factories with the same name), the missing 
+  // ones being loaded on demand by loadMissingProvider()
+  std::vector<std::string> mods;
+  for (CFuint im = 0; im < m_moduleNames.size(); ++im) {
+    const std::string lmod = getModuleName(m_moduleNames[im]);
+    std::map<std::string, IndexEntry>::const_iterator it = m_index.find(lmod);
+    cf_assert(it != m_index.end());
+    bool needed = (m_configWords.count(lmod) > 0);
+    for (CFuint p = 0; !needed && p < it->second.providers.size(); ++p) {
+      needed = (m_configWords.count(it->second.providers[p].second) > 0);
+    }
+    
+    if (needed) {
+      mods.push_back(m_moduleNames[im]);
+    }
+    else {
+      CFLog(VERBOSE,"ModuleLoader: skipping unused module " << lmod << "\n");
+    }
+  }
+  return mods;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ModuleLoader::loadMissingProvider(const std::string& factoryName,
+				       const std::string& providerName)
+{
+  CFAUTOTRACE;
+  
+  if (m_allLoaded) return;
+  
+  std::map< std::pair<std::string, std::string>, std::string >::const_iterator it = 
+    m_providerModules.find(make_pair(factoryName, providerName));
+  if (it != m_providerModules.end() && 
+      !CFEnv::getInstance().getModuleRegistry()->isRegistered(it->second)) {
+    CFLog(NOTICE,"ModuleLoader: loading module " << it->second << " for provider "
+	  << providerName << " of " << factoryName << "\n");
+    loadModule(it->second);
+    return;
+  }
+  
+  // the provider is not indexed (or its module did not register it): 
+  // all the modules are loaded
+  CFLog(NOTICE,"ModuleLoader: provider " << providerName << " of " << factoryName 
+	<< " not found in the index, loading all modules\n");
+  m_allLoaded = true;
+  for (CFuint im = 0; im < m_moduleNames.size(); ++im) {
+    if (!CFEnv::getInstance().getModuleRegistry()->isRegistered(getModuleName(m_moduleNames[im]))) {
+      loadModule(m_moduleNames[im]);
+    }
   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ModuleLoader::stageModules(const std::vector<std::string>& mods, 
+				std::vector< boost::filesystem::path >& paths)
+{
+  CFAUTOTRACE;
+  
+  using namespace boost::filesystem;
+  
+  const path stageDir(m_stageDir);
+  
+  // only one process per node copies the libraries
+  int nodeRank = 0;
+#ifdef CF_HAVE_MPI
+  MPI_Comm nodeComm;
+  MPI_Comm_split_type(PE::GetPE().GetCommunicator("Default"), MPI_COMM_TYPE_SHARED, 
+		      0, MPI_INFO_NULL, &nodeComm);
+  MPI_Comm_rank(nodeComm, &nodeRank);
+#endif
+  
+  bool staged = true;
+  if (nodeRank == 0) {
+    try {
+      create_directories(stageDir);
+      for (CFuint im = 0; im < mods.size(); ++im) {
+	const path from_file = findLibrary(mods[im], paths);
+	if (!from_file.empty()) {
+	  const path to_file = stageDir / from_file.filename();
+	  // reuse the copy staged by a previous run on this node if up to date
+	  if (!exists(to_file) || file_size(to_file) != file_size(from_file) ||
+	      last_write_time(to_file) < last_write_time(from_file)) {
+	    if (exists(to_file)) remove(to_file);
+	    copy_file(from_file, to_file);
+	  }
+	}
+      }
+    }
+    catch (std::exception& e) {
+      CFLog(WARN,"ModuleLoader: staging in " << m_stageDir << " failed: " << e.what() << "\n");
+      staged = false;
+    }
+  }
+  
+#ifdef CF_HAVE_MPI
+  int iStaged = staged;
+  MPI_Bcast(&iStaged, 1, MPI_INT, 0, nodeComm);
+  staged = (iStaged != 0);
+  MPI_Comm_free(&nodeComm);
+#endif
+  
+  // the original paths remain as fallback
+  if (staged) { paths.insert(paths.begin(), stageDir); }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ModuleLoader::loadModule(const std::string& mod)
+{
+  CFAUTOTRACE;
+
+  cf_assert( OSystem::getInstance().getLibLoader().isNotNull() );
+
+  const std::string lmod = getModuleName(mod);
 
   // check if the module has already been loaded
   // if not, then try to load it
@@ -117,6 +448,24 @@ void ModuleLoader::loadModule(const std::string& mod)
 void ModuleLoader::configure ( Config::ConfigArgs& args )
 {
   ConfigObject::configure(args);
+  
+  // collect the words of the whole configuration, i.e. the components of
+  // the keys and the tokens of the values, to find the providers in use
+  m_configWords.clear();
+  if (m_lazyLoading) {
+    for (Config::ConfigArgs::const_iterator it = args.begin(); it != args.end(); ++it) {
+      if (Common::StringOps::endsWith(it->first, "Modules.Libs")) continue;
+      
+      std::string key = it->first;
+      std::replace(key.begin(), key.end(), '.', ' ');
+      istringstream keys(key);
+      std::string word;
+      while (keys >> word) { m_configWords.insert(word); }
+      
+      istringstream values(it->second);
+      while (values >> word) { m_configWords.insert(word); }
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
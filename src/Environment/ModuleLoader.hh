@@ -9,9 +9,15 @@
 
 //////////////////////////////////////////////////////////////////////////////
 
+#include <ctime>
+#include <map>
+#include <set>
+
+#include <boost/cstdint.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include "Common/NonCopyable.hh"
+#include "Common/FactoryRegistry.hh"
 #include "Config/ConfigObject.hh"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -24,9 +30,13 @@ namespace COOLFluiD {
 
 /// This class represents a class that handles
 /// dynamic module loader upon request of the user,
+/// With lazy loading, only the modules whose providers are named in the
+/// configuration are loaded at start, the other ones being loaded when one
+/// of their providers is requested from a factory.
 /// @author Tiago Quintino
 class Environment_API ModuleLoader :
   public Config::ConfigObject,
+  public Common::FactoryRegistry::MissingProviderHandler,
   public Common::NonCopyable<ModuleLoader>   {
 
 public:
@@ -55,15 +65,86 @@ public:
   /// @param mod name of the module to load
   void loadModule(const std::string& mod);
 
+  /// Loads the module registering the given provider, according to the index,
+  /// or all the modules if the provider is not indexed
+  /// @param factoryName  type name of the factory
+  /// @param providerName name of the missing provider
+  virtual void loadMissingProvider(const std::string& factoryName,
+				   const std::string& providerName);
+
   /// Sets the dir search paths
   /// @param paths vector with all paths to search when adding a module
   void setSearchPaths(std::vector< boost::filesystem::path >& paths);
 
+private: // helper functions
+
+  /// Gets the name of the module corresponding to a library name
+  /// @param mod name of the library, with or without the lib prefix
+  std::string getModuleName(const std::string& mod) const;
+  
+  /// Finds the library of a module in the given paths
+  /// @return the path of the library, empty if not found
+  boost::filesystem::path findLibrary(const std::string& mod,
+				      const std::vector< boost::filesystem::path >& paths) const;
+  
+  /// Gets the full path of the index file, which maps every module
+  /// library to the (factory, provider) pairs it registers
+  boost::filesystem::path getIndexFilePath() const;
+  
+  /// Reads the index file
+  /// @param paths the paths where the libraries are searched
+  /// @return false if the index file does not exist or is out of date
+  bool readIndex(const std::vector< boost::filesystem::path >& paths);
+  
+  /// Loads all modules while recording the providers registered by each
+  /// of them, then writes the index file
+  void loadAllModulesAndBuildIndex();
+  
+  /// Selects the modules needed by the current configuration, according
+  /// to the index and to the words found in the configuration arguments
+  std::vector<std::string> selectNeededModules() const;
+  
+  /// Copies the needed libraries into a node-local directory and adds that
+  /// directory in front of the search paths
+  void stageModules(const std::vector<std::string>& mods, 
+		    std::vector< boost::filesystem::path >& paths);
+  
 private: // data
 
+  /// entry of the index for one module
+  struct IndexEntry {
+    /// modification time of the library
+    std::time_t time;
+    /// size of the library in bytes
+    boost::uintmax_t size;
+    /// (factory, provider) pairs registered by the module
+    std::vector< std::pair<std::string, std::string> > providers;
+  };
+
   /// configuration variable for the modules to be loaded
   std::vector<std::string> m_moduleNames;
 
+  /// load only the modules providing objects named in the configuration
+  bool m_lazyLoading;
+  
+  /// name of the file holding the index of the providers in each module
+  std::string m_indexFileName;
+  
+  /// node-local directory where to stage the needed libraries
+  std::string m_stageDir;
+  
+  /// all the words appearing in the configuration arguments
+  std::set<std::string> m_configWords;
+  
+  /// index mapping each module to its library and providers
+  std::map<std::string, IndexEntry> m_index;
+  
+  /// module registering each (factory, provider) pair
+  std::map< std::pair<std::string, std::string>, std::string > m_providerModules;
+  
+  /// flag telling that all the modules have been loaded
+  bool m_allLoaded;
+
 }; // end of class ModuleLoader
 
 //////////////////////////////////////////////////////////////////////////////
@@ -14,6 +14,7 @@
 #include "Framework/DataHandle.hh"
 #include "Framework/MeshData.hh"
 #include "Framework/Framework.hh"
+#include "Framework/GlobalReduceBatch.hh"
 #include "Framework/ComputeL2Norm.hh"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -44,7 +45,9 @@ ComputeNorm(name),
 m_gr(*this),
 sockets_norm(),
 socket_states("states"),
-m_vecnorm_name()
+m_vecnorm_name(),
+m_handles(),
+m_isPosted(false)
 {
   addConfigOptionsTo(this);
   m_vecnorm_name = "rhs";
@@ -121,13 +124,34 @@ CFreal ComputeL2Norm::GR_GetLocalValue () const
 
 //////////////////////////////////////////////////////////////////////////////
 
-RealVector ComputeL2Norm::compute ()
+void ComputeL2Norm::post ()
 {
   const std::string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  
+  // all the variables are reduced together
+  GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(nsp);
+  const CFuint nbVars = m_residuals.size();
+  m_handles.resize(nbVars);
+  for(m_var_itr = 0; m_var_itr < nbVars; m_var_itr++) {
+    m_handles[m_var_itr] = batch.addValue(GR_GetLocalValue(), GlobalReduceBatch::SUM);
+  }
+  batch.post();
+  m_isPosted = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
 
+RealVector ComputeL2Norm::compute ()
+{
+  if (!m_isPosted) {post();}
+  m_isPosted = false;
+  
+  const std::string nsp = MeshDataStack::getActive()->getPrimaryNamespace();
+  GlobalReduceBatch& batch = GlobalReduceBatch::getInstance(nsp);
+  
   for(m_var_itr = 0; m_var_itr < m_residuals.size(); m_var_itr++)
   {
-    CFreal globalValue = m_gr.GetGlobalValue (nsp);
+    CFreal globalValue = batch.getValue(m_handles[m_var_itr]);
     if(m_normalizedRes) { globalValue = globalValue/m_refVals[m_var_itr]; }
     if(globalValue > 0.)
     {
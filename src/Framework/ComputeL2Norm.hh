@@ -54,6 +54,10 @@ public: // functions
   /// Calculates the norms
   virtual RealVector compute ();
 
+  /// Registers the local contributions to the norms and starts their
+  /// global reduction
+  virtual void post ();
+
   /// Retrieves the value for the global reduce of the result
   CFreal GR_GetLocalValue () const;
 
@@ -78,6 +82,12 @@ private: // data
   /// tolerance on the residual
   CFreal m_tolerance;
   
+  /// handles of the norms in the batch of global reductions
+  std::vector<CFuint> m_handles;
+  
+  /// flag telling if the norms are being reduced
+  bool m_isPosted;
+  
 }; // end of class ComputeL2Norm
 
 //////////////////////////////////////////////////////////////////////////////
@@ -48,6 +48,11 @@ public: // functions
   /// Calculates the norms
   virtual RealVector compute () = 0;
 
+  /// Registers the local contributions to the norms and starts their global
+  /// reduction, so that it overlaps the work done before compute()
+  /// By default the norms are entirely computed by compute().
+  virtual void post () {}
+
   /// Setup the object
   virtual void setup();
 
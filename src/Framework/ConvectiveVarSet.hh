@@ -62,6 +62,20 @@ public:
   /// Set the PhysicalData corresponding to the given State
   virtual void computePhysicalData (const State& state, RealVector& pdata) = 0;
   
+  /// Set the PhysicalData corresponding to the first nbStates given States:
+  /// var sets relying on a physico-chemical library can override this to 
+  /// evaluate the properties of the whole block at once
+  virtual void computeBlockPhysicalData (const std::vector<State*>& states, 
+					 std::vector<RealVector>& pdata,
+					 const CFuint nbStates)
+  {
+    cf_assert(nbStates <= states.size());
+    cf_assert(nbStates <= pdata.size());
+    for (CFuint i = 0; i < nbStates; ++i) {
+      computePhysicalData(*states[i], pdata[i]);
+    }
+  }
+  
   /// Set the State correspoding to the PhysicalData
   virtual void computeStateFromPhysicalData(const RealVector& pdata, State& state) 
   {
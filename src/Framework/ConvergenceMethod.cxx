@@ -320,31 +320,30 @@ void ConvergenceMethod::syncGlobalDataComputeResidual(const bool computeResidual
   DataHandle<Node*, GLOBAL> nodedata = 
     MeshDataStack::getInstance().getEntryByNamespace(nsp)->getNodeDataSocketSink().getDataHandle();
   
+  // the reduction of the residual overlaps the synchronization
+  if (computeResidual) {
+    getConvergenceMethodData()->postResidual();
+  }
+  
   if (CFEnv::getInstance().getVars()->SyncAlgo != "Old") {
     if (isParallel) {
       statedata.synchronize();
       nodedata.synchronize();
     }
-    if (computeResidual) {
-      getConvergenceMethodData()->updateResidual();
-    }
   }
   else {
     // after each update the states have to be syncronized
     if (isParallel) {
       syncTimer.start();
       statedata.beginSync ();
-    }
-    
-    if (computeResidual) {
-      getConvergenceMethodData()->updateResidual();
-    }
-    
-    if (isParallel) {
       statedata.endSync();
       syncTimer.stop();
     }
   }
+  
+  if (computeResidual) {
+    getConvergenceMethodData()->updateResidual();
+  }
 
   popNamespace();
 }
@@ -370,12 +369,21 @@ void ConvergenceMethod::syncAllAndComputeResidual(const bool computeResidual)
   DataHandle<Node*, GLOBAL> nodedata = 
     MeshDataStack::getInstance().getEntryByNamespace(nsp)->getNodeDataSocketSink().getDataHandle();
   
+  // the reduction of the residual overlaps the synchronization
+  if (computeResidual)
+  {
+    getConvergenceMethodData()->postResidual();
+  }
+
   // after each update the states have to be syncronized
   if (isParallel)
   {
     syncTimer.start();
     statedata.beginSync ();
     nodedata.beginSync ();
+    statedata.endSync();
+    nodedata.endSync();
+    syncTimer.stop();
   }
 
   if (computeResidual)
@@ -383,13 +391,6 @@ void ConvergenceMethod::syncAllAndComputeResidual(const bool computeResidual)
     getConvergenceMethodData()->updateResidual();
   }
 
-  if (isParallel)
-  {
-    statedata.endSync();
-    nodedata.endSync();
-    syncTimer.stop();
-  }
-
   popNamespace();
 }
 
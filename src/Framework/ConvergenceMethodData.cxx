@@ -155,6 +155,13 @@ void ConvergenceMethodData::computeSpaceResidualNorm()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void ConvergenceMethodData::postResidual()
+{
+  m_computeNorm.getPtr()->post();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void ConvergenceMethodData::updateResidual()
 {
   // set monitored var in SubSystemStatus
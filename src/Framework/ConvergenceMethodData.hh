@@ -68,6 +68,9 @@ public: // functions
   /// @returns a FilterRHS to be used by the concrete methods for filtering
   Common::SafePtr<Framework::FilterRHS> getFilterRHS() const {  return m_filterRHS.getPtr(); }
   
+  /// Starts the global reduction of the residual, completed by updateResidual()
+  void postResidual();
+  
   /// Updates the residual and places it in the SubSystemStatus
   void updateResidual();
   
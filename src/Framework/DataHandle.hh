@@ -49,6 +49,10 @@ public:
   /// Copy constructor
   DataHandle (const DataHandle<TYPE, COMTYPE> & t) : BaseClass (t) {}
 
+  /// Copy assignment operator
+  DataHandle<TYPE,COMTYPE>& operator = (const DataHandle<TYPE, COMTYPE> & t)
+  { BaseClass::operator = (t); return *this; }
+
   /// Assignment operator
   /// This is just passed on to the underlying DataHandleInternal
   DataHandle<TYPE,COMTYPE>& operator = (const TYPE t) { BaseClass::operator = (t); return *this; }
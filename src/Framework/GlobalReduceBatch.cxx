@@ -0,0 +1,224 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "Common/PE.hh"
+#include "Common/CFLog.hh"
+#include "Common/BadValueException.hh"
+
+#ifdef CF_HAVE_MPI
+#include "Common/MPI/MPIError.hh"
+#include "Common/MPI/MPIStructDef.hh"
+#endif
+
+#include "Framework/GlobalReduceBatch.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Framework {
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::map<std::string, GlobalReduceBatch*> GlobalReduceBatch::m_batches;
+
+//////////////////////////////////////////////////////////////////////////////
+
+GlobalReduceBatch& GlobalReduceBatch::getInstance(const std::string& nspaceName)
+{
+  // the batches are never freed: as the other MPI init objects, they
+  // outlive the PE
+  std::map<std::string, GlobalReduceBatch*>::iterator it = m_batches.find(nspaceName);
+  if (it == m_batches.end()) {
+    GlobalReduceBatch* batch = new GlobalReduceBatch(nspaceName);
+    m_batches[nspaceName] = batch;
+#ifdef CF_HAVE_MPI
+    PE::GetPE().RegisterInitObject(batch);
+#endif
+    return *batch;
+  }
+  return *it->second;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+GlobalReduceBatch::GlobalReduceBatch(const std::string& nspaceName) :
+  m_nspaceName(nspaceName),
+  m_open(),
+  m_openFirst(0),
+  m_flight(),
+  m_flightSend(),
+  m_flightFirst(0),
+  m_inFlight(false),
+  m_done(),
+  m_doneFirst(0),
+  m_nbReductions(0)
+#ifdef CF_HAVE_MPI
+  ,
+  m_request(MPI_REQUEST_NULL),
+  m_pairType(MPI_DATATYPE_NULL),
+  m_op(MPI_OP_NULL),
+  m_registered(false)
+#endif
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+GlobalReduceBatch::~GlobalReduceBatch()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFuint GlobalReduceBatch::addValue(const CFreal localValue, const Operation op)
+{
+  const CFuint handle = m_openFirst + m_open.size()/2;
+  m_open.push_back(static_cast<CFreal>(op));
+  m_open.push_back(localValue);
+  return handle;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GlobalReduceBatch::post()
+{
+  if (m_inFlight) complete();
+  if (m_open.empty()) return;
+
+  const CFuint nbValues = m_open.size()/2;
+  m_flightSend.swap(m_open);
+  m_open.clear();
+  m_flight.resize(m_flightSend.size());
+  m_flightFirst = m_openFirst;
+  m_openFirst += nbValues;
+  m_inFlight = true;
+  ++m_nbReductions;
+
+#ifdef CF_HAVE_MPI
+  cf_assert(m_registered);
+  MPI_Comm comm = PE::GetPE().GetCommunicator(m_nspaceName);
+#if MPI_VERSION >= 3
+  MPIError::getInstance().check
+    ("MPI_Iallreduce", "GlobalReduceBatch::post()",
+     MPI_Iallreduce(&m_flightSend[0], &m_flight[0], nbValues, m_pairType, m_op, comm, &m_request));
+#else
+  MPIError::getInstance().check
+    ("MPI_Allreduce", "GlobalReduceBatch::post()",
+     MPI_Allreduce(&m_flightSend[0], &m_flight[0], nbValues, m_pairType, m_op, comm));
+#endif
+#else
+  m_flight = m_flightSend;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GlobalReduceBatch::complete()
+{
+  cf_assert(m_inFlight);
+
+#if defined(CF_HAVE_MPI) && MPI_VERSION >= 3
+  MPIError::getInstance().check
+    ("MPI_Wait", "GlobalReduceBatch::complete()", MPI_Wait(&m_request, MPI_STATUS_IGNORE));
+#endif
+
+  const CFuint nbValues = m_flight.size()/2;
+  m_done.resize(nbValues);
+  for (CFuint i = 0; i < nbValues; ++i) {
+    m_done[i] = m_flight[2*i+1];
+  }
+  m_doneFirst = m_flightFirst;
+  m_inFlight = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal GlobalReduceBatch::getValue(const CFuint handle)
+{
+  if (handle >= m_openFirst) {
+    cf_assert(handle < m_openFirst + m_open.size()/2);
+    post();
+  }
+
+  if (m_inFlight && handle >= m_flightFirst) {
+    complete();
+  }
+
+  if (handle < m_doneFirst || handle >= m_doneFirst + m_done.size()) {
+    throw BadValueException
+      (FromHere(), "GlobalReduceBatch::getValue() => the value has been overwritten by a later reduction");
+  }
+
+  return m_done[handle - m_doneFirst];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#ifdef CF_HAVE_MPI
+
+void GlobalReduceBatch::MPI_Init(MPI_Comm communicator)
+{
+  CFreal value = 0.;
+  MPI_Type_contiguous(2, MPIStructDef::getMPIType(&value), &m_pairType);
+  MPI_Type_commit(&m_pairType);
+  // the operations are commutative
+  MPI_Op_create(combineMPI, true, &m_op);
+  m_registered = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GlobalReduceBatch::MPI_Done()
+{
+  if (m_inFlight) complete();
+  if (m_registered) {
+    MPI_Op_free(&m_op);
+    MPI_Type_free(&m_pairType);
+    m_registered = false;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GlobalReduceBatch::combineMPI(void* in, void* inout, int* len, MPI_Datatype* datatype)
+{
+  cf_assert(len != CFNULL);
+
+  const CFreal* a = static_cast<const CFreal*>(in);
+  CFreal* b = static_cast<CFreal*>(inout);
+  for (int i = 0; i < *len; ++i, a += 2, b += 2) {
+    cf_assert(a[0] == b[0]);
+    switch (static_cast<Operation>(static_cast<int>(b[0]))) {
+    case SUM:
+      b[1] += a[1];
+      break;
+    case MAX:
+      b[1] = std::max(a[1], b[1]);
+      break;
+    case MIN:
+      b[1] = std::min(a[1], b[1]);
+      break;
+    }
+  }
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Framework
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,152 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_Framework_GlobalReduceBatch_hh
+#define COOLFluiD_Framework_GlobalReduceBatch_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/COOLFluiD.hh"
+#include "Common/NonCopyable.hh"
+#include "Framework/Framework.hh"
+
+#ifdef CF_HAVE_MPI
+#include "Common/MPI/MPIInitObject.hh"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+  namespace Framework {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class fuses the scalar global reductions of a namespace into a
+/// single (non-blocking) MPI reduction.
+/// Commands register their local contributions with addValue(), which
+/// returns a handle. The pending contributions are packed in one
+/// MPI_Iallreduce by post(), as early as the caller allows, and the
+/// reduction is only completed when a consumer first reads one of the
+/// results with getValue() (which posts the batch itself if needed).
+/// Each value carries its own operation (sum, max or min), so unrelated
+/// reductions share the same message.
+/// All the processors must add the same contributions in the same order.
+/// Warning: not thread safe, it must be used by the main thread only
+class Framework_API GlobalReduceBatch :
+#ifdef CF_HAVE_MPI
+  public Common::MPIInitObject,
+#endif
+  public Common::NonCopyable<GlobalReduceBatch>
+{
+public:
+
+  /// Operations which can be applied to a value
+  enum Operation {SUM=0, MAX=1, MIN=2};
+
+  /// @return the batch of the given namespace
+  static GlobalReduceBatch& getInstance(const std::string& nspaceName);
+
+  /// Register a local contribution to the next reduction
+  /// @return the handle of the global value
+  CFuint addValue(const CFreal localValue, const Operation op);
+
+  /// Start the reduction of the registered contributions
+  void post();
+
+  /// @return the global value corresponding to the given handle,
+  ///         completing the reduction if needed
+  CFreal getValue(const CFuint handle);
+
+  /// @return the number of reductions actually sent (for statistics)
+  CFuint getNbReductions() const {return m_nbReductions;}
+
+#ifdef CF_HAVE_MPI
+  /// Create the MPI type and operation
+  virtual void MPI_Init(MPI_Comm communicator);
+
+  /// Complete the pending reduction and free the MPI type and operation
+  virtual void MPI_Done();
+#endif
+
+private: // methods
+
+  /// Constructor
+  GlobalReduceBatch(const std::string& nspaceName);
+
+  /// Destructor
+  ~GlobalReduceBatch();
+
+  /// Wait for the reduction in flight
+  void complete();
+
+#ifdef CF_HAVE_MPI
+  /// Combine the (operation, value) pairs, called by MPI
+  static void combineMPI(void* in, void* inout, int* len, MPI_Datatype* datatype);
+#endif
+
+private: // data
+
+  /// all the batches, one per namespace
+  static std::map<std::string, GlobalReduceBatch*> m_batches;
+
+  /// name of the namespace
+  std::string m_nspaceName;
+
+  /// pending contributions as (operation, value) pairs
+  std::vector<CFreal> m_open;
+
+  /// handle of the first pending contribution
+  CFuint m_openFirst;
+
+  /// reduced (operation, value) pairs of the reduction in flight
+  std::vector<CFreal> m_flight;
+
+  /// contributions of the reduction in flight
+  std::vector<CFreal> m_flightSend;
+
+  /// handle of the first value in flight
+  CFuint m_flightFirst;
+
+  /// a reduction is in flight
+  bool m_inFlight;
+
+  /// values of the last completed reduction
+  std::vector<CFreal> m_done;
+
+  /// handle of the first completed value
+  CFuint m_doneFirst;
+
+  /// number of reductions sent
+  CFuint m_nbReductions;
+
+#ifdef CF_HAVE_MPI
+  /// request of the reduction in flight
+  MPI_Request m_request;
+
+  /// MPI type of an (operation, value) pair
+  MPI_Datatype m_pairType;
+
+  /// MPI operation combining the pairs
+  MPI_Op m_op;
+
+  /// the MPI type and operation are created
+  bool m_registered;
+#endif
+
+}; // class GlobalReduceBatch
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Framework
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Framework_GlobalReduceBatch_hh
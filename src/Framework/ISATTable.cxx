@@ -0,0 +1,360 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cmath>
+#include <algorithm>
+
+#include "Common/CFLog.hh"
+#include "Framework/ISATTable.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Framework {
+
+//////////////////////////////////////////////////////////////////////////////
+
+ISATTable::ISATTable() :
+  m_name(),
+  m_nbInputs(0),
+  m_nbOutputs(0),
+  m_relTol(0.),
+  m_absTol(0.),
+  m_maxRadius(0.),
+  m_maxRecords(0),
+  m_reportRate(0),
+  m_nbRecords(0),
+  m_phi0(),
+  m_f0(),
+  m_A(),
+  m_M(),
+  m_nodeNormal(),
+  m_nodeOffset(),
+  m_nodeChild(),
+  m_root(0),
+  m_nbQueries(0),
+  m_nbRetrieves(0),
+  m_nbGrows(0),
+  m_nbAdds(0),
+  m_nbDirect(0),
+  m_dphi(),
+  m_fL(),
+  m_Mdphi(),
+  m_phiPert(),
+  m_fPert()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+ISATTable::~ISATTable()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::setup(const std::string& name,
+		      const CFuint nbInputs, const CFuint nbOutputs,
+		      const CFreal relTol, const CFreal absTol, const CFreal maxRadius,
+		      const CFuint maxRecords, const CFuint reportRate)
+{
+  cf_assert(nbInputs > 0);
+  cf_assert(nbOutputs > 0);
+  cf_assert(maxRadius > 0.);
+
+  m_name = name;
+  m_nbInputs = nbInputs;
+  m_nbOutputs = nbOutputs;
+  m_relTol = relTol;
+  m_absTol = absTol;
+  m_maxRadius = maxRadius;
+  m_maxRecords = maxRecords;
+  m_reportRate = reportRate;
+
+  m_dphi.resize(nbInputs);
+  m_fL.resize(nbOutputs);
+  m_Mdphi.resize(nbInputs);
+  m_phiPert.resize(nbInputs);
+  m_fPert.resize(nbOutputs);
+
+  clear();
+
+  CFLog(INFO, "ISATTable::setup() => " << m_name << ": " << nbInputs << " inputs, "
+	<< nbOutputs << " outputs, max " << maxRecords << " records\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::clear()
+{
+  m_nbRecords = 0;
+  m_phi0.clear();
+  m_f0.clear();
+  m_A.clear();
+  m_M.clear();
+  m_nodeNormal.clear();
+  m_nodeOffset.clear();
+  m_nodeChild.clear();
+  m_root = 0;
+  m_nbQueries = 0;
+  m_nbRetrieves = 0;
+  m_nbGrows = 0;
+  m_nbAdds = 0;
+  m_nbDirect = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::compute(const RealVector& phi, Function& func, RealVector& f)
+{
+  cf_assert(isSetup());
+  cf_assert(phi.size() == m_nbInputs);
+  cf_assert(f.size() == m_nbOutputs);
+
+  ++m_nbQueries;
+  if (m_reportRate > 0 && m_nbQueries%m_reportRate == 0) {
+    printStatistics();
+  }
+
+  CFint parent = -1;
+  bool right = false;
+  const CFint leaf = findLeaf(phi, parent, right);
+  CFreal q = 0.;
+  if (leaf >= 0) {
+    const CFreal *const phi0 = &m_phi0[leaf*m_nbInputs];
+    for (CFuint i = 0; i < m_nbInputs; ++i) {
+      m_dphi[i] = phi[i] - phi0[i];
+    }
+
+    // retrieve: the point is in the ellipsoid of accuracy
+    q = ellipsoidNorm(leaf);
+    if (q <= 1.) {
+      linearApproximation(leaf);
+      for (CFuint i = 0; i < m_nbOutputs; ++i) {
+	f[i] = m_fL[i];
+      }
+      ++m_nbRetrieves;
+      return;
+    }
+  }
+
+  func.compute(phi, f);
+
+  if (leaf >= 0) {
+    // grow: the linear approximation is accurate outside the ellipsoid of accuracy
+    linearApproximation(leaf);
+    CFreal err2 = 0.;
+    CFreal norm2 = 0.;
+    for (CFuint i = 0; i < m_nbOutputs; ++i) {
+      const CFreal diff = f[i] - m_fL[i];
+      err2 += diff*diff;
+      norm2 += f[i]*f[i];
+    }
+    if (std::sqrt(err2) <= m_relTol*std::sqrt(norm2) + m_absTol) {
+      growEOA(leaf, q);
+      ++m_nbGrows;
+      return;
+    }
+  }
+
+  // add: a new record is created at the query point
+  if (m_nbRecords < m_maxRecords) {
+    addRecord(phi, f, func, leaf, parent, right);
+    ++m_nbAdds;
+    return;
+  }
+
+  ++m_nbDirect;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFint ISATTable::findLeaf(const RealVector& phi, CFint& parent, bool& right) const
+{
+  parent = -1;
+  right = false;
+  if (m_nbRecords == 0) return -1;
+
+  CFint child = m_root;
+  while (child >= 0) {
+    const CFreal *const normal = &m_nodeNormal[child*m_nbInputs];
+    CFreal proj = 0.;
+    for (CFuint i = 0; i < m_nbInputs; ++i) {
+      proj += normal[i]*phi[i];
+    }
+    parent = child;
+    right = (proj > m_nodeOffset[child]);
+    child = m_nodeChild[2*child + (right ? 1 : 0)];
+  }
+  return -(child + 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::addRecord(const RealVector& phi, const RealVector& f, Function& func,
+			  const CFint leaf, const CFint parent, const bool right)
+{
+  const CFuint rec = m_nbRecords++;
+  const CFuint nIn = m_nbInputs;
+  const CFuint nOut = m_nbOutputs;
+
+  m_phi0.resize(m_nbRecords*nIn);
+  m_f0.resize(m_nbRecords*nOut);
+  m_A.resize(m_nbRecords*nOut*nIn);
+  m_M.resize(m_nbRecords*nIn*nIn);
+
+  CFreal *const phi0 = &m_phi0[rec*nIn];
+  CFreal *const f0 = &m_f0[rec*nOut];
+  for (CFuint i = 0; i < nIn; ++i) {
+    phi0[i] = phi[i];
+  }
+  for (CFuint i = 0; i < nOut; ++i) {
+    f0[i] = f[i];
+  }
+
+  // sensitivities by forward finite differences
+  CFreal *const A = &m_A[rec*nOut*nIn];
+  m_phiPert = phi;
+  for (CFuint j = 0; j < nIn; ++j) {
+    const CFreal h = 1e-7*std::max(1., std::abs(phi[j]));
+    m_phiPert[j] = phi[j] + h;
+    func.compute(m_phiPert, m_fPert);
+    m_phiPert[j] = phi[j];
+    for (CFuint i = 0; i < nOut; ++i) {
+      A[i*nIn + j] = (m_fPert[i] - f0[i])/h;
+    }
+  }
+
+  // initial ellipsoid of accuracy: region where the linear term is below the
+  // tolerance (A^T A/eps^2), bounded by the max radius in every direction
+  CFreal fNorm2 = 0.;
+  for (CFuint i = 0; i < nOut; ++i) {
+    fNorm2 += f0[i]*f0[i];
+  }
+  const CFreal eps = m_relTol*std::sqrt(fNorm2) + m_absTol;
+  const CFreal ovEps2 = (eps > 0.) ? 1./(eps*eps) : 0.;
+  const CFreal ovR2 = 1./(m_maxRadius*m_maxRadius);
+  CFreal *const M = &m_M[rec*nIn*nIn];
+  for (CFuint j = 0; j < nIn; ++j) {
+    for (CFuint k = j; k < nIn; ++k) {
+      CFreal sum = 0.;
+      for (CFuint i = 0; i < nOut; ++i) {
+	sum += A[i*nIn + j]*A[i*nIn + k];
+      }
+      sum *= ovEps2;
+      if (j == k) sum += ovR2;
+      M[j*nIn + k] = sum;
+      M[k*nIn + j] = sum;
+    }
+  }
+
+  const CFint recLeaf = -static_cast<CFint>(rec + 1);
+  if (leaf < 0) {
+    m_root = recLeaf;
+    return;
+  }
+
+  // the old leaf becomes a node whose cutting plane is the perpendicular
+  // bisector of the old and the new record points
+  const CFuint node = m_nodeOffset.size();
+  const CFreal *const phiOld = &m_phi0[leaf*nIn];
+  CFreal offset = 0.;
+  for (CFuint i = 0; i < nIn; ++i) {
+    const CFreal normal = phi0[i] - phiOld[i];
+    m_nodeNormal.push_back(normal);
+    offset += normal*0.5*(phi0[i] + phiOld[i]);
+  }
+  m_nodeOffset.push_back(offset);
+  m_nodeChild.push_back(-(leaf + 1));
+  m_nodeChild.push_back(recLeaf);
+
+  if (parent < 0) {
+    m_root = node;
+  }
+  else {
+    m_nodeChild[2*parent + (right ? 1 : 0)] = node;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::growEOA(const CFuint rec, const CFreal q)
+{
+  // smallest ellipsoid with the same center including the old one and the
+  // point: M' = M - (1 - 1/q) (M dphi)(M dphi)^T/q with q = dphi^T M dphi
+  cf_assert(q > 1.);
+  const CFuint nIn = m_nbInputs;
+  CFreal *const M = &m_M[rec*nIn*nIn];
+  const CFreal coeff = (1. - 1./q)/q;
+  for (CFuint j = 0; j < nIn; ++j) {
+    for (CFuint k = 0; k < nIn; ++k) {
+      M[j*nIn + k] -= coeff*m_Mdphi[j]*m_Mdphi[k];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CFreal ISATTable::ellipsoidNorm(const CFuint rec)
+{
+  const CFuint nIn = m_nbInputs;
+  const CFreal *const M = &m_M[rec*nIn*nIn];
+  CFreal q = 0.;
+  for (CFuint j = 0; j < nIn; ++j) {
+    CFreal sum = 0.;
+    for (CFuint k = 0; k < nIn; ++k) {
+      sum += M[j*nIn + k]*m_dphi[k];
+    }
+    // stored for a subsequent growth of the ellipsoid
+    m_Mdphi[j] = sum;
+    q += m_dphi[j]*sum;
+  }
+  return q;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::linearApproximation(const CFuint rec)
+{
+  const CFuint nIn = m_nbInputs;
+  const CFreal *const f0 = &m_f0[rec*m_nbOutputs];
+  const CFreal *const A = &m_A[rec*m_nbOutputs*nIn];
+  for (CFuint i = 0; i < m_nbOutputs; ++i) {
+    CFreal sum = f0[i];
+    for (CFuint j = 0; j < nIn; ++j) {
+      sum += A[i*nIn + j]*m_dphi[j];
+    }
+    m_fL[i] = sum;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ISATTable::printStatistics() const
+{
+  const CFreal ovQueries = (m_nbQueries > 0) ? 100./m_nbQueries : 0.;
+  CFLog(INFO, "ISATTable::printStatistics() => " << m_name << ": "
+	<< m_nbQueries << " queries, "
+	<< m_nbRetrieves*ovQueries << "% retrieves, "
+	<< m_nbGrows*ovQueries << "% grows, "
+	<< m_nbAdds*ovQueries << "% adds, "
+	<< m_nbDirect*ovQueries << "% direct evaluations (table full), "
+	<< m_nbRecords << " records ("
+	<< m_nbRecords*getRecordSize(m_nbInputs, m_nbOutputs)/1048576. << " MB)\n");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace Framework
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
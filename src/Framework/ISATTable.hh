@@ -0,0 +1,205 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_Framework_ISATTable_hh
+#define COOLFluiD_Framework_ISATTable_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Framework/Framework.hh"
+#include "MathTools/RealVector.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Framework {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class implements the in-situ adaptive tabulation (ISAT) of a
+/// function f(phi), as proposed by S.B. Pope (Combust. Theory Modelling 1,
+/// 1997). Each record stores a point phi0, the value f0 = f(phi0), the
+/// sensitivity matrix A = df/dphi(phi0) and an ellipsoid of accuracy (EOA)
+/// inside which f is approximated by f0 + A (phi - phi0). The records are
+/// the leaves of a binary tree whose nodes are the cutting planes between
+/// two records. For a query point, the tree gives a leaf record and:
+/// - if the point is inside its EOA, the linear approximation is returned
+///   (retrieve);
+/// - otherwise f is computed directly and, if the linear approximation is
+///   accurate anyway, the EOA is grown to include the point (grow),
+///   else a new record is added (add), unless the table is full.
+/// @author Andrea Lani
+class Framework_API ISATTable {
+public:
+
+  /// Interface of the tabulated function
+  class Function {
+  public:
+    virtual ~Function() {}
+
+    /// compute f(phi)
+    virtual void compute(const RealVector& phi, RealVector& f) = 0;
+  };
+
+  /// Constructor
+  ISATTable();
+
+  /// Default destructor
+  ~ISATTable();
+
+  /// Set up the table
+  /// @param name        name used in the statistics report
+  /// @param nbInputs    size of phi
+  /// @param nbOutputs   size of f
+  /// @param relTol      relative tolerance on the norm of f
+  /// @param absTol      absolute tolerance on the norm of f
+  /// @param maxRadius   max radius of the initial EOAs in the phi space
+  /// @param maxRecords  max number of records
+  /// @param reportRate  number of queries between two statistics reports (0 for none)
+  void setup(const std::string& name,
+	     const CFuint nbInputs, const CFuint nbOutputs,
+	     const CFreal relTol, const CFreal absTol, const CFreal maxRadius,
+	     const CFuint maxRecords, const CFuint reportRate);
+
+  /// @return true if the table has been set up
+  bool isSetup() const {return (m_nbInputs > 0);}
+
+  /// Compute f(phi) through the table
+  void compute(const RealVector& phi, Function& func, RealVector& f);
+
+  /// Remove all the records and reset the statistics
+  void clear();
+
+  /// Log the statistics of the table
+  void printStatistics() const;
+
+  /// @return the number of bytes used by one record
+  static CFuint getRecordSize(const CFuint nbInputs, const CFuint nbOutputs)
+  {
+    return (nbInputs*(nbInputs + nbOutputs + 2) + nbOutputs + 3)*sizeof(CFreal);
+  }
+
+  /// @return the number of records
+  CFuint getNbRecords() const {return m_nbRecords;}
+
+private: // functions
+
+  /// @return the record of the leaf reached by phi (-1 if the table is empty)
+  /// @param parent  node owning the leaf (-1 if the leaf is the root)
+  /// @param right   flag telling if the leaf is the right child of parent
+  CFint findLeaf(const RealVector& phi, CFint& parent, bool& right) const;
+
+  /// add a record at phi, replacing the given leaf by a node
+  void addRecord(const RealVector& phi, const RealVector& f, Function& func,
+		 const CFint leaf, const CFint parent, const bool right);
+
+  /// grow the EOA of the given record to include phi0 + m_dphi
+  void growEOA(const CFuint rec, const CFreal q);
+
+  /// @return m_dphi^T M m_dphi for the EOA matrix M of the given record
+  /// (M m_dphi is stored in m_Mdphi)
+  CFreal ellipsoidNorm(const CFuint rec);
+
+  /// compute the linear approximation m_fL around the given record at phi0 + m_dphi
+  void linearApproximation(const CFuint rec);
+
+private: // data
+
+  /// name of the table
+  std::string m_name;
+
+  /// size of phi
+  CFuint m_nbInputs;
+
+  /// size of f
+  CFuint m_nbOutputs;
+
+  /// relative tolerance
+  CFreal m_relTol;
+
+  /// absolute tolerance
+  CFreal m_absTol;
+
+  /// max radius of the initial EOAs
+  CFreal m_maxRadius;
+
+  /// max number of records
+  CFuint m_maxRecords;
+
+  /// number of queries between two statistics reports
+  CFuint m_reportRate;
+
+  /// number of records
+  CFuint m_nbRecords;
+
+  /// points of the records (m_nbInputs per record)
+  std::vector<CFreal> m_phi0;
+
+  /// function values of the records (m_nbOutputs per record)
+  std::vector<CFreal> m_f0;
+
+  /// sensitivity matrices of the records (m_nbOutputs x m_nbInputs per record)
+  std::vector<CFreal> m_A;
+
+  /// EOA matrices of the records (m_nbInputs x m_nbInputs per record)
+  std::vector<CFreal> m_M;
+
+  /// normals of the cutting planes (m_nbInputs per node)
+  std::vector<CFreal> m_nodeNormal;
+
+  /// offsets of the cutting planes
+  std::vector<CFreal> m_nodeOffset;
+
+  /// children of the nodes: node ID if >= 0, record -(ID+1) otherwise
+  std::vector<CFint> m_nodeChild;
+
+  /// root of the tree: node ID if >= 0, record -(ID+1) otherwise
+  CFint m_root;
+
+  /// number of queries
+  CFuint m_nbQueries;
+
+  /// number of retrieves
+  CFuint m_nbRetrieves;
+
+  /// number of grows
+  CFuint m_nbGrows;
+
+  /// number of adds
+  CFuint m_nbAdds;
+
+  /// number of direct evaluations not stored because the table is full
+  CFuint m_nbDirect;
+
+  /// displacement from the record point
+  std::vector<CFreal> m_dphi;
+
+  /// linear approximation
+  std::vector<CFreal> m_fL;
+
+  /// M m_dphi
+  std::vector<CFreal> m_Mdphi;
+
+  /// perturbed point for the sensitivities
+  RealVector m_phiPert;
+
+  /// perturbed value for the sensitivities
+  RealVector m_fPert;
+
+}; // end of class ISATTable
+
+//////////////////////////////////////////////////////////////////////////////
+
+    } // namespace Framework
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Framework_ISATTable_hh
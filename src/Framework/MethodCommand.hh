@@ -13,6 +13,7 @@
 #include "Common/NullableObject.hh"
 
 #include "Common/CFLog.hh"
+#include "Common/ThreadPool.hh"
 
 #include "Framework/BaseMethodCommandProvider.hh"
 #include "Framework/NumericalCommand.hh"
@@ -61,6 +62,26 @@ public:
   /// Gets the Class name
   static std::string getClassName() { return DATA::getClassName() + "Command"; }
 
+protected:
+
+  /// Applies functor(first, end, threadID) to chunks covering [begin, end)
+  /// on the threads of the ThreadPool of this process. The functor must not
+  /// call MPI and should take its temporaries from getScratch(threadID, ...).
+  /// @param grain number of indices per chunk (0 means automatic)
+  template <typename FUNCTOR>
+  void parallelFor(const CFuint begin, const CFuint end, FUNCTOR& functor,
+		   const CFuint grain = 0)
+  {
+    Common::ThreadPool::getInstance().parallelFor(begin, end, functor, grain);
+  }
+
+  /// Scratch memory private to the given thread of the ThreadPool
+  template <typename T>
+  T* getScratch(const CFuint threadID, const size_t size)
+  {
+    return Common::ThreadPool::getInstance().getScratch<T>(threadID, size);
+  }
+
 private:
 
   /// Pointer to the data object
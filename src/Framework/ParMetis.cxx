@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <sstream>
 
 #include "Common/Stopwatch.hh"
@@ -13,6 +16,7 @@
 #include "Framework/Framework.hh"
 #include "Framework/ParMetis.hh"
 #include "Framework/MeshData.hh"
+#include "Common/MPI/MPIStructDef.hh"
 #include "Framework/PartitionerPeriodicTools.hh"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -37,6 +41,10 @@ void ParMetis::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< int >("NCommonNodes", "Parmetis parameter for mesh to graph conversion");
   options.addConfigOption< int >("RND","Random seed to use");
   options.addConfigOption< int >("Options","Parmetis options parameter");
+  options.addConfigOption< bool >("UseElemCost","Use the measured element costs (if available) as weights");
+  options.addConfigOption< bool >("MemoryConstraint","Balance the number of element nodes as second constraint");
+  options.addConfigOption< CFuint >("CostResolution","Weight given to an element with the mean cost");
+  options.addConfigOption< CFreal >("ImbalanceTol","Imbalance tolerance for each constraint");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -58,6 +66,18 @@ ParMetis::ParMetis (const std::string & S)
 
   IN_RND_ = 15;
   setParameter("RND",&IN_RND_);
+  
+  m_useElemCost = true;
+  setParameter("UseElemCost",&m_useElemCost);
+  
+  m_memoryConstraint = false;
+  setParameter("MemoryConstraint",&m_memoryConstraint);
+  
+  m_costResolution = 10;
+  setParameter("CostResolution",&m_costResolution);
+  
+  m_imbalanceTol = 1.05;
+  setParameter("ImbalanceTol",&m_imbalanceTol);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -91,21 +111,45 @@ void ParMetis::doPartition(PartitionerData& pData)
   MPI_Comm_rank (Communicator_, &CommRank);
 
   // elmdist, part, eidx, eptr was filled by FillInput()
-  PartitionerData::IndexT ncon = 1;
   PartitionerData::IndexT options[] = {1,0,15};
   
   options[0] = 0;
   options[1] = IN_Options_;
   options[2] = IN_RND_;
   
-  std::vector<PartitionerData::RealT> ubvec(ncon, 1.05);
+  const CFuint nbLocalElems = pData.elmdist[CommRank+1] - pData.elmdist[CommRank];
+  
+  // all the processes must agree on the use of the weights
+  int hasCost = (m_useElemCost && pData.elemCost.size() == nbLocalElems) ? 1 : 0;
+  int allHaveCost = 0;
+  MPI_Allreduce(&hasCost, &allHaveCost, 1, MPI_INT, MPI_MIN, Communicator_);
+  
+  std::vector<PartitionerData::IndexT> costWeights;
+  if (allHaveCost) {
+    computeWeights(pData.elemCost, m_costResolution, Communicator_, costWeights);
+  }
+  
+  // with the memory constraint, the second weight is the number of element nodes
+  PartitionerData::IndexT ncon = (allHaveCost && m_memoryConstraint) ? 2 : 1;
+  std::vector<PartitionerData::IndexT> elmwgt;
+  if (allHaveCost) {
+    elmwgt.resize(ncon*nbLocalElems);
+    for (CFuint i = 0; i < nbLocalElems; ++i) {
+      elmwgt[i*ncon] = costWeights[i];
+      if (ncon > 1) {
+	elmwgt[i*ncon + 1] = pData.eptrn[i+1] - pData.eptrn[i];
+      }
+    }
+  }
+  
+  std::vector<PartitionerData::RealT> ubvec(ncon, m_imbalanceTol);
   std::vector<PartitionerData::RealT> tpwgts (ncon*CommSize, 1.0/(PartitionerData::RealT)(CommSize));
 
-  PartitionerData::IndexT weightflag=0;
+  PartitionerData::IndexT weightflag = (allHaveCost) ? 2 : 0;
   PartitionerData::IndexT numflag = 0;
   PartitionerData::IndexT ncommonnodes = IN_NCommonNodes_;
   PartitionerData::IndexT edgecut = 0;
-  PartitionerData::IndexT* idxdummy = NULL;
+  PartitionerData::IndexT* elmwgtPtr = (allHaveCost) ? &elmwgt[0] : NULL;
   
   CFLogDebugMin( "Calling ParMetis::doPartition()\n");
   Common::Stopwatch<Common::WallTime> MetisTimer;
@@ -141,23 +185,37 @@ void ParMetis::doPartition(PartitionerData& pData)
   }
     
   CFLogNotice("ParMetis: ncommonnodes = " << ncommonnodes << "\n");
+  if (allHaveCost) {
+    CFLogNotice("ParMetis: using measured element costs as weights, ncon = " << ncon << "\n");
+  }
+  // all the processes must agree on the refinement of an initial partition
+  int hasInitialPart = (pData.initialPart.size() == nbLocalElems) ? 1 : 0;
+  int allHaveInitialPart = 0;
+  MPI_Allreduce(&hasInitialPart, &allHaveInitialPart, 1, MPI_INT, MPI_MIN, Communicator_);
+  
   MetisTimer.start ();
   PartitionerData::IndexT nbPartitions = (PartitionerData::IndexT)CommSize;
-  ParMETIS_V3_PartMeshKway (&pData.elmdist[0], // distribution of the elements (= for every cpu)
-			    &pData.eptrn[0],  // contains for each element index of the element nodes
-			    &pData.elemNode[0],    // element nodes
-			    idxdummy,     // weight of the elements // note here a big difference with ParMETIS 3.1
-			    &weightflag,  // 0 -> no weights
-			    &numflag,     // numbering starts at index 0
-			    &ncon,       // number of weights on each vertex
-			    &ncommonnodes,// connectivity degree
-			    &nbPartitions,  // Number of partitions
-			    &tpwgts[0],      // Vertex weight distribution
-			    &ubvec[0],      // Imbalance tolerance
-			    &options[0],    // Options
-			    &edgecut,       // *output* Partition quality
-			    &(*pData.part)[0],  // *output* element ranks, parmetis manual is ambivalent
-			    &Communicator_);
+  if (allHaveInitialPart) {
+    CFLogNotice("ParMetis: refining the initial partition with AdaptiveRepart\n");
+    refinePartition(pData, elmwgtPtr, weightflag, ncon, tpwgts, ubvec, edgecut);
+  }
+  else {
+    ParMETIS_V3_PartMeshKway (&pData.elmdist[0], // distribution of the elements (= for every cpu)
+			      &pData.eptrn[0],  // contains for each element index of the element nodes
+			      &pData.elemNode[0],    // element nodes
+			      elmwgtPtr,    // weight of the elements // note here a big difference with ParMETIS 3.1
+			      &weightflag,  // 0 -> no weights, 2 -> weights on the elements
+			      &numflag,     // numbering starts at index 0
+			      &ncon,       // number of weights on each vertex
+			      &ncommonnodes,// connectivity degree
+			      &nbPartitions,  // Number of partitions
+			      &tpwgts[0],      // Vertex weight distribution
+			      &ubvec[0],      // Imbalance tolerance
+			      &options[0],    // Options
+			      &edgecut,       // *output* Partition quality
+			      &(*pData.part)[0],  // *output* element ranks, parmetis manual is ambivalent
+			      &Communicator_);
+  }
   
   // putting back original element connectivity
   /// @todo elements around the two sides of the periodic bc should be on the same rank
@@ -180,6 +238,76 @@ void ParMetis::doPartition(PartitionerData& pData)
   CFLog(NOTICE, "ParMetis::doPartition() took " << MetisTimer << "\n");
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+void ParMetis::refinePartition(PartitionerData& pData,
+			       PartitionerData::IndexT* elmwgt,
+			       PartitionerData::IndexT weightflag,
+			       PartitionerData::IndexT ncon,
+			       std::vector<PartitionerData::RealT>& tpwgts,
+			       std::vector<PartitionerData::RealT>& ubvec,
+			       PartitionerData::IndexT& edgecut)
+{
+  // dual graph of the mesh: elements sharing ncommonnodes nodes are neighbours
+  PartitionerData::IndexT numflag = 0;
+  PartitionerData::IndexT ncommonnodes = IN_NCommonNodes_;
+  PartitionerData::IndexT* xadj = NULL;
+  PartitionerData::IndexT* adjncy = NULL;
+  ParMETIS_V3_Mesh2Dual (&pData.elmdist[0], &pData.eptrn[0], &pData.elemNode[0],
+			 &numflag, &ncommonnodes, &xadj, &adjncy, &Communicator_);
+  
+  // the initial partition is given by the part array, not by the 
+  // distribution of the elements among the processes (uncoupled)
+  PartitionerData::IndexT options[4];
+  options[0] = 1;
+  options[1] = IN_Options_;
+  options[2] = IN_RND_;
+  options[3] = PARMETIS_PSR_UNCOUPLED;
+  
+  // ratio between the cost of the communications and of the redistribution:
+  // the partition quality matters more than the elements kept in place
+  PartitionerData::RealT itr = 1000.;
+  PartitionerData::IndexT nbPartitions = tpwgts.size()/ncon;
+  pData.part->assign(pData.initialPart.begin(), pData.initialPart.end());
+  ParMETIS_V3_AdaptiveRepart (&pData.elmdist[0], xadj, adjncy, elmwgt, NULL, NULL,
+			      &weightflag, &numflag, &ncon, &nbPartitions, &tpwgts[0], 
+			      &ubvec[0], &itr, &options[0], &edgecut, &(*pData.part)[0], 
+			      &Communicator_);
+  
+  free(xadj);
+  free(adjncy);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void ParMetis::computeWeights(const std::vector<CFreal>& cost, 
+			      const CFuint resolution, MPI_Comm comm, 
+			      std::vector<PartitionerData::IndexT>& weights)
+{
+  CFreal localSum[2] = {0., static_cast<CFreal>(cost.size())};
+  for (CFuint i = 0; i < cost.size(); ++i) {
+    localSum[0] += cost[i];
+  }
+  
+  CFreal sum[2] = {0., 0.};
+  MPI_Allreduce(&localSum[0], &sum[0], 2, MPIStructDef::getMPIType(&localSum[0]), MPI_SUM, comm);
+  
+  // without any measured cost, all the entities are equally expensive
+  weights.resize(cost.size());
+  if (!(sum[0] > 0.) || !(sum[1] > 0.)) {
+    weights.assign(cost.size(), 1);
+    return;
+  }
+  
+  // the cap keeps the total weight far from the integer overflow
+  const CFreal mean = sum[0]/sum[1];
+  const CFreal maxWeight = 1000.*resolution;
+  for (CFuint i = 0; i < cost.size(); ++i) {
+    const CFreal w = std::floor(resolution*cost[i]/mean + 0.5);
+    weights[i] = static_cast<PartitionerData::IndexT>(std::max(1., std::min(w, maxWeight)));
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
     }
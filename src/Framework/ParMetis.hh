@@ -22,7 +22,8 @@ namespace COOLFluiD {
 ///   * Other partition methods (geom, ...) -> needs node information
 ///       -> will need method to interrogate MeshPartitioner if node data
 ///           should be present
-///   * weight array? (hybrid meshes!)
+///   * weight array? (hybrid meshes!) -> measured element costs can
+///       be used as weights, see PartitionerData::elemCost
 class Framework_API ParMetis : public MeshPartitioner
 {
 public:
@@ -41,6 +42,27 @@ public:
   /// @param args the argument list to configure this object
   virtual void configure ( Config::ConfigArgs& args );
   
+  /// Refine the initial partition of pData with ParMETIS_V3_AdaptiveRepart
+  /// on the dual graph of the mesh, the other arguments being the ones of
+  /// ParMETIS_V3_PartMeshKway
+  void refinePartition(PartitionerData& pData,
+		       PartitionerData::IndexT* elmwgt,
+		       PartitionerData::IndexT weightflag,
+		       PartitionerData::IndexT ncon,
+		       std::vector<PartitionerData::RealT>& tpwgts,
+		       std::vector<PartitionerData::RealT>& ubvec,
+		       PartitionerData::IndexT& edgecut);
+  
+  /// Convert measured costs into ParMETIS integer weights, proportional
+  /// to the cost relative to the mean cost over all the processes
+  /// @param cost        local costs
+  /// @param resolution  weight given to an entity with the mean cost
+  /// @param comm        communicator on which the mean is computed
+  /// @param weights     weights in [1, 1000*resolution]
+  static void computeWeights(const std::vector<CFreal>& cost, 
+			     const CFuint resolution, MPI_Comm comm, 
+			     std::vector<PartitionerData::IndexT>& weights);
+  
 protected:
   
   std::vector<PartitionerData::IndexT> eptr;
@@ -52,6 +74,18 @@ protected:
   int IN_NCommonNodes_;
   int IN_Options_;
   int IN_RND_;
+  
+  /// use the element costs as weights, if available
+  bool m_useElemCost;
+  
+  /// add the number of element nodes as second constraint, to balance memory too
+  bool m_memoryConstraint;
+  
+  /// weight given to an element with the mean cost
+  CFuint m_costResolution;
+  
+  /// imbalance tolerance for each constraint
+  CFreal m_imbalanceTol;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -65,6 +65,14 @@ struct Framework_API PartitionerData : public Common::NonCopyable<PartitionerDat
   /// array to store the element state pointers
   std::vector<IndexT> eptrs;
   
+  /// array to store the measured cost of each local element
+  /// (empty if the elements have to be treated as equally expensive)
+  std::vector<CFreal> elemCost;
+  
+  /// array to store an initial partition of the local elements (e.g. read
+  /// from file), to be refined by the partitioner (empty if none)
+  std::vector<IndexT> initialPart;
+  
   /// array to store the processor IDs of the locally stored
   /// nodes after the call to the MeshPartitioner
   std::vector<IndexT>* part;
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <cmath>
+
 #include "PhysicalChemicalLibrary.hh"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -14,6 +16,112 @@ namespace COOLFluiD {
     
 //////////////////////////////////////////////////////////////////////////////
 
+/// Decode the tabulation input log(T), log(p), log(rho), log(Tv), ys
+static void decodeTabulationInput(const RealVector& phi, CFdouble& temp, 
+				  CFdouble& pressure, CFdouble& rho,
+				  RealVector& tVec, RealVector& ys)
+{
+  temp = std::exp(phi[0]);
+  pressure = std::exp(phi[1]);
+  rho = std::exp(phi[2]);
+  const CFuint nbTv = tVec.size();
+  for (CFuint i = 0; i < nbTv; ++i) {
+    tVec[i] = std::exp(phi[3 + i]);
+  }
+  for (CFuint i = 0; i < ys.size(); ++i) {
+    ys[i] = phi[3 + nbTv + i];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Set the state of the library to the given thermodynamic variables, since
+/// some libraries compute the source terms from their state only
+static void setTabulatedState(PhysicalChemicalLibrary& library, CFdouble temp,
+			      CFdouble rho, const RealVector& tVec, const RealVector& ys,
+			      RealVector& rhoi, RealVector& tState)
+{
+  for (CFuint i = 0; i < ys.size(); ++i) {
+    rhoi[i] = rho*ys[i];
+  }
+  tState[0] = temp;
+  for (CFuint i = 0; i < tVec.size(); ++i) {
+    tState[1 + i] = tVec[i];
+  }
+  library.setState(&rhoi[0], &tState[0]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Mass production terms as a function of the tabulation input
+struct MassProductionFunction : public ISATTable::Function {
+  MassProductionFunction(PhysicalChemicalLibrary& library, RealVector& tVec,
+			 RealVector& ys, RealVector& rhoi, RealVector& tState, 
+			 RealVector& omega, RealMatrix& jacobian) :
+    m_library(library), m_tVec(tVec), m_ys(ys), m_rhoi(rhoi), m_tState(tState),
+    m_omega(omega), m_jacobian(jacobian), m_stateChanged(false) {}
+  
+  void compute(const RealVector& phi, RealVector& f)
+  {
+    CFdouble temp = 0., pressure = 0., rho = 0.;
+    decodeTabulationInput(phi, temp, pressure, rho, m_tVec, m_ys);
+    setTabulatedState(m_library, temp, rho, m_tVec, m_ys, m_rhoi, m_tState);
+    m_stateChanged = true;
+    m_library.getMassProductionTerm(temp, m_tVec, pressure, rho, m_ys, false, m_omega, m_jacobian);
+    f = m_omega;
+  }
+  
+  PhysicalChemicalLibrary& m_library;
+  RealVector& m_tVec;
+  RealVector& m_ys;
+  RealVector& m_rhoi;
+  RealVector& m_tState;
+  RealVector& m_omega;
+  RealMatrix& m_jacobian;
+  bool m_stateChanged;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Source terms [omega, omegav, omegaRad] as a function of the tabulation input
+struct SourceFunction : public ISATTable::Function {
+  SourceFunction(PhysicalChemicalLibrary& library, RealVector& tVec, RealVector& ys, 
+		 RealVector& rhoi, RealVector& tState, RealVector& omega, 
+		 RealVector& omegav, RealMatrix& jacobian) :
+    m_library(library), m_tVec(tVec), m_ys(ys), m_rhoi(rhoi), m_tState(tState),
+    m_omega(omega), m_omegav(omegav), m_jacobian(jacobian), m_stateChanged(false) {}
+  
+  void compute(const RealVector& phi, RealVector& f)
+  {
+    CFdouble temp = 0., pressure = 0., rho = 0., omegaRad = 0.;
+    decodeTabulationInput(phi, temp, pressure, rho, m_tVec, m_ys);
+    setTabulatedState(m_library, temp, rho, m_tVec, m_ys, m_rhoi, m_tState);
+    m_stateChanged = true;
+    m_library.getSource(temp, m_tVec, pressure, rho, m_ys, false, 
+			m_omega, m_omegav, omegaRad, m_jacobian);
+    const CFuint nbSpecies = m_omega.size();
+    for (CFuint i = 0; i < nbSpecies; ++i) {
+      f[i] = m_omega[i];
+    }
+    for (CFuint i = 0; i < m_omegav.size(); ++i) {
+      f[nbSpecies + i] = m_omegav[i];
+    }
+    f[nbSpecies + m_omegav.size()] = omegaRad;
+  }
+  
+  PhysicalChemicalLibrary& m_library;
+  RealVector& m_tVec;
+  RealVector& m_ys;
+  RealVector& m_rhoi;
+  RealVector& m_tState;
+  RealVector& m_omega;
+  RealVector& m_omegav;
+  RealMatrix& m_jacobian;
+  bool m_stateChanged;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 void PhysicalChemicalLibrary::defineConfigOptions(Config::OptionList& options)
 {
   options.addConfigOption< CFint >("electrEnergyID",
@@ -22,6 +130,18 @@ void PhysicalChemicalLibrary::defineConfigOptions(Config::OptionList& options)
   options.addConfigOption< bool >("ShiftH0","Shift the formation enthalpy to have H(T=0K)=0.");
   options.addConfigOption< CFdouble, Config::DynamicOption<> >
     ("MaxTe","Maximum value for the electron temperature."); 
+  options.addConfigOption< bool >
+    ("Tabulation","Flag to tabulate the chemical source terms with in-situ adaptive tabulation (ISAT).");
+  options.addConfigOption< CFreal >
+    ("TabulationTolerance","Relative tolerance on the tabulated source terms.");
+  options.addConfigOption< CFreal >
+    ("TabulationAbsTolerance","Absolute tolerance on the tabulated source terms.");
+  options.addConfigOption< CFreal >
+    ("TabulationMaxRadius","Max radius of the regions of accuracy in the space of log(T), log(p), log(rho), log(Tv), ys.");
+  options.addConfigOption< CFuint >
+    ("TabulationMaxMemory","Max memory per process used by each table in MB.");
+  options.addConfigOption< CFuint >
+    ("TabulationReportRate","Number of queries between two reports of the tabulation statistics (0 for none).");
 }
     
 //////////////////////////////////////////////////////////////////////////////
@@ -39,7 +159,17 @@ PhysicalChemicalLibrary::PhysicalChemicalLibrary(const std::string& name)
     m_vecH0(),
     _extraData(),
     _atomicityCoeff(),
-    _molecule2EqIDs()
+    _molecule2EqIDs(),
+    m_massProdTable(),
+    m_sourceTable(),
+    m_tabPhi(),
+    m_tabF(),
+    m_tabTVec(),
+    m_tabYs(),
+    m_tabRhoi(),
+    m_tabTState(),
+    m_tabOmega(),
+    m_tabOmegav()
 { 
   addConfigOptionsTo(this);
 
@@ -54,6 +184,24 @@ PhysicalChemicalLibrary::PhysicalChemicalLibrary(const std::string& name)
   
   _maxTe = 200000.0;
   setParameter("MaxTe",&_maxTe);
+  
+  m_tabulation = false;
+  setParameter("Tabulation",&m_tabulation);
+  
+  m_tabulationTol = 1e-3;
+  setParameter("TabulationTolerance",&m_tabulationTol);
+  
+  m_tabulationAbsTol = 1e-8;
+  setParameter("TabulationAbsTolerance",&m_tabulationAbsTol);
+  
+  m_tabulationMaxRadius = 0.05;
+  setParameter("TabulationMaxRadius",&m_tabulationMaxRadius);
+  
+  m_tabulationMaxMemory = 256;
+  setParameter("TabulationMaxMemory",&m_tabulationMaxMemory);
+  
+  m_tabulationReportRate = 1000000;
+  setParameter("TabulationReportRate",&m_tabulationReportRate);
 }
     
 //////////////////////////////////////////////////////////////////////////////
@@ -69,6 +217,305 @@ void PhysicalChemicalLibrary::configure ( Config::ConfigArgs& args )
   PhysicalPropertyLibrary::configure(args);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::getTabulatedMassProductionTerm(CFdouble& temp,
+							     RealVector& tVec,
+							     CFdouble& pressure,
+							     CFdouble& rho,
+							     const RealVector& ys,
+							     bool flagJac,
+							     RealVector& omega,
+							     RealMatrix& jacobian)
+{
+  if (!m_tabulation || flagJac) {
+    getMassProductionTerm(temp, tVec, pressure, rho, ys, flagJac, omega, jacobian);
+    return;
+  }
+  
+  setTabulationInput(temp, tVec, pressure, rho, ys);
+  if (!m_massProdTable.isSetup()) {
+    setupTabulation(m_massProdTable, "MassProductionTerm", omega.size());
+  }
+  if (m_tabOmega.size() != omega.size()) m_tabOmega.resize(omega.size());
+  if (m_tabF.size() != omega.size()) m_tabF.resize(omega.size());
+  
+  MassProductionFunction func(*this, m_tabTVec, m_tabYs, m_tabRhoi, m_tabTState, 
+			      m_tabOmega, jacobian);
+  m_massProdTable.compute(m_tabPhi, func, m_tabF);
+  if (func.m_stateChanged) {
+    // restore the state of the queried point
+    setTabulatedState(*this, temp, rho, tVec, ys, m_tabRhoi, m_tabTState);
+  }
+  omega = m_tabF;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::getTabulatedSource(CFdouble& temp,
+						 RealVector& tVec,
+						 CFdouble& pressure,
+						 CFdouble& rho,
+						 const RealVector& ys,
+						 bool flagJac,
+						 RealVector& omega,
+						 RealVector& omegav,
+						 CFdouble& omegaRad,
+						 RealMatrix& jacobian)
+{
+  if (!m_tabulation || flagJac) {
+    getSource(temp, tVec, pressure, rho, ys, flagJac, omega, omegav, omegaRad, jacobian);
+    return;
+  }
+  
+  setTabulationInput(temp, tVec, pressure, rho, ys);
+  const CFuint nbSpecies = omega.size();
+  const CFuint nbOmegav = omegav.size();
+  if (!m_sourceTable.isSetup()) {
+    setupTabulation(m_sourceTable, "Source", nbSpecies + nbOmegav + 1);
+  }
+  if (m_tabOmega.size() != nbSpecies) m_tabOmega.resize(nbSpecies);
+  if (m_tabOmegav.size() != nbOmegav) m_tabOmegav.resize(nbOmegav);
+  if (m_tabF.size() != nbSpecies + nbOmegav + 1) m_tabF.resize(nbSpecies + nbOmegav + 1);
+  
+  SourceFunction func(*this, m_tabTVec, m_tabYs, m_tabRhoi, m_tabTState, 
+		      m_tabOmega, m_tabOmegav, jacobian);
+  m_sourceTable.compute(m_tabPhi, func, m_tabF);
+  if (func.m_stateChanged) {
+    // restore the state of the queried point
+    setTabulatedState(*this, temp, rho, tVec, ys, m_tabRhoi, m_tabTState);
+  }
+  for (CFuint i = 0; i < nbSpecies; ++i) {
+    omega[i] = m_tabF[i];
+  }
+  for (CFuint i = 0; i < nbOmegav; ++i) {
+    omegav[i] = m_tabF[nbSpecies + i];
+  }
+  omegaRad = m_tabF[nbSpecies + nbOmegav];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::setDensityEnthalpyEnergyBatch(const CFuint nb,
+							    const CFdouble* temp,
+							    const CFdouble* pressure,
+							    CFdouble* dhe,
+							    CFdouble* gammaAndA)
+{
+  RealVector dheCell(3);
+  for (CFuint i = 0; i < nb; ++i) {
+    CFdouble T = temp[i];
+    CFdouble p = pressure[i];
+    setComposition(T, p);
+    setDensityEnthalpyEnergy(T, p, dheCell);
+    dhe[3*i]   = dheCell[0];
+    dhe[3*i+1] = dheCell[1];
+    dhe[3*i+2] = dheCell[2];
+    if (gammaAndA != CFNULL) {
+      CFdouble rho = dheCell[0];
+      gammaAndSoundSpeed(T, p, rho, gammaAndA[2*i], gammaAndA[2*i+1]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::gammaAndSoundSpeedBatch(const CFuint nb,
+						      const CFdouble* temp,
+						      const CFdouble* pressure,
+						      const CFdouble* rho,
+						      CFdouble* gamma,
+						      CFdouble* soundSpeed)
+{
+  for (CFuint i = 0; i < nb; ++i) {
+    CFdouble T = temp[i];
+    CFdouble p = pressure[i];
+    CFdouble r = rho[i];
+    setComposition(T, p);
+    gammaAndSoundSpeed(T, p, r, gamma[i], soundSpeed[i]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::setThermodynamicStateBatch(const CFuint nb,
+							 const CFuint nbTemps,
+							 const CFdouble* rhoi,
+							 const CFdouble* temp,
+							 const CFdouble* rho,
+							 const CFdouble* tempDim,
+							 CFdouble* pressure,
+							 CFdouble* dhe,
+							 CFdouble* gammaAndA,
+							 bool storeExtraData)
+{
+  cf_assert(nbTemps > 0);
+  const CFuint nbSpecies = _NS;
+  const CFuint nbDhe = 2 + nbTemps;
+  RealVector ys(nbSpecies);
+  RealVector rhoiCell(nbSpecies);
+  RealVector tCell(nbTemps);
+  RealVector tVec(nbTemps - 1);
+  RealVector dheCell(nbDhe);
+  for (CFuint i = 0; i < nb; ++i) {
+    CFdouble sumRhoi = 0.;
+    for (CFuint s = 0; s < nbSpecies; ++s) {
+      rhoiCell[s] = rhoi[i*nbSpecies + s];
+      sumRhoi += rhoiCell[s];
+    }
+    cf_assert(sumRhoi > 0.);
+    for (CFuint s = 0; s < nbSpecies; ++s) {
+      ys[s] = rhoiCell[s]/sumRhoi;
+    }
+    for (CFuint t = 0; t < nbTemps; ++t) {
+      tCell[t] = temp[i*nbTemps + t];
+    }
+    for (CFuint t = 1; t < nbTemps; ++t) {
+      tVec[t-1] = tempDim[i*nbTemps + t];
+    }
+
+    setSpeciesFractions(ys);
+    setState(&rhoiCell[0], &tCell[0]);
+
+    CFdouble r = rho[i];
+    CFdouble T = tempDim[i*nbTemps];
+    CFdouble p = (nbTemps > 1) ? this->pressure(r, T, &tVec[0]) : this->pressure(r, T, CFNULL);
+    pressure[i] = p;
+
+    if (dhe != CFNULL) {
+      if (nbTemps > 1) {
+	setDensityEnthalpyEnergy(T, tVec, p, dheCell, storeExtraData);
+      }
+      else {
+	setDensityEnthalpyEnergy(T, p, dheCell);
+      }
+      for (CFuint k = 0; k < nbDhe; ++k) {
+	dhe[i*nbDhe + k] = dheCell[k];
+      }
+    }
+
+    if (gammaAndA != CFNULL) {
+      RealVector *const tVecPtr = (nbTemps > 1) ? &tVec : CFNULL;
+      frozenGammaAndSoundSpeed(T, p, r, gammaAndA[2*i], gammaAndA[2*i+1], tVecPtr);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::getMassProductionTermBatch(const CFuint nb,
+							 const CFuint nbTemps,
+							 const CFdouble* temp,
+							 const CFdouble* pressure,
+							 const CFdouble* rhoi,
+							 CFdouble* omega)
+{
+  cf_assert(nbTemps > 0);
+  const CFuint nbSpecies = _NS;
+  RealVector tVec(nbTemps - 1);
+  RealVector ys(nbSpecies);
+  RealVector omegaCell(nbSpecies);
+  RealVector rhoiCell(nbSpecies);
+  RealVector tCell(nbTemps);
+  RealMatrix jacobian;
+  for (CFuint i = 0; i < nb; ++i) {
+    const CFdouble *const rhoiPtr = &rhoi[i*nbSpecies];
+    CFdouble rho = 0.;
+    for (CFuint s = 0; s < nbSpecies; ++s) {
+      rhoiCell[s] = rhoiPtr[s];
+      rho += rhoiPtr[s];
+    }
+    cf_assert(rho > 0.);
+    for (CFuint s = 0; s < nbSpecies; ++s) {
+      ys[s] = rhoiCell[s]/rho;
+    }
+    for (CFuint t = 0; t < nbTemps; ++t) {
+      tCell[t] = temp[i*nbTemps + t];
+    }
+    for (CFuint t = 1; t < nbTemps; ++t) {
+      tVec[t-1] = tCell[t];
+    }
+    
+    CFdouble T = tCell[0];
+    CFdouble p = pressure[i];
+    setState(&rhoiCell[0], &tCell[0]);
+    getMassProductionTerm(T, tVec, p, rho, ys, false, omegaCell, jacobian);
+    for (CFuint s = 0; s < nbSpecies; ++s) {
+      omega[i*nbSpecies + s] = omegaCell[s];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::getTransportCoefsBatch(const CFuint nb,
+						     const CFdouble* temp,
+						     const CFdouble* pressure,
+						     CFdouble* lambda,
+						     CFdouble* lambdacor,
+						     CFdouble* lambdael,
+						     CFdouble* eldifcoef,
+						     CFdouble* eltdifcoef)
+{
+  const CFuint nbElements = _NC;
+  RealVector lambdaelCell(nbElements);
+  RealMatrix eldifcoefCell(nbElements, nbElements);
+  RealVector eltdifcoefCell(nbElements);
+  for (CFuint i = 0; i < nb; ++i) {
+    CFdouble T = temp[i];
+    CFdouble p = pressure[i];
+    getTransportCoefs(T, p, lambda[i], lambdacor[i], 
+		      lambdaelCell, eldifcoefCell, eltdifcoefCell);
+    for (CFuint e = 0; e < nbElements; ++e) {
+      lambdael[i*nbElements + e] = lambdaelCell[e];
+      eltdifcoef[i*nbElements + e] = eltdifcoefCell[e];
+      for (CFuint f = 0; f < nbElements; ++f) {
+	eldifcoef[(i*nbElements + e)*nbElements + f] = eldifcoefCell(e,f);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::setTabulationInput(CFdouble temp, const RealVector& tVec, 
+						 CFdouble pressure, CFdouble rho, 
+						 const RealVector& ys)
+{
+  // logarithms of the thermodynamic variables, so that the tolerances and 
+  // radii are relative, and mass fractions as they are
+  static const CFreal minValue = 1e-300;
+  const CFuint nbTv = tVec.size();
+  if (m_tabPhi.size() != 3 + nbTv + ys.size()) {
+    m_tabPhi.resize(3 + nbTv + ys.size());
+    m_tabTVec.resize(nbTv);
+    m_tabYs.resize(ys.size());
+    m_tabRhoi.resize(ys.size());
+    m_tabTState.resize(1 + nbTv);
+  }
+  m_tabPhi[0] = std::log(std::max(temp, minValue));
+  m_tabPhi[1] = std::log(std::max(pressure, minValue));
+  m_tabPhi[2] = std::log(std::max(rho, minValue));
+  for (CFuint i = 0; i < nbTv; ++i) {
+    m_tabPhi[3 + i] = std::log(std::max(tVec[i], minValue));
+  }
+  for (CFuint i = 0; i < ys.size(); ++i) {
+    m_tabPhi[3 + nbTv + i] = ys[i];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void PhysicalChemicalLibrary::setupTabulation(ISATTable& table, const std::string& name,
+					      const CFuint nbOutputs)
+{
+  const CFuint nbInputs = m_tabPhi.size();
+  const CFuint maxRecords = static_cast<CFuint>
+    (m_tabulationMaxMemory*1048576./ISATTable::getRecordSize(nbInputs, nbOutputs));
+  table.setup(getName() + "::" + name, nbInputs, nbOutputs, m_tabulationTol, 
+	      m_tabulationAbsTol, m_tabulationMaxRadius, maxRecords, m_tabulationReportRate);
+}
+
 //////////////////////////////////////////////////////////////////////////////
   
 } // namespace Framework
@@ -10,6 +10,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "Framework/PhysicalPropertyLibrary.hh"
+#include "Framework/ISATTable.hh"
 #include "Common/NotImplementedException.hh"
 #include "MathTools/RealVector.hh"
 #include "MathTools/RealMatrix.hh"
@@ -425,6 +426,18 @@ public:
   			     RealVector& omega,
   			     RealMatrix& jacobian) = 0;
 
+  /// Returns the mass production/destruction terms as getMassProductionTerm(),
+  /// through the in-situ adaptive tabulation if the option Tabulation is active.
+  /// The analytical Jacobian matrix is always computed directly.
+  void getTabulatedMassProductionTerm(CFdouble& temp,
+				      RealVector& tVec,
+				      CFdouble& pressure,
+				      CFdouble& rho,
+				      const RealVector& ys,
+				      bool flagJac,
+				      RealVector& omega,
+				      RealMatrix& jacobian);
+  
   /// Returns the source term for the vibrational relaxation with VT transfer
   /// @param temp the mixture temperature
   /// @param tVec the vibrational temperature
@@ -463,6 +476,20 @@ public:
 			  CFdouble& omegaRad,
 			  RealMatrix& jacobian) = 0;
   
+  /// Returns the source terms as getSource(), through the in-situ adaptive 
+  /// tabulation if the option Tabulation is active.
+  /// The analytical Jacobian matrix is always computed directly.
+  void getTabulatedSource(CFdouble& temp,
+			  RealVector& tVec,
+			  CFdouble& pressure,
+			  CFdouble& rho,
+			  const RealVector& ys,
+			  bool flagJac,
+			  RealVector& omega,
+			  RealVector& omegav,
+			  CFdouble& omegaRad,
+			  RealMatrix& jacobian);
+  
   /**
    * Returns the source terms species continuity equations, 
    * vibrational energy conservation equation and 
@@ -522,6 +549,88 @@ public:
 				       RealVector* hsVib = CFNULL,
 				       RealVector* hsEl = CFNULL) = 0;
   
+  /// Batched LTE density, enthalpy and energy for nb cells: the composition 
+  /// is set for each cell, so setComposition() is not needed before
+  /// @param temp        temperatures (nb)
+  /// @param pressure    pressures (nb)
+  /// @param dhe         density, enthalpy and energy (3 per cell)
+  /// @param gammaAndA   if not CFNULL, equilibrium gamma and sound speed (2 per cell)
+  virtual void setDensityEnthalpyEnergyBatch(const CFuint nb,
+					     const CFdouble* temp,
+					     const CFdouble* pressure,
+					     CFdouble* dhe,
+					     CFdouble* gammaAndA = CFNULL);
+  
+  /// Batched LTE gamma and sound speed for nb cells: the composition 
+  /// is set for each cell, so setComposition() is not needed before
+  /// @param temp        temperatures (nb)
+  /// @param pressure    pressures (nb)
+  /// @param rho         densities (nb)
+  /// @param gamma       gammas (nb)
+  /// @param soundSpeed  sound speeds (nb)
+  virtual void gammaAndSoundSpeedBatch(const CFuint nb,
+				       const CFdouble* temp,
+				       const CFdouble* pressure,
+				       const CFdouble* rho,
+				       CFdouble* gamma,
+				       CFdouble* soundSpeed);
+
+  /// Batched NEQ thermodynamics for nb cells: for each cell the species
+  /// fractions and the state are set, as with setSpeciesFractions() and
+  /// setState(), before computing the pressure and the energies
+  /// @param nbTemps     number of temperatures per cell (T and Tv's)
+  /// @param rhoi        partial densities passed to setState() (NS per cell)
+  /// @param temp        temperatures passed to setState() (nbTemps per cell)
+  /// @param rho         dimensional densities (nb)
+  /// @param tempDim     dimensional temperatures (nbTemps per cell)
+  /// @param pressure    dimensional pressures (nb)
+  /// @param dhe         if not CFNULL, density, enthalpy, energy and vibrational
+  ///                    energies (2 + nbTemps per cell)
+  /// @param gammaAndA   if not CFNULL, frozen gamma and sound speed (2 per cell)
+  /// @param storeExtraData  flag telling if extra data have to be stored:
+  ///                    they correspond to the last cell
+  virtual void setThermodynamicStateBatch(const CFuint nb,
+					  const CFuint nbTemps,
+					  const CFdouble* rhoi,
+					  const CFdouble* temp,
+					  const CFdouble* rho,
+					  const CFdouble* tempDim,
+					  CFdouble* pressure,
+					  CFdouble* dhe,
+					  CFdouble* gammaAndA,
+					  bool storeExtraData = false);
+
+  /// Batched mass production terms for nb cells: the state is set for 
+  /// each cell, so setState() is not needed before
+  /// @param nbTemps     number of temperatures per cell (T and Tv's)
+  /// @param temp        temperatures (nbTemps per cell)
+  /// @param pressure    pressures (nb)
+  /// @param rhoi        partial densities (NS per cell)
+  /// @param omega       mass production terms (NS per cell)
+  virtual void getMassProductionTermBatch(const CFuint nb,
+					  const CFuint nbTemps,
+					  const CFdouble* temp,
+					  const CFdouble* pressure,
+					  const CFdouble* rhoi,
+					  CFdouble* omega);
+  
+  /// Batched elemental transport coefficients for nb cells (see getTransportCoefs())
+  /// @param temp        temperatures (nb)
+  /// @param pressure    pressures (nb)
+  /// @param lambda      thermal conductivities (nb)
+  /// @param lambdacor   corrected thermal conductivities (nb)
+  /// @param lambdael    elemental thermal demixing coefficients (NC per cell)
+  /// @param eldifcoef   elemental multicomponent diffusion coefficients (NC*NC per cell)
+  /// @param eltdifcoef  elemental thermal diffusion coefficients (NC per cell)
+  virtual void getTransportCoefsBatch(const CFuint nb,
+				      const CFdouble* temp,
+				      const CFdouble* pressure,
+				      CFdouble* lambda,
+				      CFdouble* lambdacor,
+				      CFdouble* lambdael,
+				      CFdouble* eldifcoef,
+				      CFdouble* eltdifcoef);
+  
   /// Temperature of free electrons
   CFdouble getTe(CFdouble temp, CFreal* tVec)
   {
@@ -532,6 +641,15 @@ public:
     return (presenceElectron()) ? std::min(tVec[_electrEnergyID],(CFreal)_maxTe) : temp;
   }
   
+protected:
+  
+  /// set the input of the tabulation: log(T), log(p), log(rho), log(Tv), ys
+  void setTabulationInput(CFdouble temp, const RealVector& tVec, CFdouble pressure,
+			  CFdouble rho, const RealVector& ys);
+  
+  /// set up the given tabulation table
+  void setupTabulation(ISATTable& table, const std::string& name, const CFuint nbOutputs);
+  
 protected:
   
   /// number of (types of) species
@@ -582,6 +700,54 @@ protected:
   /// Max value for Te
   CFdouble _maxTe;
   
+  /// flag telling to tabulate the chemical source terms
+  bool m_tabulation;
+  
+  /// relative tolerance of the tabulation
+  CFreal m_tabulationTol;
+  
+  /// absolute tolerance of the tabulation
+  CFreal m_tabulationAbsTol;
+  
+  /// max radius of the regions of accuracy in the space of log(T), log(p), log(rho), log(Tv), ys
+  CFreal m_tabulationMaxRadius;
+  
+  /// max memory per process used by each table in MB
+  CFuint m_tabulationMaxMemory;
+  
+  /// number of queries between two reports of the tabulation statistics
+  CFuint m_tabulationReportRate;
+  
+  /// tabulation of the mass production terms
+  ISATTable m_massProdTable;
+  
+  /// tabulation of the source terms
+  ISATTable m_sourceTable;
+  
+  /// input of the tabulation
+  RealVector m_tabPhi;
+  
+  /// output of the tabulation
+  RealVector m_tabF;
+  
+  /// vibrational temperatures for the tabulated function
+  RealVector m_tabTVec;
+  
+  /// mass fractions for the tabulated function
+  RealVector m_tabYs;
+  
+  /// partial densities of the state set by the tabulated function
+  RealVector m_tabRhoi;
+  
+  /// temperatures of the state set by the tabulated function
+  RealVector m_tabTState;
+  
+  /// mass production terms for the tabulated function
+  RealVector m_tabOmega;
+  
+  /// vibrational source terms for the tabulated function
+  RealVector m_tabOmegav;
+  
 }; // end of class PhysicalChemicalLibrary
 
 //////////////////////////////////////////////////////////////////////////////
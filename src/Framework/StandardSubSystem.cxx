@@ -29,6 +29,7 @@
 #include "Framework/MeshCreator.hh"
 #include "Framework/MeshAdapterMethod.hh"
 #include "Framework/ErrorEstimatorMethod.hh"
+#include "Framework/DynamicBalancerMethod.hh"
 #include "Framework/CouplerMethod.hh"
 #include "Framework/ConvergenceMethod.hh"
 #include "Framework/SpaceMethod.hh"
@@ -80,6 +81,8 @@ void StandardSubSystem::defineConfigOptions(Config::OptionList& options)
    options.addConfigOption< std::vector<std::string> >("ErrorEstimatorNames","Names of the error estimator.");
    options.addConfigOption< std::vector<std::string> >("MeshCreator","Self-reg keys of the mesh creator.");
    options.addConfigOption< std::vector<std::string> >("ErrorEstimatorMethod","Self-reg keys of the error estimator.");
+   options.addConfigOption< std::vector<std::string> >("DynamicBalancerMethod","Self-reg keys of the dynamic load balancer.");
+   options.addConfigOption< std::vector<std::string> >("DynamicBalancerNames","Names of the dynamic load balancer.");
    options.addConfigOption< std::vector<std::string> >("OutputFormat","Self-reg keys of the output format.");
    options.addConfigOption< std::vector<std::string> >("MeshCreatorNames","Names of the mesh creator.");
    options.addConfigOption< std::vector<std::string> >("ConvergenceMethodNames","Names of the convergence method.");
@@ -126,6 +129,10 @@ StandardSubSystem::StandardSubSystem(const std::string& name)
   setParameter("ErrorEstimatorMethod",&m_errorEstimatorMethod.mKeys);
   setParameter("ErrorEstimatorNames",&m_errorEstimatorMethod.mNames);
 
+  // DynamicBalancer-related configuration options
+  setParameter("DynamicBalancerMethod",&m_dynamicBalancerMethod.mKeys);
+  setParameter("DynamicBalancerNames",&m_dynamicBalancerMethod.mNames);
+
   // SpaceMethod-related configuration options
   setParameter("SpaceMethod",&m_spaceMethod.mKeys);
   setParameter("SpaceMethodNames",&m_spaceMethod.mNames);
@@ -207,6 +214,12 @@ void StandardSubSystem::configure ( Config::ConfigArgs& args )
   
   // builds ErrorEstimatorMethod
   configureMultiMethod<ErrorEstimatorMethod>(args,m_errorEstimatorMethod);
+  
+  // builds DynamicBalancerMethod (no Null method exists for it: 
+  // the tuple is simply left empty if no balancer is requested)
+  if (m_dynamicBalancerMethod.mKeys.size() > 0) {
+    configureMultiMethod<DynamicBalancerMethod>(args,m_dynamicBalancerMethod);
+  }
 
   // configure multi method
   configureMultiMethod<LinearSystemSolver>(args,m_linearSystemSolver);
@@ -510,6 +523,11 @@ void StandardSubSystem::setup()
   m_errorEstimatorMethod.apply
     (mem_fun<void,ErrorEstimatorMethod>(&ErrorEstimatorMethod::setMethod));
   
+  CFLog(NOTICE,"-------------------------------------------------------------\n");
+  CFLogInfo("Setting up DynamicBalancerMethod's\n");
+  m_dynamicBalancerMethod.apply
+    (mem_fun<void,DynamicBalancerMethod>(&DynamicBalancerMethod::setMethod));
+  
   // AL: recent change here: before this was after setCouplerMethod()
   CFLog(NOTICE,"-------------------------------------------------------------\n");
   CFLogInfo("Setting up DataPostProcessing's\n");
@@ -736,6 +754,11 @@ void StandardSubSystem::run()
     bool dontforce = false;
     writeSolution(dontforce);
     
+    CFLog(VERBOSE, "StandardSubSystem::run() => m_dynamicBalancerMethod.apply()\n");
+    // dynamic load balancing (the new partition is applied at restart)
+    m_dynamicBalancerMethod.apply(mem_fun<void,DynamicBalancerMethod>
+                                  (&DynamicBalancerMethod::doDynamicBalance));
+    
     // unsetup();
     // buildMeshData();
     // setup(); 
@@ -805,6 +828,10 @@ void StandardSubSystem::unsetup()
   m_outputFormat.apply
     (root_mem_fun<void,OutputFormatter>(&OutputFormatter::unsetMethod));
   
+  CFLog(VERBOSE, "StandardSubSystem::unsetup() => DynamicBalancerMethod\n");
+  m_dynamicBalancerMethod.apply
+    (mem_fun<void,DynamicBalancerMethod>(&DynamicBalancerMethod::unsetMethod));
+  
   CFLog(VERBOSE, "StandardSubSystem::unsetup() => ErrorEstimatorMethod\n");
   m_errorEstimatorMethod.apply
     (mem_fun<void,ErrorEstimatorMethod>(&ErrorEstimatorMethod::unsetMethod));
@@ -854,6 +881,7 @@ vector<Method*> StandardSubSystem::getMethodList()
   copy(m_couplerMethod.begin(), m_couplerMethod.end(), back_inserter(mList));
   copy(m_meshAdapterMethod.begin(), m_meshAdapterMethod.end(), back_inserter(mList));
   copy(m_errorEstimatorMethod.begin(), m_errorEstimatorMethod.end(), back_inserter(mList));
+  copy(m_dynamicBalancerMethod.begin(), m_dynamicBalancerMethod.end(), back_inserter(mList));
   copy(m_linearSystemSolver.begin(), m_linearSystemSolver.end(), back_inserter(mList));
   copy(m_convergenceMethod.begin(), m_convergenceMethod.end(), back_inserter(mList));
   copy(m_spaceMethod.begin(), m_spaceMethod.end(), back_inserter(mList));
@@ -24,6 +24,7 @@ namespace COOLFluiD {
     class ErrorEstimatorMethod;
     class CouplerMethod;
     class MeshAdapterMethod;
+    class DynamicBalancerMethod;
     class OutputFormatter;
     class DataProcessingMethod;
     class MeshCreator;
@@ -177,6 +178,9 @@ protected: // functions
   /// ErrorEstimatorMethod to discretize the domain
   MultiMethodTuple<ErrorEstimatorMethod> m_errorEstimatorMethod;
 
+  /// DynamicBalancerMethod to repartition the mesh at run time
+  MultiMethodTuple<DynamicBalancerMethod> m_dynamicBalancerMethod;
+
   /// SpaceMethod to discretize the domain
   MultiMethodTuple<SpaceMethod> m_spaceMethod;
 
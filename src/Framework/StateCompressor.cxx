@@ -0,0 +1,261 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "Framework/StateCompressor.hh"
+#include "Framework/BadFormatException.hh"
+
+// CF_HAVE_ZLIB is defined in coolfluid_config.h, included by the headers above
+#ifdef CF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Framework {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// encoding of each variable
+enum {LOSSLESS=0, QUANTIZED=1};
+
+// encoding of the whole block
+enum {STORED=0, DEFLATED=1};
+
+// header: block encoding (1 byte) + size of the uncompressed stream (8 bytes)
+static const CFuint headerSize = 1 + sizeof(unsigned long long);
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StateCompressor::compress(const CFreal* data, const CFuint nbEntries, const CFuint stride,
+			       const vector<CFreal>& absTol, const vector<CFreal>& relTol,
+			       vector<char>& out)
+{
+  vector<unsigned char> raw;
+  raw.reserve(nbEntries*stride*sizeof(CFreal) + stride);
+
+  for (CFuint iVar = 0; iVar < stride; ++iVar) {
+    CFreal tol = (iVar < absTol.size()) ? absTol[iVar] : 0.;
+    if (iVar < relTol.size() && relTol[iVar] > 0. && nbEntries > 0) {
+      CFreal vmin = data[iVar];
+      CFreal vmax = data[iVar];
+      for (CFuint i = 1; i < nbEntries; ++i) {
+	vmin = std::min(vmin, data[i*stride + iVar]);
+	vmax = std::max(vmax, data[i*stride + iVar]);
+      }
+      tol = std::max(tol, relTol[iVar]*(vmax - vmin));
+    }
+
+    // fall back to the lossless encoding if the quantization is not applicable
+    const size_t start = raw.size();
+    bool quantized = false;
+    if (tol > 0. && nbEntries > 0) {
+      raw.push_back(QUANTIZED);
+      quantized = encodeLossy(&data[iVar], nbEntries, stride, tol, raw);
+      if (!quantized) raw.resize(start);
+    }
+
+    if (!quantized) {
+      raw.push_back(LOSSLESS);
+      encodeLossless(&data[iVar], nbEntries, stride, raw);
+    }
+  }
+
+  const unsigned long long rawSize = raw.size();
+  out.resize(headerSize + raw.size());
+  out[0] = STORED;
+  memcpy(&out[1], &rawSize, sizeof(unsigned long long));
+
+#ifdef CF_HAVE_ZLIB
+  uLongf zSize = compressBound(raw.size());
+  vector<char> zout(headerSize + zSize);
+  if (rawSize > 0 &&
+      compress2(reinterpret_cast<Bytef*>(&zout[headerSize]), &zSize,
+		&raw[0], raw.size(), Z_BEST_SPEED) == Z_OK && zSize < raw.size()) {
+    zout.resize(headerSize + zSize);
+    zout[0] = DEFLATED;
+    memcpy(&zout[1], &rawSize, sizeof(unsigned long long));
+    out.swap(zout);
+    return;
+  }
+#endif
+
+  if (rawSize > 0) {
+    memcpy(&out[headerSize], &raw[0], raw.size());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StateCompressor::decompress(const char* in, const CFuint inSize,
+				 const CFuint nbEntries, const CFuint stride, CFreal* data)
+{
+  if (inSize < headerSize) {
+    throw BadFormatException (FromHere(), "StateCompressor::decompress() => truncated block");
+  }
+
+  unsigned long long rawSize = 0;
+  memcpy(&rawSize, &in[1], sizeof(unsigned long long));
+
+  vector<unsigned char> inflated;
+  const unsigned char* raw = reinterpret_cast<const unsigned char*>(&in[headerSize]);
+  if (in[0] == DEFLATED) {
+#ifdef CF_HAVE_ZLIB
+    inflated.resize(rawSize);
+    uLongf outSize = rawSize;
+    if (uncompress(&inflated[0], &outSize, raw, inSize - headerSize) != Z_OK ||
+	outSize != rawSize) {
+      throw BadFormatException (FromHere(), "StateCompressor::decompress() => corrupted block");
+    }
+    raw = &inflated[0];
+#else
+    throw BadFormatException
+      (FromHere(), "StateCompressor::decompress() => block is deflated but zlib is not available");
+#endif
+  }
+  else if (rawSize != inSize - headerSize) {
+    throw BadFormatException (FromHere(), "StateCompressor::decompress() => truncated block");
+  }
+
+  const CFuint nbBytes = sizeof(CFreal);
+  size_t pos = 0;
+  for (CFuint iVar = 0; iVar < stride; ++iVar) {
+    if (pos >= rawSize) {
+      throw BadFormatException (FromHere(), "StateCompressor::decompress() => truncated block");
+    }
+
+    const unsigned char encoding = raw[pos++];
+    if (encoding == LOSSLESS) {
+      if (pos + nbEntries*nbBytes > rawSize) {
+	throw BadFormatException (FromHere(), "StateCompressor::decompress() => truncated block");
+      }
+
+      // byte plane b holds the b-th byte of the XOR delta of all the entries
+      unsigned char prev[sizeof(CFreal)];
+      unsigned char curr[sizeof(CFreal)];
+      memset(prev, 0, nbBytes);
+      for (CFuint i = 0; i < nbEntries; ++i) {
+	for (CFuint b = 0; b < nbBytes; ++b) {
+	  curr[b] = raw[pos + b*nbEntries + i] ^ prev[b];
+	}
+	memcpy(&data[i*stride + iVar], curr, nbBytes);
+	memcpy(prev, curr, nbBytes);
+      }
+      pos += nbEntries*nbBytes;
+    }
+    else if (encoding == QUANTIZED) {
+      if (pos + 2*nbBytes > rawSize) {
+	throw BadFormatException (FromHere(), "StateCompressor::decompress() => truncated block");
+      }
+
+      CFreal step = 0.;
+      CFreal value = 0.;
+      memcpy(&step, &raw[pos], nbBytes); pos += nbBytes;
+      memcpy(&value, &raw[pos], nbBytes); pos += nbBytes;
+      data[iVar] = value;
+      for (CFuint i = 1; i < nbEntries; ++i) {
+	// zig-zag encoded variable length integer
+	unsigned long long z = 0;
+	CFuint shift = 0;
+	unsigned char byte = 0;
+	do {
+	  if (pos >= rawSize) {
+	    throw BadFormatException (FromHere(), "StateCompressor::decompress() => truncated block");
+	  }
+	  byte = raw[pos++];
+	  z |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+	  shift += 7;
+	} while (byte & 0x80);
+
+	const long long q = static_cast<long long>(z >> 1) ^ -static_cast<long long>(z & 1);
+	value += static_cast<CFreal>(q)*step;
+	data[i*stride + iVar] = value;
+      }
+    }
+    else {
+      throw BadFormatException (FromHere(), "StateCompressor::decompress() => unknown encoding");
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void StateCompressor::encodeLossless(const CFreal* data, const CFuint nbEntries,
+				     const CFuint stride, vector<unsigned char>& raw)
+{
+  const CFuint nbBytes = sizeof(CFreal);
+  const size_t start = raw.size();
+  raw.resize(start + nbEntries*nbBytes);
+
+  // consecutive values share sign, exponent and leading mantissa bits:
+  // their XOR is mostly made of zeros, gathered in the most significant byte planes
+  unsigned char prev[sizeof(CFreal)];
+  unsigned char curr[sizeof(CFreal)];
+  memset(prev, 0, nbBytes);
+  for (CFuint i = 0; i < nbEntries; ++i) {
+    memcpy(curr, &data[i*stride], nbBytes);
+    for (CFuint b = 0; b < nbBytes; ++b) {
+      raw[start + b*nbEntries + i] = curr[b] ^ prev[b];
+    }
+    memcpy(prev, curr, nbBytes);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool StateCompressor::encodeLossy(const CFreal* data, const CFuint nbEntries,
+				  const CFuint stride, const CFreal tol,
+				  vector<unsigned char>& raw)
+{
+  const CFuint nbBytes = sizeof(CFreal);
+  const CFreal step = 2.*tol;
+  CFreal value = data[0];
+  if (!(std::abs(value) <= std::numeric_limits<CFreal>::max())) return false;
+
+  const size_t start = raw.size();
+  raw.resize(start + 2*nbBytes);
+  memcpy(&raw[start], &step, nbBytes);
+  memcpy(&raw[start + nbBytes], &value, nbBytes);
+
+  for (CFuint i = 1; i < nbEntries; ++i) {
+    // the prediction is the previous reconstructed value, exactly as in decompress()
+    const CFreal x = data[i*stride];
+    const CFreal d = (x - value)/step;
+    if (!(std::abs(d) < 1e15)) return false;
+
+    const long long q = static_cast<long long>(std::floor(d + 0.5));
+    value += static_cast<CFreal>(q)*step;
+    if (!(std::abs(x - value) <= tol)) return false;
+
+    unsigned long long z = (static_cast<unsigned long long>(q) << 1) ^
+      static_cast<unsigned long long>(q >> 63);
+    while (z >= 0x80) {
+      raw.push_back(static_cast<unsigned char>(z | 0x80));
+      z >>= 7;
+    }
+    raw.push_back(static_cast<unsigned char>(z));
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Framework
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
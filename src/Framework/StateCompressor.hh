@@ -0,0 +1,76 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef COOLFluiD_Framework_StateCompressor_hh
+#define COOLFluiD_Framework_StateCompressor_hh
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Common/COOLFluiD.hh"
+#include "Framework/Framework.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace COOLFluiD {
+
+  namespace Framework {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class compresses blocks of interleaved state data, one variable at
+/// a time. A variable with zero tolerance is stored losslessly (XOR delta
+/// of consecutive values, split into byte planes), otherwise its values are
+/// quantized on a uniform grid through a previous-value predictor, so that
+/// the reconstruction error never exceeds the given tolerance.
+/// The resulting stream is deflated with zlib, if available.
+class Framework_API StateCompressor {
+public:
+
+  /// Compress a block of data
+  /// @param data      interleaved data, nbEntries*stride values
+  /// @param nbEntries number of entries (e.g. states) in the block
+  /// @param stride    number of variables per entry
+  /// @param absTol    absolute tolerance per variable (missing means 0)
+  /// @param relTol    tolerance per variable relative to its range in the block
+  /// @param out       compressed data (overwritten)
+  static void compress(const CFreal* data, const CFuint nbEntries, const CFuint stride,
+		       const std::vector<CFreal>& absTol, const std::vector<CFreal>& relTol,
+		       std::vector<char>& out);
+
+  /// Decompress a block of data produced by compress()
+  /// @param in        compressed data
+  /// @param inSize    size in bytes of the compressed data
+  /// @param nbEntries number of entries in the block
+  /// @param stride    number of variables per entry
+  /// @param data      interleaved data, with room for nbEntries*stride values
+  static void decompress(const char* in, const CFuint inSize,
+			 const CFuint nbEntries, const CFuint stride, CFreal* data);
+
+private:
+
+  /// Append the lossless encoding of one variable
+  static void encodeLossless(const CFreal* data, const CFuint nbEntries,
+			     const CFuint stride, std::vector<unsigned char>& raw);
+
+  /// Append the quantized encoding of one variable
+  /// @return false if the tolerance cannot be guaranteed
+  static bool encodeLossy(const CFreal* data, const CFuint nbEntries,
+			  const CFuint stride, const CFreal tol,
+			  std::vector<unsigned char>& raw);
+
+}; // end of class StateCompressor
+
+//////////////////////////////////////////////////////////////////////////////
+
+  } // namespace Framework
+
+} // namespace COOLFluiD
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // COOLFluiD_Framework_StateCompressor_hh
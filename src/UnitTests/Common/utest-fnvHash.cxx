@@ -0,0 +1,78 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test FNVHash"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "Common/FNVHash.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( FNVHash_TestSuite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( referenceValues )
+{
+  // reference values of the 64-bit FNV-1a hash
+  FNVHash empty;
+  BOOST_CHECK_EQUAL(empty.str(), "cbf29ce484222325");
+  
+  FNVHash a;
+  a.add(string("a"));
+  BOOST_CHECK_EQUAL(a.str(), "af63dc4c8601ec8c");
+  
+  FNVHash foobar;
+  foobar.add(string("foobar"));
+  BOOST_CHECK_EQUAL(foobar.str(), "85944171f73967e8");
+  BOOST_CHECK_EQUAL(foobar.getValue(), 0x85944171f73967e8ULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( pieces )
+{
+  // the hash does not depend on how the bytes are split
+  vector<double> values(10);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = 0.1*i;
+  }
+  
+  FNVHash whole;
+  whole.add(&values[0], values.size()*sizeof(double));
+  
+  FNVHash pieces;
+  for (size_t i = 0; i < values.size(); ++i) {
+    pieces.addValue(values[i]);
+  }
+  BOOST_CHECK_EQUAL(whole.str(), pieces.str());
+  
+  FNVHash other;
+  values[3] = -values[3];
+  other.add(&values[0], values.size()*sizeof(double));
+  BOOST_CHECK(whole.getValue() != other.getValue());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
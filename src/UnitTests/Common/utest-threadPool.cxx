@@ -0,0 +1,223 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test ThreadPool"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Common/ThreadPool.hh"
+#include "Common/BadValueException.hh"
+#include "Common/ParallelException.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Counts the visits of each index, with one counter array per thread
+struct CountVisits
+{
+  CountVisits(const CFuint nbThreads, const CFuint begin, const CFuint end) :
+    offset(begin), visits(nbThreads, vector<CFuint>(end - begin, 0)), badThreadID(false)
+  {
+  }
+
+  void operator()(CFuint first, CFuint end, CFuint threadID)
+  {
+    if (threadID >= visits.size()) {
+      badThreadID = true;
+      return;
+    }
+    for (CFuint i = first; i < end; ++i) {
+      ++visits[threadID][i - offset];
+    }
+  }
+
+  /// @return the total number of visits of the given index
+  CFuint getNbVisits(const CFuint i) const
+  {
+    CFuint nb = 0;
+    for (CFuint t = 0; t < visits.size(); ++t) {
+      nb += visits[t][i - offset];
+    }
+    return nb;
+  }
+
+  CFuint offset;
+  vector< vector<CFuint> > visits;
+  bool badThreadID;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Runs a parallelFor from inside each chunk and checks that it is
+/// executed by the calling thread
+struct NestedLoop
+{
+  NestedLoop(const CFuint nbThreads, const CFuint size) :
+    inner(nbThreads, 0, size), wrongThread(false)
+  {
+  }
+
+  void operator()(CFuint first, CFuint end, CFuint threadID)
+  {
+    for (CFuint i = first; i < end; ++i) {
+      CountVisits local(ThreadPool::getInstance().getNbThreads(), 0, inner.visits[0].size());
+      ThreadPool::getInstance().parallelFor(0, local.visits[0].size(), local, 1);
+      for (CFuint t = 0; t < local.visits.size(); ++t) {
+	for (CFuint k = 0; k < local.visits[t].size(); ++k) {
+	  if (local.visits[t][k] > 0 && t != threadID) wrongThread = true;
+	  inner.visits[threadID][k] += local.visits[t][k];
+	}
+      }
+    }
+  }
+
+  CountVisits inner;
+  bool wrongThread;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Throws when it reaches the given index
+struct ThrowAt
+{
+  ThrowAt(const CFuint index) : failIndex(index) {}
+
+  void operator()(CFuint first, CFuint end, CFuint threadID)
+  {
+    if (failIndex >= first && failIndex < end) {
+      throw BadValueException (FromHere(), "ThrowAt => failing index reached");
+    }
+  }
+
+  CFuint failIndex;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct ThreadPool_Fixture
+{
+  /// common setup for each test case
+  ThreadPool_Fixture() : pool(ThreadPool::getInstance())
+  {
+    ExceptionManager::getInstance().ExceptionDumps = false;
+  }
+
+  /// common tear down for each test case: the workers are joined
+  ~ThreadPool_Fixture()
+  {
+    pool.resize(1);
+  }
+
+  /// @return true if each index of [begin, end) is visited exactly once
+  bool coverOnce(const CFuint begin, const CFuint end, const CFuint grain)
+  {
+    CountVisits count(pool.getNbThreads(), begin, end);
+    pool.parallelFor(begin, end, count, grain);
+    bool once = !count.badThreadID;
+    for (CFuint i = begin; i < end; ++i) {
+      if (count.getNbVisits(i) != 1) once = false;
+    }
+    return once;
+  }
+
+  ThreadPool& pool;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( ThreadPool_TestSuite, ThreadPool_Fixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( parallelForCoversRange )
+{
+  const CFuint nbThreads[5] = {1, 2, 3, 4, 7};
+  const CFuint grains[4] = {0, 1, 5, 1000};
+  for (CFuint t = 0; t < 5; ++t) {
+    pool.resize(nbThreads[t]);
+    BOOST_CHECK_EQUAL(pool.getNbThreads(), nbThreads[t]);
+    for (CFuint g = 0; g < 4; ++g) {
+      BOOST_CHECK(coverOnce(0, 1, grains[g]));
+      BOOST_CHECK(coverOnce(3, 5, grains[g]));
+      BOOST_CHECK(coverOnce(17, 10017, grains[g]));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( emptyRange )
+{
+  pool.resize(4);
+  CountVisits count(pool.getNbThreads(), 0, 10);
+  pool.parallelFor(5, 5, count);
+  pool.parallelFor(7, 3, count);
+  for (CFuint i = 0; i < 10; ++i) {
+    BOOST_CHECK_EQUAL(count.getNbVisits(i), 0u);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( nestedParallelForIsSerial )
+{
+  pool.resize(4);
+  const CFuint nbOuter = 100;
+  const CFuint nbInner = 20;
+  NestedLoop nested(pool.getNbThreads(), nbInner);
+  pool.parallelFor(0, nbOuter, nested, 1);
+  BOOST_CHECK(!nested.wrongThread);
+  BOOST_CHECK(!nested.inner.badThreadID);
+  for (CFuint k = 0; k < nbInner; ++k) {
+    BOOST_CHECK_EQUAL(nested.inner.getNbVisits(k), nbOuter);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( exceptionIsPropagated )
+{
+  pool.resize(4);
+  ThrowAt fail(777);
+  BOOST_CHECK_THROW(pool.parallelFor(0, 1000, fail, 10), ParallelException);
+
+  // the pool is still usable after a failed loop
+  BOOST_CHECK(coverOnce(0, 1000, 10));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( shutdown )
+{
+  pool.resize(4);
+  BOOST_CHECK(coverOnce(0, 1000, 0));
+  BOOST_CHECK_NO_THROW(pool.resize(1));
+  BOOST_CHECK_EQUAL(pool.getNbThreads(), 1u);
+  BOOST_CHECK(coverOnce(0, 1000, 0));
+
+  // the workers can be spawned again
+  pool.resize(3);
+  BOOST_CHECK(coverOnce(0, 1000, 0));
+  BOOST_CHECK_NO_THROW(pool.resize(1));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
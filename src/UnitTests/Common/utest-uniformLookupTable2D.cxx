@@ -0,0 +1,148 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test UniformLookupTable2D"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+#ifdef CF_HAVE_BOOST_1_59
+#include <boost/test/tools/floating_point_comparison.hpp>
+#else
+#include <boost/test/floating_point_comparison.hpp>
+#endif
+
+#include <cstdio>
+#include <vector>
+
+#include "Common/UniformLookupTable2D.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct UniformLookupTable2D_Fixture
+{
+  /// common setup for each test case: temperatures linearly spaced and
+  /// pressures geometrically spaced, as in the Mutation++ tables
+  UniformLookupTable2D_Fixture() : cacheFile("utest-uniformLookupTable2D.bin")
+  {
+    initialize(table, 1000.);
+  }
+
+  /// common tear down for each test case
+  ~UniformLookupTable2D_Fixture()
+  {
+    std::remove(cacheFile.c_str());
+  }
+
+  /// initialize a table with a bilinear value and a monotone value
+  void initialize(UniformLookupTable2D<CFreal>& t, const CFreal tMax)
+  {
+    t.initialize(200., tMax, 9, false, 10., 1e5, 5, true, 2);
+    for (size_t i2 = 0; i2 < t.getNbKeys2(); ++i2) {
+      for (size_t i1 = 0; i1 < t.getNbKeys1(); ++i1) {
+	const CFreal k1 = t.getKey1(i1);
+	const CFreal k2 = t.getKey2(i2);
+	t.insert(i1, i2, 0, bilinear(k1, std::log(k2)));
+	t.insert(i1, i2, 1, (k1 < 500.) ? 0. : 1.);
+      }
+    }
+  }
+
+  /// function reproduced exactly by the bilinear interpolation
+  static CFreal bilinear(const CFreal x, const CFreal y)
+  {
+    return 2. + 0.5*x - 3.*y + 0.01*x*y;
+  }
+
+  UniformLookupTable2D<CFreal> table;
+  std::string cacheFile;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( UniformLookupTable2D_TestSuite, UniformLookupTable2D_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_axes )
+{
+  BOOST_CHECK_EQUAL( table.getNbKeys1(), 9u );
+  BOOST_CHECK_CLOSE( table.getKey1(0), 200., 1e-10 );
+  BOOST_CHECK_CLOSE( table.getKey1(8), 1000., 1e-10 );
+  BOOST_CHECK_CLOSE( table.getKey2(2), 1000., 1e-10 );
+  BOOST_CHECK_CLOSE( table.getKey2(4), 1e5, 1e-10 );
+}
+
+BOOST_AUTO_TEST_CASE( test_bilinear )
+{
+  // exact inside the table, keys outside being moved to the boundary
+  BOOST_CHECK_CLOSE( table.get(333., 3000., 0), bilinear(333., std::log(3000.)), 1e-8 );
+  BOOST_CHECK_CLOSE( table.get(999., 11., 0), bilinear(999., std::log(11.)), 1e-8 );
+  BOOST_CHECK_CLOSE( table.get(100., 1e6, 0), bilinear(200., std::log(1e5)), 1e-8 );
+}
+
+BOOST_AUTO_TEST_CASE( test_bicubic_monotone )
+{
+  table.setCubic(true);
+  // values at the grid points are preserved
+  BOOST_CHECK_CLOSE( table.get(300., 100., 0), bilinear(300., std::log(100.)), 1e-8 );
+
+  // no overshoot across the step of the second value
+  CFreal previous = 0.;
+  for (CFreal k1 = 200.; k1 <= 1000.; k1 += 7.) {
+    const CFreal v = table.get(k1, 500., 1);
+    BOOST_CHECK( v >= previous - 1e-12 );
+    BOOST_CHECK( v >= 0. && v <= 1. );
+    previous = v;
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_batched_get )
+{
+  table.setCubic(true);
+  const CFreal k1[3] = {250., 610., 999.};
+  const CFreal k2[3] = {20., 4000., 9e4};
+  CFreal out[6] = {0., 0., 0., 0., 0., 0.};
+  table.get(3, k1, k2, 1, out, 2);
+  for (size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL( out[2*i], table.get(k1[i], k2[i], 1) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_cache )
+{
+  BOOST_CHECK( table.writeCache(cacheFile, "test") );
+
+  UniformLookupTable2D<CFreal> same;
+  same.initialize(200., 1000., 9, false, 10., 1e5, 5, true, 2);
+  BOOST_CHECK( same.readCache(cacheFile, "test") );
+  BOOST_CHECK_EQUAL( same.get(333., 3000., 0), table.get(333., 3000., 0) );
+  BOOST_CHECK_EQUAL( same.get(777., 12., 1), table.get(777., 12., 1) );
+
+  // another signature or another range is rejected
+  UniformLookupTable2D<CFreal> other;
+  other.initialize(200., 1000., 9, false, 10., 1e5, 5, true, 2);
+  BOOST_CHECK( !other.readCache(cacheFile, "other") );
+
+  UniformLookupTable2D<CFreal> wider;
+  initialize(wider, 2000.);
+  BOOST_CHECK( !wider.readCache(cacheFile, "test") );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,169 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test PeriodicExchangePlan"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/PE.hh"
+#include "FiniteVolume/PeriodicExchangePlan.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Numerics::FiniteVolume;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// the PE is initialized once for all the test cases
+struct PE_GlobalFixture
+{
+  PE_GlobalFixture()
+  {
+    PE::InitPE(&boost::unit_test::framework::master_test_suite().argc,
+	       &boost::unit_test::framework::master_test_suite().argv);
+  }
+
+  ~PE_GlobalFixture()
+  {
+    PE::DonePE();
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( PE_GlobalFixture );
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct PeriodicExchangePlan_Fixture
+{
+  /// common setup for each test case
+  PeriodicExchangePlan_Fixture() :
+    comm(PE::GetPE().GetCommunicator("Default")),
+    rank(PE::GetPE().GetRank("Default")),
+    nbProcs(PE::GetPE().GetProcessorCount("Default")),
+    nbFaces(5),
+    blockSize(3)
+  {
+  }
+
+  /// value of the entry e of the face f of the given rank
+  CFreal faceValue(const CFuint r, const CFuint f, const CFuint e) const
+  {
+    return 1000.*r + 10.*f + e;
+  }
+
+  /// values of the local faces
+  vector<CFreal> localValues() const
+  {
+    vector<CFreal> values(nbFaces*blockSize);
+    for (CFuint f = 0; f < nbFaces; ++f) {
+      for (CFuint e = 0; e < blockSize; ++e) {
+	values[f*blockSize + e] = faceValue(rank, f, e);
+      }
+    }
+    return values;
+  }
+
+  /// checks the values received for each local face
+  void checkValues(const PeriodicExchangePlan& plan,
+		   const vector<CFuint>& partnerRank,
+		   const vector<CFuint>& partnerFace) const
+  {
+    for (CFuint f = 0; f < nbFaces; ++f) {
+      const CFreal* values = plan.getPeriodicValues(f);
+      for (CFuint e = 0; e < blockSize; ++e) {
+	BOOST_CHECK_EQUAL( values[e], faceValue(partnerRank[f], partnerFace[f], e) );
+      }
+    }
+  }
+
+  MPI_Comm comm;
+  CFuint rank;
+  CFuint nbProcs;
+  CFuint nbFaces;
+  CFuint blockSize;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( PeriodicExchangePlan_TestSuite, PeriodicExchangePlan_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_exchange_with_next_rank )
+{
+  // the faces are paired in reverse order with the faces of the next rank
+  vector<CFuint> partnerRank(nbFaces, (rank + 1) % nbProcs);
+  vector<CFuint> partnerFace(nbFaces);
+  for (CFuint f = 0; f < nbFaces; ++f) {
+    partnerFace[f] = nbFaces - 1 - f;
+  }
+
+  PeriodicExchangePlan plan;
+  plan.setup(comm, partnerRank, partnerFace, blockSize);
+  BOOST_CHECK_EQUAL( plan.getNbNeighbors(), (nbProcs > 1) ? 2u : 0u );
+
+  plan.post(localValues());
+  BOOST_CHECK( plan.isPending() );
+  plan.wait();
+  BOOST_CHECK( !plan.isPending() );
+
+  checkValues(plan, partnerRank, partnerFace);
+}
+
+BOOST_AUTO_TEST_CASE( test_mixed_pairing )
+{
+  // even faces are paired on this process, odd ones on the previous rank,
+  // several local faces can share the same periodic face
+  vector<CFuint> partnerRank(nbFaces);
+  vector<CFuint> partnerFace(nbFaces);
+  for (CFuint f = 0; f < nbFaces; ++f) {
+    partnerRank[f] = (f % 2 == 0) ? rank : (rank + nbProcs - 1) % nbProcs;
+    partnerFace[f] = f / 2;
+  }
+
+  PeriodicExchangePlan plan;
+  plan.setup(comm, partnerRank, partnerFace, blockSize);
+
+  plan.post(localValues());
+  plan.wait();
+  checkValues(plan, partnerRank, partnerFace);
+}
+
+BOOST_AUTO_TEST_CASE( test_repeated_exchanges )
+{
+  vector<CFuint> partnerRank(nbFaces, (rank + 1) % nbProcs);
+  vector<CFuint> partnerFace(nbFaces);
+  for (CFuint f = 0; f < nbFaces; ++f) {
+    partnerFace[f] = f;
+  }
+
+  PeriodicExchangePlan plan;
+  plan.setup(comm, partnerRank, partnerFace, blockSize);
+
+  // posting again completes the pending exchange first
+  plan.post(vector<CFreal>(nbFaces*blockSize, -1.));
+  plan.post(localValues());
+  BOOST_CHECK( plan.isPending() );
+
+  // waiting twice is harmless
+  plan.wait();
+  plan.wait();
+  checkValues(plan, partnerRank, partnerFace);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
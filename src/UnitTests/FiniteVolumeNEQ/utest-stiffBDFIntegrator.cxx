@@ -0,0 +1,170 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test StiffBDFIntegrator"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "FiniteVolumeNEQ/StiffBDFIntegrator.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Numerics::FiniteVolume;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct StiffBDFIntegrator_Fixture
+{
+  /// common setup for each test case: y0' = y1, y1' = -1e4 y0 - (1e4+1) y1,
+  /// whose eigenvalues are -1 and -1e4
+  StiffBDFIntegrator_Fixture() : nbEvaluations(0)
+  {
+    jacob[0] = 0.;
+    jacob[1] = 1.;
+    jacob[2] = -1e4;
+    jacob[3] = -1e4 - 1.;
+  }
+
+  /// starts the integration from (y0, y1)
+  void start(const CFreal y0, const CFreal y1)
+  {
+    bdf.resize(ode);
+    ode.y[0] = y0;
+    ode.y[1] = y1;
+    ode.absTol[0] = ode.absTol[1] = 1e-10;
+    ode.scale = 1.;
+    bdf.start(ode);
+  }
+
+  /// evaluates the requested derivatives until the integration is done
+  void integrate()
+  {
+    while (ode.nbReq > 0) {
+      for (CFuint r = 0; r < ode.nbReq; ++r, ++nbEvaluations) {
+	const CFreal *const y = &ode.req[r*2];
+	CFreal *const f = &ode.res[r*2];
+	f[0] = jacob[0]*y[0] + jacob[1]*y[1];
+	f[1] = jacob[2]*y[0] + jacob[3]*y[1];
+      }
+      bdf.advance(ode);
+    }
+  }
+
+  StiffBDFIntegrator bdf;
+  StiffBDFIntegrator::ODE ode;
+  CFreal jacob[4];
+  CFuint nbEvaluations;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( StiffBDFIntegrator_TestSuite, StiffBDFIntegrator_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_linear_stiff_system )
+{
+  bdf.setup(2, 0, 1e-6, 5000, 20);
+  bdf.setTimeStep(1.);
+  BOOST_CHECK_EQUAL( bdf.getNbVars(), 2u );
+
+  // y = a e^-t + b e^-1e4t (1, -1e4) with y(0) = (1, 0)
+  const CFreal b = -1./9999.;
+  const CFreal a = 1. - b;
+  start(1., 0.);
+  integrate();
+
+  BOOST_CHECK( !ode.failed );
+  BOOST_CHECK_EQUAL( ode.phase, StiffBDFIntegrator::DONE );
+  BOOST_CHECK_EQUAL( ode.t, 1. );
+  BOOST_CHECK_CLOSE( ode.y[0], a*exp(-1.), 0.01 );
+  BOOST_CHECK_CLOSE( ode.y[1], -a*exp(-1.), 0.01 );
+
+  // an explicit method would need more than 5000 steps to be stable
+  BOOST_CHECK( ode.nbAccepted > 1 );
+  BOOST_CHECK( ode.nbAccepted < 500 );
+  BOOST_CHECK( nbEvaluations < 2000 );
+}
+
+BOOST_AUTO_TEST_CASE( test_stiff_transient )
+{
+  bdf.setup(2, 0, 1e-6, 5000, 20);
+
+  // the fast mode is resolved over a short time step
+  const CFreal dt = 2e-4;
+  bdf.setTimeStep(dt);
+  const CFreal b = -1./9999.;
+  const CFreal a = 1. - b;
+  start(1., 0.);
+  integrate();
+
+  BOOST_CHECK( !ode.failed );
+  BOOST_CHECK_CLOSE( ode.y[0], a*exp(-dt) + b*exp(-1e4*dt), 0.01 );
+  BOOST_CHECK_CLOSE( ode.y[1], -a*exp(-dt) - 1e4*b*exp(-1e4*dt), 0.01 );
+}
+
+BOOST_AUTO_TEST_CASE( test_explicit_step )
+{
+  bdf.setup(2, 0, 1e-6, 5000, 20);
+
+  // the change over the time step is within the tolerance
+  const CFreal dt = 1e-12;
+  bdf.setTimeStep(dt);
+  start(1., -1.);
+  integrate();
+
+  BOOST_CHECK( !ode.failed );
+  BOOST_CHECK_EQUAL( ode.nbAccepted, 0u );
+  BOOST_CHECK_EQUAL( nbEvaluations, 1u );
+  BOOST_CHECK_EQUAL( ode.y[0], 1. - dt );
+  BOOST_CHECK_EQUAL( ode.y[1], -1. + dt );
+}
+
+BOOST_AUTO_TEST_CASE( test_max_steps )
+{
+  bdf.setup(2, 0, 1e-6, 3, 20);
+  bdf.setTimeStep(1.);
+  start(1., 0.);
+  integrate();
+
+  // the integration stops before the end
+  BOOST_CHECK( ode.failed );
+  BOOST_CHECK( ode.t < 1. );
+  BOOST_CHECK_EQUAL( ode.nbReq, 0u );
+}
+
+BOOST_AUTO_TEST_CASE( test_positive_variables )
+{
+  // y0' = -1e4 y0 + y1, y1' = -y1: y0 decays quickly towards y1/1e4
+  jacob[0] = -1e4;
+  jacob[1] = 1.;
+  jacob[2] = 0.;
+  jacob[3] = -1.;
+  bdf.setup(2, 2, 1e-6, 5000, 20);
+  bdf.setTimeStep(1.);
+  start(1., 1.);
+  integrate();
+
+  BOOST_CHECK( !ode.failed );
+  BOOST_CHECK( ode.y[0] >= 0. );
+  BOOST_CHECK_CLOSE( ode.y[0], exp(-1.)/9999., 0.01 );
+  BOOST_CHECK_CLOSE( ode.y[1], exp(-1.), 0.01 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
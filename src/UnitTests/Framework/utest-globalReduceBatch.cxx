@@ -0,0 +1,129 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test GlobalReduceBatch"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/PE.hh"
+#include "Common/BadValueException.hh"
+#include "Framework/GlobalReduceBatch.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Framework;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// the PE is initialized once for all the test cases
+struct PE_GlobalFixture
+{
+  PE_GlobalFixture()
+  {
+    PE::InitPE(&boost::unit_test::framework::master_test_suite().argc,
+	       &boost::unit_test::framework::master_test_suite().argv);
+  }
+
+  ~PE_GlobalFixture()
+  {
+    PE::DonePE();
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( PE_GlobalFixture );
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct GlobalReduceBatch_Fixture
+{
+  /// common setup for each test case
+  GlobalReduceBatch_Fixture() :
+    batch(GlobalReduceBatch::getInstance("Default")),
+    rank(PE::GetPE().GetRank("Default")),
+    nbProcs(PE::GetPE().GetProcessorCount("Default"))
+  {
+  }
+
+  GlobalReduceBatch& batch;
+  CFuint rank;
+  CFuint nbProcs;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( GlobalReduceBatch_TestSuite, GlobalReduceBatch_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_fused_operations )
+{
+  const CFuint nbReductions = batch.getNbReductions();
+
+  const CFuint sum = batch.addValue(rank + 1., GlobalReduceBatch::SUM);
+  const CFuint max = batch.addValue(static_cast<CFreal>(rank), GlobalReduceBatch::MAX);
+  const CFuint min = batch.addValue(10. - rank, GlobalReduceBatch::MIN);
+  batch.post();
+
+  BOOST_CHECK_EQUAL( batch.getValue(sum), 0.5*nbProcs*(nbProcs + 1) );
+  BOOST_CHECK_EQUAL( batch.getValue(max), nbProcs - 1. );
+  BOOST_CHECK_EQUAL( batch.getValue(min), 11. - nbProcs );
+
+  // the three values have been reduced together
+  BOOST_CHECK_EQUAL( batch.getNbReductions(), nbReductions + 1 );
+}
+
+BOOST_AUTO_TEST_CASE( test_get_value_posts )
+{
+  const CFuint nbReductions = batch.getNbReductions();
+
+  const CFuint handle = batch.addValue(2., GlobalReduceBatch::SUM);
+  BOOST_CHECK_EQUAL( batch.getNbReductions(), nbReductions );
+
+  BOOST_CHECK_EQUAL( batch.getValue(handle), 2.*nbProcs );
+  BOOST_CHECK_EQUAL( batch.getNbReductions(), nbReductions + 1 );
+}
+
+BOOST_AUTO_TEST_CASE( test_registration_during_flight )
+{
+  const CFuint nbReductions = batch.getNbReductions();
+
+  const CFuint first = batch.addValue(1., GlobalReduceBatch::SUM);
+  batch.post();
+
+  // a value registered while the reduction is in flight is not sent with it
+  const CFuint second = batch.addValue(static_cast<CFreal>(rank), GlobalReduceBatch::MIN);
+  BOOST_CHECK_EQUAL( batch.getValue(first), static_cast<CFreal>(nbProcs) );
+  BOOST_CHECK_EQUAL( batch.getNbReductions(), nbReductions + 1 );
+
+  BOOST_CHECK_EQUAL( batch.getValue(second), 0. );
+  BOOST_CHECK_EQUAL( batch.getNbReductions(), nbReductions + 2 );
+}
+
+BOOST_AUTO_TEST_CASE( test_overwritten_value )
+{
+  const CFuint first = batch.addValue(1., GlobalReduceBatch::MAX);
+  batch.post();
+  const CFuint second = batch.addValue(1., GlobalReduceBatch::MAX);
+  batch.post();
+  BOOST_CHECK_EQUAL( batch.getValue(second), 1. );
+
+  // only the values of the last completed reduction are kept
+  BOOST_CHECK_THROW( batch.getValue(first), BadValueException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test ISATTable"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/PE.hh"
+#include "Framework/ISATTable.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Framework;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// the PE is initialized once for all the test cases (needed by the log)
+struct PE_GlobalFixture
+{
+  PE_GlobalFixture()
+  {
+    PE::InitPE(&boost::unit_test::framework::master_test_suite().argc,
+	       &boost::unit_test::framework::master_test_suite().argv);
+  }
+
+  ~PE_GlobalFixture()
+  {
+    PE::DonePE();
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( PE_GlobalFixture );
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// f(phi) = (phi0 + 2 phi1, phi0 - phi1 + 1), counting the evaluations
+struct LinearFunction : public ISATTable::Function
+{
+  LinearFunction() : nbCalls(0) {}
+
+  void compute(const RealVector& phi, RealVector& f)
+  {
+    ++nbCalls;
+    f[0] = phi[0] + 2.*phi[1];
+    f[1] = phi[0] - phi[1] + 1.;
+  }
+
+  CFuint nbCalls;
+};
+
+/// f(phi) = (phi0^2, phi0 phi1), counting the evaluations
+struct QuadraticFunction : public ISATTable::Function
+{
+  QuadraticFunction() : nbCalls(0) {}
+
+  void compute(const RealVector& phi, RealVector& f)
+  {
+    ++nbCalls;
+    f[0] = phi[0]*phi[0];
+    f[1] = phi[0]*phi[1];
+  }
+
+  CFuint nbCalls;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct ISATTable_Fixture
+{
+  /// common setup for each test case
+  ISATTable_Fixture() : phi(2), f(2)
+  {
+    table.setup("Test", 2, 2, 1e-3, 1e-6, 0.1, 10, 0);
+  }
+
+  /// sets the query point
+  void setPhi(const CFreal phi0, const CFreal phi1)
+  {
+    phi[0] = phi0;
+    phi[1] = phi1;
+  }
+
+  ISATTable table;
+  RealVector phi;
+  RealVector f;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( ISATTable_TestSuite, ISATTable_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_add_and_retrieve )
+{
+  LinearFunction func;
+  BOOST_CHECK( table.isSetup() );
+  BOOST_CHECK_EQUAL( table.getNbRecords(), 0u );
+
+  // add: one evaluation and one per input for the sensitivities
+  setPhi(1., 2.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( table.getNbRecords(), 1u );
+  BOOST_CHECK_EQUAL( func.nbCalls, 3u );
+  BOOST_CHECK_EQUAL( f[0], 5. );
+  BOOST_CHECK_EQUAL( f[1], 0. );
+
+  // retrieve: the linear approximation, without evaluation
+  setPhi(1. + 1e-4, 2. - 1e-4);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( func.nbCalls, 3u );
+  BOOST_CHECK_CLOSE( f[0], 5. - 1e-4, 1e-6 );
+  BOOST_CHECK_SMALL( f[1] - 2e-4, 1e-10 );
+}
+
+BOOST_AUTO_TEST_CASE( test_grow )
+{
+  LinearFunction func;
+  setPhi(1., 2.);
+  table.compute(phi, func, f);
+  const CFuint nbCalls = func.nbCalls;
+
+  // outside the initial ellipsoid of accuracy, but the linear approximation
+  // is exact: the ellipsoid is grown instead of adding a record
+  setPhi(1.5, 2.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( func.nbCalls, nbCalls + 1 );
+  BOOST_CHECK_EQUAL( table.getNbRecords(), 1u );
+  BOOST_CHECK_CLOSE( f[0], 5.5, 1e-12 );
+
+  // the points between the record and the grown point are now retrieved
+  setPhi(1.4, 2.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( func.nbCalls, nbCalls + 1 );
+  BOOST_CHECK_CLOSE( f[0], 5.4, 1e-6 );
+  BOOST_CHECK_CLOSE( f[1], 0.4, 1e-5 );
+}
+
+BOOST_AUTO_TEST_CASE( test_add_second_record )
+{
+  QuadraticFunction func;
+  setPhi(1., 1.);
+  table.compute(phi, func, f);
+
+  // the linear approximation is wrong far away: a new record is added
+  setPhi(2., 1.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( table.getNbRecords(), 2u );
+  BOOST_CHECK_EQUAL( func.nbCalls, 6u );
+  BOOST_CHECK_EQUAL( f[0], 4. );
+  BOOST_CHECK_EQUAL( f[1], 2. );
+
+  // each record is reached on its side of the cutting plane
+  setPhi(1. + 1e-5, 1.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( func.nbCalls, 6u );
+  BOOST_CHECK_CLOSE( f[0], 1. + 2e-5, 1e-6 );
+
+  setPhi(2. - 1e-5, 1.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( func.nbCalls, 6u );
+  BOOST_CHECK_CLOSE( f[0], 4. - 4e-5, 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE( test_full_table )
+{
+  QuadraticFunction func;
+  table.setup("Full", 2, 2, 1e-3, 1e-6, 0.1, 1, 0);
+
+  setPhi(1., 1.);
+  table.compute(phi, func, f);
+
+  // no room left: f is computed directly
+  setPhi(3., 1.);
+  table.compute(phi, func, f);
+  BOOST_CHECK_EQUAL( table.getNbRecords(), 1u );
+  BOOST_CHECK_EQUAL( func.nbCalls, 4u );
+  BOOST_CHECK_EQUAL( f[0], 9. );
+  BOOST_CHECK_EQUAL( f[1], 3. );
+
+  table.clear();
+  BOOST_CHECK_EQUAL( table.getNbRecords(), 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
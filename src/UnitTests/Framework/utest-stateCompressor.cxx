@@ -0,0 +1,130 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test StateCompressor"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Framework/StateCompressor.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Framework;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct StateCompressor_Fixture
+{
+  /// common setup for each test case: smooth interleaved states
+  /// (density, velocity, temperature) plus a few special values
+  StateCompressor_Fixture() : nbEntries(1000), stride(3), data(nbEntries*stride)
+  {
+    for (CFuint i = 0; i < nbEntries; ++i) {
+      const CFreal x = i/static_cast<CFreal>(nbEntries);
+      data[i*stride]     = 1.2 + 0.3*std::sin(6.*x);
+      data[i*stride + 1] = -250.*x*x + 1e-12*i;
+      data[i*stride + 2] = 300. + 5000.*std::exp(-20.*(x - 0.5)*(x - 0.5));
+    }
+    data[7*stride] = 0.;
+    data[8*stride] = -0.;
+    data[9*stride + 1] = 1e300;
+  }
+
+  /// compress and decompress the data
+  void roundTrip(const vector<CFreal>& absTol, const vector<CFreal>& relTol,
+		 vector<CFreal>& result, vector<char>& compressed)
+  {
+    StateCompressor::compress(&data[0], nbEntries, stride, absTol, relTol, compressed);
+    result.assign(nbEntries*stride, 0.);
+    StateCompressor::decompress(&compressed[0], compressed.size(), nbEntries, stride, &result[0]);
+  }
+
+  CFuint nbEntries;
+  CFuint stride;
+  vector<CFreal> data;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( StateCompressor_TestSuite, StateCompressor_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_lossless )
+{
+  vector<CFreal> result;
+  vector<char> compressed;
+  roundTrip(vector<CFreal>(), vector<CFreal>(), result, compressed);
+
+  // bit-exact reconstruction, including the sign of zero
+  BOOST_CHECK( std::memcmp(&result[0], &data[0], data.size()*sizeof(CFreal)) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_quantized_error_bound )
+{
+  vector<CFreal> absTol(stride, 0.);
+  absTol[0] = 1e-6;
+  vector<CFreal> relTol(stride, 0.);
+  relTol[2] = 1e-4;
+
+  vector<CFreal> result;
+  vector<char> compressed;
+  roundTrip(absTol, relTol, result, compressed);
+
+  CFreal tMin = data[2];
+  CFreal tMax = data[2];
+  for (CFuint i = 0; i < nbEntries; ++i) {
+    tMin = std::min(tMin, data[i*stride + 2]);
+    tMax = std::max(tMax, data[i*stride + 2]);
+  }
+  const CFreal tTol = relTol[2]*(tMax - tMin);
+
+  for (CFuint i = 0; i < nbEntries; ++i) {
+    BOOST_CHECK( std::abs(result[i*stride] - data[i*stride]) <= absTol[0] );
+    // the second variable has no tolerance and stays exact
+    BOOST_CHECK( result[i*stride + 1] == data[i*stride + 1] );
+    BOOST_CHECK( std::abs(result[i*stride + 2] - data[i*stride + 2]) <= tTol );
+  }
+
+  // the quantized stream is smaller than the lossless one
+  vector<CFreal> exact;
+  vector<char> lossless;
+  roundTrip(vector<CFreal>(), vector<CFreal>(), exact, lossless);
+  BOOST_CHECK( compressed.size() < lossless.size() );
+}
+
+BOOST_AUTO_TEST_CASE( test_empty_block )
+{
+  vector<char> compressed;
+  StateCompressor::compress(CFNULL, 0, stride, vector<CFreal>(), vector<CFreal>(), compressed);
+  BOOST_CHECK_NO_THROW( StateCompressor::decompress(&compressed[0], compressed.size(), 0, stride, CFNULL) );
+}
+
+BOOST_AUTO_TEST_CASE( test_truncated_block )
+{
+  vector<CFreal> result;
+  vector<char> compressed;
+  roundTrip(vector<CFreal>(), vector<CFreal>(), result, compressed);
+  BOOST_CHECK_THROW( StateCompressor::decompress(&compressed[0], 5, nbEntries, stride, &result[0]),
+		     Common::Exception );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,251 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test tabulated chemistry"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Common/PE.hh"
+#include "Framework/PhysicalChemicalLibrary.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::Common;
+using namespace COOLFluiD::Framework;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// the PE is initialized once for all the test cases (needed by the log)
+struct PE_GlobalFixture
+{
+  PE_GlobalFixture()
+  {
+    PE::InitPE(&boost::unit_test::framework::master_test_suite().argc,
+	       &boost::unit_test::framework::master_test_suite().argv);
+  }
+
+  ~PE_GlobalFixture()
+  {
+    PE::DonePE();
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( PE_GlobalFixture );
+
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Library with two species A -> B and one vibrational temperature which, like
+ * Mutation++, computes the source terms from the state given to setState()
+ * and ignores the thermodynamic variables passed to getMassProductionTerm()
+ * and getSource()
+ */
+class StateLibrary : public PhysicalChemicalLibrary {
+public:
+
+  StateLibrary() : PhysicalChemicalLibrary("StateLibrary"), rhoiState(2), tState(2)
+  {
+    _NS = 2;
+    _nbTvib = 1;
+    m_tabulation = true;
+    m_tabulationMaxMemory = 1;
+    m_tabulationReportRate = 0;
+  }
+
+  /// rate of A -> B at the temperature of the state
+  CFdouble rate() const {return 1e6*std::exp(-50000./tState[0]);}
+
+  /// exact [omega, omegav, omegaRad] at the given state
+  static void exact(const CFdouble T, const CFdouble Tv, const CFdouble rho,
+		    const RealVector& ys, RealVector& f)
+  {
+    const CFdouble omegaB = 1e6*std::exp(-50000./T)*rho*ys[0];
+    f[0] = -omegaB;
+    f[1] = omegaB;
+    f[2] = rho*(T - Tv);
+    f[3] = 0.;
+  }
+
+  void setState(CFdouble* rhoi, CFdouble* T)
+  {
+    rhoiState[0] = rhoi[0];
+    rhoiState[1] = rhoi[1];
+    tState[0] = T[0];
+    tState[1] = T[1];
+  }
+
+  void getMassProductionTerm(CFdouble& temp, RealVector& tVec, CFdouble& pressure,
+			     CFdouble& rho, const RealVector& ys, bool flagJac,
+			     RealVector& omega, RealMatrix& jacobian)
+  {
+    omega[0] = -rate()*rhoiState[0];
+    omega[1] = rate()*rhoiState[0];
+  }
+
+  void getSource(CFdouble& temp, RealVector& tVec, CFdouble& pressure,
+		 CFdouble& rho, const RealVector& ys, bool flagJac,
+		 RealVector& omega, RealVector& omegav, CFdouble& omegaRad,
+		 RealMatrix& jacobian)
+  {
+    getMassProductionTerm(temp, tVec, pressure, rho, ys, flagJac, omega, jacobian);
+    omegav[0] = (rhoiState[0] + rhoiState[1])*(tState[0] - tState[1]);
+    omegaRad = 0.;
+  }
+
+  /// the rest of the interface is not used
+  CFdouble electronPressure(CFreal rhoE, CFreal tempE) {return 0.;}
+  void getMolarMasses(RealVector& mm) {}
+  CFdouble getCvTr() const {return 0.;}
+  CFdouble getMMass() const {return 0.;}
+  void setRiGas(RealVector& Ri) {}
+  void setMoleculesIDs(std::vector<CFuint>& v) {}
+  CFdouble pressure(CFdouble& rho, CFdouble& temp, CFreal* tVec) {return 0.;}
+  void transportCoeffNEQ(CFreal& temp, CFdouble& pressure, CFreal* tVec,
+			 RealVector& normConcGradients, RealVector& normTempGradients,
+			 CFreal& eta, CFreal& lambdaTrRo, RealVector& lambdaInt,
+			 RealVector& rhoUdiff) {}
+  CFdouble lambdaNEQ(CFdouble& temp, CFdouble& pressure) {return 0.;}
+  void lambdaVibNEQ(CFreal& temp, RealVector& tVec, CFdouble& pressure,
+		    CFreal& lambdaTrRo, RealVector& lambdaVib) {}
+  CFdouble eta(CFdouble& temp, CFdouble& pressure, CFreal* tVec) {return 0.;}
+  CFdouble lambdaEQ(CFdouble& temp, CFdouble& pressure) {return 0.;}
+  CFdouble sigma(CFdouble& temp, CFdouble& pressure, CFreal* tVec) {return 0.;}
+  void gammaAndSoundSpeed(CFdouble& temp, CFdouble& pressure, CFdouble& rho,
+			  CFdouble& gamma, CFdouble& soundSpeed) {}
+  void frozenGammaAndSoundSpeed(CFdouble& temp, CFdouble& pressure, CFdouble& rho,
+				CFdouble& gamma, CFdouble& soundSpeed, RealVector* tVec) {}
+  void setComposition(CFdouble& temp, CFdouble& pressure, RealVector* x) {}
+  void resetComposition(const RealVector& x) {}
+  CFdouble density(CFdouble& temp, CFdouble& pressure, CFreal* tVec) {return 0.;}
+  void setDensityEnthalpyEnergy(CFdouble& temp, RealVector& tVec, CFdouble& pressure,
+				RealVector& dhe, bool storeExtraData) {}
+  void setDensityEnthalpyEnergy(CFdouble& temp, CFdouble& pressure, RealVector& dhe) {}
+  void setElemFractions(const RealVector& yn) {}
+  void setElementXFromSpeciesY(const RealVector& ys) {}
+  void setSpeciesFractions(const RealVector& ys) {}
+  void setSpeciesMolarFractions(const RealVector& xs) {}
+  void setElectronFraction(RealVector& ys) {}
+  void getSpeciesMolarFractions(const RealVector& ys, RealVector& xs) {}
+  void getSpeciesMassFractions(const RealVector& xs, RealVector& ys) {}
+  void getSpeciesMassFractions(RealVector& ys) {}
+  void getSourceTermVT(CFdouble& temp, RealVector& tVec, CFdouble& pressure,
+		       CFdouble& rho, RealVector& omegav, CFdouble& omegaRad) {}
+  void getSourceEE(CFdouble& temp, RealVector& tVec, CFdouble& pressure,
+		   CFdouble& rho, const RealVector& ys, bool flagJac, CFdouble& omegaEE) {}
+  void getRhoUdiff(CFdouble& temp, CFdouble& pressure, RealVector& normConcGradients,
+		   RealVector& normTempGradients, CFreal* tVec, RealVector& rhoUdiff,
+		   bool fast) {}
+  void getSpeciesTotEnthalpies(CFdouble& temp, RealVector& tVec, CFdouble& pressure,
+			       RealVector& hsTot, RealVector* hsVib, RealVector* hsEl) {}
+
+  /// partial densities of the state
+  RealVector rhoiState;
+
+  /// temperatures of the state
+  RealVector tState;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct TabulatedChemistry_Fixture
+{
+  TabulatedChemistry_Fixture() : tVec(1), ys(2), omega(2), omegav(1), exact(4), jacobian()
+  {
+    pressure = 1e4;
+    rho = 1e-2;
+    ys[0] = 0.7;
+    ys[1] = 0.3;
+  }
+
+  /// set the state of the library as the solver does before the query
+  void setState(const CFdouble T, const CFdouble Tv)
+  {
+    CFdouble rhoi[2] = {rho*ys[0], rho*ys[1]};
+    CFdouble temps[2] = {T, Tv};
+    library.setState(rhoi, temps);
+  }
+
+  StateLibrary library;
+  CFdouble pressure;
+  CFdouble rho;
+  RealVector tVec;
+  RealVector ys;
+  RealVector omega;
+  RealVector omegav;
+  RealVector exact;
+  RealMatrix jacobian;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TabulatedChemistry_TestSuite, TabulatedChemistry_Fixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( massProductionFollowsTemperature )
+{
+  // the rate changes by 1% when T changes by 0.1%: a table whose
+  // sensitivities ignore the temperature would retrieve stale values
+  for (CFuint k = 0; k < 50; ++k) {
+    CFdouble T = 5000.*(1. + 2e-4*k);
+    tVec[0] = 4000.;
+    setState(T, tVec[0]);
+    library.getTabulatedMassProductionTerm(T, tVec, pressure, rho, ys, false, omega, jacobian);
+    StateLibrary::exact(T, tVec[0], rho, ys, exact);
+    BOOST_CHECK_CLOSE(omega[0], exact[0], 0.5);
+    BOOST_CHECK_CLOSE(omega[1], exact[1], 0.5);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( sourceFollowsTemperatures )
+{
+  for (CFuint k = 0; k < 50; ++k) {
+    CFdouble T = 5000.*(1. + 2e-4*k);
+    tVec[0] = 4000.*(1. - 2e-4*k);
+    setState(T, tVec[0]);
+    CFdouble omegaRad = 0.;
+    library.getTabulatedSource(T, tVec, pressure, rho, ys, false,
+			       omega, omegav, omegaRad, jacobian);
+    StateLibrary::exact(T, tVec[0], rho, ys, exact);
+    BOOST_CHECK_CLOSE(omega[0], exact[0], 0.5);
+    BOOST_CHECK_CLOSE(omega[1], exact[1], 0.5);
+    BOOST_CHECK_CLOSE(omegav[0], exact[2], 0.5);
+    BOOST_CHECK_SMALL(omegaRad, 1e-8);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( stateIsRestored )
+{
+  // the table evaluates the library at perturbed states, the caller must
+  // find the state of its query afterwards
+  CFdouble T = 6000.;
+  tVec[0] = 5000.;
+  setState(T, tVec[0]);
+  library.getTabulatedMassProductionTerm(T, tVec, pressure, rho, ys, false, omega, jacobian);
+  BOOST_CHECK_CLOSE(library.tState[0], T, 1e-10);
+  BOOST_CHECK_CLOSE(library.tState[1], tVec[0], 1e-10);
+  BOOST_CHECK_CLOSE(library.rhoiState[0], rho*ys[0], 1e-10);
+  BOOST_CHECK_CLOSE(library.rhoiState[1], rho*ys[1], 1e-10);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
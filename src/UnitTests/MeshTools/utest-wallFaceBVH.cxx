@@ -0,0 +1,198 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test WallFaceBVH"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <boost/test/unit_test.hpp>
+
+#include "MeshTools/WallFaceBVH.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::MeshTools;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct WallFaceBVH_Fixture
+{
+  /// common setup for each test case
+  WallFaceBVH_Fixture()
+  {
+    srand(12345);
+  }
+
+  /// random number in [0,1]
+  CFreal random() const
+  {
+    return rand()/static_cast<CFreal>(RAND_MAX);
+  }
+
+  /// random triangles and quadrilaterals of size h in the unit cube
+  void randomFaces3D(const CFuint nbFaces, const CFreal h,
+		     vector<CFuint>& faceNbNodes, vector<CFreal>& faceCoords) const
+  {
+    for (CFuint f = 0; f < nbFaces; ++f) {
+      const CFreal x = random();
+      const CFreal y = random();
+      const CFreal z = random();
+      if (f % 2 == 0) {
+	faceNbNodes.push_back(3);
+	const CFreal tri[9] = {x, y, z,  x + h*random(), y, z + h,  x, y + h, z + h*random()};
+	faceCoords.insert(faceCoords.end(), tri, tri + 9);
+      }
+      else {
+	// planar quadrilateral
+	faceNbNodes.push_back(4);
+	const CFreal quad[12] = {x, y, z,  x + h, y, z,  x + h, y + h, z + h,  x, y + h, z + h};
+	faceCoords.insert(faceCoords.end(), quad, quad + 12);
+      }
+    }
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( WallFaceBVH_TestSuite, WallFaceBVH_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_segment_distance )
+{
+  WallFaceBVH bvh;
+  const CFreal coords[4] = {0., 0., 1., 0.};
+  bvh.build(DIM_2D, vector<CFuint>(1, 2), vector<CFreal>(coords, coords + 4), 1);
+
+  const CFreal above[2] = {0.5, 2.};
+  const CFreal beyond[2] = {3., 1.};
+  const CFreal before[2] = {-1., 0.};
+  BOOST_CHECK_CLOSE( bvh.nearestDistance2(above, 100.), 4., 1e-12 );
+  BOOST_CHECK_CLOSE( bvh.nearestDistance2(beyond, 100.), 5., 1e-12 );
+  BOOST_CHECK_CLOSE( bvh.nearestDistance2(before, 100.), 1., 1e-12 );
+
+  // faces farther than the bound are ignored
+  BOOST_CHECK_EQUAL( bvh.nearestDistance2(above, 1.), 1. );
+}
+
+BOOST_AUTO_TEST_CASE( test_triangle_quad_distance )
+{
+  const CFreal tri[9] = {0., 0., 0.,  1., 0., 0.,  0., 1., 0.};
+  const CFreal quad[12] = {0., 0., 0.,  1., 0., 0.,  1., 1., 0.,  0., 1., 0.};
+
+  WallFaceBVH triBVH;
+  triBVH.build(DIM_3D, vector<CFuint>(1, 3), vector<CFreal>(tri, tri + 9), 1);
+
+  const CFreal inside[3] = {0.2, 0.2, 3.};
+  const CFreal vertexB[3] = {2., 0., 0.};
+  const CFreal edgeBC[3] = {1., 1., 0.};
+  const CFreal vertexA[3] = {-1., -1., 1.};
+  BOOST_CHECK_CLOSE( triBVH.nearestDistance2(inside, 100.), 9., 1e-12 );
+  BOOST_CHECK_CLOSE( triBVH.nearestDistance2(vertexB, 100.), 1., 1e-12 );
+  BOOST_CHECK_CLOSE( triBVH.nearestDistance2(edgeBC, 100.), 0.5, 1e-12 );
+  BOOST_CHECK_CLOSE( triBVH.nearestDistance2(vertexA, 100.), 3., 1e-12 );
+
+  // the quadrilateral is split in two triangles
+  WallFaceBVH quadBVH;
+  quadBVH.build(DIM_3D, vector<CFuint>(1, 4), vector<CFreal>(quad, quad + 12), 1);
+
+  const CFreal secondHalf[3] = {0.8, 0.9, 2.};
+  const CFreal corner[3] = {2., 2., 0.};
+  BOOST_CHECK_CLOSE( quadBVH.nearestDistance2(secondHalf, 100.), 4., 1e-12 );
+  BOOST_CHECK_CLOSE( quadBVH.nearestDistance2(corner, 100.), 2., 1e-12 );
+}
+
+BOOST_AUTO_TEST_CASE( test_pruning_matches_brute_force )
+{
+  vector<CFuint> faceNbNodes;
+  vector<CFreal> faceCoords;
+  randomFaces3D(300, 0.05, faceNbNodes, faceCoords);
+
+  // a single leaf checks all the faces
+  WallFaceBVH bruteForce;
+  bruteForce.build(DIM_3D, faceNbNodes, faceCoords, faceNbNodes.size());
+
+  WallFaceBVH bvh;
+  bvh.build(DIM_3D, faceNbNodes, faceCoords, 4);
+  BOOST_CHECK( !bvh.isEmpty() );
+
+  for (CFuint i = 0; i < 200; ++i) {
+    const CFreal point[3] = {2.*random() - 0.5, 2.*random() - 0.5, 2.*random() - 0.5};
+    BOOST_CHECK_EQUAL( bvh.nearestDistance2(point, 100.),
+		       bruteForce.nearestDistance2(point, 100.) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_empty )
+{
+  WallFaceBVH bvh;
+  bvh.build(DIM_3D, vector<CFuint>(), vector<CFreal>(), 4);
+  BOOST_CHECK( bvh.isEmpty() );
+
+  const CFreal point[3] = {0., 0., 0.};
+  BOOST_CHECK_EQUAL( bvh.nearestDistance2(point, 7.), 7. );
+}
+
+BOOST_AUTO_TEST_CASE( test_boxes )
+{
+  const CFuint nbBoxes = 100;
+  vector<CFreal> boxes;
+  for (CFuint b = 0; b < nbBoxes; ++b) {
+    const CFreal x = random();
+    const CFreal y = random();
+    const CFreal box[4] = {x, y, x + 0.1*random(), y + 0.1*random()};
+    boxes.insert(boxes.end(), box, box + 4);
+  }
+
+  WallFaceBVH bvh;
+  bvh.buildOverBoxes(DIM_2D, boxes, 2);
+
+  // the root box bounds all the boxes
+  vector<CFreal> rootBox;
+  bvh.getBoxes(0, rootBox);
+  BOOST_CHECK_EQUAL( rootBox.size(), 4u );
+  for (CFuint b = 0; b < nbBoxes; ++b) {
+    BOOST_CHECK( rootBox[0] <= boxes[4*b] && boxes[4*b + 2] <= rootBox[2] );
+    BOOST_CHECK( rootBox[1] <= boxes[4*b + 1] && boxes[4*b + 3] <= rootBox[3] );
+  }
+
+  for (CFuint i = 0; i < 50; ++i) {
+    const CFreal point[2] = {1.4*random() - 0.2, 1.4*random() - 0.2};
+
+    CFreal minMax2 = 100.;
+    vector<CFuint> expected;
+    for (CFuint b = 0; b < nbBoxes; ++b) {
+      minMax2 = std::min(minMax2, WallFaceBVH::boxMaxDistance2(DIM_2D, &boxes[4*b], point));
+    }
+    for (CFuint b = 0; b < nbBoxes; ++b) {
+      if (WallFaceBVH::boxMinDistance2(DIM_2D, &boxes[4*b], point) < minMax2) {
+	expected.push_back(b);
+      }
+    }
+
+    const CFreal upperBound2 = bvh.boxesUpperBound2(point, 100.);
+    BOOST_CHECK_EQUAL( upperBound2, minMax2 );
+
+    vector<CFuint> boxIDs;
+    bvh.getBoxesCloserThan(point, upperBound2, boxIDs);
+    sort(boxIDs.begin(), boxIDs.end());
+    BOOST_CHECK( boxIDs == expected );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,161 @@
+// Copyright (C) 2012 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test PhiloxStream"
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "RadiativeTransfer/Solvers/MonteCarlo/RandomNumberGenerator.hh"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+using namespace COOLFluiD;
+using namespace COOLFluiD::RadiativeTransfer;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct PhiloxStream_Fixture
+{
+  /// number in ]0,1[ made of two 32 bits words, as drawn by the generator
+  CFreal toUnit(const boost::uint32_t a, const boost::uint32_t b) const
+  {
+    return ((a >> 5)*67108864. + (b >> 6) + 0.5)*(1./9007199254740992.);
+  }
+
+  /// draws n numbers from the given stream
+  vector<CFreal> draw(RandomNumberGenerator& rng, const CFuint n) const
+  {
+    vector<CFreal> numbers(n);
+    for (CFuint i = 0; i < n; ++i) {
+      numbers[i] = rng.uniformRand();
+    }
+    return numbers;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( PhiloxStream_TestSuite, PhiloxStream_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_known_answer )
+{
+  // Philox4x32-10 of the null counter with the null key (Random123 known
+  // answer): 6627e8d5 e169c58d bc57ac4c 9b00dbd8
+  RandomNumberGenerator rng;
+  rng.setStream(0, 0, 0, 0);
+  BOOST_CHECK_EQUAL( rng.uniformRand(), toUnit(0x6627e8d5u, 0xe169c58du) );
+  BOOST_CHECK_EQUAL( rng.uniformRand(), toUnit(0xbc57ac4cu, 0x9b00dbd8u) );
+}
+
+BOOST_AUTO_TEST_CASE( test_reproducible_streams )
+{
+  RandomNumberGenerator rng1;
+  RandomNumberGenerator rng2;
+
+  // the numbers do not depend on what was drawn before
+  rng2.seed(7);
+  draw(rng2, 13);
+  rng2.setStream(3, 11, 5, 0);
+  draw(rng2, 3);
+
+  rng1.setStream(42, 1234, 17, 2);
+  rng2.setStream(42, 1234, 17, 2);
+  const vector<CFreal> numbers = draw(rng1, 25);
+  BOOST_CHECK( numbers == draw(rng2, 25) );
+
+  // any change of the stream gives different numbers
+  rng2.setStream(43, 1234, 17, 2);
+  BOOST_CHECK( numbers != draw(rng2, 25) );
+  rng2.setStream(42, 1235, 17, 2);
+  BOOST_CHECK( numbers != draw(rng2, 25) );
+  rng2.setStream(42, 1234, 18, 2);
+  BOOST_CHECK( numbers != draw(rng2, 25) );
+  rng2.setStream(42, 1234, 17, 3);
+  BOOST_CHECK( numbers != draw(rng2, 25) );
+}
+
+BOOST_AUTO_TEST_CASE( test_seed_leaves_stream )
+{
+  RandomNumberGenerator rng1;
+  RandomNumberGenerator rng2;
+  rng1.setStream(1, 2, 3, 4);
+  draw(rng1, 5);
+
+  rng1.seed(99);
+  rng2.seed(99);
+  BOOST_CHECK( draw(rng1, 10) == draw(rng2, 10) );
+}
+
+BOOST_AUTO_TEST_CASE( test_distribution )
+{
+  RandomNumberGenerator rng;
+  rng.setStream(2013, 0, 0, 0);
+
+  const CFuint n = 100000;
+  CFreal sum = 0.;
+  CFreal sum2 = 0.;
+  for (CFuint i = 0; i < n; ++i) {
+    const CFreal x = rng.uniformRand();
+    BOOST_CHECK( x > 0. && x < 1. );
+    sum += x;
+    sum2 += x*x;
+  }
+
+  // mean 1/2 and variance 1/12 within a few standard errors
+  const CFreal mean = sum/n;
+  BOOST_CHECK_SMALL( mean - 0.5, 0.005 );
+  BOOST_CHECK_SMALL( sum2/n - mean*mean - 1./12., 0.002 );
+
+  const CFreal y = rng.uniformRand(-2., 3.);
+  BOOST_CHECK( y > -2. && y < 3. );
+}
+
+BOOST_AUTO_TEST_CASE( test_sphere_directions )
+{
+  RandomNumberGenerator rng;
+  rng.setStream(5, 6, 7, 8);
+
+  for (CFuint dim = 2; dim <= 3; ++dim) {
+    CFreal mean[3] = {0., 0., 0.};
+    const CFuint n = 10000;
+    for (CFuint i = 0; i < n; ++i) {
+      CFreal direction[3] = {0., 0., 0.};
+      rng.sphereDirections(dim, direction);
+      BOOST_CHECK_CLOSE( direction[0]*direction[0] + direction[1]*direction[1] +
+			 direction[2]*direction[2], 1., 1e-10 );
+      for (CFuint d = 0; d < dim; ++d) {
+	mean[d] += direction[d]/n;
+      }
+    }
+    for (CFuint d = 0; d < dim; ++d) {
+      BOOST_CHECK_SMALL( mean[d], 0.03 );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_hash_key )
+{
+  const boost::uint32_t key = RandomNumberGenerator::hashKey(1, 2, 3, 4);
+  BOOST_CHECK_EQUAL( key, RandomNumberGenerator::hashKey(1, 2, 3, 4) );
+  BOOST_CHECK( key != RandomNumberGenerator::hashKey(1, 2, 3, 5) );
+  BOOST_CHECK( key != RandomNumberGenerator::hashKey(2, 1, 3, 4) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////